@@ -99,6 +99,7 @@
 
 static int system_has_forkfd(void);
 static int system_forkfd(int flags, pid_t *ppid, int *system);
+static int system_vforkfd(int flags, pid_t *ppid, int (*childFn)(void *), void *token, int *system);
 static int system_forkfd_wait(int ffd, struct forkfd_info *info, int ffdwoptions, struct rusage *rusage);
 
 static int disable_fork_fallback(void)
@@ -764,6 +765,43 @@ err_free:
     freeInfo(header, info);
     return -1;
 }
+
+/**
+ * @brief vforkfd returns a file descriptor representing a child process
+ * @return a file descriptor, or -1 in case of failure
+ *
+ * vforkfd() is like forkfd(), but instead of returning twice, it runs
+ * @a childFn(@a token) in the child process and exits the child with the
+ * function's return value if it returns. Where the system allows it, the
+ * child shares the parent's memory and the calling thread is suspended until
+ * the child has either called execve(2) or exited, like with vfork(2). That
+ * avoids copying the parent's page tables, which dominates the cost of
+ * starting a process from a large application.
+ *
+ * Because of that, @a childFn must only call async-signal-safe functions and
+ * must not modify memory the parent uses. It should also block or reset
+ * signal handlers that could run in the child, as they would do so on the
+ * parent's memory.
+ *
+ * If the system cannot start a child that way, or @a flags contains
+ * @c FFD_USE_FORK, vforkfd() uses forkfd() and calls @a childFn in the
+ * forked child.
+ */
+int vforkfd(int flags, pid_t *ppid, int (*childFn)(void *), void *token)
+{
+    int fd;
+    if ((flags & FFD_USE_FORK) == 0) {
+        int system;
+        fd = system_vforkfd(flags, ppid, childFn, token, &system);
+        if (system || disable_fork_fallback())
+            return fd;
+    }
+
+    fd = forkfd(flags, ppid);
+    if (fd == FFD_CHILD_PROCESS)
+        _exit(childFn(token));
+    return fd;
+}
 #endif // FORKFD_NO_FORKFD
 
 #if _POSIX_SPAWN > 0 && !defined(FORKFD_NO_SPAWNFD)
@@ -880,6 +918,16 @@ int system_forkfd(int flags, pid_t *ppid, int *system)
     return -1;
 }
 
+int system_vforkfd(int flags, pid_t *ppid, int (*childFn)(void *), void *token, int *system)
+{
+    (void)flags;
+    (void)ppid;
+    (void)childFn;
+    (void)token;
+    *system = 0;
+    return -1;
+}
+
 int system_forkfd_wait(int ffd, struct forkfd_info *info, int options, struct rusage *rusage)
 {
     (void)ffd;
@@ -85,6 +85,17 @@ int system_forkfd(int flags, pid_t *ppid, int *system)
     return ret;
 }
 
+int system_vforkfd(int flags, pid_t *ppid, int (*childFn)(void *), void *token, int *system)
+{
+    /* no vfork-like variant of pdfork(); let vforkfd() call forkfd() */
+    (void)flags;
+    (void)ppid;
+    (void)childFn;
+    (void)token;
+    *system = 0;
+    return -1;
+}
+
 int system_forkfd_wait(int ffd, struct forkfd_info *info, int ffdoptions, struct rusage *rusage)
 {
     pid_t pid;
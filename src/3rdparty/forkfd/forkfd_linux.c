@@ -36,6 +36,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/resource.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
@@ -131,19 +132,34 @@ int system_has_forkfd()
     return ffd_atomic_load(&system_forkfd_state, FFD_ATOMIC_RELAXED) > 0;
 }
 
-int system_forkfd(int flags, pid_t *ppid, int *system)
+static int system_forkfd_supported()
 {
-    pid_t pid;
-    int pidfd;
-
     int state = ffd_atomic_load(&system_forkfd_state, FFD_ATOMIC_RELAXED);
     if (state == 0) {
         state = detect_clone_pidfd_support();
         ffd_atomic_store(&system_forkfd_state, state, FFD_ATOMIC_RELAXED);
     }
-    if (state < 0) {
+    return state > 0;
+}
+
+static void system_forkfd_set_flags(int pidfd, int flags)
+{
+    if ((flags & FFD_CLOEXEC) == 0) {
+        /* pidfd defaults to O_CLOEXEC */
+        fcntl(pidfd, F_SETFD, 0);
+    }
+    if (flags & FFD_NONBLOCK)
+        fcntl(pidfd, F_SETFL, fcntl(pidfd, F_GETFL) | O_NONBLOCK);
+}
+
+int system_forkfd(int flags, pid_t *ppid, int *system)
+{
+    pid_t pid;
+    int pidfd;
+
+    if (!system_forkfd_supported()) {
         *system = 0;
-        return state;
+        return -1;
     }
 
     *system = 1;
@@ -160,13 +176,66 @@ int system_forkfd(int flags, pid_t *ppid, int *system)
     }
 
     /* parent process */
-    if ((flags & FFD_CLOEXEC) == 0) {
-        /* pidfd defaults to O_CLOEXEC */
-        fcntl(pidfd, F_SETFD, 0);
+    system_forkfd_set_flags(pidfd, flags);
+    return pidfd;
+}
+
+int system_vforkfd(int flags, pid_t *ppid, int (*childFn)(void *), void *token, int *system)
+{
+#if defined(__hppa__) || defined(__ia64__)
+    /* stacks grow upwards, or clone() takes a stack size: not worth it */
+    (void) flags;
+    (void) ppid;
+    (void) childFn;
+    (void) token;
+    *system = 0;
+    return -1;
+#else
+    /* The child runs on a stack of its own until it execs or exits. Below
+     * it is a guard page, so that overflowing it faults instead of
+     * corrupting the memory it shares with us. childFn gets the arguments
+     * by pointer, so unlike posix_spawn() we need no room for copying
+     * them. */
+    const size_t stackSize = 64 * 1024;
+    const size_t guardSize = (size_t)sysconf(_SC_PAGESIZE);
+    char *childStack;
+    pid_t pid;
+    int pidfd = -1;
+    int saved_errno;
+
+    if (!system_forkfd_supported()) {
+        *system = 0;
+        return -1;
     }
-    if (flags & FFD_NONBLOCK)
-        fcntl(pidfd, F_SETFL, fcntl(pidfd, F_GETFL) | O_NONBLOCK);
+
+    childStack = (char *)mmap(NULL, guardSize + stackSize, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    if (childStack == MAP_FAILED) {
+        *system = 0;
+        return -1;
+    }
+    if (mprotect(childStack, guardSize, PROT_NONE) != 0) {
+        munmap(childStack, guardSize + stackSize);
+        *system = 0;
+        return -1;
+    }
+
+    *system = 1;
+    int cloneflags = CLONE_PIDFD | CLONE_VM | CLONE_VFORK | SIGCHLD;
+    pid = clone(childFn, childStack + guardSize + stackSize, cloneflags, token, &pidfd);
+
+    /* with CLONE_VFORK, the child is done with the stack by now */
+    saved_errno = errno;
+    munmap(childStack, guardSize + stackSize);
+    errno = saved_errno;
+    if (pid < 0)
+        return pid;
+    if (ppid)
+        *ppid = pid;
+
+    system_forkfd_set_flags(pidfd, flags);
     return pidfd;
+#endif
 }
 
 int system_forkfd_wait(int ffd, struct forkfd_info *info, int ffdoptions, struct rusage *rusage)
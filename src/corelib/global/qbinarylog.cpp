@@ -0,0 +1,591 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qbinarylog_p.h"
+
+#include "qendian.h"
+#include "qiodevice.h"
+#include "qthread.h"
+
+#include <chrono>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QBinaryLog;
+
+namespace {
+// A printf conversion specification, as understood by QString::vasprintf()
+struct FormatSpec
+{
+    enum Length { None, Char, Short, Long, LongLong, IntMax, Size, PtrDiff, LongDouble };
+
+    QByteArray flags;       // flags, width and precision, '*' included
+    int starCount = 0;      // number of int arguments for '*' width and precision
+    Length length = None;
+    char conversion = 0;
+};
+} // unnamed namespace
+
+// Parses the specification following a '%' at \a p; returns the end of it
+static const char *parseFormatSpec(const char *p, FormatSpec *spec)
+{
+    const auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+    const char *begin = p;
+    while (*p && strchr("-+ #0'", *p))
+        ++p;
+    if (*p == '*') {
+        ++spec->starCount;
+        ++p;
+    } else {
+        while (isDigit(*p))
+            ++p;
+    }
+    if (*p == '.') {
+        ++p;
+        if (*p == '*') {
+            ++spec->starCount;
+            ++p;
+        } else {
+            while (isDigit(*p))
+                ++p;
+        }
+    }
+    spec->flags = QByteArray(begin, p - begin);
+
+    switch (*p) {
+    case 'h':
+        spec->length = *++p == 'h' ? (++p, FormatSpec::Char) : FormatSpec::Short;
+        break;
+    case 'l':
+        spec->length = *++p == 'l' ? (++p, FormatSpec::LongLong) : FormatSpec::Long;
+        break;
+    case 'L':
+        spec->length = FormatSpec::LongDouble;
+        ++p;
+        break;
+    case 'j':
+        spec->length = FormatSpec::IntMax;
+        ++p;
+        break;
+    case 'z':
+        spec->length = FormatSpec::Size;
+        ++p;
+        break;
+    case 't':
+        spec->length = FormatSpec::PtrDiff;
+        ++p;
+        break;
+    }
+
+    spec->conversion = *p;
+    return *p ? p + 1 : p;
+}
+
+template <typename T>
+static void appendValue(QByteArray &data, T value)
+{
+    const T le = qToLittleEndian(value);
+    data.append(reinterpret_cast<const char *>(&le), sizeof le);
+}
+
+static void appendArgument(QByteArray &data, ArgumentTag tag, quint64 value)
+{
+    data.append(char(tag));
+    appendValue(data, value);
+}
+
+// Copies the arguments for \a format into \a payload. Returns false if the
+// format uses a conversion that cannot be recorded.
+static bool captureArguments(QByteArray &payload, const char *format, va_list ap)
+{
+    for (const char *p = format; *p; ) {
+        if (*p++ != '%')
+            continue;
+        if (*p == '%') {
+            ++p;
+            continue;
+        }
+
+        FormatSpec spec;
+        p = parseFormatSpec(p, &spec);
+        for (int i = 0; i < spec.starCount; ++i)
+            appendArgument(payload, SignedArgument, quint64(qint64(va_arg(ap, int))));
+
+        switch (spec.conversion) {
+        case 'd':
+        case 'i': {
+            // like QString::vasprintf(), don't truncate to char or short
+            qint64 value;
+            switch (spec.length) {
+            case FormatSpec::None:
+            case FormatSpec::Char:
+            case FormatSpec::Short: value = va_arg(ap, int); break;
+            case FormatSpec::Long: value = va_arg(ap, long); break;
+            case FormatSpec::LongLong: value = va_arg(ap, qlonglong); break;
+            case FormatSpec::IntMax: value = va_arg(ap, intmax_t); break;
+            case FormatSpec::Size: value = va_arg(ap, qsizetype); break;
+            case FormatSpec::PtrDiff: value = va_arg(ap, ptrdiff_t); break;
+            default: return false;
+            }
+            appendArgument(payload, SignedArgument, quint64(value));
+            break;
+        }
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X': {
+            quint64 value;
+            switch (spec.length) {
+            case FormatSpec::None:
+            case FormatSpec::Char:
+            case FormatSpec::Short: value = va_arg(ap, uint); break;
+            case FormatSpec::Long: value = va_arg(ap, ulong); break;
+            case FormatSpec::LongLong: value = va_arg(ap, qulonglong); break;
+            case FormatSpec::IntMax: value = va_arg(ap, uintmax_t); break;
+            case FormatSpec::Size: value = va_arg(ap, size_t); break;
+            case FormatSpec::PtrDiff: value = quint64(va_arg(ap, ptrdiff_t)); break;
+            default: return false;
+            }
+            appendArgument(payload, UnsignedArgument, value);
+            break;
+        }
+        case 'c':
+            if (spec.length != FormatSpec::None)
+                return false;
+            appendArgument(payload, SignedArgument, quint64(qint64(va_arg(ap, int))));
+            break;
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A': {
+            const double value = spec.length == FormatSpec::LongDouble
+                    ? double(va_arg(ap, long double)) : va_arg(ap, double);
+            payload.append(char(DoubleArgument));
+            appendValue(payload, value);
+            break;
+        }
+        case 's': {
+            if (spec.length != FormatSpec::None)
+                return false;
+            const char *string = va_arg(ap, const char *);
+            const quint32 size = string ? quint32(qstrlen(string)) : 0;
+            payload.append(char(StringArgument));
+            appendValue(payload, size);
+            payload.append(string, size);
+            break;
+        }
+        case 'p':
+            if (spec.length != FormatSpec::None)
+                return false;
+            appendArgument(payload, PointerArgument, quintptr(va_arg(ap, void *)));
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+    \internal
+    \class QBinaryLogWriter
+    \inmodule QtCore
+
+    \brief Writes log messages to a file in a compact binary format.
+
+    Debug and info messages logged with printf-style formats are not
+    formatted: the writer records the format string and copies the
+    arguments, leaving the formatting to QBinaryLogReader. All other
+    messages, including those streamed through QDebug, arrive formatted
+    and are stored as text. Strings from the message context are
+    written only once and referred to by id afterwards.
+
+    All functions are thread-safe.
+*/
+
+QBinaryLogWriter::~QBinaryLogWriter()
+{
+    close();
+}
+
+bool QBinaryLogWriter::open(const char *fileName)
+{
+    QMutexLocker locker(&mutex);
+    if (file)
+        return false;
+    file = fopen(fileName, "wb");
+    if (!file)
+        return false;
+
+    setvbuf(file, nullptr, _IOFBF, 64 * 1024);
+    const quint32 version = qToLittleEndian(Version);
+    fwrite(Magic, 1, sizeof Magic, file);
+    fwrite(&version, 1, sizeof version, file);
+    return true;
+}
+
+void QBinaryLogWriter::close()
+{
+    QMutexLocker locker(&mutex);
+    if (file)
+        fclose(file);
+    file = nullptr;
+    strings.clear();
+    nextStringId = 1;
+}
+
+void QBinaryLogWriter::flush()
+{
+    QMutexLocker locker(&mutex);
+    if (file)
+        fflush(file);
+}
+
+/*!
+    Writes the already formatted \a message.
+*/
+void QBinaryLogWriter::write(QtMsgType type, const QMessageLogContext &context,
+                             const QString &message)
+{
+    QMutexLocker locker(&mutex);
+    if (!file)
+        return;
+
+    payload.resize(message.size() * sizeof(char16_t));
+    qToLittleEndian<char16_t>(message.utf16(), message.size(), payload.data());
+    writeMessage(type, context, 0);
+}
+
+/*!
+    Records \a format and the arguments in \a ap without formatting them.
+    Returns false, without consuming \a ap, if the message cannot be
+    recorded that way; the caller then has to format it.
+*/
+bool QBinaryLogWriter::writeDeferred(QtMsgType type, const QMessageLogContext &context,
+                                     const char *format, va_list ap)
+{
+    QMutexLocker locker(&mutex);
+    if (!file || !format)
+        return false;
+
+    payload.resize(0);
+    va_list args;
+    va_copy(args, ap);
+    const bool captured = captureArguments(payload, format, args);
+    va_end(args);
+    if (!captured)
+        return false;
+
+    writeMessage(type, context, stringId(format));
+    return true;
+}
+
+quint32 QBinaryLogWriter::stringId(const char *string)
+{
+    if (!string)
+        return 0;
+
+    // the pointer is only a hint: buffers are reused for different strings
+    auto it = strings.find(string);
+    if (it != strings.end() && qstrcmp(it->text, string) == 0)
+        return it->id;
+
+    const quint32 id = nextStringId++;
+    const quint32 size = quint32(qstrlen(string));
+    strings.insert(string, { id, QByteArray(string, size) });
+
+    record.resize(0);
+    record.append(char(StringRecord));
+    appendValue(record, id);
+    appendValue(record, size);
+    record.append(string, size);
+    fwrite(record.constData(), 1, size_t(record.size()), file);
+    return id;
+}
+
+void QBinaryLogWriter::writeMessage(QtMsgType type, const QMessageLogContext &context,
+                                    quint32 formatId)
+{
+    using namespace std::chrono;
+    const qint64 nsecs = duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+    const quint32 fileId = stringId(context.file);
+    const quint32 functionId = stringId(context.function);
+    const quint32 categoryId = stringId(context.category);
+
+    record.resize(0);
+    record.append(char(MessageRecord));
+    record.append(char(type));
+    appendValue(record, nsecs);
+    appendValue(record, quint64(quintptr(QThread::currentThreadId())));
+    appendValue(record, fileId);
+    appendValue(record, qint32(context.line));
+    appendValue(record, functionId);
+    appendValue(record, categoryId);
+    appendValue(record, formatId);
+    appendValue(record, quint32(payload.size()));
+    record.append(payload);
+    fwrite(record.constData(), 1, size_t(record.size()), file);
+}
+
+/*!
+    \internal
+    \class QBinaryLogReader
+    \inmodule QtCore
+
+    \brief Reads the messages written by QBinaryLogWriter.
+
+    Call readNext() until it returns false, then check hasError(). The
+    properties of the current message are available through the accessors;
+    message() formats deferred messages the way qDebug() would have.
+*/
+
+QBinaryLogReader::QBinaryLogReader(QIODevice *device)
+    : device(device)
+{
+}
+
+bool QBinaryLogReader::setError(const QString &message)
+{
+    error = message;
+    return false;
+}
+
+bool QBinaryLogReader::read(void *data, qint64 size)
+{
+    if (device->read(static_cast<char *>(data), size) != size)
+        return setError(QStringLiteral("Unexpected end of binary log"));
+    return true;
+}
+
+template <typename T>
+bool QBinaryLogReader::read(T *value)
+{
+    if (!read(static_cast<void *>(value), sizeof(T)))
+        return false;
+    *value = qFromLittleEndian(*value);
+    return true;
+}
+
+const char *QBinaryLogReader::string(quint32 id)
+{
+    if (id == 0)
+        return nullptr;
+    auto it = strings.constFind(id);
+    if (it == strings.constEnd()) {
+        setError(QStringLiteral("Undefined string %1 in binary log").arg(id));
+        return nullptr;
+    }
+    return it->constData();
+}
+
+bool QBinaryLogReader::readNext()
+{
+    if (hasError())
+        return false;
+
+    if (!headerRead) {
+        char magic[sizeof Magic];
+        quint32 version;
+        if (!read(magic, sizeof magic) || !read(&version))
+            return false;
+        if (memcmp(magic, Magic, sizeof Magic) != 0)
+            return setError(QStringLiteral("Not a binary log"));
+        if (version != Version)
+            return setError(QStringLiteral("Unsupported binary log version %1").arg(version));
+        headerRead = true;
+    }
+
+    const auto readBlock = [this](QByteArray *data) {
+        quint32 size;
+        if (!read(&size))
+            return false;
+        if (!device->isSequential() && size > device->size() - device->pos())
+            return setError(QStringLiteral("Unexpected end of binary log"));
+        data->resize(size);
+        return read(data->data(), size);
+    };
+
+    while (!device->atEnd()) {
+        quint8 kind;
+        if (!read(&kind))
+            return false;
+
+        if (kind == StringRecord) {
+            quint32 id;
+            QByteArray data;
+            if (!read(&id) || !readBlock(&data))
+                return false;
+            strings.insert(id, data);
+            continue;
+        }
+        if (kind != MessageRecord)
+            return setError(QStringLiteral("Unknown record in binary log"));
+
+        quint8 type;
+        qint32 line;
+        quint32 fileId, functionId, categoryId, formatId;
+        if (!read(&type) || !read(&nsecsSinceEpoch) || !read(&thread) || !read(&fileId)
+                || !read(&line) || !read(&functionId) || !read(&categoryId) || !read(&formatId)
+                || !readBlock(&payload)) {
+            return false;
+        }
+        msgType = QtMsgType(type);
+        ctx.file = string(fileId);
+        ctx.line = line;
+        ctx.function = string(functionId);
+        ctx.category = string(categoryId);
+        format = string(formatId);
+        return !hasError();
+    }
+    return false;
+}
+
+/*!
+    Returns the text of the current message.
+*/
+QString QBinaryLogReader::message() const
+{
+    if (!format) {
+        QString text(payload.size() / qsizetype(sizeof(char16_t)), Qt::Uninitialized);
+        qFromLittleEndian<char16_t>(payload.constData(), text.size(), text.data());
+        return text;
+    }
+
+    const char *arg = payload.constData();
+    const char *const end = arg + payload.size();
+    const auto takeValue = [&](auto *value) {
+        if (end - arg < qsizetype(sizeof *value))
+            return false;
+        *value = qFromLittleEndian<std::remove_pointer_t<decltype(value)>>(arg);
+        arg += sizeof *value;
+        return true;
+    };
+    const auto takeTag = [&](char *tag) {
+        if (arg == end)
+            return false;
+        *tag = *arg++;
+        return true;
+    };
+
+    QString result;
+    for (const char *p = format; *p; ) {
+        const char *literal = p;
+        while (*p && *p != '%')
+            ++p;
+        result += QString::fromUtf8(literal, p - literal);
+        if (!*p)
+            break;
+        if (*++p == '%') {
+            result += QLatin1Char('%');
+            ++p;
+            continue;
+        }
+
+        FormatSpec spec;
+        p = parseFormatSpec(p, &spec);
+        QByteArray conversion = "%";
+        for (char c : qAsConst(spec.flags)) {
+            char tag;
+            qint64 value;
+            if (c == '*' && takeTag(&tag) && takeValue(&value))
+                conversion += QByteArray::number(value);
+            else
+                conversion += c;
+        }
+
+        char tag;
+        if (!takeTag(&tag))
+            break;
+        switch (tag) {
+        case SignedArgument:
+        case UnsignedArgument: {
+            quint64 value;
+            if (!takeValue(&value))
+                break;
+            if (spec.conversion == 'c') {
+                conversion += 'c';
+                result += QString::asprintf(conversion.constData(), int(value));
+            } else {
+                conversion += "ll";
+                conversion += spec.conversion;
+                if (tag == SignedArgument)
+                    result += QString::asprintf(conversion.constData(), qlonglong(value));
+                else
+                    result += QString::asprintf(conversion.constData(), qulonglong(value));
+            }
+            break;
+        }
+        case DoubleArgument: {
+            double value;
+            if (!takeValue(&value))
+                break;
+            conversion += spec.conversion;
+            result += QString::asprintf(conversion.constData(), value);
+            break;
+        }
+        case StringArgument: {
+            quint32 size;
+            if (!takeValue(&size) || end - arg < qsizetype(size))
+                break;
+            const QByteArray string(arg, size);
+            arg += size;
+            conversion += 's';
+            result += QString::asprintf(conversion.constData(), string.constData());
+            break;
+        }
+        case PointerArgument: {
+            quint64 value;
+            if (!takeValue(&value))
+                break;
+            conversion += 'p';
+            result += QString::asprintf(conversion.constData(),
+                                        reinterpret_cast<void *>(quintptr(value)));
+            break;
+        }
+        }
+    }
+    return result;
+}
+
+QT_END_NAMESPACE
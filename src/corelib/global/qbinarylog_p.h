@@ -0,0 +1,177 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QBINARYLOG_P_H
+#define QBINARYLOG_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qlogging.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qstring.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+
+QT_BEGIN_NAMESPACE
+
+class QIODevice;
+
+/*
+    Binary log files start with Magic followed by the quint32 Version. The
+    rest is a sequence of records, each introduced by a RecordKind byte. All
+    integers are little-endian.
+
+    StringRecord:  quint32 id, quint32 size, size bytes.
+        Defines the string that later records refer to by id. Ids are
+        assigned per distinct const char * (file names, function names,
+        category names and format strings); id 0 stands for nullptr.
+
+    MessageRecord: quint8 type, qint64 nanoseconds since the epoch,
+        quint64 thread id, quint32 file id, qint32 line, quint32 function id,
+        quint32 category id, quint32 format id, quint32 size, size bytes of
+        payload.
+        A format id of 0 means the payload is the message text in UTF-16.
+        Otherwise the payload holds the printf arguments for the format, each
+        an ArgumentTag followed by a qint64, quint64 or double, or by a
+        quint32 size and that many bytes for strings.
+*/
+namespace QBinaryLog {
+constexpr char Magic[8] = { 'Q', 't', 'B', 'i', 'n', 'L', 'o', 'g' };
+constexpr quint32 Version = 1;
+
+enum RecordKind : quint8 {
+    StringRecord = 1,
+    MessageRecord = 2
+};
+
+enum ArgumentTag : quint8 {
+    SignedArgument = 'i',
+    UnsignedArgument = 'u',
+    DoubleArgument = 'd',
+    StringArgument = 's',
+    PointerArgument = 'p'
+};
+}
+
+class Q_CORE_EXPORT QBinaryLogWriter
+{
+    Q_DISABLE_COPY_MOVE(QBinaryLogWriter)
+public:
+    QBinaryLogWriter() = default;
+    ~QBinaryLogWriter();
+
+    bool open(const char *fileName);
+    bool isOpen() const { return file != nullptr; }
+    void close();
+    void flush();
+
+    void write(QtMsgType type, const QMessageLogContext &context, const QString &message);
+    bool writeDeferred(QtMsgType type, const QMessageLogContext &context,
+                       const char *format, va_list ap);
+
+private:
+    quint32 stringId(const char *string);
+    void writeMessage(QtMsgType type, const QMessageLogContext &context, quint32 formatId);
+
+    QMutex mutex;
+    FILE *file = nullptr;
+    struct StringEntry
+    {
+        quint32 id;
+        QByteArray text;
+    };
+    QHash<const char *, StringEntry> strings;
+    quint32 nextStringId = 1;
+    QByteArray payload;
+    QByteArray record;
+};
+
+class Q_CORE_EXPORT QBinaryLogReader
+{
+    Q_DISABLE_COPY_MOVE(QBinaryLogReader)
+public:
+    explicit QBinaryLogReader(QIODevice *device);
+
+    bool readNext();
+    bool hasError() const { return !error.isEmpty(); }
+    QString errorString() const { return error; }
+
+    QtMsgType type() const { return msgType; }
+    // the context's strings stay valid for the lifetime of the reader
+    const QMessageLogContext &context() const { return ctx; }
+    qint64 timestamp() const { return nsecsSinceEpoch; }
+    quint64 threadId() const { return thread; }
+    QString message() const;
+
+private:
+    bool read(void *data, qint64 size);
+    template <typename T> bool read(T *value);
+    const char *string(quint32 id);
+    bool setError(const QString &message);
+
+    QIODevice *device;
+    QHash<quint32, QByteArray> strings;
+    QString error;
+    bool headerRead = false;
+
+    QtMsgType msgType = QtDebugMsg;
+    QMessageLogContext ctx;
+    qint64 nsecsSinceEpoch = 0;
+    quint64 thread = 0;
+    const char *format = nullptr;
+    QByteArray payload;
+};
+
+QT_END_NAMESPACE
+
+#endif // QBINARYLOG_P_H
@@ -57,6 +57,7 @@
 #include "qdatetime.h"
 #include "qcoreapplication.h"
 #include "qthread.h"
+#include "private/qbinarylog_p.h"
 #include "private/qloggingregistry_p.h"
 #include "private/qcoreapplication_p.h"
 #include "private/qsimd_p.h"
@@ -165,6 +166,14 @@ static QT_PREPEND_NAMESPACE(qint64) qt_gettid()
 #include <memory>
 #include <vector>
 
+#if !defined(QT_BOOTSTRAPPED) && QT_CONFIG(thread) && defined(Q_COMPILER_THREAD_LOCAL)
+#  define QLOGGING_HAVE_ASYNC_OUTPUT
+#  include <atomic>
+#  include <condition_variable>
+#  include <mutex>
+#  include <thread>
+#endif
+
 #include <stdio.h>
 
 QT_BEGIN_NAMESPACE
@@ -175,6 +184,10 @@ Q_NORETURN
 static void qt_message_fatal(QtMsgType, const QMessageLogContext &context, const QString &message);
 static void qt_message_print(QtMsgType, const QMessageLogContext &context, const QString &message);
 static void qt_message_print(const QString &message);
+#ifndef QT_BOOTSTRAPPED
+static bool qt_message_deferred(QtMsgType msgType, const QMessageLogContext &context,
+                                const char *msg, va_list ap);
+#endif
 
 static int checked_var_value(const char *varname)
 {
@@ -219,6 +232,18 @@ static bool isDefaultCategory(const char *category)
     return !category || strcmp(category, "default") == 0;
 }
 
+#ifndef QT_BOOTSTRAPPED
+static bool isDisabledInDefaultCategory(QtMsgType msgType, const QMessageLogContext &context)
+{
+    // qDebug, qWarning, ... macros do not check whether category is enabled
+    if (msgType != QtFatalMsg && isDefaultCategory(context.category)) {
+        if (QLoggingCategory *defaultCategory = QLoggingCategory::defaultCategory())
+            return !defaultCategory->isEnabled(msgType);
+    }
+    return false;
+}
+#endif
+
 /*!
     Returns true if writing to \c stderr is supported.
 
@@ -371,6 +396,13 @@ static inline void convert_to_wchar_t_elided(wchar_t *d, size_t space, const cha
 Q_NEVER_INLINE
 static QString qt_message(QtMsgType msgType, const QMessageLogContext &context, const char *msg, va_list ap)
 {
+#ifndef QT_BOOTSTRAPPED
+    // debug and info messages are never fatal, so their text may not be needed
+    if ((msgType == QtDebugMsg || msgType == QtInfoMsg)
+            && qt_message_deferred(msgType, context, msg, ap)) {
+        return QString();
+    }
+#endif
     QString buf = QString::vasprintf(msg, ap);
     qt_message_print(msgType, context, buf);
     return buf;
@@ -1497,6 +1529,29 @@ static QBasicAtomicPointer<void (QtMsgType, const QMessageLogContext &, const QS
     // Boostrapped tools always print to stderr, so no need for alternate sinks
 #else
 
+namespace {
+struct BinaryLogOutput : QBinaryLogWriter
+{
+    BinaryLogOutput()
+    {
+        const QByteArray fileName = qgetenv("QT_LOGGING_BINARY");
+        if (!fileName.isEmpty() && !open(fileName.constData()))
+            fprintf(stderr, "QT_LOGGING_BINARY: cannot open %s\n", fileName.constData());
+    }
+};
+} // unnamed namespace
+
+Q_GLOBAL_STATIC(BinaryLogOutput, binaryLogOutput)
+
+static QBinaryLogWriter *activeBinaryLogWriter()
+{
+    static const bool enabled = !qEnvironmentVariableIsEmpty("QT_LOGGING_BINARY");
+    if (!enabled || binaryLogOutput.isDestroyed())
+        return nullptr;
+    QBinaryLogWriter *writer = binaryLogOutput();
+    return writer->isOpen() ? writer : nullptr;
+}
+
 #if QT_CONFIG(slog2)
 #ifndef QT_LOG_CODE
 #define QT_LOG_CODE 9000
@@ -1733,6 +1788,263 @@ static bool wasm_default_message_handler(QtMsgType type,
 
 // --------------------------------------------------------------------------
 
+#ifdef QLOGGING_HAVE_ASYNC_OUTPUT
+namespace {
+/*
+    Writes formatted messages to stderr from a background thread, so that the
+    logging threads do not block on terminal or pipe I/O. Enabled by setting
+    QT_LOGGING_ASYNC to "block" (or any non-zero number) or "drop".
+
+    Every logging thread owns a fixed-size single-producer/single-consumer
+    ring of records, so enqueueing is lock-free. The writer thread drains
+    all rings in batches; records of one thread keep their order, records
+    of different threads may interleave differently than they were logged.
+    When a ring is full the producer either sleeps until the writer has made
+    room (Block) or discards the record (Drop); the number of discarded
+    records is reported.
+*/
+class AsyncLogWriter
+{
+public:
+    enum Mode { Disabled, Block, Drop };
+
+    static Mode modeFromEnvironment()
+    {
+        const QByteArray value = qgetenv("QT_LOGGING_ASYNC").trimmed().toLower();
+        if (value == "drop")
+            return Drop;
+        if (value == "block" || value.toInt() != 0)
+            return Block;
+        return Disabled;
+    }
+
+    AsyncLogWriter()
+        : mode(modeFromEnvironment()),
+          writer([this] { run(); })
+    {
+    }
+
+    ~AsyncLogWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            quit = true;
+        }
+        wakeCondition.notify_one();
+        writer.join();
+    }
+
+    void enqueue(QByteArray &&record)
+    {
+        Ring *ring = threadRing();
+        const quint32 tail = ring->tail.load(std::memory_order_relaxed);
+        if (tail - ring->head.load(std::memory_order_acquire) >= RingSize) {
+            if (mode == Drop) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            waitForSpace(ring, tail);
+        }
+        ring->records[tail % RingSize] = std::move(record);
+        ring->tail.store(tail + 1, std::memory_order_seq_cst);
+
+        // pairs with the store in run(): either the writer sees our record
+        // before going to sleep, or we see that it is idle and wake it up
+        if (writerIdle.load(std::memory_order_seq_cst))
+            wake();
+    }
+
+    // Writes out everything that was enqueued so far, on the calling thread.
+    void flush()
+    {
+        drain();
+    }
+
+private:
+    static constexpr quint32 RingSize = 1024;
+    static constexpr qsizetype BatchSize = 64 * 1024;
+
+    struct Ring
+    {
+        QByteArray records[RingSize];
+        std::atomic<quint32> head = {0};    // next record to write out
+        std::atomic<quint32> tail = {0};    // next free slot
+        std::atomic<bool> orphaned = {false};
+    };
+
+    struct ThreadRing
+    {
+        std::shared_ptr<Ring> ring;
+        ~ThreadRing()
+        {
+            // the writer releases the ring once it is drained
+            if (ring)
+                ring->orphaned.store(true, std::memory_order_release);
+        }
+    };
+
+    Ring *threadRing()
+    {
+        static thread_local ThreadRing current;
+        if (!current.ring) {
+            current.ring = std::make_shared<Ring>();
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            rings.push_back(current.ring);
+        }
+        return current.ring.get();
+    }
+
+    void wake()
+    {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+        }
+        wakeCondition.notify_one();
+    }
+
+    // Sleeps until the writer has made room in the full \a ring.
+    void waitForSpace(Ring *ring, quint32 tail)
+    {
+        wake();
+        std::unique_lock<std::mutex> lock(spaceMutex);
+        // pairs with the load in releaseSpace(): either the writer sees
+        // that we are waiting, or we see the room it made
+        blockedProducers.fetch_add(1, std::memory_order_seq_cst);
+        spaceCondition.wait(lock, [ring, tail] {
+            return tail - ring->head.load(std::memory_order_seq_cst) < RingSize;
+        });
+        blockedProducers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Wakes the producers waiting for room, after heads were moved.
+    void releaseSpace()
+    {
+        if (blockedProducers.load(std::memory_order_seq_cst) == 0)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(spaceMutex);
+        }
+        spaceCondition.notify_all();
+    }
+
+    bool hasPendingRecords()
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        for (const auto &ring : rings) {
+            if (ring->head.load(std::memory_order_relaxed)
+                    != ring->tail.load(std::memory_order_acquire)) {
+                return true;
+            }
+        }
+        return dropped.load(std::memory_order_relaxed) != 0;
+    }
+
+    bool drain()
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        bool wrote = false;
+        const auto write = [&] {
+            fwrite(batch.constData(), 1, size_t(batch.size()), stderr);
+            batch.resize(0);
+            wrote = true;
+        };
+
+        for (auto it = rings.begin(); it != rings.end(); ) {
+            Ring *ring = it->get();
+            // read before the tail, so that no record of an exiting thread is lost
+            const bool orphaned = ring->orphaned.load(std::memory_order_acquire);
+            quint32 head = ring->head.load(std::memory_order_relaxed);
+            const quint32 tail = ring->tail.load(std::memory_order_acquire);
+            for (; head != tail; ++head) {
+                QByteArray &record = ring->records[head % RingSize];
+                batch += record;
+                record.clear();
+                if (batch.size() >= BatchSize) {
+                    write();
+                    // make room for a blocked producer as early as possible
+                    ring->head.store(head + 1, std::memory_order_seq_cst);
+                    releaseSpace();
+                }
+            }
+            ring->head.store(head, std::memory_order_seq_cst);
+            if (orphaned)
+                it = rings.erase(it);
+            else
+                ++it;
+        }
+        releaseSpace();
+
+        if (const int count = dropped.exchange(0, std::memory_order_relaxed))
+            batch += "QT_LOGGING_ASYNC: " + QByteArray::number(count) + " messages dropped\n";
+        if (!batch.isEmpty())
+            write();
+        if (wrote)
+            fflush(stderr);
+        return wrote;
+    }
+
+    void run()
+    {
+        for (;;) {
+            if (drain())
+                continue;
+
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            if (quit)
+                break;
+            writerIdle.store(true, std::memory_order_seq_cst);
+            if (!hasPendingRecords())
+                wakeCondition.wait(lock);
+            writerIdle.store(false, std::memory_order_relaxed);
+        }
+        drain();
+    }
+
+    const Mode mode;
+    std::atomic<int> dropped = {0};
+    std::atomic<bool> writerIdle = {false};
+
+    std::mutex ringsMutex;  // protects rings and batch, serializes draining
+    std::vector<std::shared_ptr<Ring>> rings;
+    QByteArray batch;
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    bool quit = false;
+
+    // producers waiting for room in their ring, in Block mode
+    std::mutex spaceMutex;
+    std::condition_variable spaceCondition;
+    std::atomic<int> blockedProducers = {0};
+
+    std::thread writer; // last, so that it starts after everything above
+};
+} // unnamed namespace
+
+Q_GLOBAL_STATIC(AsyncLogWriter, asyncLogWriter)
+
+static AsyncLogWriter *activeAsyncLogWriter()
+{
+    static const bool enabled = AsyncLogWriter::modeFromEnvironment() != AsyncLogWriter::Disabled;
+    // messages logged during static destruction are written synchronously
+    if (!enabled || asyncLogWriter.isDestroyed())
+        return nullptr;
+    return asyncLogWriter();
+}
+#endif // QLOGGING_HAVE_ASYNC_OUTPUT
+
+static void flushPendingMessages()
+{
+#ifdef QLOGGING_HAVE_ASYNC_OUTPUT
+    if (AsyncLogWriter *writer = activeAsyncLogWriter())
+        writer->flush();
+#endif
+#ifndef QT_BOOTSTRAPPED
+    if (QBinaryLogWriter *writer = activeBinaryLogWriter())
+        writer->flush();
+#endif
+}
+
 static void stderr_message_handler(QtMsgType type, const QMessageLogContext &context, const QString &message)
 {
     QString formattedMessage = qFormatLogMessage(type, context, message);
@@ -1742,6 +2054,19 @@ static void stderr_message_handler(QtMsgType type, const QMessageLogContext &con
     if (formattedMessage.isNull())
         return;
 
+#ifdef QLOGGING_HAVE_ASYNC_OUTPUT
+    if (type != QtFatalMsg) {
+        if (AsyncLogWriter *writer = activeAsyncLogWriter()) {
+            QByteArray record = std::move(formattedMessage).toLocal8Bit();
+            record += '\n';
+            writer->enqueue(std::move(record));
+            return;
+        }
+    } else {
+        flushPendingMessages();
+    }
+#endif
+
     fprintf(stderr, "%s\n", formattedMessage.toLocal8Bit().constData());
     fflush(stderr);
 }
@@ -1754,6 +2079,16 @@ static void qDefaultMessageHandler(QtMsgType type, const QMessageLogContext &con
 {
     bool handledStderr = false;
 
+#if !defined(QT_BOOTSTRAPPED)
+    // the binary log replaces all other output, except for fatal messages
+    if (QBinaryLogWriter *writer = activeBinaryLogWriter()) {
+        writer->write(type, context, message);
+        if (type != QtFatalMsg)
+            return;
+        writer->flush();
+    }
+#endif
+
     // A message sink logs the message to a structured or unstructured destination,
     // optionally formatting the message if the latter, and returns true if the sink
     // handled stderr output as well, which will shortcut our default stderr output.
@@ -1810,13 +2145,8 @@ static void qt_message_print(QtMsgType msgType, const QMessageLogContext &contex
 #ifndef QT_BOOTSTRAPPED
     Q_TRACE(qt_message_print, msgType, context.category, context.function, context.file, context.line, message);
 
-    // qDebug, qWarning, ... macros do not check whether category is enabledgc
-    if (msgType != QtFatalMsg && isDefaultCategory(context.category)) {
-        if (QLoggingCategory *defaultCategory = QLoggingCategory::defaultCategory()) {
-            if (!defaultCategory->isEnabled(msgType))
-                return;
-        }
-    }
+    if (isDisabledInDefaultCategory(msgType, context))
+        return;
 #endif
 
     // prevent recursion in case the message handler generates messages
@@ -1830,6 +2160,31 @@ static void qt_message_print(QtMsgType msgType, const QMessageLogContext &contex
     }
 }
 
+#ifndef QT_BOOTSTRAPPED
+// Records a printf-style message in the binary log without formatting it,
+// like qt_message_print() would record the formatted one. Returns false if
+// the message has to be formatted and printed as usual.
+static bool qt_message_deferred(QtMsgType msgType, const QMessageLogContext &context,
+                                const char *msg, va_list ap)
+{
+    // the trace point and custom message handlers need the formatted text
+    if (Q_TRACE_ENABLED(qt_message_print) || messageHandler.loadAcquire())
+        return false;
+    QBinaryLogWriter *writer = activeBinaryLogWriter();
+    if (!writer)
+        return false;
+    if (isDisabledInDefaultCategory(msgType, context))
+        return true;
+
+    // a message logged while this one is written goes to stderr, as in
+    // qt_message_print()
+    if (!grabMessageHandler())
+        return false;
+    const auto ungrab = qScopeGuard([]{ ungrabMessageHandler(); });
+    return writer->writeDeferred(msgType, context, msg, ap);
+}
+#endif
+
 static void qt_message_print(const QString &message)
 {
 #if defined(Q_OS_WIN) && !defined(QT_BOOTSTRAPPED)
@@ -1900,8 +2255,11 @@ static void qt_message_fatal(QtMsgType, const QMessageLogContext &context, const
 void qt_message_output(QtMsgType msgType, const QMessageLogContext &context, const QString &message)
 {
     qt_message_print(msgType, context, message);
-    if (isFatal(msgType))
+    if (isFatal(msgType)) {
+        // warnings made fatal by QT_FATAL_WARNINGS may still be queued
+        flushPendingMessages();
         qt_message_fatal(msgType, context, message);
+    }
 }
 
 void qErrnoWarning(const char *msg, ...)
@@ -1968,6 +2326,24 @@ void qErrnoWarning(int code, const char *msg, ...)
     output under X11 or to the debugger under Windows. If it is a
     fatal message, the application aborts immediately.
 
+    When the default message handler writes to \c stderr, the output can be
+    moved to a background thread by setting the \c QT_LOGGING_ASYNC
+    environment variable. With the value \c block, a thread logging faster
+    than the output can be written waits once its queue of 1024 messages is
+    full; with \c drop, further messages are discarded instead and their
+    number is reported. Messages of a single thread keep their order.
+    Queued messages are written out before a fatal message and when the
+    application exits.
+
+    Setting \c QT_LOGGING_BINARY to a file name makes the default message
+    handler write all messages to that file in a compact binary format
+    instead, which the \c binarylogdump utility turns back into text using
+    the message pattern. Only messages logged through printf-style qDebug()
+    and qInfo() calls, including their category variants, are recorded
+    without being formatted; messages streamed through QDebug, such as
+    \c{qCDebug(category) << value}, and all warnings are formatted first
+    as usual. Fatal messages are additionally printed as usual.
+
     Only one message handler can be defined, since this is usually
     done on an application-wide basis to control debug output.
 
@@ -0,0 +1,850 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qasyncfileio_p.h"
+
+#include "qfile.h"
+#include "qmutex.h"
+#include "qpromise.h"
+#include "qrunnable.h"
+#include "qthread.h"
+#include "qthreadpool.h"
+#include "qvarlengtharray.h"
+
+#ifdef Q_OS_UNIX
+#include "private/qcore_unix_p.h"
+#include <sys/stat.h>
+#include <sys/uio.h>
+#endif
+
+#ifdef Q_OS_LINUX
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#  if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup) \
+        && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register) && defined(STATX_SIZE)
+#    include <linux/io_uring.h>
+#    ifdef IO_URING_OP_SUPPORTED
+#      define QT_ASYNCFILEIO_HAVE_IO_URING
+#    endif
+#  endif
+#endif
+
+#include <deque>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+    \class QAsyncFileIO
+    \inmodule QtCore
+    \since 6.1
+
+    \brief The QAsyncFileIO class reads and writes files without blocking the
+    calling thread.
+
+    Every request returns a QFuture that finishes once the data has been
+    transferred; use QFutureWatcher to be notified in an event loop. Many
+    requests can be submitted at once with the list overloads, which is how
+    loading a large number of small files should be done.
+
+    On Linux the requests are handed to the kernel through an io_uring
+    instance shared by all callers and completed by a single thread. When
+    io_uring is not available (other platforms, older kernels, or sandboxes
+    that forbid it) and when the QT_NO_IO_URING environment variable is set,
+    the requests run on a private QThreadPool instead.
+
+    \sa instance()
+*/
+
+/*!
+    \enum QAsyncFileIO::Backend
+
+    \value ThreadPoolBackend The requests block in worker threads.
+    \value IoUringBackend The requests are submitted to an io_uring instance.
+*/
+
+/*!
+    \struct QAsyncFileIO::ReadRequest
+
+    Describes one positional read: \c size bytes from \c fd starting at
+    \c offset, stored in \c buffer.
+*/
+
+class QAsyncFileRequest
+{
+public:
+    enum Operation {
+        Read,
+        Write,
+        Open,
+        Stat
+    };
+
+    enum Completion {
+        Finished,
+        Resubmit,
+        RunOnThread
+    };
+
+    // Linux moves at most 0x7ffff000 bytes per read or write, so longer
+    // transfers are split into chunks of 1 GiB.
+    static constexpr qint64 MaxTransferSize = Q_INT64_C(1) << 30;
+
+    virtual ~QAsyncFileRequest() = default;
+
+    // Performs the whole request on the calling thread.
+    virtual void run() = 0;
+
+#ifdef Q_OS_UNIX
+    // Reports the result of the current operation: the number of bytes
+    // moved, a file descriptor or a negative errno value. Returns whether
+    // the request is done, must be submitted again for its next operation,
+    // or has to be finished by run() on a worker thread.
+    virtual Completion completed(qint64 result) = 0;
+
+    qint64 chunkSize() const { return qMin(size, MaxTransferSize); }
+
+    qint64 transferOnce() const
+    {
+        qint64 result;
+        if (operation == Read)
+            EINTR_LOOP(result, ::pread(fd, buffer, size_t(chunkSize()), QT_OFF_T(offset)));
+        else
+            EINTR_LOOP(result, ::pwrite(fd, buffer, size_t(chunkSize()), QT_OFF_T(offset)));
+        return result < 0 ? -qint64(errno) : result;
+    }
+
+    struct iovec iov;
+#endif
+
+    Operation operation = Read;
+    int fd = -1;
+    qint64 offset = 0;
+    char *buffer = nullptr;
+    qint64 size = 0;
+};
+
+#ifdef Q_OS_UNIX
+class QAsyncPositionalRequest : public QAsyncFileRequest
+{
+public:
+    void run() override
+    {
+        for (;;) {
+            const qint64 result = transferOnce();
+            if (result == -EAGAIN) {
+                // a non-blocking fd: wait until it is ready instead of
+                // retrying at once
+                if (waitUntilReady())
+                    continue;
+                completed(-qint64(errno));
+                return;
+            }
+            if (completed(result) != Resubmit)
+                return;
+        }
+    }
+
+    Completion completed(qint64 result) override
+    {
+        if (result == -EINTR)
+            return Resubmit;
+        // resubmitting to the ring would spin, so a worker thread polls
+        if (result == -EAGAIN)
+            return RunOnThread;
+        if (result > 0) {
+            done += result;
+            // only a chunk that went through completely continues with the
+            // rest; any other short transfer is the caller's to handle
+            if (result == MaxTransferSize && size > MaxTransferSize) {
+                offset += result;
+                buffer += result;
+                size -= result;
+                return Resubmit;
+            }
+        }
+        promise.addResult(result < 0 && done == 0 ? qint64(-1) : done);
+        promise.finish();
+        return Finished;
+    }
+
+    bool waitUntilReady() const
+    {
+        pollfd pfd = qt_make_pollfd(fd, operation == Read ? POLLIN : POLLOUT);
+        return qt_poll_msecs(&pfd, 1, -1) >= 0;
+    }
+
+    QPromise<qint64> promise;
+    qint64 done = 0;
+};
+#endif
+
+class QAsyncFileReadRequest : public QAsyncFileRequest
+{
+public:
+    void run() override
+    {
+        QFile file(fileName);
+        if (file.open(QIODevice::ReadOnly)) {
+            QByteArray contents = file.readAll();
+            if (file.error() == QFileDevice::NoError)
+                promise.addResult(std::move(contents));
+        }
+        promise.finish();
+    }
+
+#ifdef QT_ASYNCFILEIO_HAVE_IO_URING
+    // Prepares a native read that starts by opening the file. Returns false
+    // for resources, which have to go through QFile.
+    bool prepareNative()
+    {
+        if (fileName.startsWith(QLatin1Char(':')))
+            return false;
+        nativeName = QFile::encodeName(fileName);
+        operation = Open;
+        return true;
+    }
+
+    Completion completed(qint64 result) override
+    {
+        if (result == -EINTR || result == -EAGAIN)
+            return Resubmit;
+        switch (operation) {
+        case Open:
+            if (result < 0)
+                break;
+            fd = int(result);
+            operation = Stat;
+            return Resubmit;
+        case Stat:
+            // files that do not report their size are read through QFile
+            if (result < 0 || !S_ISREG(stx.stx_mode) || qint64(stx.stx_size) <= 0) {
+                closeNative();
+                return RunOnThread;
+            }
+            data.resize(qsizetype(stx.stx_size));
+            buffer = data.data();
+            size = data.size();
+            operation = Read;
+            return Resubmit;
+        case Read:
+            if (result > 0) {
+                offset += result;
+                buffer += result;
+                size -= result;
+                if (size > 0)
+                    return Resubmit;
+            }
+            if (result >= 0) {
+                // a file that shrank in the meantime ends early
+                data.truncate(qsizetype(offset));
+                promise.addResult(std::move(data));
+            }
+            break;
+        case Write:
+            Q_UNREACHABLE();
+        }
+        closeNative();
+        promise.finish();
+        return Finished;
+    }
+
+    void closeNative()
+    {
+        if (fd >= 0)
+            qt_safe_close(fd);
+        fd = -1;
+    }
+
+    QByteArray nativeName;
+    struct statx stx;
+#elif defined(Q_OS_UNIX)
+    // only the io_uring engine reads files piece by piece
+    Completion completed(qint64) override
+    {
+        Q_UNREACHABLE();
+        return Finished;
+    }
+#endif
+
+    QString fileName;
+    QByteArray data;
+    QPromise<QByteArray> promise;
+};
+
+class QAsyncFileIOEngine
+{
+public:
+    virtual ~QAsyncFileIOEngine() = default;
+    virtual QAsyncFileIO::Backend backend() const = 0;
+
+    // Takes ownership of the requests.
+    virtual void submit(QAsyncFileRequest *const *requests, qsizetype count) = 0;
+    virtual void submitFileReads(QAsyncFileReadRequest *const *requests, qsizetype count)
+    {
+        QVarLengthArray<QAsyncFileRequest *, 64> base(requests, requests + count);
+        submit(base.constData(), count);
+    }
+};
+
+class QAsyncFileThreadPoolEngine : public QAsyncFileIOEngine
+{
+    // The runnables of one submission share the list and pull the next
+    // request from it, so a slow file does not hold up the ones behind it.
+    struct Batch
+    {
+        std::vector<std::unique_ptr<QAsyncFileRequest>> requests;
+        QAtomicInteger<qsizetype> next = 0;
+    };
+
+    class BatchRunnable : public QRunnable
+    {
+    public:
+        explicit BatchRunnable(std::shared_ptr<Batch> batch) : batch(std::move(batch)) {}
+
+        void run() override
+        {
+            const qsizetype count = qsizetype(batch->requests.size());
+            for (qsizetype i = batch->next.fetchAndAddRelaxed(1); i < count;
+                 i = batch->next.fetchAndAddRelaxed(1)) {
+                batch->requests[i]->run();
+                batch->requests[i].reset();
+            }
+        }
+
+    private:
+        std::shared_ptr<Batch> batch;
+    };
+
+public:
+    QAsyncFileThreadPoolEngine()
+    {
+        // the workers spend their time blocked in the kernel, not on the CPU
+        pool.setMaxThreadCount(qMax(4, 2 * QThread::idealThreadCount()));
+        pool.setExpiryTimeout(5000);
+    }
+
+    ~QAsyncFileThreadPoolEngine()
+    {
+        pool.waitForDone();
+    }
+
+    QAsyncFileIO::Backend backend() const override
+    {
+        return QAsyncFileIO::ThreadPoolBackend;
+    }
+
+    void submit(QAsyncFileRequest *const *requests, qsizetype count) override
+    {
+        if (count <= 0)
+            return;
+        auto batch = std::make_shared<Batch>();
+        batch->requests.reserve(size_t(count));
+        for (qsizetype i = 0; i < count; ++i)
+            batch->requests.emplace_back(requests[i]);
+        const qsizetype runnables = qMin(count, qsizetype(pool.maxThreadCount()));
+        for (qsizetype i = 0; i < runnables; ++i)
+            pool.start(new BatchRunnable(batch));
+    }
+
+private:
+    QThreadPool pool;
+};
+
+#ifdef QT_ASYNCFILEIO_HAVE_IO_URING
+class QAsyncFileIoUringEngine : public QAsyncFileIOEngine
+{
+    static constexpr unsigned RingEntries = 256;
+
+    class CompletionThread : public QThread
+    {
+    public:
+        explicit CompletionThread(QAsyncFileIoUringEngine *engine) : engine(engine) {}
+        void run() override { engine->processCompletions(); }
+
+    private:
+        QAsyncFileIoUringEngine *engine;
+    };
+
+public:
+    QAsyncFileIoUringEngine() = default;
+    ~QAsyncFileIoUringEngine();
+
+    // Returns false if the kernel refused to set up the ring.
+    bool initialize();
+
+    QAsyncFileIO::Backend backend() const override
+    {
+        return QAsyncFileIO::IoUringBackend;
+    }
+
+    void submit(QAsyncFileRequest *const *requests, qsizetype count) override;
+    void submitFileReads(QAsyncFileReadRequest *const *requests, qsizetype count) override;
+
+private:
+    static int enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+    {
+        return int(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+    }
+
+    bool probeFileOperations() const;
+    void prepareEntry(io_uring_sqe *sqe, QAsyncFileRequest *request);
+    void queueSubmissions();
+    void processCompletions();
+
+    int ringFd = -1;
+    void *sqRing = MAP_FAILED;
+    void *cqRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    unsigned *sqHead = nullptr;
+    unsigned *sqTail = nullptr;
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+    unsigned *sqArray = nullptr;
+    io_uring_sqe *sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+    unsigned *cqHead = nullptr;
+    unsigned *cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe *cqes = nullptr;
+    bool openInRing = false;
+
+    // Protects the submission ring and everything below.
+    QMutex mutex;
+    std::deque<QAsyncFileRequest *> pending;
+    unsigned inFlight = 0;
+    bool stopping = false;
+
+    std::unique_ptr<CompletionThread> completionThread;
+    QAsyncFileThreadPoolEngine fallback;
+};
+
+bool QAsyncFileIoUringEngine::initialize()
+{
+    io_uring_params params = {};
+    ringFd = int(syscall(__NR_io_uring_setup, RingEntries, &params));
+    if (ringFd < 0)
+        return false;
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMap)
+        sqRingSize = cqRingSize = qMax(sqRingSize, cqRingSize);
+
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                  ringFd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED)
+        return false;
+    cqRing = singleMap ? sqRing
+                       : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+    if (cqRing == MAP_FAILED)
+        return false;
+    sqes = static_cast<io_uring_sqe *>(mmap(nullptr, params.sq_entries * sizeof(io_uring_sqe),
+                                            PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                            ringFd, IORING_OFF_SQES));
+    if (sqes == MAP_FAILED)
+        return false;
+
+    char *sq = static_cast<char *>(sqRing);
+    sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sqMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sqEntries = params.sq_entries;
+    sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    char *cq = static_cast<char *>(cqRing);
+    cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cqMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+    openInRing = probeFileOperations();
+
+    completionThread.reset(new CompletionThread(this));
+    completionThread->setObjectName(QStringLiteral("QAsyncFileIO"));
+    completionThread->start();
+    return true;
+}
+
+QAsyncFileIoUringEngine::~QAsyncFileIoUringEngine()
+{
+    if (completionThread) {
+        // The completion thread exits once the requests still in flight
+        // have completed. If there are none, a no-op with a null user_data
+        // wakes it; otherwise their completions do, and the submission ring
+        // may be full anyway.
+        QMutexLocker locker(&mutex);
+        stopping = true;
+        const unsigned tail = *sqTail;
+        if (inFlight == 0 && tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) < sqEntries) {
+            const unsigned index = tail & sqMask;
+            io_uring_sqe *sqe = &sqes[index];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = IORING_OP_NOP;
+            sqArray[index] = index;
+            __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+            int ret;
+            EINTR_LOOP(ret, enter(ringFd, 1, 0, 0));
+        }
+        locker.unlock();
+        completionThread->wait();
+    }
+    if (sqes != MAP_FAILED)
+        munmap(sqes, sqEntries * sizeof(io_uring_sqe));
+    if (cqRing != MAP_FAILED && cqRing != sqRing)
+        munmap(cqRing, cqRingSize);
+    if (sqRing != MAP_FAILED)
+        munmap(sqRing, sqRingSize);
+    if (ringFd >= 0)
+        qt_safe_close(ringFd);
+}
+
+// Returns true if the kernel can open and stat files in the ring, so that
+// readFiles() never blocks the caller in open() or fstat().
+bool QAsyncFileIoUringEngine::probeFileOperations() const
+{
+    alignas(io_uring_probe) char storage[sizeof(io_uring_probe)
+                                         + IORING_OP_LAST * sizeof(io_uring_probe_op)] = {};
+    auto probe = reinterpret_cast<io_uring_probe *>(storage);
+    if (syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) < 0)
+        return false;
+    const auto supported = [probe](unsigned op) {
+        return op <= probe->last_op && op < probe->ops_len
+                && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    };
+    return supported(IORING_OP_OPENAT) && supported(IORING_OP_STATX);
+}
+
+void QAsyncFileIoUringEngine::prepareEntry(io_uring_sqe *sqe, QAsyncFileRequest *request)
+{
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->user_data = quintptr(request);
+    switch (request->operation) {
+    case QAsyncFileRequest::Open: {
+        auto read = static_cast<QAsyncFileReadRequest *>(request);
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = quintptr(read->nativeName.constData());
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+        break;
+    }
+    case QAsyncFileRequest::Stat: {
+        auto read = static_cast<QAsyncFileReadRequest *>(request);
+        sqe->opcode = IORING_OP_STATX;
+        sqe->fd = read->fd;
+        sqe->addr = quintptr("");
+        sqe->addr2 = quintptr(&read->stx);
+        sqe->len = STATX_TYPE | STATX_SIZE;
+        sqe->statx_flags = AT_EMPTY_PATH;
+        break;
+    }
+    case QAsyncFileRequest::Read:
+    case QAsyncFileRequest::Write:
+        request->iov.iov_base = request->buffer;
+        request->iov.iov_len = size_t(request->chunkSize());
+        sqe->opcode = request->operation == QAsyncFileRequest::Read ? IORING_OP_READV
+                                                                    : IORING_OP_WRITEV;
+        sqe->fd = request->fd;
+        sqe->off = quint64(request->offset);
+        sqe->addr = quintptr(&request->iov);
+        sqe->len = 1;
+        break;
+    }
+}
+
+// Moves pending requests into the submission ring and hands them to the
+// kernel. Requests beyond the ring size wait in the pending queue until
+// earlier ones complete, so the completion ring can never overflow.
+void QAsyncFileIoUringEngine::queueSubmissions()
+{
+    unsigned tail = *sqTail;
+    const unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    while (!pending.empty() && inFlight < sqEntries && tail - head < sqEntries) {
+        QAsyncFileRequest *request = pending.front();
+        pending.pop_front();
+
+        const unsigned index = tail & sqMask;
+        prepareEntry(&sqes[index], request);
+        sqArray[index] = index;
+        ++tail;
+        ++inFlight;
+    }
+    __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+
+    const unsigned toSubmit = tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    if (toSubmit) {
+        int ret;
+        EINTR_LOOP(ret, enter(ringFd, toSubmit, 0, 0));
+        // on EAGAIN or EBUSY the entries stay in the ring for the next call
+    }
+}
+
+void QAsyncFileIoUringEngine::submit(QAsyncFileRequest *const *requests, qsizetype count)
+{
+    QMutexLocker locker(&mutex);
+    pending.insert(pending.end(), requests, requests + count);
+    queueSubmissions();
+}
+
+void QAsyncFileIoUringEngine::submitFileReads(QAsyncFileReadRequest *const *requests,
+                                              qsizetype count)
+{
+    // Without open and stat support in the ring, the workers have to open
+    // the files; doing it here would block the caller.
+    if (!openInRing) {
+        fallback.submitFileReads(requests, count);
+        return;
+    }
+
+    QVarLengthArray<QAsyncFileRequest *, 64> native;
+    QVarLengthArray<QAsyncFileRequest *, 64> others;
+    for (qsizetype i = 0; i < count; ++i) {
+        if (requests[i]->prepareNative())
+            native.append(requests[i]);
+        else
+            others.append(requests[i]);
+    }
+    if (!native.isEmpty())
+        submit(native.constData(), native.size());
+    if (!others.isEmpty())
+        fallback.submit(others.constData(), others.size());
+}
+
+void QAsyncFileIoUringEngine::processCompletions()
+{
+    QVarLengthArray<QAsyncFileRequest *, RingEntries> resubmit;
+    QVarLengthArray<QAsyncFileRequest *, RingEntries> handOver;
+    for (;;) {
+        int ret;
+        EINTR_LOOP(ret, enter(ringFd, 0, 1, IORING_ENTER_GETEVENTS));
+
+        unsigned head = *cqHead;
+        const unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        unsigned finished = 0;
+        for (; head != tail; ++head) {
+            const io_uring_cqe &cqe = cqes[head & cqMask];
+            auto request = reinterpret_cast<QAsyncFileRequest *>(quintptr(cqe.user_data));
+            if (!request)
+                continue;
+            ++finished;
+            switch (request->completed(cqe.res)) {
+            case QAsyncFileRequest::Finished:
+                delete request;
+                break;
+            case QAsyncFileRequest::Resubmit:
+                resubmit.append(request);
+                break;
+            case QAsyncFileRequest::RunOnThread:
+                handOver.append(request);
+                break;
+            }
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+        if (!handOver.isEmpty()) {
+            fallback.submit(handOver.constData(), handOver.size());
+            handOver.clear();
+        }
+
+        QMutexLocker locker(&mutex);
+        inFlight -= finished;
+        pending.insert(pending.begin(), resubmit.cbegin(), resubmit.cend());
+        resubmit.clear();
+        queueSubmissions();
+        if (stopping && inFlight == 0 && pending.empty())
+            return;
+    }
+}
+#endif // QT_ASYNCFILEIO_HAVE_IO_URING
+
+/*!
+    Creates an instance that uses io_uring if \a preferredBackend is
+    IoUringBackend and the kernel supports it, and a thread pool otherwise.
+
+    Most code should share instance() instead.
+*/
+QAsyncFileIO::QAsyncFileIO(Backend preferredBackend)
+{
+#ifdef QT_ASYNCFILEIO_HAVE_IO_URING
+    if (preferredBackend == IoUringBackend && !qEnvironmentVariableIsSet("QT_NO_IO_URING")) {
+        auto ring = std::make_unique<QAsyncFileIoUringEngine>();
+        if (ring->initialize())
+            engine = std::move(ring);
+    }
+#else
+    Q_UNUSED(preferredBackend);
+#endif
+    if (!engine)
+        engine = std::make_unique<QAsyncFileThreadPoolEngine>();
+}
+
+/*!
+    Waits for all submitted requests to complete and destroys the instance.
+*/
+QAsyncFileIO::~QAsyncFileIO() = default;
+
+Q_GLOBAL_STATIC(QAsyncFileIO, asyncFileIO)
+
+/*!
+    Returns the instance shared by the whole application, or \nullptr during
+    application shutdown.
+*/
+QAsyncFileIO *QAsyncFileIO::instance()
+{
+    return asyncFileIO();
+}
+
+/*!
+    Returns the backend that carries out the requests.
+*/
+QAsyncFileIO::Backend QAsyncFileIO::backend() const
+{
+    return engine->backend();
+}
+
+#ifdef Q_OS_UNIX
+static QAsyncPositionalRequest *createPositionalRequest(QAsyncFileRequest::Operation operation,
+                                                        int fd, qint64 offset, void *buffer,
+                                                        qint64 size)
+{
+    auto request = new QAsyncPositionalRequest;
+    request->operation = operation;
+    request->fd = fd;
+    request->offset = offset;
+    request->buffer = static_cast<char *>(buffer);
+    request->size = size;
+    request->promise.start();
+    return request;
+}
+
+/*!
+    Reads up to \a size bytes at \a offset of the file descriptor \a fd
+    directly into \a buffer, without moving the file position.
+
+    The future's result is the number of bytes read, which is less than
+    \a size at the end of the file, or -1 on error. \a fd and \a buffer must
+    stay valid until the future has finished.
+*/
+QFuture<qint64> QAsyncFileIO::read(int fd, qint64 offset, void *buffer, qint64 size)
+{
+    QAsyncFileRequest *request = createPositionalRequest(QAsyncFileRequest::Read, fd, offset,
+                                                         buffer, size);
+    QFuture<qint64> future = static_cast<QAsyncPositionalRequest *>(request)->promise.future();
+    engine->submit(&request, 1);
+    return future;
+}
+
+/*!
+    \overload
+
+    Submits all \a requests at once and returns one future per request, in
+    the same order.
+*/
+QList<QFuture<qint64>> QAsyncFileIO::read(const QList<ReadRequest> &requests)
+{
+    QList<QFuture<qint64>> futures;
+    futures.reserve(requests.size());
+    QVarLengthArray<QAsyncFileRequest *, 64> batch;
+    batch.reserve(requests.size());
+    for (const ReadRequest &r : requests) {
+        QAsyncPositionalRequest *request =
+                createPositionalRequest(QAsyncFileRequest::Read, r.fd, r.offset, r.buffer, r.size);
+        futures.append(request->promise.future());
+        batch.append(request);
+    }
+    engine->submit(batch.constData(), batch.size());
+    return futures;
+}
+
+/*!
+    Writes up to \a size bytes from \a data at \a offset of the file
+    descriptor \a fd, without moving the file position.
+
+    The future's result is the number of bytes written or -1 on error.
+    \a fd and \a data must stay valid until the future has finished.
+*/
+QFuture<qint64> QAsyncFileIO::write(int fd, qint64 offset, const void *data, qint64 size)
+{
+    QAsyncFileRequest *request =
+            createPositionalRequest(QAsyncFileRequest::Write, fd, offset,
+                                    const_cast<void *>(data), size);
+    QFuture<qint64> future = static_cast<QAsyncPositionalRequest *>(request)->promise.future();
+    engine->submit(&request, 1);
+    return future;
+}
+#endif // Q_OS_UNIX
+
+/*!
+    Reads the whole file \a fileName.
+
+    The future has the file's contents as its result. If the file cannot be
+    opened or read, the future finishes without a result.
+*/
+QFuture<QByteArray> QAsyncFileIO::readFile(const QString &fileName)
+{
+    return readFiles(QStringList(fileName)).constFirst();
+}
+
+/*!
+    Reads all \a fileNames at once and returns one future per file, in the
+    same order.
+
+    \sa readFile()
+*/
+QList<QFuture<QByteArray>> QAsyncFileIO::readFiles(const QStringList &fileNames)
+{
+    QList<QFuture<QByteArray>> futures;
+    futures.reserve(fileNames.size());
+    QVarLengthArray<QAsyncFileReadRequest *, 64> batch;
+    batch.reserve(fileNames.size());
+    for (const QString &fileName : fileNames) {
+        auto request = new QAsyncFileReadRequest;
+        request->fileName = fileName;
+        request->promise.start();
+        futures.append(request->promise.future());
+        batch.append(request);
+    }
+    engine->submitFileReads(batch.constData(), batch.size());
+    return futures;
+}
+
+QT_END_NAMESPACE
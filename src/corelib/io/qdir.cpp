@@ -55,8 +55,13 @@
 #include "qfilesystementry_p.h"
 #include "qfilesystemmetadata_p.h"
 #include "qfilesystemengine_p.h"
+#include "qfileinfo_p.h"
 #include <qstringbuilder.h>
 
+#ifdef Q_OS_UNIX
+#  include "private/qcore_unix_p.h"
+#endif
+
 #ifdef QT_BUILD_CORE_LIB
 #  include "qresource.h"
 #  include "private/qcoreglobaldata_p.h"
@@ -237,6 +242,10 @@ struct QDirSortItem
     mutable QString filename_cache;
     mutable QString suffix_cache;
     QFileInfo item;
+    // Looked up once before sorting, only if the sort flags need them
+    QDateTime modified;
+    qint64 size = 0;
+    bool isDir = false;
 };
 
 
@@ -253,32 +262,21 @@ bool QDirSortItemComparator::operator()(const QDirSortItem &n1, const QDirSortIt
     const QDirSortItem* f1 = &n1;
     const QDirSortItem* f2 = &n2;
 
-    if ((qt_cmp_si_sort_flags & QDir::DirsFirst) && (f1->item.isDir() != f2->item.isDir()))
-        return f1->item.isDir();
-    if ((qt_cmp_si_sort_flags & QDir::DirsLast) && (f1->item.isDir() != f2->item.isDir()))
-        return !f1->item.isDir();
+    if ((qt_cmp_si_sort_flags & QDir::DirsFirst) && (f1->isDir != f2->isDir))
+        return f1->isDir;
+    if ((qt_cmp_si_sort_flags & QDir::DirsLast) && (f1->isDir != f2->isDir))
+        return !f1->isDir;
 
     qint64 r = 0;
     int sortBy = (qt_cmp_si_sort_flags & QDir::SortByMask)
                  | (qt_cmp_si_sort_flags & QDir::Type);
 
     switch (sortBy) {
-      case QDir::Time: {
-        QDateTime firstModified = f1->item.lastModified();
-        QDateTime secondModified = f2->item.lastModified();
-
-        // QDateTime by default will do all sorts of conversions on these to
-        // find timezones, which is incredibly expensive. As we aren't
-        // presenting these to the user, we don't care (at all) about the
-        // local timezone, so force them to UTC to avoid that conversion.
-        firstModified.setTimeSpec(Qt::UTC);
-        secondModified.setTimeSpec(Qt::UTC);
-
-        r = firstModified.msecsTo(secondModified);
+      case QDir::Time:
+        r = f1->modified.msecsTo(f2->modified);
         break;
-      }
       case QDir::Size:
-          r = f2->item.size() - f1->item.size();
+          r = f2->size - f1->size;
         break;
       case QDir::Type:
       {
@@ -320,8 +318,52 @@ bool QDirSortItemComparator::operator()(const QDirSortItem &n1, const QDirSortIt
     return r < 0;
 }
 
+#ifdef Q_OS_UNIX
+/*!
+    \internal
+
+    Fetches the metadata that sorting by \a sort compares for all entries
+    of \a l, which are in this directory, in one pass. Each entry takes a
+    single stat relative to the open directory, instead of QFileInfo
+    resolving the full path on first use.
+
+    Only sorting by time or size needs this: the directory flag alone
+    usually comes with the listing already.
+*/
+void QDirPrivate::prefetchSortMetaData(QDir::SortFlags sort, QFileInfoList &l) const
+{
+    const int sortBy = (sort & QDir::SortByMask);
+    if ((sortBy != QDir::Time && sortBy != QDir::Size) || fileEngine)
+        return;
+
+    int dirfd = -1;
+    for (QFileInfo &fileInfo : l) {
+        if (!fileInfo.caching())
+            continue;
+        if (dirfd == -1) {
+            dirfd = qt_safe_open(dirEntry.nativeFilePath().constData(), O_RDONLY | O_DIRECTORY);
+            if (dirfd == -1)
+                return;
+        }
+        // the stat covers everything the listing knew about the entry
+        const QFileSystemEntry entry(fileInfo.filePath());
+        const QByteArray &nativePath = entry.nativeFilePath();
+        const char *name = nativePath.constData() + nativePath.lastIndexOf('/') + 1;
+        QFileSystemMetaData metaData;
+        if (QFileSystemEngine::fillMetaData(dirfd, name, metaData))
+            fileInfo = QFileInfo(new QFileInfoPrivate(entry, metaData));
+    }
+    if (dirfd != -1)
+        qt_safe_close(dirfd);
+}
+#else
+void QDirPrivate::prefetchSortMetaData(QDir::SortFlags, QFileInfoList &) const
+{
+}
+#endif
+
 inline void QDirPrivate::sortFileList(QDir::SortFlags sort, QFileInfoList &l,
-                                      QStringList *names, QFileInfoList *infos)
+                                      QStringList *names, QFileInfoList *infos) const
 {
     // names and infos are always empty lists or 0 here
     int n = l.size();
@@ -334,9 +376,27 @@ inline void QDirPrivate::sortFileList(QDir::SortFlags sort, QFileInfoList &l,
                     names->append(l.at(i).fileName());
             }
         } else {
+            prefetchSortMetaData(sort, l);
+
+            const int sortBy = (sort & QDir::SortByMask);
+            const bool needsType = (sort & (QDir::DirsFirst | QDir::DirsLast));
             QScopedArrayPointer<QDirSortItem> si(new QDirSortItem[n]);
-            for (int i = 0; i < n; ++i)
-                si[i].item = l.at(i);
+            for (int i = 0; i < n; ++i) {
+                QDirSortItem &item = si[i];
+                item.item = l.at(i);
+                if (sortBy == QDir::Time) {
+                    // QDateTime by default will do all sorts of conversions on these to
+                    // find timezones, which is incredibly expensive. As we aren't
+                    // presenting these to the user, we don't care (at all) about the
+                    // local timezone, so force them to UTC to avoid that conversion.
+                    item.modified = item.item.lastModified();
+                    item.modified.setTimeSpec(Qt::UTC);
+                } else if (sortBy == QDir::Size) {
+                    item.size = item.item.size();
+                }
+                if (needsType)
+                    item.isDir = item.item.isDir();
+            }
             std::sort(si.data(), si.data() + n, QDirSortItemComparator(sort));
             // put them back in the list(s)
             if (infos) {
@@ -80,7 +80,8 @@ public:
     void initFileEngine();
     void initFileLists(const QDir &dir) const;
 
-    static void sortFileList(QDir::SortFlags, QFileInfoList &, QStringList *, QFileInfoList *);
+    void prefetchSortMetaData(QDir::SortFlags, QFileInfoList &) const;
+    void sortFileList(QDir::SortFlags, QFileInfoList &, QStringList *, QFileInfoList *) const;
 
     static inline QChar getFilterSepChar(const QString &nameFilter);
 
@@ -387,6 +387,9 @@ inline void QFileSystemMetaData::fillFromStatxBuf(const struct statx &statxBuffe
     groupId_ = statxBuffer.stx_gid;
 }
 #else
+static int qt_real_statx(int, const char *, int, struct statx *)
+{ return -ENOSYS; }
+
 static int qt_statx(const char *, struct statx *)
 { return -ENOSYS; }
 
@@ -546,9 +549,22 @@ void QFileSystemMetaData::fillFromDirEnt(const QT_DIRENT &entry)
     }
 #elif defined(_DIRENT_HAVE_D_TYPE) || defined(Q_OS_BSD4)
     // BSD4 includes OS X and iOS
+    fillFromDirEntType(entry.d_type);
+#else
+    Q_UNUSED(entry);
+#endif
+}
+
+/*!
+    \internal
 
+    Fills the type flags from the d_type value \a type of a directory entry.
+*/
+void QFileSystemMetaData::fillFromDirEntType(int type)
+{
+#if defined(_DIRENT_HAVE_D_TYPE) || defined(Q_OS_BSD4)
     // ### This will clear all entry flags and knownFlagsMask
-    switch (entry.d_type)
+    switch (type)
     {
     case DT_DIR:
         knownFlagsMask = QFileSystemMetaData::LinkType
@@ -615,8 +631,57 @@ void QFileSystemMetaData::fillFromDirEnt(const QT_DIRENT &entry)
         clear();
     }
 #else
-    Q_UNUSED(entry);
+    Q_UNUSED(type);
+    clear();
+#endif
+}
+
+#if defined(QT_USE_XOPEN_LFS_EXTENSIONS) && defined(QT_LARGEFILE_SUPPORT)
+#  define QT_FSTATAT ::fstatat64
+#else
+#  define QT_FSTATAT ::fstatat
 #endif
+
+//static
+bool QFileSystemEngine::fillMetaData(int dirfd, const char *name, QFileSystemMetaData &data)
+{
+    data.entryFlags &= ~(QFileSystemMetaData::PosixStatFlags | QFileSystemMetaData::LinkType
+                         | QFileSystemMetaData::ExistsAttribute);
+    data.knownFlagsMask |= QFileSystemMetaData::PosixStatFlags | QFileSystemMetaData::LinkType
+            | QFileSystemMetaData::ExistsAttribute;
+
+    union {
+        QT_STATBUF statBuffer;
+        struct statx statxBuffer;
+    };
+
+    // Same order as fillMetaData() above: lstat first, and stat only for
+    // symlinks, so that the result describes the link's target.
+    for (int flags : { AT_SYMLINK_NOFOLLOW, 0 }) {
+        mode_t mode;
+        int ret = qt_real_statx(dirfd, name, flags, &statxBuffer);
+        if (ret == -ENOSYS) {
+            if (QT_FSTATAT(dirfd, name, &statBuffer, flags) != 0)
+                return flags == 0;   // a dangling symlink still exists
+            mode = statBuffer.st_mode;
+            if (flags == 0 || !S_ISLNK(mode))
+                data.fillFromStatBuf(statBuffer);
+        } else if (ret == 0) {
+            mode = statxBuffer.stx_mode;
+            if (flags == 0 || !S_ISLNK(mode))
+                data.fillFromStatxBuf(statxBuffer);
+        } else {
+            return flags == 0;
+        }
+
+        if (flags == 0 || !S_ISLNK(mode)) {
+            data.entryFlags |= QFileSystemMetaData::ExistsAttribute;
+            return true;
+        }
+        data.entryFlags |= QFileSystemMetaData::LinkType;
+    }
+    Q_UNREACHABLE();
+    return false;
 }
 
 //static
@@ -230,6 +230,7 @@ public:
     void fillFromStatxBuf(const struct statx &statBuffer);
     void fillFromStatBuf(const QT_STATBUF &statBuffer);
     void fillFromDirEnt(const QT_DIRENT &statBuffer);
+    void fillFromDirEntType(int type);
 #endif
 
 #if defined(Q_OS_WIN)
@@ -47,6 +47,7 @@
 #include <qfile.h>
 #include <qfileinfo.h>
 #include <qscopeguard.h>
+#include <qset.h>
 #include <qsocketnotifier.h>
 #include <qvarlengtharray.h>
 
@@ -270,17 +271,24 @@ QStringList QInotifyFileSystemWatcherEngine::addPaths(const QStringList &paths,
                                                       QStringList *directories)
 {
     QStringList unhandled;
+    // Look the paths up in hashes rather than in the lists, which would
+    // make adding many paths quadratic. The lists only need to be hashed
+    // when they hold paths that another engine watches.
+    QSet<QString> otherFiles;
+    QSet<QString> otherDirectories;
+    if (files->size() + directories->size() > pathToID.size()) {
+        otherFiles = QSet<QString>(files->cbegin(), files->cend());
+        otherDirectories = QSet<QString>(directories->cbegin(), directories->cend());
+    }
     for (const QString &path : paths) {
         QFileInfo fi(path);
         bool isDir = fi.isDir();
         auto sg = qScopeGuard([&]{ unhandled.push_back(path); });
-        if (isDir) {
-            if (directories->contains(path))
-                continue;
-        } else {
-            if (files->contains(path))
-                continue;
-        }
+        const auto known = pathToID.constFind(path);
+        if (known != pathToID.constEnd() && (*known < 0) == isDir)
+            continue;
+        if ((isDir ? otherDirectories : otherFiles).contains(path))
+            continue;
 
         int wd = inotify_add_watch(inotifyFd,
                                    QFile::encodeName(path),
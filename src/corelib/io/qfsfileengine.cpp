@@ -131,6 +131,10 @@ void QFSFileEnginePrivate::init()
     lastIOCommand = IOFlushCommand;
     lastFlushFailed = false;
     closeFileHandle = false;
+#ifndef Q_OS_WIN
+    sequential_read_hint = 0;
+    sequentialReadBytes = 0;
+#endif
 #ifdef Q_OS_WIN
     fileAttrib = INVALID_FILE_ATTRIBUTES;
     fileHandle = INVALID_HANDLE_VALUE;
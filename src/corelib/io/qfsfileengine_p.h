@@ -215,6 +215,12 @@ public:
     mutable uint tried_stat : 1;
     mutable uint need_lstat : 1;
     mutable uint is_link : 1;
+#ifndef Q_OS_WIN
+    uint sequential_read_hint : 1;
+
+    // bytes read since the last seek, see nativeRead()
+    qint64 sequentialReadBytes;
+#endif
 
 #if defined(Q_OS_WIN)
     bool doStat(QFileSystemMetaData::MetaDataFlags flags) const;
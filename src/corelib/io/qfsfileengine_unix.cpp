@@ -62,6 +62,10 @@
 
 QT_BEGIN_NAMESPACE
 
+#ifndef QFSFILEENGINE_SEQUENTIAL_HINT_THRESHOLD
+#define QFSFILEENGINE_SEQUENTIAL_HINT_THRESHOLD (1024 * 1024)
+#endif
+
 /*!
     \internal
 
@@ -165,6 +169,8 @@ bool QFSFileEnginePrivate::nativeOpen(QIODevice::OpenMode openMode)
 */
 bool QFSFileEnginePrivate::nativeClose()
 {
+    sequential_read_hint = 0;
+    sequentialReadBytes = 0;
     return closeFdFh();
 }
 
@@ -253,7 +259,19 @@ qint64 QFSFileEnginePrivate::nativeRead(char *data, qint64 len)
         return readBytes;
     }
 
-    return readFdFh(data, len);
+    const qint64 readBytes = readFdFh(data, len);
+#ifdef POSIX_FADV_SEQUENTIAL
+    // Once a file has been read front to back for a while, ask the kernel
+    // for more aggressive readahead. nativeSeek() takes the hint back.
+    if (readBytes > 0 && fd != -1 && !fh && !sequential_read_hint) {
+        sequentialReadBytes += readBytes;
+        if (sequentialReadBytes >= QFSFILEENGINE_SEQUENTIAL_HINT_THRESHOLD) {
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+            sequential_read_hint = 1;
+        }
+    }
+#endif
+    return readBytes;
 }
 
 /*!
@@ -285,6 +303,13 @@ qint64 QFSFileEnginePrivate::nativePos() const
 */
 bool QFSFileEnginePrivate::nativeSeek(qint64 pos)
 {
+    sequentialReadBytes = 0;
+#ifdef POSIX_FADV_SEQUENTIAL
+    if (sequential_read_hint) {
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_NORMAL);
+        sequential_read_hint = 0;
+    }
+#endif
     return seekFdFh(pos);
 }
 
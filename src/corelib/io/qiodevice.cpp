@@ -774,6 +774,7 @@ bool QIODevice::open(OpenMode mode)
     d->openMode = mode;
     d->pos = (mode & Append) ? size() : qint64(0);
     d->accessMode = QIODevicePrivate::Unset;
+    d->readAheadShift = 0;
     d->readBuffers.clear();
     d->writeBuffers.clear();
     d->setReadChannelCount(isReadable() ? 1 : 0);
@@ -905,11 +906,29 @@ void QIODevicePrivate::seekBuffer(qint64 newPos)
         // random-access devices, the buffer is cleared. The next read
         // operation will then refill the buffer.
         buffer.clear();
+        readAheadShift = 0;
     } else {
         buffer.free(offset);
     }
 }
 
+/*!
+    \internal
+
+    Removes the first chunk from the read buffer and returns it without
+    copying the data, unless it is mostly unused read-ahead space.
+*/
+QByteArray QIODevicePrivate::takeReadBufferChunk()
+{
+    const qint64 size = buffer.nextDataBlockSize();
+    QByteArray chunk = buffer.read();
+    if (!isSequential())
+        pos += size;
+    if (chunk.capacity() - chunk.size() > readBufferChunkSize)
+        chunk.squeeze();
+    return chunk;
+}
+
 /*!
     Returns \c true if the current read and write position is at the end
     of the device (i.e. there is no more data available for reading on
@@ -1108,12 +1127,19 @@ qint64 QIODevicePrivate::read(char *data, qint64 maxSize, bool peeking)
                 } else {
                     // Do not read more than maxSize on unbuffered devices
                     const qint64 bytesToBuffer = (buffered || readBufferChunkSize < maxSize)
-                            ? qint64(readBufferChunkSize)
+                            ? qint64(readBufferChunkSize) << readAheadShift
                             : maxSize;
                     // Try to fill QIODevice buffer by single read
                     readFromDevice = q->readData(buffer.reserve(bytesToBuffer), bytesToBuffer);
                     deviceAtEof = (readFromDevice != bytesToBuffer);
                     buffer.chop(bytesToBuffer - qMax(Q_INT64_C(0), readFromDevice));
+                    // The buffer was drained and refilled without a seek in
+                    // between: the device is being scanned, so read further
+                    // ahead next time.
+                    if (!deviceAtEof && buffered && !sequential
+                        && bytesToBuffer * 2 <= QIODEVICE_MAXREADAHEAD) {
+                        ++readAheadShift;
+                    }
                     if (readFromDevice > 0) {
                         if (!sequential)
                             devicePos += readFromDevice;
@@ -1205,11 +1231,8 @@ QByteArray QIODevice::read(qint64 maxSize)
 
     // Try to prevent the data from being copied, if we have a chunk
     // with the same size in the read buffer.
-    if (maxSize == d->buffer.nextDataBlockSize() && !d->transactionStarted
-        && (d->openMode & (QIODevice::ReadOnly | QIODevice::Text)) == QIODevice::ReadOnly) {
-        result = d->buffer.read();
-        if (!d->isSequential())
-            d->pos += maxSize;
+    if (maxSize == d->buffer.nextDataBlockSize() && d->canTakeReadBufferChunk()) {
+        result = d->takeReadBufferChunk();
         if (d->buffer.isEmpty())
             readData(nullptr, 0);
         return result;
@@ -1218,8 +1241,19 @@ QByteArray QIODevice::read(qint64 maxSize)
     CHECK_MAXLEN(read, result);
     CHECK_MAXBYTEARRAYSIZE(read);
 
+    // If more than the first chunk is wanted, start with the chunk itself
+    // and read the rest behind it.
+    qint64 readBytes = 0;
+    if (maxSize > d->buffer.nextDataBlockSize() && d->buffer.nextDataBlockSize() > 0
+        && d->canTakeReadBufferChunk()) {
+        result = d->takeReadBufferChunk();
+        readBytes = result.size();
+    }
+
     result.resize(int(maxSize));
-    qint64 readBytes = read(result.data(), result.size());
+    const qint64 readResult = read(result.data() + readBytes, result.size() - readBytes);
+    if (readResult > 0 || readBytes == 0)
+        readBytes += readResult;
 
     if (readBytes <= 0)
         result.clear();
@@ -1248,10 +1282,19 @@ QByteArray QIODevice::readAll()
     QByteArray result;
     qint64 readBytes = (d->isSequential() ? Q_INT64_C(0) : size());
     if (readBytes == 0) {
-        // Size is unknown, read incrementally.
-        qint64 readChunkSize = qMax(qint64(d->readBufferChunkSize),
-                                    d->isSequential() ? (d->buffer.size() - d->transactionPos)
-                                                      : d->buffer.size());
+        // Size is unknown, read incrementally. Take over the first buffered
+        // chunk instead of copying it, and read in growing steps so that
+        // large amounts of data don't cost a read call per buffer chunk.
+        qint64 readChunkSize;
+        if (d->buffer.nextDataBlockSize() > 0 && d->canTakeReadBufferChunk()) {
+            result = d->takeReadBufferChunk();
+            readBytes = result.size();
+            readChunkSize = qMax(qint64(d->readBufferChunkSize), d->buffer.size());
+        } else {
+            readChunkSize = qMax(qint64(d->readBufferChunkSize),
+                                 d->isSequential() ? (d->buffer.size() - d->transactionPos)
+                                                   : d->buffer.size());
+        }
         qint64 readResult;
         do {
             if (readBytes + readChunkSize >= MaxByteArraySize) {
@@ -1262,7 +1305,8 @@ QByteArray QIODevice::readAll()
             readResult = read(result.data() + readBytes, readChunkSize);
             if (readResult > 0 || readBytes == 0) {
                 readBytes += readResult;
-                readChunkSize = d->readBufferChunkSize;
+                readChunkSize = qBound(qint64(d->readBufferChunkSize), readBytes,
+                                       qint64(QIODEVICE_MAXREADAHEAD));
             }
         } while (readResult > 0);
     } else {
@@ -67,6 +67,10 @@ QT_BEGIN_NAMESPACE
 #define QIODEVICE_BUFFERSIZE 16384
 #endif
 
+#ifndef QIODEVICE_MAXREADAHEAD
+#define QIODEVICE_MAXREADAHEAD (1024 * 1024)
+#endif
+
 Q_CORE_EXPORT int qt_subtract_from_timeout(int timeout, int elapsed);
 
 class Q_CORE_EXPORT QIODevicePrivate
@@ -150,6 +154,13 @@ public:
         RandomAccess
     };
     mutable AccessMode accessMode = Unset;
+
+    // Buffered reads from random-access devices fill the read buffer with
+    // readBufferChunkSize << readAheadShift bytes. The shift grows while the
+    // device is read front to back, up to QIODEVICE_MAXREADAHEAD, and drops
+    // back to zero when seeking discards the buffer. It lives in what used
+    // to be padding, see the note about the library hook data above.
+    quint8 readAheadShift = 0;
     inline bool isSequential() const
     {
         if (accessMode == Unset)
@@ -164,6 +175,13 @@ public:
     }
     bool allWriteBuffersEmpty() const;
 
+    inline bool canTakeReadBufferChunk() const
+    {
+        return !transactionStarted
+               && (openMode & (QIODevice::ReadOnly | QIODevice::Text)) == QIODevice::ReadOnly;
+    }
+    QByteArray takeReadBufferChunk();
+
     void seekBuffer(qint64 newPos);
 
     inline void setCurrentReadChannel(int channel)
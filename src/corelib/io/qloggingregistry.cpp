@@ -47,6 +47,8 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qcoreapplication.h>
 
+#include <algorithm>
+
 #if QT_CONFIG(settings)
 #include <QtCore/qsettings.h>
 #include <QtCore/private/qsettings_p.h>
@@ -167,6 +169,147 @@ void QLoggingRule::parse(QStringView pattern)
     category = p.toString();
 }
 
+/*!
+    \class QLoggingRuleMatcher
+    \internal
+
+    Finds the rules that apply to a category without testing every rule.
+    Full text rules are looked up in a hash, and the patterns of left and
+    right filters are stored in a prefix and a suffix trie, so that walking
+    the category name once collects all of them. Only the rare mid filters
+    are tested one by one.
+*/
+
+/*!
+    \internal
+    Compiles the rules of the \a count rule sets in \a ruleSets, where later
+    rules take precedence over earlier ones.
+*/
+void QLoggingRuleMatcher::setRules(const QList<QLoggingRule> *ruleSets, qsizetype count)
+{
+    rules.clear();
+    fullTextRules.clear();
+    prefixTrie.clear();
+    suffixTrie.clear();
+    midRules.clear();
+
+    for (qsizetype i = 0; i < count; ++i) {
+        for (const QLoggingRule &rule : ruleSets[i]) {
+            // category names are Latin-1, so other rules can never match
+            if (!rule.flags || !QtPrivate::isLatin1(rule.category))
+                continue;
+            const int index = int(rules.size());
+            rules.append(rule);
+            const QByteArray pattern = rule.category.toLatin1();
+            if (rule.flags == QLoggingRule::FullText)
+                fullTextRules[pattern].append(index);
+            else if (rule.flags == QLoggingRule::LeftFilter)
+                insert(prefixTrie, pattern, false, index);
+            else if (rule.flags == QLoggingRule::RightFilter)
+                insert(suffixTrie, pattern, true, index);
+            else
+                midRules.append(index);
+        }
+    }
+}
+
+void QLoggingRuleMatcher::insert(Trie &trie, const QByteArray &key, bool reversed, int rule)
+{
+    if (trie.isEmpty())
+        trie.append(TrieNode());
+
+    int node = 0;
+    for (qsizetype i = 0; i < key.size(); ++i) {
+        const char c = key.at(reversed ? key.size() - 1 - i : i);
+        const auto &children = trie.at(node).children;
+        const auto it = std::find_if(children.begin(), children.end(),
+                                     [c](const auto &child) { return child.first == c; });
+        if (it != children.end()) {
+            node = it->second;
+        } else {
+            const int child = int(trie.size());
+            trie.append(TrieNode());
+            trie[node].children.append({ c, child });
+            node = child;
+        }
+    }
+    trie[node].rules.append(rule);
+}
+
+void QLoggingRuleMatcher::collect(const Trie &trie, QLatin1String key, bool reversed,
+                                  Matches &matches)
+{
+    if (trie.isEmpty())
+        return;
+
+    const char *data = key.data();
+    int node = 0;
+    for (qsizetype i = 0; ; ++i) {
+        const TrieNode &current = trie.at(node);
+        if (!current.rules.isEmpty())
+            matches.append(current.rules.constData(), current.rules.size());
+        if (i == key.size())
+            break;
+        const char c = data[reversed ? key.size() - 1 - i : i];
+        const auto it = std::find_if(current.children.begin(), current.children.end(),
+                                     [c](const auto &child) { return child.first == c; });
+        if (it == current.children.end())
+            break;
+        node = it->second;
+    }
+}
+
+/*!
+    \internal
+    Returns how the rules decide about the category \a categoryName.
+*/
+QLoggingRuleMatcher::Result QLoggingRuleMatcher::match(QLatin1String categoryName) const
+{
+    Matches matches;
+
+    if (!fullTextRules.isEmpty()) {
+        const auto it = fullTextRules.constFind(
+                QByteArray::fromRawData(categoryName.data(), categoryName.size()));
+        if (it != fullTextRules.constEnd())
+            matches.append(it->constData(), it->size());
+    }
+    collect(prefixTrie, categoryName, false, matches);
+
+    const qsizetype suffixStart = matches.size();
+    collect(suffixTrie, categoryName, true, matches);
+    // QLoggingRule::pass() only accepts a suffix if it is also the pattern's
+    // first occurrence in the name
+    const auto notFirstOccurrence = [&](int index) {
+        const QString &pattern = rules.at(index).category;
+        return categoryName.indexOf(pattern) != categoryName.size() - pattern.size();
+    };
+    matches.erase(std::remove_if(matches.begin() + suffixStart, matches.end(),
+                                 notFirstOccurrence),
+                  matches.end());
+
+    for (int index : midRules) {
+        if (categoryName.indexOf(rules.at(index).category) >= 0)
+            matches.append(index);
+    }
+
+    std::sort(matches.begin(), matches.end());
+
+    Result result;
+    for (int index : qAsConst(matches)) {
+        const QLoggingRule &rule = rules.at(index);
+        const qint8 decision = rule.enabled ? 1 : -1;
+        if (rule.messageType < 0 || rule.messageType == QtDebugMsg)
+            result.debug = decision;
+        if (rule.messageType < 0 || rule.messageType == QtInfoMsg)
+            result.info = decision;
+        if (rule.messageType < 0 || rule.messageType == QtWarningMsg)
+            result.warning = decision;
+        if (rule.messageType < 0 || rule.messageType == QtCriticalMsg)
+            result.critical = decision;
+    }
+    return result;
+}
+
 /*!
     \class QLoggingSettingsParser
     \since 5.3
@@ -397,6 +540,46 @@ void QLoggingRegistry::setApiRules(const QString &content)
     (The caller must lock registryMutex to make sure the API is thread safe.)
 */
 void QLoggingRegistry::updateRules()
+{
+    const QList<QLoggingRule> previous = ruleMatcher.compiledRules();
+    ruleMatcher.setRules(ruleSets, NumRuleSets);
+
+    // a custom filter may depend on anything, so it sees every category
+    if (categoryFilter != defaultCategoryFilter) {
+        filterAllCategories();
+        return;
+    }
+
+    // The rules up to the first difference decide as before, so only the
+    // categories matched by one of the rules after it can change.
+    const QList<QLoggingRule> &current = ruleMatcher.compiledRules();
+    const auto sameRule = [](const QLoggingRule &a, const QLoggingRule &b) {
+        return a.category == b.category && a.messageType == b.messageType
+                && a.flags == b.flags && a.enabled == b.enabled;
+    };
+    qsizetype common = 0;
+    while (common < previous.size() && common < current.size()
+           && sameRule(previous.at(common), current.at(common))) {
+        ++common;
+    }
+    if (common == previous.size() && common == current.size())
+        return;
+
+    const QList<QLoggingRule> changed[] = { previous.mid(common), current.mid(common) };
+    QLoggingRuleMatcher changedMatcher;
+    changedMatcher.setRules(changed, 2);
+    for (auto it = categories.keyBegin(), end = categories.keyEnd(); it != end; ++it) {
+        const auto result = changedMatcher.match(QLatin1String((*it)->categoryName()));
+        if (result.debug || result.info || result.warning || result.critical)
+            defaultCategoryFilter(*it);
+    }
+}
+
+/*!
+    \internal
+    Runs the current filter on every registered category.
+*/
+void QLoggingRegistry::filterAllCategories()
 {
     for (auto it = categories.keyBegin(), end = categories.keyEnd(); it != end; ++it)
         (*categoryFilter)(*it);
@@ -417,7 +600,7 @@ QLoggingRegistry::installFilter(QLoggingCategory::CategoryFilter filter)
     QLoggingCategory::CategoryFilter old = categoryFilter;
     categoryFilter = filter;
 
-    updateRules();
+    filterAllCategories();
 
     return old;
 }
@@ -455,24 +638,15 @@ void QLoggingRegistry::defaultCategoryFilter(QLoggingCategory *cat)
             debug = false;
     }
 
-    const auto categoryName = QLatin1String(cat->categoryName());
-
-    for (const auto &ruleSet : reg->ruleSets) {
-        for (const auto &rule : ruleSet) {
-            int filterpass = rule.pass(categoryName, QtDebugMsg);
-            if (filterpass != 0)
-                debug = (filterpass > 0);
-            filterpass = rule.pass(categoryName, QtInfoMsg);
-            if (filterpass != 0)
-                info = (filterpass > 0);
-            filterpass = rule.pass(categoryName, QtWarningMsg);
-            if (filterpass != 0)
-                warning = (filterpass > 0);
-            filterpass = rule.pass(categoryName, QtCriticalMsg);
-            if (filterpass != 0)
-                critical = (filterpass > 0);
-        }
-    }
+    const auto result = reg->ruleMatcher.match(QLatin1String(cat->categoryName()));
+    if (result.debug)
+        debug = (result.debug > 0);
+    if (result.info)
+        info = (result.info > 0);
+    if (result.warning)
+        warning = (result.warning > 0);
+    if (result.critical)
+        critical = (result.critical > 0);
 
     cat->setEnabled(QtDebugMsg, debug);
     cat->setEnabled(QtInfoMsg, info);
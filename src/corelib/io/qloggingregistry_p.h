@@ -58,6 +58,7 @@
 #include <QtCore/qmutex.h>
 #include <QtCore/qstring.h>
 #include <QtCore/qtextstream.h>
+#include <QtCore/qvarlengtharray.h>
 
 class tst_QLoggingRegistry;
 
@@ -90,6 +91,43 @@ private:
 Q_DECLARE_OPERATORS_FOR_FLAGS(QLoggingRule::PatternFlags)
 Q_DECLARE_TYPEINFO(QLoggingRule, Q_RELOCATABLE_TYPE);
 
+class Q_AUTOTEST_EXPORT QLoggingRuleMatcher
+{
+public:
+    // For each message type: 1 if the last applicable rule enables it,
+    // -1 if it disables it, 0 if no rule applies.
+    struct Result
+    {
+        qint8 debug = 0;
+        qint8 info = 0;
+        qint8 warning = 0;
+        qint8 critical = 0;
+    };
+
+    void setRules(const QList<QLoggingRule> *ruleSets, qsizetype count);
+    Result match(QLatin1String categoryName) const;
+
+    const QList<QLoggingRule> &compiledRules() const { return rules; }
+
+private:
+    struct TrieNode
+    {
+        QVarLengthArray<std::pair<char, int>, 4> children;
+        QList<int> rules;
+    };
+    using Trie = QList<TrieNode>;
+    using Matches = QVarLengthArray<int, 16>;
+
+    static void insert(Trie &trie, const QByteArray &key, bool reversed, int rule);
+    static void collect(const Trie &trie, QLatin1String key, bool reversed, Matches &matches);
+
+    QList<QLoggingRule> rules; // in the order in which they apply
+    QHash<QByteArray, QList<int>> fullTextRules;
+    Trie prefixTrie;
+    Trie suffixTrie; // of the reversed patterns
+    QList<int> midRules;
+};
+
 class Q_AUTOTEST_EXPORT QLoggingSettingsParser
 {
 public:
@@ -127,6 +165,7 @@ public:
 
 private:
     void updateRules();
+    void filterAllCategories();
 
     static void defaultCategoryFilter(QLoggingCategory *category);
 
@@ -144,6 +183,7 @@ private:
 
     // protected by mutex:
     QList<QLoggingRule> ruleSets[NumRuleSets];
+    QLoggingRuleMatcher ruleMatcher;
     QHash<QLoggingCategory *, QtMsgType> categories;
     QLoggingCategory::CategoryFilter categoryFilter;
 
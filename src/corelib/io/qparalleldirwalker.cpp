@@ -0,0 +1,538 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qparalleldirwalker_p.h"
+
+#include "qdiriterator.h"
+#include "qmutex.h"
+#include "qrunnable.h"
+#include "qthreadpool.h"
+#include "qwaitcondition.h"
+#if QT_CONFIG(regularexpression)
+#include "qregularexpression.h"
+#endif
+
+#include "private/qfileinfo_p.h"
+#include "private/qfilesystemengine_p.h"
+#include "private/qfilesystementry_p.h"
+#include "private/qfilesystemmetadata_p.h"
+
+#ifdef Q_OS_UNIX
+#include "private/qcore_unix_p.h"
+#endif
+
+#ifdef Q_OS_LINUX
+#include <sys/syscall.h>
+#  ifdef SYS_getdents64
+#    include <dirent.h>
+#    define QT_PARALLELDIRWALKER_GETDENTS
+#  endif
+#endif
+
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+    \class QParallelDirWalker
+    \inmodule QtCore
+    \since 6.1
+
+    \brief The QParallelDirWalker class lists a directory tree using several
+    threads.
+
+    QDirIterator with QDirIterator::Subdirectories lists one directory after
+    the other. QParallelDirWalker hands the subdirectories it finds to the
+    threads of a QThreadPool, so that a large tree is listed as fast as the
+    file system can deliver it. The entries are passed to a callback in
+    batches while the walk is in progress.
+
+    On Linux the directories are read with getdents64() into a large buffer,
+    and the entry types it reports are used instead of calling stat() for
+    every entry. With FetchMetaData, the worker threads also fetch the full
+    metadata of every entry, relative to the open directory, so that calls
+    like QFileInfo::size() on the results do not have to.
+
+    The filters work as for QDirIterator, except that \c{.} and \c{..} are
+    never listed. Hidden subdirectories are only entered if QDir::Hidden or
+    QDir::AllDirs is set, and symlinks to directories only with
+    FollowSymlinks, in which case a symlink leading back to a directory above
+    it is not entered.
+*/
+
+/*!
+    \enum QParallelDirWalker::Option
+
+    \value NoOptions The default.
+    \value FollowSymlinks Enter symlinks to directories.
+    \value FetchMetaData Fetch all metadata of the entries on the worker
+    threads.
+*/
+
+/*!
+    \typedef QParallelDirWalker::Callback
+
+    A function taking a \c{const QFileInfoList &}.
+*/
+
+class QParallelDirWalkerState : public std::enable_shared_from_this<QParallelDirWalkerState>
+{
+public:
+    // The callback gets at most this many entries at a time.
+    static constexpr qsizetype BatchSize = 1024;
+#ifdef QT_PARALLELDIRWALKER_GETDENTS
+    static constexpr size_t DirentBufferSize = 256 * 1024;
+#endif
+
+    QParallelDirWalkerState(QDir::Filters filters, QParallelDirWalker::Options options,
+                            const QStringList &nameFilters,
+                            const QParallelDirWalker::Callback &callback, QThreadPool *pool);
+
+    void run();
+    void waitForIdle();
+    void cancel();
+
+    struct Directory
+    {
+        QFileSystemEntry entry;
+        // Ids of the directories above, only with FollowSymlinks.
+        QList<QByteArray> ancestors;
+    };
+
+    QMutex mutex;
+    QWaitCondition condition;
+    // Directories still to be listed, used as a stack to keep it short.
+    std::vector<Directory> pending;
+    int busy = 0;
+    int workers = 0;
+    bool canceled = false;
+
+private:
+    struct Scratch
+    {
+        QFileInfoList batch;
+        std::vector<Directory> subdirectories;
+        // The ancestors of the subdirectories, i.e. the ones of the
+        // directory being listed plus its own id.
+        QList<QByteArray> ancestors;
+#ifdef QT_PARALLELDIRWALKER_GETDENTS
+        std::unique_ptr<char[]> direntBuffer;
+#endif
+    };
+
+    bool isCanceled()
+    {
+        QMutexLocker locker(&mutex);
+        return canceled;
+    }
+    bool enter(const Directory &directory, const QByteArray &id, Scratch &scratch) const;
+    void listDirectory(const Directory &directory, Scratch &scratch);
+    void addEntry(const QFileInfo &fileInfo, const QFileSystemEntry &entry, bool hidden,
+                  Scratch &scratch);
+    void flush(Scratch &scratch);
+    bool matchesFilters(const QFileInfo &fileInfo, bool hidden) const;
+
+    const QDir::Filters filters;
+    const QParallelDirWalker::Options options;
+    const QParallelDirWalker::Callback callback;
+    QThreadPool *const pool;
+    const int maxWorkers;
+    const bool hasNameFilters;
+#if QT_CONFIG(regularexpression)
+    QList<QRegularExpression> nameRegExps;
+#endif
+};
+
+QParallelDirWalkerState::QParallelDirWalkerState(QDir::Filters filters,
+                                                 QParallelDirWalker::Options options,
+                                                 const QStringList &nameFilters,
+                                                 const QParallelDirWalker::Callback &callback,
+                                                 QThreadPool *pool)
+    : filters(filters == QDir::NoFilter ? QDir::Filters(QDir::AllEntries) : filters),
+      options(options),
+      callback(callback),
+      pool(pool),
+      maxWorkers(qMax(1, pool->maxThreadCount())),
+      hasNameFilters(!nameFilters.isEmpty())
+{
+#if QT_CONFIG(regularexpression)
+    nameRegExps.reserve(nameFilters.size());
+    for (const QString &filter : nameFilters) {
+        nameRegExps.append(QRegularExpression::fromWildcard(
+                filter, (filters & QDir::CaseSensitive) ? Qt::CaseSensitive : Qt::CaseInsensitive));
+    }
+#endif
+}
+
+// Lists directories until there are none left. Every thread taking part in
+// the walk runs this, including the one that called walk().
+void QParallelDirWalkerState::run()
+{
+    Scratch scratch;
+    QMutexLocker locker(&mutex);
+    for (;;) {
+        while (pending.empty() && busy > 0 && !canceled)
+            condition.wait(&mutex);
+        if (pending.empty() || canceled)
+            break;
+
+        const Directory directory = std::move(pending.back());
+        pending.pop_back();
+        ++busy;
+        locker.unlock();
+
+        listDirectory(directory, scratch);
+
+        locker.relock();
+        --busy;
+        for (Directory &subdirectory : scratch.subdirectories)
+            pending.push_back(std::move(subdirectory));
+        const bool foundWork = !scratch.subdirectories.empty();
+        scratch.subdirectories.clear();
+
+        if (foundWork) {
+            // Bring in more threads while there is more work than idle ones.
+            while (workers < maxWorkers && qsizetype(pending.size()) > workers - busy) {
+                ++workers;
+                auto self = shared_from_this();
+                pool->start(QRunnable::create([self] { self->run(); }));
+            }
+            condition.wakeAll();
+        } else if (busy == 0 && pending.empty()) {
+            condition.wakeAll();
+        }
+    }
+    --workers;
+    if (busy == 0)
+        condition.wakeAll();
+}
+
+// Waits until no thread is listing a directory or calling the callback.
+void QParallelDirWalkerState::waitForIdle()
+{
+    QMutexLocker locker(&mutex);
+    while (busy > 0)
+        condition.wait(&mutex);
+}
+
+void QParallelDirWalkerState::cancel()
+{
+    QMutexLocker locker(&mutex);
+    canceled = true;
+    pending.clear();
+    condition.wakeAll();
+}
+
+// Sets up the ancestors for the subdirectories of \a directory, or returns
+// false if following a symlink has led back into one of its own ancestors.
+bool QParallelDirWalkerState::enter(const Directory &directory, const QByteArray &id,
+                                    Scratch &scratch) const
+{
+    if (!(options & QParallelDirWalker::FollowSymlinks))
+        return true;
+    if (!id.isEmpty() && directory.ancestors.contains(id))
+        return false;
+    scratch.ancestors = directory.ancestors;
+    scratch.ancestors.append(id);
+    return true;
+}
+
+#ifdef QT_PARALLELDIRWALKER_GETDENTS
+// The record layout of getdents64(), which glibc does not declare.
+struct QLinuxDirent64
+{
+    quint64 d_ino;
+    qint64 d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+
+void QParallelDirWalkerState::listDirectory(const Directory &directory, Scratch &scratch)
+{
+    const QByteArray nativeDirectory = directory.entry.nativeFilePath();
+    const int fd = qt_safe_open(nativeDirectory.constData(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0)
+        return;
+    if (!enter(directory,
+               (options & QParallelDirWalker::FollowSymlinks) ? QFileSystemEngine::id(fd)
+                                                               : QByteArray(),
+               scratch)) {
+        qt_safe_close(fd);
+        return;
+    }
+
+    if (!scratch.direntBuffer)
+        scratch.direntBuffer.reset(new char[DirentBufferSize]);
+    char *buffer = scratch.direntBuffer.get();
+
+    QByteArray prefix = nativeDirectory;
+    if (!prefix.endsWith('/'))
+        prefix += '/';
+
+    long size;
+    while (!isCanceled()
+           && (size = syscall(SYS_getdents64, fd, buffer, DirentBufferSize)) > 0) {
+        for (long offset = 0; offset < size;) {
+            const auto record = reinterpret_cast<const QLinuxDirent64 *>(buffer + offset);
+            offset += record->d_reclen;
+
+            const char *name = record->d_name;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                continue;
+
+            QFileSystemMetaData metaData;
+            // Symlinks are looked at in any case: the filters and the
+            // decision to descend go by what the link points to.
+            if ((options & QParallelDirWalker::FetchMetaData) || record->d_type == DT_UNKNOWN
+                || record->d_type == DT_LNK) {
+                QFileSystemEngine::fillMetaData(fd, name, metaData);
+            } else {
+                metaData.fillFromDirEntType(record->d_type);
+            }
+
+            const QFileSystemEntry entry(prefix + name, QFileSystemEntry::FromNativePath());
+            addEntry(QFileInfo(new QFileInfoPrivate(entry, metaData)), entry, name[0] == '.',
+                     scratch);
+        }
+    }
+    qt_safe_close(fd);
+    flush(scratch);
+}
+#else
+void QParallelDirWalkerState::listDirectory(const Directory &directory, Scratch &scratch)
+{
+    if (!enter(directory,
+               (options & QParallelDirWalker::FollowSymlinks)
+                       ? QFileSystemEngine::id(directory.entry) : QByteArray(),
+               scratch)) {
+        return;
+    }
+
+    QDirIterator it(directory.entry.filePath(),
+                    QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
+    while (it.hasNext() && !isCanceled()) {
+        it.next();
+        QFileInfo fileInfo = it.fileInfo();
+        if (options & QParallelDirWalker::FetchMetaData)
+            fileInfo.stat();
+        addEntry(fileInfo, QFileSystemEntry(fileInfo.filePath()), fileInfo.isHidden(), scratch);
+    }
+    flush(scratch);
+}
+#endif
+
+void QParallelDirWalkerState::addEntry(const QFileInfo &fileInfo, const QFileSystemEntry &entry,
+                                       bool hidden, Scratch &scratch)
+{
+    if (fileInfo.isDir() && (!fileInfo.isSymLink() || (options & QParallelDirWalker::FollowSymlinks))
+        && (!hidden || (filters & (QDir::AllDirs | QDir::Hidden)))) {
+        scratch.subdirectories.push_back({ entry, scratch.ancestors });
+    }
+
+    if (matchesFilters(fileInfo, hidden)) {
+        scratch.batch.append(fileInfo);
+        if (scratch.batch.size() >= BatchSize)
+            flush(scratch);
+    }
+}
+
+void QParallelDirWalkerState::flush(Scratch &scratch)
+{
+    if (scratch.batch.isEmpty())
+        return;
+    if (!isCanceled())
+        callback(scratch.batch);
+    scratch.batch.clear();
+}
+
+// Same as QDirIteratorPrivate::matchesFilters(), minus the handling of
+// "." and "..", which are never listed.
+bool QParallelDirWalkerState::matchesFilters(const QFileInfo &fi, bool hidden) const
+{
+#if QT_CONFIG(regularexpression)
+    // Pass all entries through name filters, except dirs if the AllDirs
+    if (hasNameFilters && !((filters & QDir::AllDirs) && fi.isDir())) {
+        const QString fileName = fi.fileName();
+        bool matched = false;
+        for (const auto &re : nameRegExps) {
+            if (re.match(fileName).hasMatch()) {
+                matched = true;
+                break;
+            }
+        }
+        if (!matched)
+            return false;
+    }
+#endif
+    // skip symlinks
+    const bool skipSymlinks = (filters & QDir::NoSymLinks);
+    const bool includeSystem = (filters & QDir::System);
+    if (skipSymlinks && fi.isSymLink()) {
+        // The only reason to save this file is if it is a broken link and we are requesting system files.
+        if (!includeSystem || fi.exists())
+            return false;
+    }
+
+    // filter hidden
+    if (!(filters & QDir::Hidden) && hidden)
+        return false;
+
+    // filter system files
+    if (!includeSystem && (!(fi.isFile() || fi.isDir() || fi.isSymLink())
+                    || (!fi.exists() && fi.isSymLink())))
+        return false;
+
+    // skip directories
+    const bool skipDirs = !(filters & (QDir::Dirs | QDir::AllDirs));
+    if (skipDirs && fi.isDir())
+        return false;
+
+    // skip files
+    const bool skipFiles = !(filters & QDir::Files);
+    if (skipFiles && fi.isFile())
+        return false;
+
+    // filter permissions
+    const bool filterPermissions = ((filters & QDir::PermissionMask)
+                                    && (filters & QDir::PermissionMask) != QDir::PermissionMask);
+    const bool doWritable = !filterPermissions || (filters & QDir::Writable);
+    const bool doExecutable = !filterPermissions || (filters & QDir::Executable);
+    const bool doReadable = !filterPermissions || (filters & QDir::Readable);
+    if (filterPermissions
+        && ((doReadable && !fi.isReadable())
+            || (doWritable && !fi.isWritable())
+            || (doExecutable && !fi.isExecutable()))) {
+        return false;
+    }
+
+    return true;
+}
+
+/*!
+    Constructs a walker for the tree below \a path that lists the entries
+    matching \a filters, with the given \a options.
+*/
+QParallelDirWalker::QParallelDirWalker(const QString &path, QDir::Filters filters,
+                                       Options options)
+    : m_path(path), m_filters(filters), m_options(options)
+{
+}
+
+/*!
+    Destroys the walker. A walk must not be in progress.
+*/
+QParallelDirWalker::~QParallelDirWalker() = default;
+
+/*!
+    \fn QStringList QParallelDirWalker::nameFilters() const
+    \fn void QParallelDirWalker::setNameFilters(const QStringList &nameFilters)
+
+    The wildcard patterns that file names must match, as in
+    QDir::setNameFilters().
+*/
+
+/*!
+    \fn QThreadPool *QParallelDirWalker::threadPool() const
+    \fn void QParallelDirWalker::setThreadPool(QThreadPool *pool)
+
+    The thread pool that the walk runs on. By default, that is
+    QThreadPool::globalInstance(). The walk uses up to
+    QThreadPool::maxThreadCount() threads of it, besides the calling thread.
+*/
+
+/*!
+    Lists the whole tree and returns when it is done or canceled.
+
+    The matching entries are passed to \a callback in batches, from the
+    thread that listed them. Several threads can call \a callback at the
+    same time. It is not called anymore once walk() has returned.
+
+    The entries of a directory come in the order the file system returns
+    them, and a directory's entries may be reported before or after those
+    of its subdirectories.
+
+    \sa cancel()
+*/
+void QParallelDirWalker::walk(const Callback &callback)
+{
+    QThreadPool *pool = m_threadPool ? m_threadPool : QThreadPool::globalInstance();
+    auto state = std::make_shared<QParallelDirWalkerState>(m_filters, m_options, m_nameFilters,
+                                                           callback, pool);
+    state->pending.push_back({ QFileSystemEntry(m_path), {} });
+    state->workers = 1;
+    std::atomic_store(&m_state, state);
+
+    // The calling thread takes part, so the walk makes progress even when
+    // all threads of the pool are busy with something else.
+    state->run();
+    state->waitForIdle();
+
+    std::atomic_store(&m_state, std::shared_ptr<QParallelDirWalkerState>());
+}
+
+/*!
+    Lists the whole tree and returns the matching entries, in no particular
+    order.
+*/
+QFileInfoList QParallelDirWalker::entryInfoList()
+{
+    QMutex mutex;
+    QFileInfoList result;
+    walk([&](const QFileInfoList &entries) {
+        QMutexLocker locker(&mutex);
+        result += entries;
+    });
+    return result;
+}
+
+/*!
+    Stops the walk in progress. This can be called from any thread,
+    including from the callback. walk() returns after the batches that are
+    already being passed to the callback.
+*/
+void QParallelDirWalker::cancel()
+{
+    if (auto state = std::atomic_load(&m_state))
+        state->cancel();
+}
+
+QT_END_NAMESPACE
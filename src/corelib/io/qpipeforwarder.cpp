@@ -0,0 +1,728 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qpipeforwarder_p.h"
+
+#include "qmutex.h"
+#include "qscopeguard.h"
+#include "qthread.h"
+#include "qvarlengtharray.h"
+
+#include "private/qcore_unix_p.h"
+#include "private/qobject_p.h"
+#include "private/qprocess_p.h"
+
+#include <algorithm>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+    \class QPipeForwarder
+    \inmodule QtCore
+
+    \brief The QPipeForwarder class moves a stream of bytes from one file
+    descriptor to one or more others on a worker thread.
+
+    The source is typically the standard output of a QProcess and the sinks
+    are other processes, files or sockets. On Linux the data is moved with
+    splice() and, when it has to reach several sinks, duplicated with tee(),
+    so that it never gets copied into user space. Elsewhere, and whenever
+    the kernel refuses to splice between the given descriptors, the
+    forwarder falls back to a read() and write() loop.
+
+    A forwarder is started once. It stops at the end of the source, when
+    cancel() is called, or when no sink is left that accepts data, and emits
+    finished(). Descriptors passed with QFileDevice::AutoCloseHandle, and the
+    pipes taken over from a QProcess, are closed by the worker as soon as it
+    stops, so that processes reading from a sink see the end of their input.
+*/
+
+/*!
+    \fn void QPipeForwarder::finished()
+
+    This signal is emitted when the forwarder has stopped, after reaching
+    the end of the source, after cancel(), or because of an error.
+*/
+
+// Largest amount of data moved by one splice() call
+static constexpr size_t SpliceChunk = 1 << 20;
+// Capacity requested for the pipes the data is staged in
+static constexpr int StagePipeSize = 1 << 20;
+// Buffer used when the data has to be copied
+static constexpr qsizetype CopyChunk = 64 * 1024;
+
+class QPipeForwarderPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QPipeForwarder)
+
+    class WorkerThread : public QThread
+    {
+    public:
+        explicit WorkerThread(QPipeForwarderPrivate *d) : d(d) {}
+        void run() override { d->run(); }
+
+    private:
+        QPipeForwarderPrivate *d;
+    };
+
+public:
+    struct Sink
+    {
+        int fd = -1;
+        bool owned = false;
+        bool isPipe = false;
+        bool failed = false;
+        bool copy = false;          // the kernel refused to splice into fd
+        int restoreFlags = -1;      // status flags before fd was made non-blocking
+        int stage[2] = { -1, -1 };  // tee() target when fanning out
+        qint64 staged = 0;
+        QByteArray pending;         // written after the staged data
+    };
+
+    ~QPipeForwarderPrivate();
+
+    void emitFinished();
+    void setError(const QString &message);
+    bool stopRequested() const { return canceled.loadRelaxed() != 0; }
+    void closeDescriptors();
+
+    // worker thread
+    void run();
+    bool waitFor(int fd, short events);
+    bool hasLiveSinks() const;
+    void failSink(Sink &sink, int error);
+    void flushSink(Sink &sink);
+    bool drainSinks();
+    void copy();
+#ifdef Q_OS_LINUX
+    bool spliceDirect();
+    bool spliceStaged();
+#endif
+
+    int sourceFd = -1;
+    bool sourceOwned = false;
+    bool sourceIsPipe = false;
+    QByteArray sourcePending;
+    QList<Sink> sinks;
+
+    int wakePipe[2] = { -1, -1 };
+    int sourceStage[2] = { -1, -1 };
+    qint64 sourceStaged = 0;
+    WorkerThread *thread = nullptr;
+    bool finishedEmitted = false;
+
+    QAtomicInt canceled;
+    QAtomicInt zeroCopy;
+    QAtomicInteger<qint64> forwarded;
+    mutable QMutex errorMutex;
+    QString errorString;
+};
+
+static bool isPipe(int fd)
+{
+    QT_STATBUF st;
+    return QT_FSTAT(fd, &st) == 0 && S_ISFIFO(st.st_mode);
+}
+
+static void closeFd(int &fd)
+{
+    if (fd != -1) {
+        qt_safe_close(fd);
+        fd = -1;
+    }
+}
+
+static void closePipe(int pipe[2])
+{
+    closeFd(pipe[0]);
+    closeFd(pipe[1]);
+}
+
+#ifdef Q_OS_LINUX
+static bool createStagePipe(int pipe[2])
+{
+    if (qt_safe_pipe(pipe, O_NONBLOCK) != 0)
+        return false;
+    // A larger pipe means fewer round trips; failing to grow it is harmless.
+    ::fcntl(pipe[1], F_SETPIPE_SZ, StagePipeSize);
+    return true;
+}
+#endif
+
+QPipeForwarderPrivate::~QPipeForwarderPrivate()
+{
+    closeDescriptors();
+}
+
+void QPipeForwarderPrivate::closeDescriptors()
+{
+    if (sourceOwned)
+        closeFd(sourceFd);
+    closePipe(sourceStage);
+    for (Sink &sink : sinks) {
+        if (sink.restoreFlags != -1) {
+            ::fcntl(sink.fd, F_SETFL, sink.restoreFlags);
+            sink.restoreFlags = -1;
+        }
+        if (sink.owned)
+            closeFd(sink.fd);
+        closePipe(sink.stage);
+    }
+}
+
+void QPipeForwarderPrivate::emitFinished()
+{
+    Q_Q(QPipeForwarder);
+    if (finishedEmitted)
+        return;
+    finishedEmitted = true;
+    closePipe(wakePipe);
+    emit q->finished();
+}
+
+void QPipeForwarderPrivate::setError(const QString &message)
+{
+    QMutexLocker locker(&errorMutex);
+    if (errorString.isEmpty())
+        errorString = message;
+}
+
+void QPipeForwarderPrivate::run()
+{
+    // A sink whose reader went away must report EPIPE, not kill us.
+    qt_ignore_sigpipe();
+
+    if (!sourcePending.isEmpty()) {
+        for (Sink &sink : sinks)
+            sink.pending.append(sourcePending);
+        forwarded.fetchAndAddRelaxed(sourcePending.size());
+        sourcePending.clear();
+    }
+
+    bool handled = false;
+    if (drainSinks()) {
+#ifdef Q_OS_LINUX
+        if (sinks.size() == 1 && (sourceIsPipe || sinks.constFirst().isPipe))
+            handled = spliceDirect();
+        else
+            handled = spliceStaged();
+#endif
+        if (!handled)
+            copy();
+    }
+    if (stopRequested())
+        setError(QPipeForwarder::tr("Forwarding was canceled"));
+    closeDescriptors();
+}
+
+// Waits until fd is ready for events. Returns false if we were asked to stop.
+bool QPipeForwarderPrivate::waitFor(int fd, short events)
+{
+    pollfd pfds[2] = { qt_make_pollfd(wakePipe[0], POLLIN), qt_make_pollfd(fd, events) };
+    if (qt_poll_msecs(pfds, 2, -1) < 0) {
+        setError(qt_error_string(errno));
+        return false;
+    }
+    return pfds[0].revents == 0;
+}
+
+bool QPipeForwarderPrivate::hasLiveSinks() const
+{
+    return std::any_of(sinks.cbegin(), sinks.cend(), [](const Sink &sink) { return !sink.failed; });
+}
+
+void QPipeForwarderPrivate::failSink(Sink &sink, int error)
+{
+    sink.failed = true;
+    sink.staged = 0;
+    sink.pending.clear();
+    setError(QPipeForwarder::tr("Cannot write to file descriptor %1: %2")
+             .arg(sink.fd).arg(qt_error_string(error)));
+}
+
+// Moves as much of the staged and pending data of sink as it accepts
+// without blocking. Only called once poll() reported it writable.
+void QPipeForwarderPrivate::flushSink(Sink &sink)
+{
+#ifdef Q_OS_LINUX
+    while (sink.staged > 0 && !sink.copy) {
+        const ssize_t n = ::splice(sink.stage[0], nullptr, sink.fd, nullptr, size_t(sink.staged),
+                                   SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (n > 0) {
+            sink.staged -= n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && errno == EAGAIN) {
+            return;
+        } else if (n < 0 && errno == EINVAL) {
+            // e.g. a file opened with O_APPEND; copy from now on
+            sink.copy = true;
+            zeroCopy.storeRelaxed(0);
+        } else {
+            failSink(sink, n < 0 ? errno : EPIPE);
+            return;
+        }
+    }
+    if (sink.staged > 0) {
+        // The staged data precedes anything pending.
+        QByteArray staged(sink.staged, Qt::Uninitialized);
+        if (qt_safe_read(sink.stage[0], staged.data(), staged.size()) != staged.size()) {
+            failSink(sink, errno);
+            return;
+        }
+        sink.pending.prepend(staged);
+        sink.staged = 0;
+    }
+#endif
+    if (!sink.pending.isEmpty()) {
+        const qint64 n = qt_safe_write(sink.fd, sink.pending.constData(), sink.pending.size());
+        if (n > 0)
+            sink.pending.remove(0, n);
+        else if (n < 0 && errno != EAGAIN)
+            failSink(sink, errno);
+    }
+}
+
+// Blocks until every sink took all the data staged or pending for it.
+// Returns false if we were asked to stop or no sink is left.
+bool QPipeForwarderPrivate::drainSinks()
+{
+    forever {
+        QVarLengthArray<pollfd, 8> pfds;
+        QVarLengthArray<Sink *, 8> waiting;
+        pfds.append(qt_make_pollfd(wakePipe[0], POLLIN));
+        for (Sink &sink : sinks) {
+            if (!sink.failed && (sink.staged > 0 || !sink.pending.isEmpty())) {
+                pfds.append(qt_make_pollfd(sink.fd, POLLOUT));
+                waiting.append(&sink);
+            }
+        }
+        if (waiting.isEmpty())
+            return hasLiveSinks();
+
+        if (qt_poll_msecs(pfds.data(), nfds_t(pfds.size()), -1) < 0) {
+            setError(qt_error_string(errno));
+            return false;
+        }
+        if (pfds[0].revents)
+            return false;
+        for (qsizetype i = 0; i < waiting.size(); ++i) {
+            if (pfds[i + 1].revents)
+                flushSink(*waiting[i]);
+        }
+    }
+}
+
+void QPipeForwarderPrivate::copy()
+{
+    zeroCopy.storeRelaxed(0);
+    QByteArray buffer(CopyChunk, Qt::Uninitialized);
+    while (drainSinks() && waitFor(sourceFd, POLLIN)) {
+        const qint64 n = qt_safe_read(sourceFd, buffer.data(), buffer.size());
+        if (n == 0)
+            return;
+        if (n < 0) {
+            if (errno == EAGAIN)
+                continue;
+            setError(QPipeForwarder::tr("Cannot read from file descriptor %1: %2")
+                     .arg(sourceFd).arg(qt_error_string(errno)));
+            return;
+        }
+        for (Sink &sink : sinks) {
+            if (!sink.failed)
+                sink.pending.append(buffer.constData(), n);
+        }
+        forwarded.fetchAndAddRelaxed(n);
+    }
+}
+
+#ifdef Q_OS_LINUX
+// One sink, and the source or the sink is a pipe: splice straight across.
+// Returns false if the kernel cannot splice between the two at all.
+bool QPipeForwarderPrivate::spliceDirect()
+{
+    Sink &sink = sinks.first();
+    bool moved = false;
+    while (waitFor(sourceFd, POLLIN) && waitFor(sink.fd, POLLOUT)) {
+        const ssize_t n = ::splice(sourceFd, nullptr, sink.fd, nullptr, SpliceChunk,
+                                   SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (n > 0) {
+            moved = true;
+            forwarded.fetchAndAddRelaxed(n);
+            continue;
+        }
+        if (n == 0)
+            break;
+        if (errno == EINTR || errno == EAGAIN)
+            continue;
+        if (errno == EINVAL && !moved)
+            return false;
+        if (errno == EPIPE)
+            failSink(sink, errno);
+        else
+            setError(qt_error_string(errno));
+        break;
+    }
+    return true;
+}
+
+// Several sinks, or neither end is a pipe. The data is first moved into a
+// pipe if the source is not one, then tee()d into a staging pipe per sink
+// and finally spliced from there. Returns false if the kernel cannot
+// splice from the source at all.
+bool QPipeForwarderPrivate::spliceStaged()
+{
+    if (!sourceIsPipe && !createStagePipe(sourceStage))
+        return false;
+    for (Sink &sink : sinks) {
+        if (!createStagePipe(sink.stage))
+            return false;
+    }
+    const int sourcePipe = sourceIsPipe ? sourceFd : sourceStage[0];
+    const int devNull = qt_safe_open("/dev/null", O_WRONLY);
+    const auto cleanup = qScopeGuard([devNull] {
+        if (devNull != -1)
+            qt_safe_close(devNull);
+    });
+    QByteArray scratch;
+    bool moved = false;
+    bool atEnd = false;
+
+    while (drainSinks() && !atEnd) {
+        if ((sourceIsPipe || sourceStaged == 0) && !waitFor(sourceFd, POLLIN))
+            break;
+        if (!sourceIsPipe && sourceStaged == 0) {
+            const ssize_t n = ::splice(sourceFd, nullptr, sourceStage[1], nullptr, SpliceChunk,
+                                       SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (n > 0) {
+                sourceStaged = n;
+            } else if (n == 0) {
+                atEnd = true;
+                continue;
+            } else if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            } else if (errno == EINVAL && !moved) {
+                return false;
+            } else {
+                setError(qt_error_string(errno));
+                break;
+            }
+        }
+
+        // Duplicate the head of the source pipe into every staging pipe.
+        // They are all empty, so normally each takes the same amount.
+        ssize_t length = -1;
+        QVarLengthArray<ssize_t, 8> teed(sinks.size());
+        for (qsizetype i = 0; i < sinks.size(); ++i) {
+            Sink &sink = sinks[i];
+            teed[i] = 0;
+            if (sink.failed)
+                continue;
+            ssize_t n = ::tee(sourcePipe, sink.stage[1], length < 0 ? SpliceChunk : size_t(length),
+                              SPLICE_F_NONBLOCK);
+            if (length < 0) {
+                if (n == 0)
+                    atEnd = true;
+                if (n <= 0)
+                    break;
+                length = n;
+            }
+            teed[i] = qMax<ssize_t>(n, 0);
+            sink.staged += teed[i];
+        }
+        if (length < 0) {
+            if (atEnd || errno == EINTR || errno == EAGAIN)
+                continue;
+            if (errno == EINVAL && !moved)
+                return false;
+            setError(qt_error_string(errno));
+            break;
+        }
+        moved = true;
+
+        // Consume what was duplicated. A sink that took less gets the rest
+        // through a plain write(), which requires reading it out.
+        bool complete = true;
+        for (qsizetype i = 0; i < sinks.size(); ++i)
+            complete = complete && (sinks.at(i).failed || teed[i] == length);
+        ssize_t left = length;
+        while (complete && devNull != -1 && left > 0) {
+            const ssize_t n = ::splice(sourcePipe, nullptr, devNull, nullptr, size_t(left),
+                                       SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (n <= 0)
+                break;
+            left -= n;
+        }
+        if (left > 0) {
+            zeroCopy.storeRelaxed(0);
+            scratch.resize(left);
+            if (qt_safe_read(sourcePipe, scratch.data(), left) != left) {
+                setError(qt_error_string(errno));
+                break;
+            }
+            const ssize_t offset = length - left;
+            for (qsizetype i = 0; i < sinks.size(); ++i) {
+                Sink &sink = sinks[i];
+                if (!sink.failed && teed[i] < length) {
+                    const ssize_t from = qMax(teed[i], offset);
+                    sink.pending.append(scratch.constData() + from - offset, length - from);
+                }
+            }
+        }
+        if (!sourceIsPipe)
+            sourceStaged -= length;
+        forwarded.fetchAndAddRelaxed(length);
+    }
+    return true;
+}
+#endif
+
+/*!
+    Constructs a QPipeForwarder with the given \a parent.
+*/
+QPipeForwarder::QPipeForwarder(QObject *parent)
+    : QObject(*new QPipeForwarderPrivate, parent)
+{
+}
+
+/*!
+    Destroys the forwarder, stopping it first if it is still running.
+*/
+QPipeForwarder::~QPipeForwarder()
+{
+    Q_D(QPipeForwarder);
+    if (d->thread) {
+        cancel();
+        d->thread->wait();
+        delete d->thread;
+        d->thread = nullptr;
+    }
+    closePipe(d->wakePipe);
+}
+
+/*!
+    Reads the data to forward from \a fd. The descriptor is closed when the
+    forwarder stops if \a handleFlags contains QFileDevice::AutoCloseHandle.
+    Returns \c false if the forwarder was already started.
+*/
+bool QPipeForwarder::setSource(int fd, QFileDevice::FileHandleFlags handleFlags)
+{
+    Q_D(QPipeForwarder);
+    if (d->thread || fd < 0)
+        return false;
+    if (d->sourceOwned)
+        closeFd(d->sourceFd);
+    d->sourceFd = fd;
+    d->sourceOwned = handleFlags.testFlag(QFileDevice::AutoCloseHandle);
+    d->sourcePending.clear();
+    return true;
+}
+
+/*!
+    \overload
+
+    Forwards the given output \a channel of \a process, which must be
+    running and reading that channel through a pipe. The pipe is taken
+    over from \a process, which does not report data on that channel
+    afterwards. Data it already read but that was not consumed yet is
+    forwarded first.
+*/
+bool QPipeForwarder::setSource(QProcess *process, QProcess::ProcessChannel channel)
+{
+    Q_D(QPipeForwarder);
+    if (d->thread || !process || process->state() == QProcess::NotRunning)
+        return false;
+    QProcessPrivate *pd = static_cast<QProcessPrivate *>(QObjectPrivate::get(process));
+    QByteArray pending;
+    const int fd = pd->detachChannelPipe(channel == QProcess::StandardError ? &pd->stderrChannel
+                                                                         : &pd->stdoutChannel,
+                                         &pending);
+    if (!setSource(fd, QFileDevice::AutoCloseHandle))
+        return false;
+    d->sourcePending = pending;
+    return true;
+}
+
+/*!
+    Adds \a fd to the descriptors the data is written to. The descriptor is
+    closed when the forwarder stops if \a handleFlags contains
+    QFileDevice::AutoCloseHandle. While the forwarder runs, \a fd is in
+    non-blocking mode, so that a sink that stops reading cannot keep it
+    from being canceled. Returns \c false if the forwarder was already
+    started.
+*/
+bool QPipeForwarder::addSink(int fd, QFileDevice::FileHandleFlags handleFlags)
+{
+    Q_D(QPipeForwarder);
+    if (d->thread || fd < 0)
+        return false;
+    QPipeForwarderPrivate::Sink sink;
+    sink.fd = fd;
+    sink.owned = handleFlags.testFlag(QFileDevice::AutoCloseHandle);
+    d->sinks.append(sink);
+    return true;
+}
+
+/*!
+    \overload
+
+    Writes the data to the standard input of \a process, which must be
+    running and writing to it through a pipe. The pipe is taken over from
+    \a process and closed when the forwarder stops; data written to
+    \a process before is sent first.
+*/
+bool QPipeForwarder::addSink(QProcess *process)
+{
+    Q_D(QPipeForwarder);
+    if (d->thread || !process || process->state() == QProcess::NotRunning)
+        return false;
+    QProcessPrivate *pd = static_cast<QProcessPrivate *>(QObjectPrivate::get(process));
+    QByteArray pending;
+    const int fd = pd->detachChannelPipe(&pd->stdinChannel, &pending);
+    if (!addSink(fd, QFileDevice::AutoCloseHandle))
+        return false;
+    d->sinks.last().pending = pending;
+    return true;
+}
+
+/*!
+    Starts forwarding on a worker thread. Returns \c false if no source or
+    sink was set, or if the forwarder was started before.
+*/
+bool QPipeForwarder::start()
+{
+    Q_D(QPipeForwarder);
+    if (d->thread || d->sourceFd == -1 || d->sinks.isEmpty())
+        return false;
+    if (qt_safe_pipe(d->wakePipe, O_NONBLOCK) != 0) {
+        d->setError(qt_error_string(errno));
+        return false;
+    }
+    d->sourceIsPipe = isPipe(d->sourceFd);
+    for (QPipeForwarderPrivate::Sink &sink : d->sinks) {
+        sink.isPipe = isPipe(sink.fd);
+        const int flags = ::fcntl(sink.fd, F_GETFL);
+        if (flags != -1 && !(flags & O_NONBLOCK)
+            && ::fcntl(sink.fd, F_SETFL, flags | O_NONBLOCK) == 0) {
+            sink.restoreFlags = flags;
+        }
+    }
+#ifdef Q_OS_LINUX
+    d->zeroCopy.storeRelaxed(1);
+#endif
+
+    d->thread = new QPipeForwarderPrivate::WorkerThread(d);
+    connect(d->thread, &QThread::finished, this, [d] { d->emitFinished(); });
+    d->thread->start();
+    return true;
+}
+
+/*!
+    Asks the forwarder to stop. Data that was not written yet is dropped.
+*/
+void QPipeForwarder::cancel()
+{
+    Q_D(QPipeForwarder);
+    if (!d->thread || d->finishedEmitted)
+        return;
+    d->canceled.storeRelaxed(1);
+    const char c = 0;
+    qt_safe_write(d->wakePipe[1], &c, 1);
+}
+
+/*!
+    Returns \c true if the forwarder was started and has not stopped yet.
+*/
+bool QPipeForwarder::isRunning() const
+{
+    Q_D(const QPipeForwarder);
+    return d->thread && !d->thread->isFinished();
+}
+
+/*!
+    Blocks until the forwarder has stopped, or \a msecs milliseconds have
+    passed; -1 waits forever. Emits finished() and returns \c true if it
+    stopped.
+*/
+bool QPipeForwarder::waitForFinished(int msecs)
+{
+    Q_D(QPipeForwarder);
+    if (!d->thread || !d->thread->wait(QDeadlineTimer(msecs)))
+        return false;
+    d->emitFinished();
+    return true;
+}
+
+/*!
+    Returns the number of bytes read from the source and handed to the sinks.
+*/
+qint64 QPipeForwarder::bytesForwarded() const
+{
+    Q_D(const QPipeForwarder);
+    return d->forwarded.loadRelaxed();
+}
+
+/*!
+    Returns \c true if the data was moved by the kernel without being copied
+    through the worker. This is only final once the forwarder has stopped.
+*/
+bool QPipeForwarder::isZeroCopy() const
+{
+    Q_D(const QPipeForwarder);
+    return d->zeroCopy.loadRelaxed() != 0;
+}
+
+/*!
+    Returns a description of the last error, or an empty string.
+*/
+QString QPipeForwarder::errorString() const
+{
+    Q_D(const QPipeForwarder);
+    QMutexLocker locker(&d->errorMutex);
+    return d->errorString;
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qpipeforwarder_p.cpp"
@@ -507,6 +507,12 @@ void QProcessPrivate::Channel::clear()
     either of the two channels by calling readAllStandardOutput() or
     readAllStandardError().
 
+    On Unix, a process started with QIODevice::Unbuffered in its open
+    mode reads large blocks straight from the pipe into the buffer
+    passed to read(), instead of copying them through QProcess's
+    internal buffer first. This is useful when consuming a high volume
+    of output.
+
     The terminology for the channels can be misleading. Be aware that
     the process's output channels correspond to QProcess's
     \e read channels, whereas the process's input channels correspond
@@ -1925,11 +1931,26 @@ auto QProcess::setupChildProcess() -> Use_setChildProcessModifier_Instead
 qint64 QProcess::readData(char *data, qint64 maxlen)
 {
     Q_D(QProcess);
-    Q_UNUSED(data);
     if (!maxlen)
         return 0;
     if (d->processState == QProcess::NotRunning)
         return -1;              // EOF
+#ifdef Q_OS_UNIX
+    // In unbuffered mode, read straight from the pipe into the caller's
+    // buffer once the channel's ring buffer has been drained. End of file
+    // and errors are left for the notifier to report.
+    if (openMode() & QIODevice::Unbuffered) {
+        QProcessPrivate::Channel *channel = (d->currentReadChannel == QProcess::StandardError
+                                             ? &d->stderrChannel : &d->stdoutChannel);
+        if (!channel->closed && channel->pipe[0] != INVALID_Q_PIPE) {
+            const qint64 readBytes = d->readFromChannel(channel, data, maxlen);
+            if (readBytes > 0)
+                return readBytes;
+        }
+    }
+#else
+    Q_UNUSED(data);
+#endif
     return 0;
 }
 
@@ -203,6 +203,13 @@ public:
     typedef QHash<QString, Key> NameHash;
     mutable NameHash nameMap;
     mutable QMutex nameMapMutex;
+
+    QByteArray environmentBlock(int *count) const;
+    // environmentBlock() cache, valid while blockVars shares its data with vars
+    mutable QMutex blockMutex;
+    mutable Map blockVars;
+    mutable QByteArray block;
+    mutable int blockCount = 0;
 #endif
 
     static QProcessEnvironment fromList(const QStringList &list);
@@ -320,6 +327,7 @@ public:
     bool openChannel(Channel &channel);
 #if defined(Q_OS_UNIX)
     void commitChannels();
+    int detachChannelPipe(Channel *channel, QByteArray *pending);
 #endif
     void closeChannel(Channel *channel);
     void closeWriteChannel();
@@ -144,6 +144,34 @@ QProcessEnvironment QProcessEnvironment::systemEnvironment()
 
 #endif // !defined(Q_OS_DARWIN)
 
+/*
+    Returns the variables as consecutive "name=value" strings, each one
+    null-terminated, and stores how many there are in \a count. The result
+    is kept until vars is modified, so that starting many processes with
+    the same environment encodes it only once.
+*/
+QByteArray QProcessEnvironmentPrivate::environmentBlock(int *count) const
+{
+    const QMutexLocker locker(&blockMutex);
+    if (block.isNull() || !blockVars.isSharedWith(vars)) {
+        QByteArray result;
+        for (auto it = vars.constBegin(), end = vars.constEnd(); it != end; ++it) {
+            const qsizetype start = result.size();
+            result += it.key();
+            result += '=';
+            result += it.value().bytes();
+            // execve() sees each entry only up to its first null byte
+            result.truncate(start + qstrlen(result.constData() + start));
+            result += '\0';
+        }
+        block = result;
+        blockCount = int(vars.size());
+        blockVars = vars;
+    }
+    *count = blockCount;
+    return block;
+}
+
 #if QT_CONFIG(process)
 
 namespace {
@@ -222,6 +250,43 @@ void QProcessPrivate::closeChannel(Channel *channel)
     destroyPipe(channel->pipe);
 }
 
+/*
+    Hands the parent's end of \a channel's pipe over to the caller, who
+    becomes responsible for closing it. Data already buffered by QProcess
+    for that channel (read from stdout/stderr, or not yet written to stdin)
+    is moved into \a pending so that nothing is lost or reordered.
+    Returns -1 if the channel is not connected to a pipe.
+*/
+int QProcessPrivate::detachChannelPipe(Channel *channel, QByteArray *pending)
+{
+    const bool isStdin = (channel == &stdinChannel);
+    int &fd = channel->pipe[isStdin ? 1 : 0];
+    if (channel->type != Channel::Normal || fd == -1)
+        return -1;
+
+    delete channel->notifier;
+    channel->notifier = nullptr;
+
+    QRingBuffer *buffer = nullptr;
+    if (isStdin) {
+        if (!writeBuffers.isEmpty())
+            buffer = &writeBuffers[0];
+        channel->closed = true;
+    } else {
+        const int channelIdx = (channel == &stdoutChannel ? QProcess::StandardOutput
+                                                          : QProcess::StandardError);
+        if (readBuffers.size() > channelIdx)
+            buffer = &readBuffers[channelIdx];
+    }
+    pending->clear();
+    while (buffer && !buffer->isEmpty())
+        pending->append(buffer->read());
+
+    const int result = fd;
+    fd = -1;
+    return result;
+}
+
 /*
     Create the pipes to a QProcessPrivate::Channel.
 */
@@ -340,6 +405,67 @@ void QProcessPrivate::commitChannels()
     }
 }
 
+// Points envp at the entries of a QProcessEnvironmentPrivate::environmentBlock().
+static char **_q_environmentPointers(const QByteArray &block, int envc)
+{
+    char **envp = new char *[envc + 1];
+    char *entry = const_cast<char *>(block.constData());
+    for (int i = 0; i < envc; ++i) {
+        envp[i] = entry;
+        entry += strlen(entry) + 1;
+    }
+    envp[envc] = nullptr;
+    return envp;
+}
+
+namespace {
+// Searching PATH costs a stat() per directory for every start. Programs
+// are usually started again and again, so remember where they were found
+// for as long as PATH and the current directory, which relative entries
+// of PATH depend on, stay the same and the file is still executable.
+struct ProgramPathCache
+{
+    QMutex mutex;
+    QByteArray path;
+    QString currentDir;
+    QHash<QString, QByteArray> programs;
+};
+}
+
+Q_GLOBAL_STATIC(ProgramPathCache, programPathCache)
+
+static QByteArray findExecutable(const QString &program)
+{
+    const QByteArray path = qgetenv("PATH");
+    const QString currentDir = QDir::currentPath();
+    ProgramPathCache *cache = programPathCache();
+    if (cache) {
+        const QMutexLocker locker(&cache->mutex);
+        if (cache->path != path || cache->currentDir != currentDir) {
+            cache->path = path;
+            cache->currentDir = currentDir;
+            cache->programs.clear();
+        }
+        const auto it = cache->programs.constFind(program);
+        if (it != cache->programs.constEnd() && ::access(it->constData(), X_OK) == 0)
+            return *it;
+    }
+
+    const QString exeFilePath = QStandardPaths::findExecutable(program);
+    if (exeFilePath.isEmpty())
+        return QByteArray();
+    const QByteArray encoded = QFile::encodeName(exeFilePath);
+    if (cache) {
+        const QMutexLocker locker(&cache->mutex);
+        if (cache->path == path && cache->currentDir == currentDir) {
+            if (cache->programs.size() >= 256)
+                cache->programs.clear();
+            cache->programs.insert(program, encoded);
+        }
+    }
+    return encoded;
+}
+
 static char **_q_dupEnvironment(const QProcessEnvironmentPrivate::Map &environment, int *envc)
 {
     *envc = 0;
@@ -365,6 +491,38 @@ static char **_q_dupEnvironment(const QProcessEnvironmentPrivate::Map &environme
     return envp;
 }
 
+namespace {
+struct ChildStartInfo
+{
+    QProcessPrivate *d;
+    const char *workingDirectory;
+    char **argv;
+    char **envp;
+    const sigset_t *signalMask;
+};
+}
+
+// Runs in the child started by vforkfd(), which may share our memory.
+static int startChild(void *token)
+{
+    const ChildStartInfo *info = static_cast<ChildStartInfo *>(token);
+
+    // Drop the handlers inherited from the parent before unblocking signals.
+    for (int signal = 1; signal < NSIG; ++signal) {
+        struct sigaction action;
+        if (::sigaction(signal, nullptr, &action) == 0 && action.sa_handler != SIG_DFL
+            && action.sa_handler != SIG_IGN) {
+            action.sa_handler = SIG_DFL;
+            action.sa_flags = 0;
+            ::sigaction(signal, &action, nullptr);
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, info->signalMask, nullptr);
+
+    info->d->execChild(info->workingDirectory, info->argv, info->envp);
+    return -1;
+}
+
 void QProcessPrivate::startProcess()
 {
     Q_Q(QProcess);
@@ -428,11 +586,9 @@ void QProcessPrivate::startProcess()
     // Add the program name to the argument list.
     argv[0] = nullptr;
     if (!program.contains(QLatin1Char('/'))) {
-        const QString &exeFilePath = QStandardPaths::findExecutable(program);
-        if (!exeFilePath.isEmpty()) {
-            const QByteArray &tmp = QFile::encodeName(exeFilePath);
-            argv[0] = ::strdup(tmp.constData());
-        }
+        const QByteArray exeFilePath = findExecutable(program);
+        if (!exeFilePath.isEmpty())
+            argv[0] = ::strdup(exeFilePath.constData());
     }
     if (!argv[0])
         argv[0] = ::strdup(encodedProgramName.constData());
@@ -441,11 +597,14 @@ void QProcessPrivate::startProcess()
     for (int i = 0; i < arguments.count(); ++i)
         argv[i + 1] = ::strdup(QFile::encodeName(arguments.at(i)).constData());
 
-    // Duplicate the environment.
+    // Get the encoded environment; envp points into environmentBlock.
     int envc = 0;
     char **envp = nullptr;
+    QByteArray environmentBlock;
     if (environment.d.constData()) {
-        envp = _q_dupEnvironment(environment.d.constData()->vars, &envc);
+        environmentBlock = environment.d.constData()->environmentBlock(&envc);
+        if (envc)
+            envp = _q_environmentPointers(environmentBlock, envc);
     }
 
     // Encode the working directory if it's non-empty, otherwise just pass 0.
@@ -464,15 +623,28 @@ void QProcessPrivate::startProcess()
 #endif
 
     pid_t childPid;
-    forkfd = ::forkfd(ffdflags , &childPid);
-    int lastForkErrno = errno;
+    int lastForkErrno;
+    if (childProcessModifier) {
+        // The modifier may run arbitrary code, so it needs a real fork().
+        forkfd = ::forkfd(ffdflags , &childPid);
+        lastForkErrno = errno;
+    } else {
+        // The child shares our memory until it execs, which saves copying
+        // the page tables. Block all signals meanwhile: a handler running
+        // in the child would run on our memory.
+        sigset_t allSignals, oldSignalMask;
+        sigfillset(&allSignals);
+        pthread_sigmask(SIG_SETMASK, &allSignals, &oldSignalMask);
+        ChildStartInfo info = { this, workingDirPtr, argv, envp, &oldSignalMask };
+        forkfd = ::vforkfd(ffdflags, &childPid, startChild, &info);
+        lastForkErrno = errno;
+        pthread_sigmask(SIG_SETMASK, &oldSignalMask, nullptr);
+    }
     if (forkfd != FFD_CHILD_PROCESS) {
         // Parent process.
         // Clean up duplicated memory.
         for (int i = 0; i <= arguments.count(); ++i)
             free(argv[i]);
-        for (int i = 0; i < envc; ++i)
-            free(envp[i]);
         delete [] argv;
         delete [] envp;
     }
@@ -529,6 +701,17 @@ void QProcessPrivate::startProcess()
     }
     if (stderrChannel.pipe[0] != -1)
         ::fcntl(stderrChannel.pipe[0], F_SETFL, ::fcntl(stderrChannel.pipe[0], F_GETFL) | O_NONBLOCK);
+
+#ifdef F_SETPIPE_SZ
+    // Unbuffered readers expect bulk output; a larger pipe lets the child
+    // write more per wake-up. Failing to grow it is harmless.
+    if (openMode & QIODevice::Unbuffered) {
+        for (Channel *channel : { &stdoutChannel, &stderrChannel }) {
+            if (channel->pipe[0] != -1)
+                ::fcntl(channel->pipe[0], F_SETPIPE_SZ, 1024 * 1024);
+        }
+    }
+#endif
 }
 
 struct ChildError
@@ -573,11 +756,11 @@ void QProcessPrivate::execChild(const char *workingDir, char **argv, char **envp
 
     // notify failure
     // don't use strerror or any other routines that may allocate memory, since
-    // some buggy libc versions can deadlock on locked mutexes.
+    // some buggy libc versions can deadlock on locked mutexes. Don't modify
+    // any member either: the child may share its memory with the parent.
 report_errno:
     error.code = errno;
     qt_safe_write(childStartedPipe[1], &error, sizeof(error));
-    childStartedPipe[1] = -1;
 }
 
 bool QProcessPrivate::processStarted(QString *errorMessage)
@@ -0,0 +1,718 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qrecursivefilesystemwatcher_p.h"
+
+#include "qdir.h"
+#include "qfile.h"
+#include "qfileinfo.h"
+#include "qhash.h"
+#include "qmap.h"
+#include "qmutex.h"
+#include "qset.h"
+#include "qsocketnotifier.h"
+#include "qtimer.h"
+
+#include "private/qcore_unix_p.h"
+#include "private/qobject_p.h"
+#include "private/qparalleldirwalker_p.h"
+
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <sys/statfs.h>
+
+#if __has_include(<sys/fanotify.h>)
+#  include <sys/fanotify.h>
+#  if defined(FAN_REPORT_DFID_NAME) && defined(FAN_MARK_FILESYSTEM)
+#    define QT_RECURSIVEWATCHER_FANOTIFY
+#  endif
+#endif
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+    \class QRecursiveFileSystemWatcher
+    \inmodule QtCore
+    \since 6.1
+
+    \brief The QRecursiveFileSystemWatcher class watches whole directory
+    trees for changes.
+
+    QFileSystemWatcher needs every directory of a tree added separately, and
+    its inotify engine uses one watch per directory. A large tree runs into
+    the per-user limit on inotify watches and takes long to set up.
+
+    QRecursiveFileSystemWatcher watches everything below the paths passed to
+    addPath(), including directories that are created later. Changes are
+    collected for debounceInterval() milliseconds and then reported in one
+    pathsChanged() signal, so that a burst of changes costs one signal.
+
+    With the FanotifyBackend, the file systems containing the watched paths
+    are marked with fanotify, which reports every change with the handle of
+    the directory it happened in. The watcher only keeps a table from the
+    handles of the directories in the trees to their paths, and no kernel
+    resources per directory. Marking a file system needs CAP_SYS_ADMIN, and
+    Linux 5.9 for the directory entry names. If the first path cannot be
+    watched this way, the watcher falls back to the InotifyBackend, which
+    adds one inotify watch per directory; the directories are listed and
+    registered from the threads of a QParallelDirWalker.
+
+    This class is only available on Linux.
+*/
+
+/*!
+    \enum QRecursiveFileSystemWatcher::Backend
+
+    \value InotifyBackend One inotify watch per directory.
+    \value FanotifyBackend One fanotify mark per file system.
+*/
+
+/*!
+    \fn void QRecursiveFileSystemWatcher::pathsChanged(const QStringList &paths)
+
+    This signal is emitted with the sorted \a paths of the files and
+    directories that were created, removed, renamed or modified, or whose
+    attributes changed, since the last time. For a renamed entry, both the
+    old and the new path are reported. When directories are created, only
+    the directory itself is reported, not the entries created in it before
+    the watcher caught up.
+
+    If the kernel dropped events, the watched paths themselves are reported,
+    and the trees should be scanned again.
+*/
+
+static const int DefaultDebounceInterval = 50;
+
+static const quint32 InotifyMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO
+        | IN_MODIFY | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+#ifdef QT_RECURSIVEWATCHER_FANOTIFY
+static const quint64 FanotifyMask = FAN_CREATE | FAN_DELETE | FAN_MOVED_FROM | FAN_MOVED_TO
+        | FAN_MODIFY | FAN_ATTRIB | FAN_DELETE_SELF | FAN_MOVE_SELF | FAN_ONDIR;
+#endif
+
+class QRecursiveFileSystemWatcherPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QRecursiveFileSystemWatcher)
+
+public:
+    bool init(QRecursiveFileSystemWatcher::Backend preferredBackend);
+    void closeBackend();
+
+    bool addTree(const QString &path);
+    void removeTree(const QString &path);
+    QByteArray watchDirectory(const QString &path);
+    void insert(const QString &path, const QByteArray &id);
+    void forget(const QByteArray &id);
+
+    void readEvents();
+    void readInotifyEvents();
+#ifdef QT_RECURSIVEWATCHER_FANOTIFY
+    QByteArray markFileSystem(const QByteArray &nativePath, int mountId);
+    void unmarkUnusedFileSystems();
+    void readFanotifyEvents();
+#endif
+    void entryChanged(const QString &directory, const char *name, bool isDirectory,
+                      bool added, bool removed);
+    void directoryGone(const QString &directory);
+    void overflowed();
+    void addChange(const QString &path);
+    void emitChanges();
+
+    QRecursiveFileSystemWatcher::Backend backend = QRecursiveFileSystemWatcher::InotifyBackend;
+    int fd = -1;
+    QSocketNotifier *notifier = nullptr;
+    QTimer *debounceTimer = nullptr;
+    QStringList roots;
+    QSet<QString> changedPaths;
+    bool warnedAboutLimit = false;
+
+    // Guards the tables while the worker threads of a walk fill them in.
+    QMutex mutex;
+    // The inotify watch descriptor or the fanotify file handle of each
+    // watched directory, as bytes.
+    QHash<QByteArray, QString> idToPath;
+    QMap<QString, QByteArray> pathToId;
+#ifdef QT_RECURSIVEWATCHER_FANOTIFY
+    // The fsid of each mount whose file system is marked, and the path the
+    // mark was added through.
+    struct MarkedFileSystem
+    {
+        QByteArray fsid;
+        QByteArray nativePath;
+    };
+    QHash<int, MarkedFileSystem> markedMounts;
+#endif
+};
+
+static QByteArray inotifyId(int wd)
+{
+    return QByteArray(reinterpret_cast<const char *>(&wd), sizeof(wd));
+}
+
+#ifdef QT_RECURSIVEWATCHER_FANOTIFY
+static QByteArray fanotifyId(const void *fsid, const struct file_handle *handle)
+{
+    static_assert(sizeof(fsid_t) == sizeof(__kernel_fsid_t));
+    QByteArray id(sizeof(fsid_t) + sizeof(handle->handle_type) + handle->handle_bytes,
+                  Qt::Uninitialized);
+    char *at = id.data();
+    memcpy(at, fsid, sizeof(fsid_t));
+    at += sizeof(fsid_t);
+    memcpy(at, &handle->handle_type, sizeof(handle->handle_type));
+    at += sizeof(handle->handle_type);
+    memcpy(at, handle->f_handle, handle->handle_bytes);
+    return id;
+}
+#endif
+
+static bool isBelow(const QString &path, const QString &directory)
+{
+    return path.size() > directory.size() && path.startsWith(directory)
+            && (directory.endsWith(QLatin1Char('/')) || path.at(directory.size()) == QLatin1Char('/'));
+}
+
+bool QRecursiveFileSystemWatcherPrivate::init(QRecursiveFileSystemWatcher::Backend preferredBackend)
+{
+    Q_Q(QRecursiveFileSystemWatcher);
+    closeBackend();
+
+#ifdef QT_RECURSIVEWATCHER_FANOTIFY
+    if (preferredBackend == QRecursiveFileSystemWatcher::FanotifyBackend) {
+        fd = fanotify_init(FAN_CLASS_NOTIF | FAN_CLOEXEC | FAN_NONBLOCK | FAN_REPORT_DFID_NAME,
+                           O_RDONLY);
+        if (fd != -1)
+            backend = QRecursiveFileSystemWatcher::FanotifyBackend;
+    }
+#else
+    Q_UNUSED(preferredBackend);
+#endif
+    if (fd == -1) {
+        fd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+        if (fd == -1) {
+            qErrnoWarning("QRecursiveFileSystemWatcher: inotify_init1 failed");
+            return false;
+        }
+        backend = QRecursiveFileSystemWatcher::InotifyBackend;
+    }
+
+    notifier = new QSocketNotifier(fd, QSocketNotifier::Read, q);
+    QObject::connect(notifier, &QSocketNotifier::activated, q, [this] { readEvents(); });
+    return true;
+}
+
+void QRecursiveFileSystemWatcherPrivate::closeBackend()
+{
+    delete notifier;
+    notifier = nullptr;
+    if (fd != -1)
+        qt_safe_close(fd);
+    fd = -1;
+    idToPath.clear();
+    pathToId.clear();
+#ifdef QT_RECURSIVEWATCHER_FANOTIFY
+    markedMounts.clear();
+#endif
+}
+
+// Watches \a path and all directories below it. The directories are
+// listed, and registered batch by batch, from several threads.
+bool QRecursiveFileSystemWatcherPrivate::addTree(const QString &path)
+{
+    const QByteArray rootId = watchDirectory(path);
+    if (rootId.isEmpty())
+        return false;
+    insert(path, rootId);
+
+    QParallelDirWalker walker(path, QDir::Dirs | QDir::Hidden | QDir::NoSymLinks);
+    walker.walk([this](const QFileInfoList &entries) {
+        QVarLengthArray<std::pair<QString, QByteArray>, 64> watched;
+        for (const QFileInfo &entry : entries) {
+            QString directory = entry.filePath();
+            QByteArray id = watchDirectory(directory);
+            if (!id.isEmpty())
+                watched.append({ std::move(directory), std::move(id) });
+        }
+        QMutexLocker locker(&mutex);
+        for (const auto &[directory, id] : watched)
+            insert(directory, id);
+    });
+    return true;
+}
+
+// Stops watching \a path and everything below it.
+void QRecursiveFileSystemWatcherPrivate::removeTree(const QString &path)
+{
+    const auto forgetEntry = [this](QMap<QString, QByteArray>::iterator it) {
+        const QByteArray &id = it.value();
+        const auto idIt = idToPath.find(id);
+        if (idIt != idToPath.end() && *idIt == it.key()) {
+            if (backend == QRecursiveFileSystemWatcher::InotifyBackend) {
+                int wd;
+                memcpy(&wd, id.constData(), sizeof(wd));
+                inotify_rm_watch(fd, wd);
+            }
+            idToPath.erase(idIt);
+        }
+        return pathToId.erase(it);
+    };
+
+    auto it = pathToId.find(path);
+    if (it != pathToId.end())
+        forgetEntry(it);
+
+    // Everything below path is one range in the map; entries like
+    // "path-1" sort between path and its children.
+    const QString prefix = path.endsWith(QLatin1Char('/')) ? path : path + QLatin1Char('/');
+    it = pathToId.lowerBound(prefix);
+    while (it != pathToId.end() && it.key().startsWith(prefix))
+        it = forgetEntry(it);
+}
+
+// Called with the mutex locked, or from the thread of the watcher while
+// no walk is in progress.
+void QRecursiveFileSystemWatcherPrivate::insert(const QString &path, const QByteArray &id)
+{
+    idToPath.insert(id, path);
+    pathToId.insert(path, id);
+}
+
+// Forgets the directory whose watch the kernel has removed.
+void QRecursiveFileSystemWatcherPrivate::forget(const QByteArray &id)
+{
+    const QString path = idToPath.take(id);
+    const auto it = pathToId.find(path);
+    if (it != pathToId.end() && *it == id)
+        pathToId.erase(it);
+}
+
+// Starts watching the directory \a path and returns the id that its events
+// will carry. This is called from the threads of a walk.
+QByteArray QRecursiveFileSystemWatcherPrivate::watchDirectory(const QString &path)
+{
+    const QByteArray nativePath = QFile::encodeName(path);
+#ifdef QT_RECURSIVEWATCHER_FANOTIFY
+    if (backend == QRecursiveFileSystemWatcher::FanotifyBackend) {
+        alignas(struct file_handle) char storage[sizeof(struct file_handle) + MAX_HANDLE_SZ];
+        auto handle = reinterpret_cast<struct file_handle *>(storage);
+        handle->handle_bytes = MAX_HANDLE_SZ;
+        int mountId;
+        if (name_to_handle_at(AT_FDCWD, nativePath.constData(), handle, &mountId,
+                              AT_SYMLINK_FOLLOW) != 0) {
+            return QByteArray();
+        }
+
+        QByteArray fsid;
+        {
+            QMutexLocker locker(&mutex);
+            fsid = markedMounts.value(mountId).fsid;
+        }
+        if (fsid.isNull())
+            fsid = markFileSystem(nativePath, mountId);
+        if (fsid.isNull())
+            return QByteArray();
+        return fanotifyId(fsid.constData(), handle);
+    }
+#endif
+
+    const int wd = inotify_add_watch(fd, nativePath.constData(), InotifyMask);
+    if (wd == -1) {
+        if (errno == ENOSPC) {
+            QMutexLocker locker(&mutex);
+            if (!warnedAboutLimit) {
+                warnedAboutLimit = true;
+                qWarning("QRecursiveFileSystemWatcher: out of inotify watches, see "
+                         "/proc/sys/fs/inotify/max_user_watches");
+            }
+        }
+        return QByteArray();
+    }
+    return inotifyId(wd);
+}
+
+#ifdef QT_RECURSIVEWATCHER_FANOTIFY
+// Marks the file system that \a nativePath is on, so that all changes on it
+// are reported, and returns its fsid.
+QByteArray QRecursiveFileSystemWatcherPrivate::markFileSystem(const QByteArray &nativePath,
+                                                              int mountId)
+{
+    struct statfs buffer;
+    if (statfs(nativePath.constData(), &buffer) != 0)
+        return QByteArray();
+    if (fanotify_mark(fd, FAN_MARK_ADD | FAN_MARK_FILESYSTEM, FanotifyMask, AT_FDCWD,
+                      nativePath.constData()) != 0) {
+        return QByteArray();
+    }
+    const QByteArray fsid(reinterpret_cast<const char *>(&buffer.f_fsid), sizeof(buffer.f_fsid));
+    QMutexLocker locker(&mutex);
+    markedMounts.insert(mountId, { fsid, nativePath });
+    return fsid;
+}
+
+// Removes the marks of the file systems that no watched directory is on
+// any more. If the path a mark was added through is gone, the mark stays
+// until the watcher is destroyed; its events are then simply not in the
+// tables.
+void QRecursiveFileSystemWatcherPrivate::unmarkUnusedFileSystems()
+{
+    if (backend != QRecursiveFileSystemWatcher::FanotifyBackend)
+        return;
+
+    QSet<QByteArray> usedFsids;
+    for (const QByteArray &id : qAsConst(pathToId))
+        usedFsids.insert(id.left(sizeof(fsid_t)));
+
+    QSet<QByteArray> unmarked;
+    for (auto it = markedMounts.begin(); it != markedMounts.end();) {
+        if (usedFsids.contains(it->fsid)) {
+            ++it;
+            continue;
+        }
+        // several mounts can show the same file system
+        if (!unmarked.contains(it->fsid)) {
+            fanotify_mark(fd, FAN_MARK_REMOVE | FAN_MARK_FILESYSTEM, FanotifyMask, AT_FDCWD,
+                          it->nativePath.constData());
+            unmarked.insert(it->fsid);
+        }
+        it = markedMounts.erase(it);
+    }
+}
+#endif
+
+void QRecursiveFileSystemWatcherPrivate::readEvents()
+{
+#ifdef QT_RECURSIVEWATCHER_FANOTIFY
+    if (backend == QRecursiveFileSystemWatcher::FanotifyBackend) {
+        readFanotifyEvents();
+        return;
+    }
+#endif
+    readInotifyEvents();
+}
+
+void QRecursiveFileSystemWatcherPrivate::readInotifyEvents()
+{
+    alignas(struct inotify_event) char buffer[64 * 1024];
+    ssize_t size;
+    while ((size = qt_safe_read(fd, buffer, sizeof(buffer))) > 0) {
+        for (const char *at = buffer; at < buffer + size;) {
+            const auto event = reinterpret_cast<const struct inotify_event *>(at);
+            at += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                overflowed();
+                continue;
+            }
+            const QByteArray id = inotifyId(event->wd);
+            const auto it = idToPath.constFind(id);
+            if (it == idToPath.constEnd())
+                continue;
+            const QString directory = *it;
+
+            if (event->mask & IN_IGNORED) {
+                forget(id);
+            } else if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+                directoryGone(directory);
+            } else {
+                entryChanged(directory, event->len ? event->name : nullptr,
+                             event->mask & IN_ISDIR, event->mask & (IN_CREATE | IN_MOVED_TO),
+                             event->mask & (IN_DELETE | IN_MOVED_FROM));
+            }
+        }
+    }
+}
+
+#ifdef QT_RECURSIVEWATCHER_FANOTIFY
+void QRecursiveFileSystemWatcherPrivate::readFanotifyEvents()
+{
+    alignas(struct fanotify_event_metadata) char buffer[64 * 1024];
+    ssize_t size;
+    while ((size = qt_safe_read(fd, buffer, sizeof(buffer))) > 0) {
+        auto metadata = reinterpret_cast<struct fanotify_event_metadata *>(buffer);
+        for (; FAN_EVENT_OK(metadata, size); metadata = FAN_EVENT_NEXT(metadata, size)) {
+            if (metadata->vers != FANOTIFY_METADATA_VERSION)
+                return;
+            if (metadata->fd >= 0)
+                qt_safe_close(metadata->fd);
+            if (metadata->mask & FAN_Q_OVERFLOW) {
+                overflowed();
+                continue;
+            }
+
+            const char *record = reinterpret_cast<const char *>(metadata) + metadata->metadata_len;
+            const char *end = reinterpret_cast<const char *>(metadata) + metadata->event_len;
+            while (record < end) {
+                const auto info = reinterpret_cast<const struct fanotify_event_info_fid *>(record);
+                if (info->hdr.len == 0)
+                    break;
+                record += info->hdr.len;
+                const int type = info->hdr.info_type;
+                if (type != FAN_EVENT_INFO_TYPE_DFID_NAME && type != FAN_EVENT_INFO_TYPE_DFID
+                    && type != FAN_EVENT_INFO_TYPE_FID) {
+                    continue;
+                }
+
+                const auto handle = reinterpret_cast<const struct file_handle *>(info->handle);
+                const auto it = idToPath.constFind(fanotifyId(&info->fsid, handle));
+                if (it == idToPath.constEnd())
+                    break;
+                const QString directory = *it;
+
+                if (metadata->mask & (FAN_DELETE_SELF | FAN_MOVE_SELF)) {
+                    directoryGone(directory);
+                } else {
+                    const char *name = type == FAN_EVENT_INFO_TYPE_DFID_NAME
+                            ? reinterpret_cast<const char *>(handle->f_handle) + handle->handle_bytes
+                            : nullptr;
+                    entryChanged(directory, name, metadata->mask & FAN_ONDIR,
+                                 metadata->mask & (FAN_CREATE | FAN_MOVED_TO),
+                                 metadata->mask & (FAN_DELETE | FAN_MOVED_FROM));
+                }
+                break;
+            }
+        }
+    }
+}
+#endif
+
+// Something happened to \a name in \a directory, or to \a directory itself
+// if \a name is null.
+void QRecursiveFileSystemWatcherPrivate::entryChanged(const QString &directory, const char *name,
+                                                      bool isDirectory, bool added, bool removed)
+{
+    if (!name || !*name || qstrcmp(name, ".") == 0) {
+        addChange(directory);
+        return;
+    }
+
+    QString path = directory;
+    if (!path.endsWith(QLatin1Char('/')))
+        path += QLatin1Char('/');
+    path += QFile::decodeName(name);
+    addChange(path);
+
+    if (isDirectory) {
+        if (removed)
+            removeTree(path);
+        if (added)
+            addTree(path);
+    }
+}
+
+// A watched directory was deleted or moved away. Below a watched path,
+// that is reported by the parent as well; a watched path itself stops
+// being watched.
+void QRecursiveFileSystemWatcherPrivate::directoryGone(const QString &directory)
+{
+    if (!roots.contains(directory))
+        return;
+    addChange(directory);
+    removeTree(directory);
+    roots.removeOne(directory);
+#ifdef QT_RECURSIVEWATCHER_FANOTIFY
+    unmarkUnusedFileSystems();
+#endif
+}
+
+void QRecursiveFileSystemWatcherPrivate::overflowed()
+{
+    for (const QString &root : qAsConst(roots))
+        addChange(root);
+}
+
+void QRecursiveFileSystemWatcherPrivate::addChange(const QString &path)
+{
+    changedPaths.insert(path);
+    if (!debounceTimer->isActive())
+        debounceTimer->start();
+}
+
+void QRecursiveFileSystemWatcherPrivate::emitChanges()
+{
+    Q_Q(QRecursiveFileSystemWatcher);
+    if (changedPaths.isEmpty())
+        return;
+    QStringList paths = changedPaths.values();
+    changedPaths.clear();
+    paths.sort();
+    emit q->pathsChanged(paths);
+}
+
+/*!
+    Constructs a watcher with the given \a parent that uses the
+    \a preferredBackend if it is available.
+*/
+QRecursiveFileSystemWatcher::QRecursiveFileSystemWatcher(Backend preferredBackend,
+                                                         QObject *parent)
+    : QObject(*new QRecursiveFileSystemWatcherPrivate, parent)
+{
+    Q_D(QRecursiveFileSystemWatcher);
+    d->debounceTimer = new QTimer(this);
+    d->debounceTimer->setSingleShot(true);
+    d->debounceTimer->setInterval(DefaultDebounceInterval);
+    connect(d->debounceTimer, &QTimer::timeout, this, [d] { d->emitChanges(); });
+    d->init(preferredBackend);
+}
+
+/*!
+    Destroys the watcher.
+*/
+QRecursiveFileSystemWatcher::~QRecursiveFileSystemWatcher()
+{
+    Q_D(QRecursiveFileSystemWatcher);
+    d->closeBackend();
+}
+
+/*!
+    Returns \c true if the watcher could be set up.
+*/
+bool QRecursiveFileSystemWatcher::isValid() const
+{
+    Q_D(const QRecursiveFileSystemWatcher);
+    return d->fd != -1;
+}
+
+/*!
+    Returns the backend in use.
+*/
+QRecursiveFileSystemWatcher::Backend QRecursiveFileSystemWatcher::backend() const
+{
+    Q_D(const QRecursiveFileSystemWatcher);
+    return d->backend;
+}
+
+/*!
+    Watches the directory \a path and everything below it. Symlinks are
+    not followed. Returns \c false if \a path is not a directory or could
+    not be watched. If some of the directories below \a path cannot be
+    watched, for instance because of the inotify limit, the rest is still
+    watched and \c true is returned.
+*/
+bool QRecursiveFileSystemWatcher::addPath(const QString &path)
+{
+    Q_D(QRecursiveFileSystemWatcher);
+    if (d->fd == -1)
+        return false;
+
+    const QFileInfo fileInfo(path);
+    if (!fileInfo.isDir())
+        return false;
+    const QString directory = QDir::cleanPath(fileInfo.absoluteFilePath());
+    if (d->roots.contains(directory))
+        return true;
+
+    if (!d->addTree(directory)) {
+        // The file system may not support file handles, or marking it may
+        // need privileges we don't have.
+        if (d->backend != FanotifyBackend || !d->roots.isEmpty() || !d->init(InotifyBackend)
+            || !d->addTree(directory)) {
+            return false;
+        }
+    }
+    d->roots.append(directory);
+    return true;
+}
+
+/*!
+    Stops watching the tree at \a path, which must have been passed to
+    addPath() before.
+*/
+bool QRecursiveFileSystemWatcher::removePath(const QString &path)
+{
+    Q_D(QRecursiveFileSystemWatcher);
+    const QString directory = QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+    if (!d->roots.removeOne(directory))
+        return false;
+
+    d->removeTree(directory);
+    // Restore what other trees overlapping with this one still need.
+    for (const QString &root : qAsConst(d->roots)) {
+        if (isBelow(root, directory))
+            d->addTree(root);
+        else if (isBelow(directory, root))
+            d->addTree(directory);
+    }
+#ifdef QT_RECURSIVEWATCHER_FANOTIFY
+    d->unmarkUnusedFileSystems();
+#endif
+    return true;
+}
+
+/*!
+    Returns the paths passed to addPath() that are being watched.
+*/
+QStringList QRecursiveFileSystemWatcher::paths() const
+{
+    Q_D(const QRecursiveFileSystemWatcher);
+    return d->roots;
+}
+
+/*!
+    Returns the number of directories being watched.
+*/
+qsizetype QRecursiveFileSystemWatcher::watchedDirectoryCount() const
+{
+    Q_D(const QRecursiveFileSystemWatcher);
+    return d->pathToId.size();
+}
+
+/*!
+    Returns the time in milliseconds that changes are collected for before
+    pathsChanged() is emitted. The default is 50.
+*/
+int QRecursiveFileSystemWatcher::debounceInterval() const
+{
+    Q_D(const QRecursiveFileSystemWatcher);
+    return d->debounceTimer->interval();
+}
+
+/*!
+    Sets the time that changes are collected for to \a msecs.
+*/
+void QRecursiveFileSystemWatcher::setDebounceInterval(int msecs)
+{
+    Q_D(QRecursiveFileSystemWatcher);
+    d->debounceTimer->setInterval(msecs);
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qrecursivefilesystemwatcher_p.cpp"
@@ -1188,6 +1188,7 @@ void QConfFileSettingsPrivate::remove(const QString &key)
     }
     if (confFile->originalKeys.contains(theKey))
         confFile->removedKeys.insert(theKey, QVariant());
+    confFile->keysChanged();
 }
 
 void QConfFileSettingsPrivate::set(const QString &key, const QVariant &value)
@@ -1202,6 +1203,34 @@ void QConfFileSettingsPrivate::set(const QString &key, const QVariant &value)
     const auto locker = qt_scoped_lock(confFile->mutex);
     confFile->removedKeys.remove(theKey);
     confFile->addedKeys.insert(theKey, value);
+    confFile->keysChanged();
+}
+
+/*
+    Returns the snapshot of the keys of confFiles[index]. The snapshot cached
+    in this object is reused without locking as long as the generation of the
+    file is unchanged, so repeated reads of settings that are not being
+    modified never touch the file's mutex.
+*/
+const QConfFileSnapshot *QConfFileSettingsPrivate::snapshot(qsizetype index) const
+{
+    QConfFile *confFile = confFiles.at(index);
+    if (snapshots.size() != confFiles.size())
+        snapshots.resize(confFiles.size());
+    QExplicitlySharedDataPointer<const QConfFileSnapshot> &cached = snapshots[index];
+    if (cached && cached->generation == confFile->generation.loadAcquire())
+        return cached.data();
+
+    const auto locker = qt_scoped_lock(confFile->mutex);
+    if (!confFile->snapshot) {
+        ensureAllSectionsParsed(confFile);
+        QConfFileSnapshot *s = new QConfFileSnapshot;
+        s->keys = confFile->mergedKeyMap();
+        s->generation = confFile->generation.loadRelaxed();
+        confFile->snapshot.reset(s);
+    }
+    cached = confFile->snapshot;
+    return cached.data();
 }
 
 bool QConfFileSettingsPrivate::get(const QString &key, QVariant *value) const
@@ -1210,6 +1239,21 @@ bool QConfFileSettingsPrivate::get(const QString &key, QVariant *value) const
     ParsedSettingsMap::const_iterator j;
     bool found = false;
 
+    if (snapshotReads) {
+        for (qsizetype i = 0; i < confFiles.size(); ++i) {
+            const ParsedSettingsMap &keys = snapshot(i)->keys;
+            j = keys.constFind(theKey);
+            if (j != keys.constEnd()) {
+                if (value)
+                    *value = *j;
+                return true;
+            }
+            if (!fallbacks)
+                break;
+        }
+        return false;
+    }
+
     for (auto confFile : qAsConst(confFiles)) {
         const auto locker = qt_scoped_lock(confFile->mutex);
 
@@ -1243,31 +1287,41 @@ QStringList QConfFileSettingsPrivate::children(const QString &prefix, ChildSpec
     QSettingsKey thePrefix(prefix, caseSensitivity);
     int startPos = prefix.size();
 
-    for (auto confFile : qAsConst(confFiles)) {
-        const auto locker = qt_scoped_lock(confFile->mutex);
-
-        if (thePrefix.isEmpty())
-            ensureAllSectionsParsed(confFile);
-        else
-            ensureSectionParsed(confFile, thePrefix);
-
-        j = const_cast<const ParsedSettingsMap *>(
-                &confFile->originalKeys)->lowerBound( thePrefix);
-        while (j != confFile->originalKeys.constEnd() && j.key().startsWith(thePrefix)) {
-            if (!confFile->removedKeys.contains(j.key()))
+    if (snapshotReads) {
+        for (qsizetype i = 0; i < confFiles.size(); ++i) {
+            const ParsedSettingsMap &keys = snapshot(i)->keys;
+            for (j = keys.lowerBound(thePrefix); j != keys.constEnd() && j.key().startsWith(thePrefix); ++j)
                 processChild(QStringView{j.key().originalCaseKey()}.mid(startPos), spec, result);
-            ++j;
+            if (!fallbacks)
+                break;
         }
+    } else {
+        for (auto confFile : qAsConst(confFiles)) {
+            const auto locker = qt_scoped_lock(confFile->mutex);
+
+            if (thePrefix.isEmpty())
+                ensureAllSectionsParsed(confFile);
+            else
+                ensureSectionParsed(confFile, thePrefix);
+
+            j = const_cast<const ParsedSettingsMap *>(
+                    &confFile->originalKeys)->lowerBound( thePrefix);
+            while (j != confFile->originalKeys.constEnd() && j.key().startsWith(thePrefix)) {
+                if (!confFile->removedKeys.contains(j.key()))
+                    processChild(QStringView{j.key().originalCaseKey()}.mid(startPos), spec, result);
+                ++j;
+            }
 
-        j = const_cast<const ParsedSettingsMap *>(
-                &confFile->addedKeys)->lowerBound(thePrefix);
-        while (j != confFile->addedKeys.constEnd() && j.key().startsWith(thePrefix)) {
-            processChild(QStringView{j.key().originalCaseKey()}.mid(startPos), spec, result);
-            ++j;
-        }
+            j = const_cast<const ParsedSettingsMap *>(
+                    &confFile->addedKeys)->lowerBound(thePrefix);
+            while (j != confFile->addedKeys.constEnd() && j.key().startsWith(thePrefix)) {
+                processChild(QStringView{j.key().originalCaseKey()}.mid(startPos), spec, result);
+                ++j;
+            }
 
-        if (!fallbacks)
-            break;
+            if (!fallbacks)
+                break;
+        }
     }
     std::sort(result.begin(), result.end());
     result.erase(std::unique(result.begin(), result.end()),
@@ -1287,6 +1341,7 @@ void QConfFileSettingsPrivate::clear()
     ensureAllSectionsParsed(confFile);
     confFile->addedKeys.clear();
     confFile->removedKeys = confFile->originalKeys;
+    confFile->keysChanged();
 }
 
 void QConfFileSettingsPrivate::sync()
@@ -1416,6 +1471,7 @@ void QConfFileSettingsPrivate::syncConfFile(QConfFile *confFile)
 
         confFile->size = fileInfo.size();
         confFile->timeStamp = fileInfo.lastModified();
+        confFile->keysChanged();
     }
 
     /*
@@ -2864,6 +2920,51 @@ void QSettings::setAtomicSyncRequired(bool enable)
     d->atomicSyncOnly = enable;
 }
 
+/*!
+    \since 6.1
+
+    Returns \c true if reading settings through this QSettings object uses
+    snapshots of the settings file; otherwise returns \c false.
+
+    \sa setSnapshotReadingEnabled()
+*/
+bool QSettings::isSnapshotReadingEnabled() const
+{
+    Q_D(const QSettings);
+    return d->snapshotReads;
+}
+
+/*!
+    \since 6.1
+
+    Configures whether value(), contains(), allKeys(), childKeys() and
+    childGroups() read from an immutable snapshot of the settings file.
+    The default is \c false.
+
+    The settings of a file are shared between all QSettings objects using it
+    within the process and are normally protected by a mutex that every read
+    has to acquire. With \a enable set to \c true, this object instead keeps
+    a reference to a fully parsed copy of the settings, which it reads without
+    any locking for as long as the settings are not modified, by this or any
+    other QSettings object, or reloaded by sync(). After a modification, the
+    next read builds a new snapshot.
+
+    This makes repeated reads from many threads, each using its own QSettings
+    object, scale well. It is however slower for code that alternates writing
+    and reading settings, as each write invalidates the snapshot, and the
+    whole file is parsed on the first read rather than one group at a time.
+
+    This only applies to file-based formats; reading from the native
+    settings store on Windows and \macos is not affected.
+
+    \sa isSnapshotReadingEnabled(), sync()
+*/
+void QSettings::setSnapshotReadingEnabled(bool enable)
+{
+    Q_D(QSettings);
+    d->snapshotReads = enable;
+}
+
 /*!
     Appends \a prefix to the current group.
 
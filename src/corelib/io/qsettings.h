@@ -149,6 +149,8 @@ public:
     Status status() const;
     bool isAtomicSyncRequired() const;
     void setAtomicSyncRequired(bool enable);
+    bool isSnapshotReadingEnabled() const;
+    void setSnapshotReadingEnabled(bool enable);
 
     void beginGroup(const QString &prefix);
     void endGroup();
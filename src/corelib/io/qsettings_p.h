@@ -54,6 +54,7 @@
 #include "QtCore/qdatetime.h"
 #include "QtCore/qmap.h"
 #include "QtCore/qmutex.h"
+#include "QtCore/qshareddata.h"
 #include "QtCore/qiodevice.h"
 #include "QtCore/qstack.h"
 #include "QtCore/qstringlist.h"
@@ -147,6 +148,18 @@ inline QString QSettingsGroup::toString() const
     return result;
 }
 
+/*
+    An immutable copy of all keys of a QConfFile, with the pending changes
+    applied. QConfFileSettingsPrivate keeps a reference to one per file and
+    uses it for reads for as long as the file's generation does not change.
+*/
+class QConfFileSnapshot : public QSharedData
+{
+public:
+    ParsedSettingsMap keys;
+    int generation;
+};
+
 class Q_AUTOTEST_EXPORT QConfFile
 {
 public:
@@ -169,6 +182,16 @@ public:
     QMutex mutex;
     bool userPerms;
 
+    // Incremented, with mutex held, whenever the keys change; read without it.
+    QAtomicInt generation;
+    QExplicitlySharedDataPointer<const QConfFileSnapshot> snapshot;
+
+    void keysChanged()
+    {
+        snapshot.reset();
+        generation.fetchAndAddRelease(1);
+    }
+
 private:
 #ifdef Q_DISABLE_COPY
     QConfFile(const QConfFile &);
@@ -247,6 +270,7 @@ protected:
     bool fallbacks;
     bool pendingChanges;
     bool atomicSyncOnly = true;
+    bool snapshotReads = false;
     mutable QSettings::Status status;
 };
 
@@ -291,8 +315,10 @@ private:
 #endif
     void ensureAllSectionsParsed(QConfFile *confFile) const;
     void ensureSectionParsed(QConfFile *confFile, const QSettingsKey &key) const;
+    const QConfFileSnapshot *snapshot(qsizetype index) const;
 
     QList<QConfFile *> confFiles;
+    mutable QList<QExplicitlySharedDataPointer<const QConfFileSnapshot>> snapshots;
     QSettings::ReadFunc readFunc;
     QSettings::WriteFunc writeFunc;
     QString extension;
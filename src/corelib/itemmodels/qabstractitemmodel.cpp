@@ -54,6 +54,8 @@
 #include <qdatetime.h>
 #include <qloggingcategory.h>
 
+#include <algorithm>
+#include <iterator>
 #include <limits.h>
 
 QT_BEGIN_NAMESPACE
@@ -65,13 +67,14 @@ QPersistentModelIndexData *QPersistentModelIndexData::create(const QModelIndex &
     Q_ASSERT(index.isValid()); // we will _never_ insert an invalid index in the list
     QPersistentModelIndexData *d = nullptr;
     QAbstractItemModel *model = const_cast<QAbstractItemModel *>(index.model());
-    QMultiHash<QModelIndex, QPersistentModelIndexData *> &indexes = model->d_func()->persistent.indexes;
+    auto &indexes = model->d_func()->persistent.indexes;
     const auto it = indexes.constFind(index);
     if (it != indexes.cend()) {
         d = (*it);
     } else {
         d = new QPersistentModelIndexData(index);
         indexes.insert(index, d);
+        model->d_func()->persistent.addSibling(d);
     }
     Q_ASSERT(d);
     return d;
@@ -746,9 +749,13 @@ QAbstractItemModel *QAbstractItemModelPrivate::staticEmptyModel()
 
 void QAbstractItemModelPrivate::invalidatePersistentIndexes()
 {
-    for (QPersistentModelIndexData *data : qAsConst(persistent.indexes))
+    for (QPersistentModelIndexData *data : qAsConst(persistent.indexes)) {
         data->index = QModelIndex();
+        data->siblings = nullptr;
+    }
     persistent.indexes.clear();
+    qDeleteAll(persistent.siblings);
+    persistent.siblings.clear();
 }
 
 /*!
@@ -761,6 +768,7 @@ void QAbstractItemModelPrivate::invalidatePersistentIndex(const QModelIndex &ind
     if (it != persistent.indexes.cend()) {
         QPersistentModelIndexData *data = *it;
         persistent.indexes.erase(it);
+        persistent.removeSibling(data);
         data->index = QModelIndex();
     }
 }
@@ -871,6 +879,7 @@ void QAbstractItemModelPrivate::removePersistentIndexData(QPersistentModelIndexD
         // This assert may happen if the model use changePersistentIndex in a way that could result on two
         // QPersistentModelIndex pointing to the same index.
         Q_UNUSED(removed);
+        persistent.removeSibling(data);
     }
     // make sure our optimization still works
     for (int i = persistent.moved.count() - 1; i >= 0; --i) {
@@ -893,12 +902,13 @@ void QAbstractItemModelPrivate::rowsAboutToBeInserted(const QModelIndex &parent,
     Q_Q(QAbstractItemModel);
     Q_UNUSED(last);
     QList<QPersistentModelIndexData *> persistent_moved;
+    persistent.updateSiblingParents();
     if (first < q->rowCount(parent)) {
-        for (auto *data : qAsConst(persistent.indexes)) {
-            const QModelIndex &index = data->index;
-            if (index.row() >= first && index.isValid() && index.parent() == parent) {
-                persistent_moved.append(data);
-            }
+        if (const auto *siblings = persistent.siblings.value(parent)) {
+            const auto end = siblings->indexes.cend();
+            auto it = siblings->indexes.lower_bound(first);
+            for (; it != end; ++it)
+                persistent_moved.append(*it);
         }
     }
     persistent.moved.push(persistent_moved);
@@ -914,8 +924,10 @@ void QAbstractItemModelPrivate::rowsInserted(const QModelIndex &parent,
         persistent.indexes.erase(persistent.indexes.constFind(old));
         data->index = q_func()->index(old.row() + count, old.column(), parent);
         if (data->index.isValid()) {
+            // still in the same place among its siblings
             persistent.insertMultiAtEnd(data->index, data);
         } else {
+            persistent.removeSibling(data);
             qWarning() << "QAbstractItemModel::endInsertRows:  Invalid index (" << old.row() + count << ',' << old.column() << ") in model" << q_func();
         }
     }
@@ -930,9 +942,18 @@ void QAbstractItemModelPrivate::itemsAboutToBeMoved(const QModelIndex &srcParent
     const bool sameParent = (srcParent == destinationParent);
     const bool movingUp = (srcFirst > destinationChild);
 
-    for (auto *data : qAsConst(persistent.indexes)) {
+    QList<QPersistentModelIndexData *> candidates;
+    persistent.updateSiblingParents();
+    if (const auto *siblings = persistent.siblings.value(srcParent))
+        std::copy(siblings->indexes.cbegin(), siblings->indexes.cend(), std::back_inserter(candidates));
+    if (!sameParent) {
+        if (const auto *siblings = persistent.siblings.value(destinationParent))
+            std::copy(siblings->indexes.cbegin(), siblings->indexes.cend(), std::back_inserter(candidates));
+    }
+
+    for (auto *data : qAsConst(candidates)) {
         const QModelIndex &index = data->index;
-        const QModelIndex &parent = index.parent();
+        const QModelIndex &parent = data->siblings->parent;
         const bool isSourceIndex = (parent == srcParent);
         const bool isDestinationIndex = (parent == destinationParent);
 
@@ -1016,9 +1037,23 @@ void QAbstractItemModelPrivate::itemsMoved(const QModelIndex &sourceParent, int
     const int source_change = (!sameParent || !movingUp) ? -1*(sourceLast - sourceFirst + 1) : sourceLast - sourceFirst + 1 ;
     const int destination_change = sourceLast - sourceFirst + 1;
 
+    // the moved indexes change places among their siblings, so take them out
+    // until all of them have moved
+    for (const auto *moved : {&moved_explicitly, &moved_in_source, &moved_in_destination}) {
+        for (auto *data : *moved)
+            persistent.removeSibling(data);
+    }
+
     movePersistentIndexes(moved_explicitly, explicit_change, destinationParent, orientation);
     movePersistentIndexes(moved_in_source, source_change, sourceParent, orientation);
     movePersistentIndexes(moved_in_destination, destination_change, destinationParent, orientation);
+
+    for (const auto *moved : {&moved_explicitly, &moved_in_source, &moved_in_destination}) {
+        for (auto *data : *moved) {
+            if (data->index.isValid())
+                persistent.addSibling(data);
+        }
+    }
 }
 
 void QAbstractItemModelPrivate::rowsAboutToBeRemoved(const QModelIndex &parent,
@@ -1026,22 +1061,30 @@ void QAbstractItemModelPrivate::rowsAboutToBeRemoved(const QModelIndex &parent,
 {
     QList<QPersistentModelIndexData *> persistent_moved;
     QList<QPersistentModelIndexData *> persistent_invalidated;
+    persistent.updateSiblingParents();
     // find the persistent indexes that are affected by the change, either by being in the removed subtree
     // or by being on the same level and below the removed rows
-    for (auto *data : qAsConst(persistent.indexes)) {
-        bool level_changed = false;
-        QModelIndex current = data->index;
+    for (const auto *siblings : qAsConst(persistent.siblings)) {
+        if (siblings->parent == parent) { // on the same level as the change
+            const auto end = siblings->indexes.cend();
+            auto it = siblings->indexes.lower_bound(first);
+            for (; it != end; ++it) {
+                if ((*it)->index.row() > last) // below the removed rows
+                    persistent_moved.append(*it);
+                else // in the removed subtree
+                    persistent_invalidated.append(*it);
+            }
+            continue;
+        }
+        QModelIndex current = siblings->parent;
         while (current.isValid()) {
             QModelIndex current_parent = current.parent();
-            if (current_parent == parent) { // on the same level as the change
-                if (!level_changed && current.row() > last) // below the removed rows
-                    persistent_moved.append(data);
-                else if (current.row() <= last && current.row() >= first) // in the removed subtree
-                    persistent_invalidated.append(data);
+            if (current_parent == parent) {
+                if (current.row() <= last && current.row() >= first) // in the removed subtree
+                    std::copy(siblings->indexes.cbegin(), siblings->indexes.cend(), std::back_inserter(persistent_invalidated));
                 break;
             }
             current = current_parent;
-            level_changed = true;
         }
     }
 
@@ -1059,8 +1102,10 @@ void QAbstractItemModelPrivate::rowsRemoved(const QModelIndex &parent,
         persistent.indexes.erase(persistent.indexes.constFind(old));
         data->index = q_func()->index(old.row() - count, old.column(), parent);
         if (data->index.isValid()) {
+            // still in the same place among its siblings
             persistent.insertMultiAtEnd(data->index, data);
         } else {
+            persistent.removeSibling(data);
             qWarning() << "QAbstractItemModel::endRemoveRows:  Invalid index (" << old.row() - count << ',' << old.column() << ") in model" << q_func();
         }
     }
@@ -1069,6 +1114,7 @@ void QAbstractItemModelPrivate::rowsRemoved(const QModelIndex &parent,
         auto pit = persistent.indexes.constFind(data->index);
         if (pit != persistent.indexes.cend())
             persistent.indexes.erase(pit);
+        persistent.removeSibling(data);
         data->index = QModelIndex();
     }
 }
@@ -1079,11 +1125,13 @@ void QAbstractItemModelPrivate::columnsAboutToBeInserted(const QModelIndex &pare
     Q_Q(QAbstractItemModel);
     Q_UNUSED(last);
     QList<QPersistentModelIndexData *> persistent_moved;
+    persistent.updateSiblingParents();
     if (first < q->columnCount(parent)) {
-        for (auto *data : qAsConst(persistent.indexes)) {
-            const QModelIndex &index = data->index;
-            if (index.column() >= first && index.isValid() && index.parent() == parent)
-                persistent_moved.append(data);
+        if (const auto *siblings = persistent.siblings.value(parent)) {
+            for (auto *data : siblings->indexes) {
+                if (data->index.column() >= first)
+                    persistent_moved.append(data);
+            }
         }
     }
     persistent.moved.push(persistent_moved);
@@ -1099,8 +1147,10 @@ void QAbstractItemModelPrivate::columnsInserted(const QModelIndex &parent,
         persistent.indexes.erase(persistent.indexes.constFind(old));
         data->index = q_func()->index(old.row(), old.column() + count, parent);
         if (data->index.isValid()) {
+            // still in the same place among its siblings
             persistent.insertMultiAtEnd(data->index, data);
         } else {
+            persistent.removeSibling(data);
             qWarning() << "QAbstractItemModel::endInsertColumns:  Invalid index (" << old.row() << ',' << old.column() + count << ") in model" << q_func();
         }
     }
@@ -1111,22 +1161,29 @@ void QAbstractItemModelPrivate::columnsAboutToBeRemoved(const QModelIndex &paren
 {
     QList<QPersistentModelIndexData *> persistent_moved;
     QList<QPersistentModelIndexData *> persistent_invalidated;
+    persistent.updateSiblingParents();
     // find the persistent indexes that are affected by the change, either by being in the removed subtree
     // or by being on the same level and to the right of the removed columns
-    for (auto *data : qAsConst(persistent.indexes)) {
-        bool level_changed = false;
-        QModelIndex current = data->index;
-        while (current.isValid()) {
-            QModelIndex current_parent = current.parent();
-            if (current_parent == parent) { // on the same level as the change
-                if (!level_changed && current.column() > last) // right of the removed columns
+    for (const auto *siblings : qAsConst(persistent.siblings)) {
+        if (siblings->parent == parent) { // on the same level as the change
+            for (auto *data : siblings->indexes) {
+                const int column = data->index.column();
+                if (column > last) // right of the removed columns
                     persistent_moved.append(data);
-                else if (current.column() <= last && current.column() >= first) // in the removed subtree
+                else if (column >= first) // in the removed subtree
                     persistent_invalidated.append(data);
+            }
+            continue;
+        }
+        QModelIndex current = siblings->parent;
+        while (current.isValid()) {
+            QModelIndex current_parent = current.parent();
+            if (current_parent == parent) {
+                if (current.column() <= last && current.column() >= first) // in the removed subtree
+                    std::copy(siblings->indexes.cbegin(), siblings->indexes.cend(), std::back_inserter(persistent_invalidated));
                 break;
             }
             current = current_parent;
-            level_changed = true;
         }
     }
 
@@ -1145,8 +1202,10 @@ void QAbstractItemModelPrivate::columnsRemoved(const QModelIndex &parent,
         persistent.indexes.erase(persistent.indexes.constFind(old));
         data->index = q_func()->index(old.row(), old.column() - count, parent);
         if (data->index.isValid()) {
+            // still in the same place among its siblings
             persistent.insertMultiAtEnd(data->index, data);
         } else {
+            persistent.removeSibling(data);
             qWarning() << "QAbstractItemModel::endRemoveColumns:  Invalid index (" << old.row() << ',' << old.column() - count << ") in model" << q_func();
         }
     }
@@ -1155,6 +1214,7 @@ void QAbstractItemModelPrivate::columnsRemoved(const QModelIndex &parent,
         auto index = persistent.indexes.constFind(data->index);
         if (index != persistent.indexes.constEnd())
             persistent.indexes.erase(index);
+        persistent.removeSibling(data);
         data->index = QModelIndex();
     }
 }
@@ -1732,6 +1792,7 @@ void QAbstractItemModel::resetInternalData()
 QAbstractItemModel::QAbstractItemModel(QObject *parent)
     : QObject(*new QAbstractItemModelPrivate, parent)
 {
+    d_func()->sendPostedDataChangedOnLayoutChange();
 }
 
 /*!
@@ -1740,6 +1801,7 @@ QAbstractItemModel::QAbstractItemModel(QObject *parent)
 QAbstractItemModel::QAbstractItemModel(QAbstractItemModelPrivate &dd, QObject *parent)
     : QObject(dd, parent)
 {
+    d_func()->sendPostedDataChangedOnLayoutChange();
 }
 
 /*!
@@ -2908,6 +2970,7 @@ void QAbstractItemModel::beginInsertRows(const QModelIndex &parent, int first, i
     Q_ASSERT(first <= rowCount(parent)); // == is allowed, to insert at the end
     Q_ASSERT(last >= first);
     Q_D(QAbstractItemModel);
+    d->sendPostedDataChanged();
     d->changes.push(QAbstractItemModelPrivate::Change(parent, first, last));
     emit rowsAboutToBeInserted(parent, first, last, QPrivateSignal());
     d->rowsAboutToBeInserted(parent, first, last);
@@ -2963,6 +3026,7 @@ void QAbstractItemModel::beginRemoveRows(const QModelIndex &parent, int first, i
     Q_ASSERT(last >= first);
     Q_ASSERT(last < rowCount(parent));
     Q_D(QAbstractItemModel);
+    d->sendPostedDataChanged();
     d->changes.push(QAbstractItemModelPrivate::Change(parent, first, last));
     emit rowsAboutToBeRemoved(parent, first, last, QPrivateSignal());
     d->rowsAboutToBeRemoved(parent, first, last);
@@ -3113,6 +3177,7 @@ bool QAbstractItemModel::beginMoveRows(const QModelIndex &sourceParent, int sour
     Q_ASSERT(sourceLast >= sourceFirst);
     Q_ASSERT(destinationChild >= 0);
     Q_D(QAbstractItemModel);
+    d->sendPostedDataChanged();
 
     if (!d->allowMove(sourceParent, sourceFirst, sourceLast, destinationParent, destinationChild, Qt::Vertical)) {
         return false;
@@ -3211,6 +3276,7 @@ void QAbstractItemModel::beginInsertColumns(const QModelIndex &parent, int first
     Q_ASSERT(first <= columnCount(parent)); // == is allowed, to insert at the end
     Q_ASSERT(last >= first);
     Q_D(QAbstractItemModel);
+    d->sendPostedDataChanged();
     d->changes.push(QAbstractItemModelPrivate::Change(parent, first, last));
     emit columnsAboutToBeInserted(parent, first, last, QPrivateSignal());
     d->columnsAboutToBeInserted(parent, first, last);
@@ -3267,6 +3333,7 @@ void QAbstractItemModel::beginRemoveColumns(const QModelIndex &parent, int first
     Q_ASSERT(last >= first);
     Q_ASSERT(last < columnCount(parent));
     Q_D(QAbstractItemModel);
+    d->sendPostedDataChanged();
     d->changes.push(QAbstractItemModelPrivate::Change(parent, first, last));
     emit columnsAboutToBeRemoved(parent, first, last, QPrivateSignal());
     d->columnsAboutToBeRemoved(parent, first, last);
@@ -3332,6 +3399,7 @@ bool QAbstractItemModel::beginMoveColumns(const QModelIndex &sourceParent, int s
     Q_ASSERT(sourceLast >= sourceFirst);
     Q_ASSERT(destinationChild >= 0);
     Q_D(QAbstractItemModel);
+    d->sendPostedDataChanged();
 
     if (!d->allowMove(sourceParent, sourceFirst, sourceLast, destinationParent, destinationChild, Qt::Horizontal)) {
         return false;
@@ -3409,6 +3477,8 @@ void QAbstractItemModel::endMoveColumns()
 */
 void QAbstractItemModel::beginResetModel()
 {
+    Q_D(QAbstractItemModel);
+    d->discardPostedDataChanged();
     emit modelAboutToBeReset(QPrivateSignal());
 }
 
@@ -3450,9 +3520,12 @@ void QAbstractItemModel::changePersistentIndex(const QModelIndex &from, const QM
     if (it != d->persistent.indexes.cend()) {
         QPersistentModelIndexData *data = *it;
         d->persistent.indexes.erase(it);
+        d->persistent.removeSibling(data);
         data->index = to;
-        if (to.isValid())
+        if (to.isValid()) {
             d->persistent.insertMultiAtEnd(to, data);
+            d->persistent.addSibling(data);
+        }
     }
 }
 
@@ -3482,14 +3555,17 @@ void QAbstractItemModel::changePersistentIndexList(const QModelIndexList &from,
         if (it != d->persistent.indexes.cend()) {
             QPersistentModelIndexData *data = *it;
             d->persistent.indexes.erase(it);
+            d->persistent.removeSibling(data);
             data->index = to.at(i);
             if (data->index.isValid())
                 toBeReinserted << data;
         }
     }
 
-    for (auto *data : qAsConst(toBeReinserted))
+    for (auto *data : qAsConst(toBeReinserted)) {
         d->persistent.insertMultiAtEnd(data->index, data);
+        d->persistent.addSibling(data);
+    }
 }
 
 /*!
@@ -3697,6 +3773,336 @@ void QAbstractItemModel::multiData(const QModelIndex &index, QModelRoleDataSpan
         d.setData(data(index, d.role()));
 }
 
+/*!
+    \since 6.1
+
+    Fills \a values with the data stored under the given \a role for the
+    items in \a column from \a firstRow to \a lastRow, inclusive, under
+    the given \a parent. \a values must have room for
+    \c{lastRow - firstRow + 1} elements; the item in \a firstRow is
+    stored first.
+
+    This is equivalent to calling data() for each of the items. If direct
+    access was enabled with setDirectColumnDataEnabled(), QStringListModel,
+    QStandardItemModel and QSqlQueryModel read the data from their storage
+    instead, without creating a QModelIndex for each item.
+
+    Items that do not exist, or that have no data for \a role, are set to
+    an invalid QVariant. To read a range of several columns or roles, call
+    this function once for each column and role.
+
+    \sa data(), multiData()
+*/
+void QAbstractItemModel::columnData(int column, int firstRow, int lastRow, int role,
+                                    QVariant *values, const QModelIndex &parent) const
+{
+    Q_D(const QAbstractItemModel);
+    Q_ASSERT(checkIndex(parent));
+    if (lastRow < firstRow)
+        return;
+    if (d->directColumnData)
+        d->columnData(column, firstRow, lastRow, role, values, parent);
+    else
+        d->QAbstractItemModelPrivate::columnData(column, firstRow, lastRow, role, values, parent);
+}
+
+/*!
+    \since 6.1
+
+    Sets whether columnData() may read the data of the items directly from
+    the model's storage to \a enabled. The default is \c false, and
+    columnData() calls data() for each item.
+
+    QStringListModel, QStandardItemModel and QSqlQueryModel can skip data()
+    when this is enabled, which makes sorting them with
+    QSortFilterProxyModel faster. Only enable it for instances of these
+    classes themselves, or of subclasses that do not reimplement data()
+    (or, for QSqlQueryModel, indexInQuery()): columnData() would not see
+    what a reimplementation returns. Other models are not affected.
+
+    \sa isDirectColumnDataEnabled(), columnData()
+*/
+void QAbstractItemModel::setDirectColumnDataEnabled(bool enabled)
+{
+    Q_D(QAbstractItemModel);
+    d->directColumnData = enabled;
+}
+
+/*!
+    \since 6.1
+
+    Returns whether columnData() may read the data of the items directly
+    from the model's storage.
+
+    \sa setDirectColumnDataEnabled()
+*/
+bool QAbstractItemModel::isDirectColumnDataEnabled() const
+{
+    Q_D(const QAbstractItemModel);
+    return d->directColumnData;
+}
+
+/*!
+    \internal
+
+    The implementation of QAbstractItemModel::columnData(). Private classes
+    reimplement this to read from their storage directly; the reimplementation
+    is only called when QAbstractItemModel::setDirectColumnDataEnabled() was
+    used, since a subclass of the model may have reimplemented data().
+*/
+void QAbstractItemModelPrivate::columnData(int column, int firstRow, int lastRow, int role,
+                                           QVariant *values, const QModelIndex &parent) const
+{
+    Q_Q(const QAbstractItemModel);
+    for (int row = firstRow; row <= lastRow; ++row) {
+        // some models return data for the invalid index, like for their root
+        const QModelIndex index = q->index(row, column, parent);
+        *values++ = index.isValid() ? q->data(index, role) : QVariant();
+    }
+}
+
+/*!
+    \since 6.1
+
+    Sets whether dataChanged() notifications posted with postDataChanged()
+    are coalesced to \a enabled. The default is \c false.
+
+    When coalescing is enabled, postDataChanged() does not emit dataChanged()
+    right away. The changes posted until control returns to the event loop
+    of the model's thread are merged: changes to overlapping or adjacent rows
+    under the same parent are reported by a single dataChanged() signal,
+    covering the columns and roles of all of them. This lets a model that
+    updates many items, one at a time, notify views and proxy models a few
+    times instead of once for every item.
+
+    The pending changes are always sent before rows or columns are inserted,
+    removed or moved, and when the model emits layoutAboutToBeChanged(), and
+    they are discarded when the model is reset, so that they never refer to
+    rows that no longer exist. Every receiver of layoutAboutToBeChanged()
+    is notified after the pending changes have been sent.
+
+    Disabling coalescing sends the pending changes, unless a batch started
+    with beginDataChangedBatch() is open.
+
+    \sa isDataChangedCoalescingEnabled(), postDataChanged(),
+        beginDataChangedBatch()
+*/
+void QAbstractItemModel::setDataChangedCoalescingEnabled(bool enabled)
+{
+    Q_D(QAbstractItemModel);
+    if (d->dataChangedCoalescing == enabled)
+        return;
+    d->dataChangedCoalescing = enabled;
+    if (!enabled && d->dataChangedBatchDepth == 0)
+        d->sendPostedDataChanged();
+}
+
+/*!
+    \since 6.1
+
+    Returns \c true if dataChanged() notifications posted with
+    postDataChanged() are coalesced until control returns to the event loop;
+    otherwise returns \c false.
+
+    \sa setDataChangedCoalescingEnabled()
+*/
+bool QAbstractItemModel::isDataChangedCoalescingEnabled() const
+{
+    Q_D(const QAbstractItemModel);
+    return d->dataChangedCoalescing;
+}
+
+/*!
+    \since 6.1
+
+    Notifies attached views and proxy models that the \a roles of the items
+    from \a topLeft to \a bottomRight have changed, like emitting
+    dataChanged() does. \a topLeft and \a bottomRight must have the same
+    parent. An empty \a roles list means that all roles may have changed.
+
+    If neither coalescing nor a batch is active, this function emits
+    dataChanged() immediately. Otherwise the change is merged with the other
+    pending changes, and reported when control returns to the event loop,
+    when the outermost batch ends, or when sendPostedDataChanged() is called,
+    whichever comes first.
+
+    \sa setDataChangedCoalescingEnabled(), beginDataChangedBatch(),
+        sendPostedDataChanged()
+*/
+void QAbstractItemModel::postDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                         const QList<int> &roles)
+{
+    Q_D(QAbstractItemModel);
+    Q_ASSERT(checkIndex(topLeft, CheckIndexOption::IndexIsValid));
+    Q_ASSERT(checkIndex(bottomRight, CheckIndexOption::IndexIsValid));
+    Q_ASSERT(topLeft.parent() == bottomRight.parent());
+    if (!d->dataChangedCoalescing && d->dataChangedBatchDepth == 0) {
+        emit dataChanged(topLeft, bottomRight, roles);
+        return;
+    }
+    d->postDataChanged(topLeft, bottomRight, roles);
+}
+
+/*!
+    \since 6.1
+
+    Starts a batch of changes. The changes posted with postDataChanged()
+    until the matching call to endDataChangedBatch() are merged, and sent
+    when the batch ends. Batches can be nested; the changes are sent when
+    the outermost batch ends.
+
+    Unlike coalescing, batches do not depend on an event loop.
+
+    \sa endDataChangedBatch(), setDataChangedCoalescingEnabled()
+*/
+void QAbstractItemModel::beginDataChangedBatch()
+{
+    Q_D(QAbstractItemModel);
+    ++d->dataChangedBatchDepth;
+}
+
+/*!
+    \since 6.1
+
+    Ends a batch of changes started with beginDataChangedBatch(). If this is
+    the outermost batch, the pending changes are sent.
+
+    \sa beginDataChangedBatch()
+*/
+void QAbstractItemModel::endDataChangedBatch()
+{
+    Q_D(QAbstractItemModel);
+    Q_ASSERT(d->dataChangedBatchDepth > 0);
+    if (--d->dataChangedBatchDepth == 0)
+        d->sendPostedDataChanged();
+}
+
+/*!
+    \since 6.1
+
+    Emits dataChanged() for the changes posted with postDataChanged() that
+    have not been sent yet, even if a batch is open.
+
+    \sa postDataChanged()
+*/
+void QAbstractItemModel::sendPostedDataChanged()
+{
+    Q_D(QAbstractItemModel);
+    d->sendPostedDataChanged();
+}
+
+static void qMergeChangedRoles(QList<int> &roles, const QList<int> &other)
+{
+    if (roles.isEmpty())
+        return;
+    if (other.isEmpty()) {
+        roles.clear();
+        return;
+    }
+    for (int role : other) {
+        if (!roles.contains(role))
+            roles.append(role);
+    }
+}
+
+/*!
+    \internal
+
+    Merges the change with the pending changes to overlapping or adjacent
+    rows under the same parent.
+*/
+void QAbstractItemModelPrivate::postDataChanged(const QModelIndex &topLeft,
+                                                const QModelIndex &bottomRight,
+                                                const QList<int> &roles)
+{
+    Q_Q(QAbstractItemModel);
+    const QModelIndex parent = topLeft.parent();
+    auto it = pendingDataChanged.find(parent);
+    if (it == pendingDataChanged.end()) {
+        it = pendingDataChanged.insert(parent, PendingDataChanges());
+        pendingDataChangedParents.append(parent);
+    }
+    PendingDataChanges &changes = it.value();
+
+    int firstRow = topLeft.row();
+    PendingDataChange change = { bottomRight.row(), topLeft.column(), bottomRight.column(), roles };
+    auto run = changes.upper_bound(firstRow);
+    if (run != changes.begin() && std::prev(run)->second.lastRow >= firstRow - 1)
+        --run;
+    while (run != changes.end() && run->first <= change.lastRow + 1) {
+        firstRow = qMin(firstRow, run->first);
+        change.lastRow = qMax(change.lastRow, run->second.lastRow);
+        change.firstColumn = qMin(change.firstColumn, run->second.firstColumn);
+        change.lastColumn = qMax(change.lastColumn, run->second.lastColumn);
+        qMergeChangedRoles(change.roles, run->second.roles);
+        run = changes.erase(run);
+    }
+    changes.emplace_hint(run, firstRow, std::move(change));
+
+    if (dataChangedCoalescing && dataChangedBatchDepth == 0 && !dataChangedSendScheduled) {
+        dataChangedSendScheduled = true;
+        QMetaObject::invokeMethod(q, [this] {
+            dataChangedSendScheduled = false;
+            if (dataChangedBatchDepth == 0)
+                sendPostedDataChanged();
+        }, Qt::QueuedConnection);
+    }
+}
+
+/*!
+    \internal
+
+    Emits dataChanged() for the pending changes, in the order their parents
+    were first posted. Changes posted while doing so are kept for later.
+*/
+void QAbstractItemModelPrivate::sendPostedDataChanged()
+{
+    Q_Q(QAbstractItemModel);
+    if (pendingDataChangedParents.isEmpty())
+        return;
+    const QHash<QModelIndex, PendingDataChanges> pending = std::exchange(pendingDataChanged, {});
+    const QList<QModelIndex> parents = std::exchange(pendingDataChangedParents, {});
+    for (const QModelIndex &parent : parents) {
+        // don't trust rows that went away without beginRemoveRows()
+        const int rowCount = q->rowCount(parent);
+        const int columnCount = q->columnCount(parent);
+        for (const auto &run : *pending.constFind(parent)) {
+            const int lastRow = qMin(run.second.lastRow, rowCount - 1);
+            const int lastColumn = qMin(run.second.lastColumn, columnCount - 1);
+            if (run.first > lastRow || run.second.firstColumn > lastColumn)
+                continue;
+            emit q->dataChanged(q->index(run.first, run.second.firstColumn, parent),
+                                q->index(lastRow, lastColumn, parent), run.second.roles);
+        }
+    }
+}
+
+/*!
+    \internal
+
+    Forgets about the pending changes, when the model is reset.
+*/
+void QAbstractItemModelPrivate::discardPostedDataChanged()
+{
+    pendingDataChanged.clear();
+    pendingDataChangedParents.clear();
+}
+
+/*!
+    \internal
+
+    The pending changes are kept by row, and a layout change moves rows
+    without telling where to, so they are sent when the model emits
+    layoutAboutToBeChanged(). The connection is made when the model is
+    constructed, so that it comes before those of all other receivers.
+*/
+void QAbstractItemModelPrivate::sendPostedDataChangedOnLayoutChange()
+{
+    Q_Q(QAbstractItemModel);
+    QObject::connect(q, &QAbstractItemModel::layoutAboutToBeChanged, q,
+                     [this] { sendPostedDataChanged(); }, Qt::DirectConnection);
+}
+
 /*!
     \class QAbstractTableModel
     \inmodule QtCore
@@ -4183,6 +4589,81 @@ void QAbstractItemModelPrivate::Persistent::insertMultiAtEnd(const QModelIndex&
     }
 }
 
+/*!
+    \internal
+    Files \a data with the other persistent indexes under \a parent, so that
+    inserting or removing rows and columns there only visits the persistent
+    indexes at or after the changed position, instead of all of them.
+ */
+void QAbstractItemModelPrivate::Persistent::addSibling(QPersistentModelIndexData *data,
+                                                       const QModelIndex &parent)
+{
+    Q_ASSERT(!data->siblings);
+    QPersistentModelIndexSiblings *&group = siblings[parent];
+    if (!group) {
+        group = new QPersistentModelIndexSiblings;
+        group->parent = parent;
+    }
+    data->position = group->indexes.insert(data);
+    data->siblings = group;
+}
+
+/*!
+    \internal
+    Takes \a data out of the persistent indexes filed under its parent.
+ */
+void QAbstractItemModelPrivate::Persistent::removeSibling(QPersistentModelIndexData *data)
+{
+    QPersistentModelIndexSiblings *group = data->siblings;
+    if (!group)
+        return;
+    group->indexes.erase(data->position);
+    data->siblings = nullptr;
+    if (group->indexes.empty()) {
+        siblings.remove(group->parent);
+        delete group;
+    }
+}
+
+/*!
+    \internal
+    Persistent indexes keep pointing to the same items when rows or columns
+    are inserted, removed or moved in front of their parent, or when the
+    parent is moved in a layout change, but the parent's own index changes.
+    Files them again under the parent the model reports now.
+
+    Models need not report the new index of a parent that is not persistent
+    itself, so this is called before the groups are looked up, rather than
+    after the changes that may have moved them.
+ */
+void QAbstractItemModelPrivate::Persistent::updateSiblingParents()
+{
+    QList<QPersistentModelIndexSiblings *> moved;
+    for (QPersistentModelIndexSiblings *group : qAsConst(siblings)) {
+        if (group->parent.isValid() && (*group->indexes.begin())->index.parent() != group->parent)
+            moved.append(group);
+    }
+    if (moved.isEmpty())
+        return;
+    // take all of them out first, as a moved parent may take the place of another one
+    for (QPersistentModelIndexSiblings *group : qAsConst(moved)) {
+        siblings.remove(group->parent);
+        group->parent = (*group->indexes.begin())->index.parent();
+    }
+    for (QPersistentModelIndexSiblings *group : qAsConst(moved)) {
+        QPersistentModelIndexSiblings *&existing = siblings[group->parent];
+        if (!existing) {
+            existing = group;
+            continue;
+        }
+        for (auto *data : group->indexes) {
+            data->siblings = existing;
+            data->position = existing->indexes.insert(data);
+        }
+        delete group;
+    }
+}
+
 QT_END_NAMESPACE
 
 #include "moc_qabstractitemmodel.cpp"
@@ -363,6 +363,13 @@ public:
     [[nodiscard]] bool checkIndex(const QModelIndex &index, CheckIndexOptions options = CheckIndexOption::NoOption) const;
 
     virtual void multiData(const QModelIndex &index, QModelRoleDataSpan roleDataSpan) const;
+    void columnData(int column, int firstRow, int lastRow, int role, QVariant *values,
+                    const QModelIndex &parent = QModelIndex()) const;
+    void setDirectColumnDataEnabled(bool enabled);
+    bool isDirectColumnDataEnabled() const;
+
+    void setDataChangedCoalescingEnabled(bool enabled);
+    bool isDataChangedCoalescingEnabled() const;
 
 Q_SIGNALS:
     void dataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
@@ -429,6 +436,12 @@ protected:
     void beginResetModel();
     void endResetModel();
 
+    void postDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                         const QList<int> &roles = QList<int>());
+    void beginDataChangedBatch();
+    void endDataChangedBatch();
+    void sendPostedDataChanged();
+
     void changePersistentIndex(const QModelIndex &from, const QModelIndex &to);
     void changePersistentIndexList(const QModelIndexList &from, const QModelIndexList &to);
     QModelIndexList persistentIndexList() const;
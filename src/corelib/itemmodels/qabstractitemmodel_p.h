@@ -58,10 +58,33 @@
 #include "QtCore/qset.h"
 #include "QtCore/qhash.h"
 
+#include <map>
+#include <set>
+
 QT_BEGIN_NAMESPACE
 
 QT_REQUIRE_CONFIG(itemmodel);
 
+class QPersistentModelIndexData;
+
+// The persistent indexes that share a parent, ordered by row and column.
+// The order is that of the indexes themselves, so that shifting some of
+// them by the same amount, as inserting or removing rows does, keeps it.
+struct QPersistentModelIndexSiblings
+{
+    struct PositionLessThan
+    {
+        using is_transparent = void;
+        inline bool operator()(const QPersistentModelIndexData *lhs, const QPersistentModelIndexData *rhs) const;
+        inline bool operator()(const QPersistentModelIndexData *lhs, int row) const;
+        inline bool operator()(int row, const QPersistentModelIndexData *rhs) const;
+    };
+    typedef std::multiset<QPersistentModelIndexData *, PositionLessThan> Set;
+
+    QModelIndex parent;
+    Set indexes;
+};
+
 class QPersistentModelIndexData
 {
 public:
@@ -69,10 +92,43 @@ public:
     QPersistentModelIndexData(const QModelIndex &idx) : index(idx) {}
     QModelIndex index;
     QAtomicInt ref;
+    QPersistentModelIndexSiblings *siblings = nullptr;
+    QPersistentModelIndexSiblings::Set::iterator position;
     static QPersistentModelIndexData *create(const QModelIndex &index);
     static void destroy(QPersistentModelIndexData *data);
 };
 
+bool QPersistentModelIndexSiblings::PositionLessThan::operator()(const QPersistentModelIndexData *lhs,
+                                                                  const QPersistentModelIndexData *rhs) const
+{
+    if (lhs->index.row() != rhs->index.row())
+        return lhs->index.row() < rhs->index.row();
+    return lhs->index.column() < rhs->index.column();
+}
+
+bool QPersistentModelIndexSiblings::PositionLessThan::operator()(const QPersistentModelIndexData *lhs, int row) const
+{ return lhs->index.row() < row; }
+
+bool QPersistentModelIndexSiblings::PositionLessThan::operator()(int row, const QPersistentModelIndexData *rhs) const
+{ return row < rhs->index.row(); }
+
+// The key of the persistent index hashes. qHash(QModelIndex) adds the
+// internal id to the position without hashing it, so in tree models, where
+// the children of a parent share an id, many keys would collide.
+struct QPersistentModelIndexKey
+{
+    QPersistentModelIndexKey(const QModelIndex &index) : index(index) {}
+    QModelIndex index;
+
+    friend bool operator==(const QPersistentModelIndexKey &lhs, const QPersistentModelIndexKey &rhs) noexcept
+    { return lhs.index == rhs.index; }
+    friend size_t qHash(const QPersistentModelIndexKey &key, size_t seed = 0) noexcept
+    {
+        return size_t((size_t(key.index.row()) << 4) + size_t(key.index.column()))
+                + qHash(key.index.internalId(), seed);
+    }
+};
+
 class Q_CORE_EXPORT QAbstractItemModelPrivate : public QObjectPrivate
 {
     Q_DECLARE_PUBLIC(QAbstractItemModel)
@@ -93,6 +149,8 @@ public:
     void columnsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
     void columnsRemoved(const QModelIndex &parent, int first, int last);
     static QAbstractItemModel *staticEmptyModel();
+    virtual void columnData(int column, int firstRow, int lastRow, int role, QVariant *values,
+                            const QModelIndex &parent) const;
     static bool variantLessThan(const QVariant &v1, const QVariant &v2);
 
     void itemsAboutToBeMoved(const QModelIndex &srcParent, int srcFirst, int srcLast, const QModelIndex &destinationParent, int destinationChild, Qt::Orientation);
@@ -142,12 +200,42 @@ public:
 
     struct Persistent {
         Persistent() {}
-        QMultiHash<QModelIndex, QPersistentModelIndexData *> indexes;
+        ~Persistent() { qDeleteAll(siblings); }
+        QMultiHash<QPersistentModelIndexKey, QPersistentModelIndexData *> indexes;
+        QHash<QPersistentModelIndexKey, QPersistentModelIndexSiblings *> siblings; // by parent
         QStack<QList<QPersistentModelIndexData *>> moved;
         QStack<QList<QPersistentModelIndexData *>> invalidated;
         void insertMultiAtEnd(const QModelIndex& key, QPersistentModelIndexData *data);
+        void addSibling(QPersistentModelIndexData *data, const QModelIndex &parent);
+        void addSibling(QPersistentModelIndexData *data) { addSibling(data, data->index.parent()); }
+        void removeSibling(QPersistentModelIndexData *data);
+        void updateSiblingParents();
     } persistent;
 
+    // dataChanged() notifications posted with postDataChanged(), merged
+    // into runs of rows per parent until they are sent
+    struct PendingDataChange {
+        int lastRow;
+        int firstColumn, lastColumn;
+        QList<int> roles; // empty for all roles
+    };
+    typedef std::map<int, PendingDataChange> PendingDataChanges; // by first row
+    void postDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                         const QList<int> &roles);
+    void sendPostedDataChanged();
+    void discardPostedDataChanged();
+    void sendPostedDataChangedOnLayoutChange();
+
+    QHash<QModelIndex, PendingDataChanges> pendingDataChanged;
+    QList<QModelIndex> pendingDataChangedParents; // in posting order
+    int dataChangedBatchDepth = 0;
+    bool dataChangedCoalescing = false;
+    bool dataChangedSendScheduled = false;
+
+    // set with setDirectColumnDataEnabled(): columnData() may read the
+    // model's storage instead of calling data()
+    bool directColumnData = false;
+
     static const QHash<int,QByteArray> &defaultRoleNames();
     static bool isVariantLessThan(const QVariant &left, const QVariant &right,
                                   Qt::CaseSensitivity cs = Qt::CaseSensitive, bool isLocaleAware = false);
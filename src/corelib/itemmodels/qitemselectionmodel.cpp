@@ -44,6 +44,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <vector>
 
 QT_BEGIN_NAMESPACE
 
@@ -573,6 +574,336 @@ void QItemSelection::split(const QItemSelectionRange &range,
     }
 }
 
+/*
+    Returns \c true if the valid ranges in \a selection all belong to \a model.
+*/
+static bool qSelectionIsFromModel(const QItemSelection &selection, const QAbstractItemModel *model)
+{
+    for (const QItemSelectionRange &range : selection) {
+        if (range.model() != model && range.isValid())
+            return false;
+    }
+    return true;
+}
+
+void QItemSelectionRegion::add(const QItemSelection &selection)
+{
+    for (const QItemSelectionRange &range : selection) {
+        if (range.isValid())
+            apply(range, Add);
+    }
+}
+
+/*
+    Applies \a command to the region the same way QItemSelection::merge()
+    applies it to a selection.
+*/
+void QItemSelectionRegion::merge(const QItemSelection &selection,
+                                 QItemSelectionModel::SelectionFlags command)
+{
+    if (command & QItemSelectionModel::Deselect) {
+        for (const QItemSelectionRange &range : selection) {
+            if (range.isValid())
+                apply(range, Subtract);
+        }
+    } else if (command & QItemSelectionModel::Toggle) {
+        // the ranges of the selection can overlap, so toggle the items they
+        // cover instead, each of them once
+        QItemSelectionRegion toggled;
+        toggled.add(selection);
+        for (auto it = toggled.parents.cbegin(); it != toggled.parents.cend(); ++it) {
+            const Bands &bands = it.value();
+            for (auto band = bands.cbegin(); band != bands.cend(); ++band) {
+                const auto next = std::next(band);
+                if (next == bands.cend())
+                    break;
+                for (const auto &columns : band->second) {
+                    Bands &target = parents[it.key()];
+                    apply(target, band->first, next->first - 1,
+                          columns.first, columns.second, Toggle);
+                    if (target.empty())
+                        parents.remove(it.key());
+                }
+            }
+        }
+    } else if (command & QItemSelectionModel::Select) {
+        add(selection);
+    }
+}
+
+bool QItemSelectionRegion::contains(const QModelIndex &index) const
+{
+    const auto it = parents.constFind(index.parent());
+    if (it == parents.cend())
+        return false;
+    const Bands &bands = it.value();
+    const auto band = bands.upper_bound(index.row());
+    if (band == bands.cbegin())
+        return false;
+    const Columns &columns = std::prev(band)->second;
+    const int column = index.column();
+    const auto c = std::lower_bound(columns.cbegin(), columns.cend(), column,
+                                    [](const QPair<int, int> &c, int column) {
+                                        return c.second < column;
+                                    });
+    return c != columns.cend() && c->first <= column;
+}
+
+bool QItemSelectionRegion::intersects(const QItemSelectionRange &range) const
+{
+    const auto it = parents.constFind(range.parent());
+    if (it == parents.cend())
+        return false;
+    const Bands &bands = it.value();
+    auto band = bands.upper_bound(range.top());
+    if (band != bands.cbegin())
+        --band;
+    const int left = range.left();
+    const int right = range.right();
+    for (; band != bands.cend() && band->first <= range.bottom(); ++band) {
+        const Columns &columns = band->second;
+        const auto c = std::lower_bound(columns.cbegin(), columns.cend(), left,
+                                        [](const QPair<int, int> &c, int column) {
+                                            return c.second < column;
+                                        });
+        if (c != columns.cend() && c->first <= right)
+            return true;
+    }
+    return false;
+}
+
+bool QItemSelectionRegion::intersects(const QItemSelection &selection) const
+{
+    if (parents.isEmpty())
+        return false;
+    for (const QItemSelectionRange &range : selection) {
+        if (range.isValid() && intersects(range))
+            return true;
+    }
+    return false;
+}
+
+void QItemSelectionRegion::apply(Columns &columns, int left, int right, Operation operation)
+{
+    Columns result;
+    switch (operation) {
+    case Add: {
+        auto it = columns.cbegin();
+        for (; it != columns.cend() && it->second < left - 1; ++it)
+            result.append(*it);
+        for (; it != columns.cend() && it->first <= right + 1; ++it) {
+            left = qMin(left, it->first);
+            right = qMax(right, it->second);
+        }
+        result.append(qMakePair(left, right));
+        for (; it != columns.cend(); ++it)
+            result.append(*it);
+        break;
+    }
+    case Subtract:
+        for (const auto &c : qAsConst(columns)) {
+            if (c.second < left || c.first > right) {
+                result.append(c);
+                continue;
+            }
+            if (c.first < left)
+                result.append(qMakePair(c.first, left - 1));
+            if (c.second > right)
+                result.append(qMakePair(right + 1, c.second));
+        }
+        break;
+    case Toggle: {
+        // select the gaps between the selected columns, deselect the rest
+        Columns gaps;
+        int next = left;
+        for (const auto &c : qAsConst(columns)) {
+            if (c.second < left || c.first > right)
+                continue;
+            if (c.first > next)
+                gaps.append(qMakePair(next, c.first - 1));
+            next = c.second + 1;
+        }
+        if (next <= right)
+            gaps.append(qMakePair(next, right));
+        apply(columns, left, right, Subtract);
+        for (const auto &gap : qAsConst(gaps))
+            apply(columns, gap.first, gap.second, Add);
+        return;
+    }
+    }
+    columns = result;
+}
+
+void QItemSelectionRegion::apply(Bands &bands, int top, int bottom, int left, int right,
+                                 Operation operation)
+{
+    // make the rows top and bottom + 1 start bands of their own
+    const auto split = [&bands](int row) {
+        const auto it = bands.upper_bound(row);
+        if (it == bands.begin())
+            return bands.emplace_hint(it, row, Columns());
+        const auto previous = std::prev(it);
+        if (previous->first == row)
+            return previous;
+        return bands.emplace_hint(it, row, previous->second);
+    };
+    const auto first = split(top);
+    const auto last = split(bottom + 1);
+    for (auto it = first; it != last; ++it)
+        apply(it->second, left, right, operation);
+
+    // join the bands that became equal to their neighbours
+    auto it = first == bands.begin() ? first : std::prev(first);
+    const auto end = std::next(last);
+    for (auto next = std::next(it); next != end; next = std::next(it)) {
+        if (next->second == it->second)
+            bands.erase(next);
+        else
+            it = next;
+    }
+    if (!bands.empty() && bands.begin()->second.isEmpty())
+        bands.erase(bands.begin());
+}
+
+void QItemSelectionRegion::apply(const QItemSelectionRange &range, Operation operation)
+{
+    const QModelIndex parent = range.parent();
+    auto it = parents.find(parent);
+    if (it == parents.end()) {
+        if (operation == Subtract)
+            return;
+        it = parents.insert(parent, Bands());
+    }
+    apply(it.value(), range.top(), range.bottom(), range.left(), range.right(), operation);
+    if (it.value().empty())
+        parents.erase(it);
+}
+
+/*!
+    \internal
+
+    Merges the current selection into the ranges. The index of the ranges is
+    kept up to date, and spares the merge when nothing intersects.
+*/
+void QItemSelectionModelPrivate::finalize()
+{
+    if (currentSelection.isEmpty())
+        return;
+
+    if (rangesRegionValid && !modelChanging && qSelectionIsFromModel(currentSelection, model)) {
+        if (rangesRegion.intersects(currentSelection)) {
+            ranges.merge(currentSelection, currentCommand);
+        } else if ((currentCommand & (QItemSelectionModel::Select | QItemSelectionModel::Toggle))
+                   && !(currentCommand & QItemSelectionModel::Deselect)) {
+            // what merge() would do without any intersections
+            for (const QItemSelectionRange &range : qAsConst(currentSelection)) {
+                if (range.isValid())
+                    ranges.append(range);
+            }
+        }
+        rangesRegion.merge(currentSelection, currentCommand);
+    } else {
+        ranges.merge(currentSelection, currentCommand);
+        rangesRegionValid = false;
+    }
+    currentSelection.clear();
+    currentRegionValid = false;
+}
+
+/*!
+    \internal
+
+    Makes sure rangesRegion covers the ranges, if they are many enough for
+    it to pay off. Returns \c false if it can't be used.
+*/
+bool QItemSelectionModelPrivate::ensureRangesRegion() const
+{
+    if (rangesRegionValid)
+        return true;
+    // the indexes can't be trusted until the model is done changing
+    if (modelChanging || ranges.count() < 16 || !qSelectionIsFromModel(ranges, model))
+        return false;
+    rangesRegion.clear();
+    rangesRegion.add(ranges);
+    rangesRegionValid = true;
+    return true;
+}
+
+/*!
+    \internal
+
+    Makes sure currentRegion covers the current selection, if it is large
+    enough for it to pay off. Returns \c false if it can't be used.
+*/
+bool QItemSelectionModelPrivate::ensureCurrentRegion() const
+{
+    if (currentRegionValid)
+        return true;
+    if (modelChanging || currentSelection.count() < 16)
+        return false;
+    // QItemSelection::contains() does not ignore invalid ranges
+    for (const QItemSelectionRange &range : currentSelection) {
+        if (!range.isValid() || range.model() != model)
+            return false;
+    }
+    currentRegion.clear();
+    currentRegion.add(currentSelection);
+    currentRegionValid = true;
+    return true;
+}
+
+/*
+    The ranges merge() adds to a selection \a command is applied to, when
+    \a selection intersects none of its ranges.
+*/
+static QItemSelection qAddedRanges(const QItemSelection &selection,
+                                   QItemSelectionModel::SelectionFlags command)
+{
+    QItemSelection added;
+    if ((command & (QItemSelectionModel::Select | QItemSelectionModel::Toggle))
+        && !(command & QItemSelectionModel::Deselect)) {
+        for (const QItemSelectionRange &range : selection) {
+            if (range.isValid())
+                added.append(range);
+        }
+    }
+    return added;
+}
+
+/*!
+    \internal
+
+    Applies \a command with \a selection when neither it nor the current
+    selection intersects the ranges, so that the change can be worked out
+    from the current and new selections only, instead of the whole
+    selection. Returns \c false if the generic path must be taken.
+*/
+bool QItemSelectionModelPrivate::selectDisjoint(const QItemSelection &selection,
+                                                QItemSelectionModel::SelectionFlags command)
+{
+    Q_Q(QItemSelectionModel);
+    if (!ensureRangesRegion())
+        return false;
+    if (!(command & QItemSelectionModel::Current))
+        finalize();
+    if (!rangesRegionValid
+        || !qSelectionIsFromModel(currentSelection, model)
+        || !qSelectionIsFromModel(selection, model)
+        || rangesRegion.intersects(currentSelection)
+        || rangesRegion.intersects(selection)) {
+        return false;
+    }
+
+    const QItemSelection deselected = qAddedRanges(currentSelection, currentCommand);
+    if (command & (QItemSelectionModel::Toggle | QItemSelectionModel::Select
+                   | QItemSelectionModel::Deselect)) {
+        currentCommand = command;
+        currentSelection = selection;
+        currentRegionValid = false;
+    }
+    q->emitSelectionChanged(qAddedRanges(currentSelection, currentCommand), deselected);
+    return true;
+}
 
 void QItemSelectionModelPrivate::initModel(QAbstractItemModel *m)
 {
@@ -603,6 +934,18 @@ void QItemSelectionModelPrivate::initModel(QAbstractItemModel *m)
           SLOT(_q_layoutChanged(QList<QPersistentModelIndex>,QAbstractItemModel::LayoutChangeHint)) },
         { SIGNAL(modelReset()),
           SLOT(reset()) },
+        { SIGNAL(modelAboutToBeReset()),
+          SLOT(_q_modelAboutToBeChanged()) },
+        { SIGNAL(rowsInserted(QModelIndex,int,int)),
+          SLOT(_q_modelChanged()) },
+        { SIGNAL(rowsRemoved(QModelIndex,int,int)),
+          SLOT(_q_modelChanged()) },
+        { SIGNAL(columnsInserted(QModelIndex,int,int)),
+          SLOT(_q_modelChanged()) },
+        { SIGNAL(columnsRemoved(QModelIndex,int,int)),
+          SLOT(_q_modelChanged()) },
+        { SIGNAL(modelReset()),
+          SLOT(_q_modelChanged()) },
         { nullptr, nullptr }
     };
 
@@ -616,6 +959,7 @@ void QItemSelectionModelPrivate::initModel(QAbstractItemModel *m)
         q->reset();
     }
     model = m;
+    _q_modelChanged();
     if (model) {
         for (const Cx *cx = &connections[0]; cx->signal; cx++)
             QObject::connect(model, cx->signal, q, cx->slot);
@@ -668,6 +1012,7 @@ void QItemSelectionModelPrivate::_q_rowsAboutToBeRemoved(const QModelIndex &pare
                                                          int start, int end)
 {
     Q_Q(QItemSelectionModel);
+    _q_modelAboutToBeChanged();
     finalize();
 
     // update current index
@@ -739,6 +1084,7 @@ void QItemSelectionModelPrivate::_q_columnsAboutToBeRemoved(const QModelIndex &p
                                                             int start, int end)
 {
     Q_Q(QItemSelectionModel);
+    _q_modelAboutToBeChanged();
 
     // update current index
     if (currentIndex.isValid() && parent == currentIndex.parent()
@@ -772,6 +1118,7 @@ void QItemSelectionModelPrivate::_q_columnsAboutToBeInserted(const QModelIndex &
                                                              int start, int end)
 {
     Q_UNUSED(end);
+    _q_modelAboutToBeChanged();
     finalize();
     QList<QItemSelectionRange> split;
     QList<QItemSelectionRange>::iterator it = ranges.begin();
@@ -801,6 +1148,7 @@ void QItemSelectionModelPrivate::_q_rowsAboutToBeInserted(const QModelIndex &par
                                                           int start, int end)
 {
     Q_UNUSED(end);
+    _q_modelAboutToBeChanged();
     finalize();
     QList<QItemSelectionRange> split;
     QList<QItemSelectionRange>::iterator it = ranges.begin();
@@ -830,6 +1178,7 @@ void QItemSelectionModelPrivate::_q_rowsAboutToBeInserted(const QModelIndex &par
 */
 void QItemSelectionModelPrivate::_q_layoutAboutToBeChanged(const QList<QPersistentModelIndex> &, QAbstractItemModel::LayoutChangeHint hint)
 {
+    _q_modelAboutToBeChanged();
     savedPersistentIndexes.clear();
     savedPersistentCurrentIndexes.clear();
     savedPersistentRowLengths.clear();
@@ -995,6 +1344,8 @@ static bool qt_PersistentModelIndexLessThan(const QPersistentModelIndex &i1, con
 */
 void QItemSelectionModelPrivate::_q_layoutChanged(const QList<QPersistentModelIndex> &, QAbstractItemModel::LayoutChangeHint hint)
 {
+    _q_modelChanged();
+
     // special case for when all indexes are selected
     if (tableSelected && tableColCount == model->columnCount(tableParent)
         && tableRowCount == model->rowCount(tableParent)) {
@@ -1050,6 +1401,34 @@ void QItemSelectionModelPrivate::_q_layoutChanged(const QList<QPersistentModelIn
     }
 }
 
+/*!
+    \internal
+
+    The indexes in the selection can't be trusted from now on, until the
+    model is done changing.
+*/
+void QItemSelectionModelPrivate::_q_modelAboutToBeChanged()
+{
+    modelChanging = true;
+    rangesMayBeInvalid = true;
+    rangesRegionValid = false;
+    currentRegionValid = false;
+}
+
+/*!
+    \internal
+
+    The model is done changing; the indexes of the selection have been
+    updated, or invalidated, and have to be indexed again.
+*/
+void QItemSelectionModelPrivate::_q_modelChanged()
+{
+    modelChanging = false;
+    rangesMayBeInvalid = true;
+    rangesRegionValid = false;
+    currentRegionValid = false;
+}
+
 /*!
     \class QItemSelectionModel
     \inmodule QtCore
@@ -1251,20 +1630,30 @@ void QItemSelectionModel::select(const QItemSelection &selection, QItemSelection
     // it contains will be invalid. We can't clear them in a modelReset slot because that might already
     // be too late if another model observer is connected to the same modelReset slot and is invoked first
     // it might call select() on this selection model before any such QItemSelectionModelPrivate::_q_modelReset() slot
-    // is invoked, so it would not be cleared yet. We clear it invalid ranges in it here.
-    d->ranges.removeIf(QtFunctionObjects::IsNotValid());
-
-    QItemSelection old = d->ranges;
-    old.merge(d->currentSelection, d->currentCommand);
+    // is invoked, so it would not be cleared yet. We clear it invalid ranges in it here, unless
+    // the model has not changed since the last time.
+    if (d->rangesMayBeInvalid) {
+        d->ranges.removeIf(QtFunctionObjects::IsNotValid());
+        d->rangesMayBeInvalid = d->modelChanging;
+    }
 
     // expand selection according to SelectionBehavior
     if (command & Rows || command & Columns)
         sel = d->expandSelection(sel, command);
 
+    if (!(command & Clear) && d->selectDisjoint(sel, command))
+        return;
+
+    QItemSelection old = d->ranges;
+    old.merge(d->currentSelection, d->currentCommand);
+
     // clear ranges and currentSelection
     if (command & Clear) {
         d->ranges.clear();
         d->currentSelection.clear();
+        d->rangesRegion.clear();
+        d->rangesRegionValid = !d->modelChanging;
+        d->currentRegionValid = false;
     }
 
     // merge and clear currentSelection if Current was not set (ie. start new currentSelection)
@@ -1275,6 +1664,7 @@ void QItemSelectionModel::select(const QItemSelection &selection, QItemSelection
     if (command & Toggle || command & Select || command & Deselect) {
         d->currentCommand = command;
         d->currentSelection = sel;
+        d->currentRegionValid = false;
     }
 
     // generate new selection, compare with old and emit selectionChanged()
@@ -1385,22 +1775,31 @@ bool QItemSelectionModel::isSelected(const QModelIndex &index) const
 
     bool selected = false;
     //  search model ranges
-    QList<QItemSelectionRange>::const_iterator it = d->ranges.begin();
-    for (; it != d->ranges.end(); ++it) {
-        if ((*it).isValid() && (*it).contains(index)) {
-            selected = true;
-            break;
+    if (d->ensureRangesRegion()) {
+        selected = d->rangesRegion.contains(index);
+    } else {
+        QList<QItemSelectionRange>::const_iterator it = d->ranges.begin();
+        for (; it != d->ranges.end(); ++it) {
+            if ((*it).isValid() && (*it).contains(index)) {
+                selected = true;
+                break;
+            }
         }
     }
 
     // check  currentSelection
     if (d->currentSelection.count()) {
+        // unselectable items are not selected either way, see below
+        const auto currentContains = [d, &index] {
+            return d->ensureCurrentRegion() ? d->currentRegion.contains(index)
+                                            : d->currentSelection.contains(index);
+        };
         if ((d->currentCommand & Deselect) && selected)
-            selected = !d->currentSelection.contains(index);
+            selected = !currentContains();
         else if (d->currentCommand & Toggle)
-            selected ^= d->currentSelection.contains(index);
+            selected ^= currentContains();
         else if ((d->currentCommand & Select) && !selected)
-            selected = d->currentSelection.contains(index);
+            selected = currentContains();
     }
 
     if (selected) {
@@ -1822,6 +2221,60 @@ void QItemSelectionModel::setModel(QAbstractItemModel *model)
     emit modelChanged(model);
 }
 
+/*
+    Removes the ranges that are in both \a deselected and \a selected. They
+    are paired exactly as removing them from the lists one by one would,
+    without moving the ranges that are left each time.
+*/
+static void qRemoveEqualRanges(QItemSelection &deselected, QItemSelection &selected)
+{
+    const qsizetype deselectedCount = deselected.count();
+    const qsizetype selectedCount = selected.count();
+    std::vector<bool> deselectedRemoved(deselectedCount);
+    std::vector<bool> selectedRemoved(selectedCount);
+    // the ranges of selected that are left, as a list
+    std::vector<qsizetype> next(selectedCount);
+    for (qsizetype s = 0; s < selectedCount; ++s)
+        next[s] = s + 1;
+    qsizetype first = 0;
+
+    // all the ranges of deselected from o on are left
+    for (qsizetype o = 0; o < deselectedCount; ++o) {
+        bool advance = true;
+        qsizetype previous = -1;
+        for (qsizetype s = first; s < selectedCount && o < deselectedCount;) {
+            if (deselected.at(o) == selected.at(s)) {
+                deselectedRemoved[o++] = true;
+                selectedRemoved[s] = true;
+                s = next[s];
+                if (previous < 0)
+                    first = s;
+                else
+                    next[previous] = s;
+                advance = false;
+            } else {
+                previous = s;
+                s = next[s];
+            }
+        }
+        if (advance)
+            ++o;
+    }
+
+    QItemSelection deselectedLeft;
+    for (qsizetype o = 0; o < deselectedCount; ++o) {
+        if (!deselectedRemoved[o])
+            deselectedLeft.append(deselected.at(o));
+    }
+    QItemSelection selectedLeft;
+    for (qsizetype s = 0; s < selectedCount; ++s) {
+        if (!selectedRemoved[s])
+            selectedLeft.append(selected.at(s));
+    }
+    deselected.swap(deselectedLeft);
+    selected.swap(selectedLeft);
+}
+
 /*!
     Compares the two selections \a newSelection and \a oldSelection
     and emits selectionChanged() with the deselected and selected items.
@@ -1844,21 +2297,7 @@ void QItemSelectionModel::emitSelectionChanged(const QItemSelection &newSelectio
     QItemSelection selected = newSelection;
 
     // remove equal ranges
-    bool advance;
-    for (int o = 0; o < deselected.count(); ++o) {
-        advance = true;
-        for (int s = 0; s < selected.count() && o < deselected.count();) {
-            if (deselected.at(o) == selected.at(s)) {
-                deselected.removeAt(o);
-                selected.removeAt(s);
-                advance = false;
-            } else {
-                ++s;
-            }
-        }
-        if (advance)
-            ++o;
-    }
+    qRemoveEqualRanges(deselected, selected);
 
     // find intersections
     QItemSelection intersections;
@@ -52,11 +52,46 @@
 //
 
 #include "private/qobject_p.h"
+#include <QtCore/qhash.h>
+#include <QtCore/qvarlengtharray.h>
+
+#include <map>
 
 QT_REQUIRE_CONFIG(itemmodel);
 
 QT_BEGIN_NAMESPACE
 
+/*
+    The items covered by the valid ranges of a selection, grouped by parent.
+    For each parent, the rows are divided into bands over which the selected
+    columns are the same, so that looking up an item or a range takes
+    logarithmic time however fragmented the selection is.
+*/
+class QItemSelectionRegion
+{
+public:
+    void clear() { parents.clear(); }
+    void add(const QItemSelection &selection);
+    void merge(const QItemSelection &selection, QItemSelectionModel::SelectionFlags command);
+
+    bool contains(const QModelIndex &index) const;
+    bool intersects(const QItemSelectionRange &range) const;
+    bool intersects(const QItemSelection &selection) const;
+
+private:
+    enum Operation { Add, Subtract, Toggle };
+    // sorted, disjoint and not adjacent column intervals
+    typedef QVarLengthArray<QPair<int, int>, 2> Columns;
+    // the band starting at each row extends to the next one; the last one is empty
+    typedef std::map<int, Columns> Bands;
+
+    static void apply(Columns &columns, int left, int right, Operation operation);
+    static void apply(Bands &bands, int top, int bottom, int left, int right, Operation operation);
+    void apply(const QItemSelectionRange &range, Operation operation);
+
+    QHash<QModelIndex, Bands> parents;
+};
+
 class QItemSelectionModelPrivate: public QObjectPrivate
 {
     Q_DECLARE_PUBLIC(QItemSelectionModel)
@@ -64,10 +99,15 @@ public:
     QItemSelectionModelPrivate()
       : model(nullptr),
         currentCommand(QItemSelectionModel::NoUpdate),
-        tableSelected(false), tableColCount(0), tableRowCount(0) {}
+        tableSelected(false), tableColCount(0), tableRowCount(0),
+        rangesRegionValid(false), currentRegionValid(false),
+        modelChanging(false), rangesMayBeInvalid(true) {}
 
     QItemSelection expandSelection(const QItemSelection &selection,
                                    QItemSelectionModel::SelectionFlags command) const;
+    bool selectDisjoint(const QItemSelection &selection, QItemSelectionModel::SelectionFlags command);
+    bool ensureRangesRegion() const;
+    bool ensureCurrentRegion() const;
 
     void initModel(QAbstractItemModel *model);
 
@@ -77,6 +117,8 @@ public:
     void _q_columnsAboutToBeInserted(const QModelIndex &parent, int start, int end);
     void _q_layoutAboutToBeChanged(const QList<QPersistentModelIndex> &parents = QList<QPersistentModelIndex>(), QAbstractItemModel::LayoutChangeHint hint = QAbstractItemModel::NoLayoutChangeHint);
     void _q_layoutChanged(const QList<QPersistentModelIndex> &parents = QList<QPersistentModelIndex>(), QAbstractItemModel::LayoutChangeHint hint = QAbstractItemModel::NoLayoutChangeHint);
+    void _q_modelAboutToBeChanged();
+    void _q_modelChanged();
 
     inline void remove(QList<QItemSelectionRange> &r)
     {
@@ -85,12 +127,7 @@ public:
             ranges.removeAll(*it);
     }
 
-    inline void finalize()
-    {
-        ranges.merge(currentSelection, currentCommand);
-        if (!currentSelection.isEmpty())  // ### perhaps this should be in QList
-            currentSelection.clear();
-    }
+    void finalize();
 
     QPointer<QAbstractItemModel> model;
     QItemSelection ranges;
@@ -105,6 +142,16 @@ public:
     bool tableSelected;
     QPersistentModelIndex tableParent;
     int tableColCount, tableRowCount;
+
+    // the items in ranges and in currentSelection, for the lookups of large
+    // selections; they are rebuilt when the model changes
+    mutable QItemSelectionRegion rangesRegion;
+    mutable QItemSelectionRegion currentRegion;
+    mutable bool rangesRegionValid;
+    mutable bool currentRegionValid;
+    // between the signals before and after a change of the model's structure
+    bool modelChanging;
+    bool rangesMayBeInvalid;
 };
 
 QT_END_NAMESPACE
@@ -44,8 +44,14 @@
 #include <qdatetime.h>
 #include <qpair.h>
 #include <qstringlist.h>
+#include <qscopedvaluerollback.h>
 #include <private/qabstractitemmodel_p.h>
 #include <private/qabstractproxymodel_p.h>
+#if QT_CONFIG(thread)
+#include <qsemaphore.h>
+#include <qthreadpool.h>
+#include <qvarlengtharray.h>
+#endif
 
 #include <algorithm>
 
@@ -67,16 +73,110 @@ static inline QSet<int> qListToSet(const QList<int> &vector)
     return {vector.begin(), vector.end()};
 }
 
+// Above this many items times the number of separately signalled ranges of
+// them, a filter change replaces the items within a single layout change
+static constexpr qint64 FilterChangeMaximumIncrementalWork = 1 << 22;
+
+#if QT_CONFIG(thread)
+// Filtering or sorting fewer items than this on several threads does not pay off
+static constexpr int ParallelSortFilterMinimumItems = 8192;
+
+static int qParallelChunkCount(int items)
+{
+    return qMin(QThreadPool::globalInstance()->maxThreadCount(),
+                items / ParallelSortFilterMinimumItems);
+}
+
+/*
+    Calls \a function for each chunk in [0, \a chunks), on the idle threads of
+    the global thread pool and on the calling thread, and waits for all of
+    them. Chunks that no thread can be found for run on the calling thread,
+    so this cannot dead-lock when the pool is busy.
+*/
+template <typename Function>
+static void qRunChunksInParallel(int chunks, const Function &function)
+{
+    QThreadPool *pool = QThreadPool::globalInstance();
+    QSemaphore done;
+    int started = 0;
+    QVarLengthArray<int, 16> local = { 0 };
+    for (int chunk = 1; chunk < chunks; ++chunk) {
+        if (pool->tryStart([&function, &done, chunk] { function(chunk); done.release(); }))
+            ++started;
+        else
+            local.append(chunk);
+    }
+    for (int chunk : qAsConst(local))
+        function(chunk);
+    done.acquire(started);
+}
+#endif
+
+/*
+    Sorts \a items with \a lessThan, keeping the order of equal items. When
+    \a parallel is true, large lists are split into chunks that are sorted
+    on several threads and then merged, in order.
+*/
+template <typename LessThan>
+static void qStableSortItems(QList<int> &items, const LessThan &lessThan, bool parallel)
+{
+#if QT_CONFIG(thread)
+    const int chunks = parallel ? qParallelChunkCount(items.size()) : 1;
+    if (chunks > 1) {
+        int *const data = items.data();
+        const qint64 count = items.size();
+        const auto bound = [&](int chunk) { return data + count * chunk / chunks; };
+        qRunChunksInParallel(chunks, [&](int chunk) {
+            std::stable_sort(bound(chunk), bound(chunk + 1), lessThan);
+        });
+        // Merge neighboring runs pairwise; inplace_merge puts equal items of
+        // the earlier run first, so the result is the same as a stable sort.
+        for (int width = 1; width < chunks; width *= 2) {
+            const int merges = (chunks - width + 2 * width - 1) / (2 * width);
+            qRunChunksInParallel(merges, [&](int merge) {
+                const int first = merge * 2 * width;
+                std::inplace_merge(bound(first), bound(first + width),
+                                   bound(qMin(first + 2 * width, chunks)), lessThan);
+            });
+        }
+        return;
+    }
+#else
+    Q_UNUSED(parallel);
+#endif
+    std::stable_sort(items.begin(), items.end(), lessThan);
+}
+
+/*
+    The indexes of the rows being sorted, from first_row on, and the data
+    lessThan() compares for them, read in one go with
+    QAbstractItemModel::columnData(). It is only read while sorting, so it
+    can be shared by the threads of a parallel sort.
+*/
+struct QSortFilterProxyModelSortKeys
+{
+    int first_row = 0;
+    QList<QModelIndex> indexes;
+    QList<QVariant> values;
+    mutable bool used = false; // set by lessThan() while values is empty
+
+    inline QModelIndex index(int row) const { return indexes.at(row - first_row); }
+};
+
 class QSortFilterProxyModelLessThan
 {
 public:
     inline QSortFilterProxyModelLessThan(int column, const QModelIndex &parent,
                                        const QAbstractItemModel *source,
-                                       const QSortFilterProxyModel *proxy)
-        : sort_column(column), source_parent(parent), source_model(source), proxy_model(proxy) {}
+                                       const QSortFilterProxyModel *proxy,
+                                       const QSortFilterProxyModelSortKeys *keys)
+        : sort_column(column), source_parent(parent), source_model(source), proxy_model(proxy),
+          sort_keys(keys) {}
 
     inline bool operator()(int r1, int r2) const
     {
+        if (sort_keys)
+            return proxy_model->lessThan(sort_keys->index(r1), sort_keys->index(r2));
         QModelIndex i1 = source_model->index(r1, sort_column, source_parent);
         QModelIndex i2 = source_model->index(r2, sort_column, source_parent);
         return proxy_model->lessThan(i1, i2);
@@ -87,6 +187,7 @@ private:
     QModelIndex source_parent;
     const QAbstractItemModel *source_model;
     const QSortFilterProxyModel *proxy_model;
+    const QSortFilterProxyModelSortKeys *sort_keys;
 };
 
 class QSortFilterProxyModelGreaterThan
@@ -94,12 +195,15 @@ class QSortFilterProxyModelGreaterThan
 public:
     inline QSortFilterProxyModelGreaterThan(int column, const QModelIndex &parent,
                                           const QAbstractItemModel *source,
-                                          const QSortFilterProxyModel *proxy)
+                                          const QSortFilterProxyModel *proxy,
+                                          const QSortFilterProxyModelSortKeys *keys)
         : sort_column(column), source_parent(parent),
-          source_model(source), proxy_model(proxy) {}
+          source_model(source), proxy_model(proxy), sort_keys(keys) {}
 
     inline bool operator()(int r1, int r2) const
     {
+        if (sort_keys)
+            return proxy_model->lessThan(sort_keys->index(r2), sort_keys->index(r1));
         QModelIndex i1 = source_model->index(r1, sort_column, source_parent);
         QModelIndex i2 = source_model->index(r2, sort_column, source_parent);
         return proxy_model->lessThan(i2, i1);
@@ -110,6 +214,7 @@ private:
     QModelIndex source_parent;
     const QAbstractItemModel *source_model;
     const QSortFilterProxyModel *proxy_model;
+    const QSortFilterProxyModelSortKeys *sort_keys;
 };
 
 
@@ -170,6 +275,7 @@ public:
     Qt::CaseSensitivity sort_casesensitivity;
     int sort_role;
     bool sort_localeaware;
+    mutable const QSortFilterProxyModelSortKeys *sort_keys = nullptr; // while sorting
 
     int filter_column;
     int filter_role;
@@ -180,6 +286,11 @@ public:
     bool accept_children;
     bool complete_insert;
     bool dynamic_sortfilter;
+    bool incremental_filter;
+    bool layout_change_filter;
+    bool parallel_sortfilter;
+    bool filter_is_fixed_string;
+    QString filter_fixed_string;
     QRowsRemoval itemsBeingRemoved;
 
     QModelIndexPairList saved_persistent_indexes;
@@ -293,10 +404,21 @@ public:
     void update_persistent_indexes(const QModelIndexPairList &source_indexes);
 
     void filter_about_to_be_changed(const QModelIndex &source_parent = QModelIndex());
-    void filter_changed(Direction dir, const QModelIndex &source_parent = QModelIndex());
+    void filter_changed(Direction dir, const QModelIndex &source_parent = QModelIndex(),
+                        QSortFilterProxyModel::FilterChangeHint hint = QSortFilterProxyModel::NoFilterChangeHint);
     QSet<int> handle_filter_changed(
         QList<int> &source_to_proxy, QList<int> &proxy_to_source,
+        const QModelIndex &source_parent, Qt::Orientation orient,
+        QSortFilterProxyModel::FilterChangeHint hint);
+    void replace_filtered_items(
+        QList<int> &source_to_proxy, QList<int> &proxy_to_source,
+        const QList<int> &source_items_remove, const QList<int> &source_items_insert,
         const QModelIndex &source_parent, Qt::Orientation orient);
+    QSortFilterProxyModel::FilterChangeHint fixed_string_change_hint(
+        const QString &pattern, Qt::CaseSensitivity cs) const;
+    template <typename ItemAt>
+    QList<int> filter_source_items(int count, ItemAt item_at, bool accepted,
+                                   const QModelIndex &source_parent, Qt::Orientation orient) const;
 
     void updateChildrenMapping(const QModelIndex &source_parent, Mapping *parent_mapping,
                                Qt::Orientation orient, int start, int end, int delta_item_count, bool remove);
@@ -399,6 +521,51 @@ void QSortFilterProxyModelPrivate::_q_clearMapping()
     update_persistent_indexes(source_indexes);
 }
 
+/*!
+  \internal
+
+  Returns the items \c{item_at(i)}, for \c i from 0 to \a count, that the
+  row or column filter accepts, or, if \a accepted is false, rejects.
+  When parallel sorting and filtering is enabled, a large number of items
+  is filtered on several threads.
+*/
+template <typename ItemAt>
+QList<int> QSortFilterProxyModelPrivate::filter_source_items(
+    int count, ItemAt item_at, bool accepted,
+    const QModelIndex &source_parent, Qt::Orientation orient) const
+{
+    Q_Q(const QSortFilterProxyModel);
+    const auto accepts = [&](int source_item) {
+        return (orient == Qt::Vertical)
+                ? filterAcceptsRowInternal(source_item, source_parent)
+                : q->filterAcceptsColumn(source_item, source_parent);
+    };
+    QList<int> source_items;
+#if QT_CONFIG(thread)
+    const int chunks = parallel_sortfilter ? qParallelChunkCount(count) : 1;
+    if (chunks > 1) {
+        QList<bool> matches(count);
+        bool *const match = matches.data();
+        qRunChunksInParallel(chunks, [&](int chunk) {
+            const int end = int(qint64(count) * (chunk + 1) / chunks);
+            for (int i = int(qint64(count) * chunk / chunks); i < end; ++i)
+                match[i] = (accepts(item_at(i)) == accepted);
+        });
+        for (int i = 0; i < count; ++i) {
+            if (match[i])
+                source_items.append(item_at(i));
+        }
+        return source_items;
+    }
+#endif
+    for (int i = 0; i < count; ++i) {
+        const int source_item = item_at(i);
+        if (accepts(source_item) == accepted)
+            source_items.append(source_item);
+    }
+    return source_items;
+}
+
 IndexMap::const_iterator QSortFilterProxyModelPrivate::create_mapping(
     const QModelIndex &source_parent) const
 {
@@ -411,11 +578,8 @@ IndexMap::const_iterator QSortFilterProxyModelPrivate::create_mapping(
     Mapping *m = new Mapping;
 
     int source_rows = model->rowCount(source_parent);
-    m->source_rows.reserve(source_rows);
-    for (int i = 0; i < source_rows; ++i) {
-        if (filterAcceptsRowInternal(i, source_parent))
-            m->source_rows.append(i);
-    }
+    m->source_rows = filter_source_items(source_rows, [](int i) { return i; }, true,
+                                         source_parent, Qt::Vertical);
     int source_cols = model->columnCount(source_parent);
     m->source_columns.reserve(source_cols);
     for (int i = 0; i < source_cols; ++i) {
@@ -586,12 +750,38 @@ void QSortFilterProxyModelPrivate::sort_source_rows(
 {
     Q_Q(const QSortFilterProxyModel);
     if (source_sort_column >= 0) {
+        QSortFilterProxyModelSortKeys keys;
+        QScopedValueRollback<const QSortFilterProxyModelSortKeys *> rollback(sort_keys, nullptr);
+        if (source_rows.size() > 2) {
+            const auto range = std::minmax_element(source_rows.cbegin(), source_rows.cend());
+            const int first = *range.first;
+            const int last = *range.second;
+            // don't read the data of many rows that are not being sorted
+            if (last - first < 2 * source_rows.size()) {
+                // find out whether lessThan() compares the data, so that
+                // reading it in advance is worth it
+                sort_keys = &keys;
+                q->lessThan(model->index(first, source_sort_column, source_parent),
+                            model->index(last, source_sort_column, source_parent));
+                sort_keys = nullptr;
+                if (keys.used) {
+                    keys.first_row = first;
+                    keys.indexes.reserve(last - first + 1);
+                    for (int row = first; row <= last; ++row)
+                        keys.indexes.append(model->index(row, source_sort_column, source_parent));
+                    keys.values.resize(last - first + 1);
+                    model->columnData(source_sort_column, first, last, sort_role,
+                                      keys.values.data(), source_parent);
+                    sort_keys = &keys;
+                }
+            }
+        }
         if (sort_order == Qt::AscendingOrder) {
-            QSortFilterProxyModelLessThan lt(source_sort_column, source_parent, model, q);
-            std::stable_sort(source_rows.begin(), source_rows.end(), lt);
+            QSortFilterProxyModelLessThan lt(source_sort_column, source_parent, model, q, sort_keys);
+            qStableSortItems(source_rows, lt, parallel_sortfilter);
         } else {
-            QSortFilterProxyModelGreaterThan gt(source_sort_column, source_parent, model, q);
-            std::stable_sort(source_rows.begin(), source_rows.end(), gt);
+            QSortFilterProxyModelGreaterThan gt(source_sort_column, source_parent, model, q, sort_keys);
+            qStableSortItems(source_rows, gt, parallel_sortfilter);
         }
     } else { // restore the source model order
         std::stable_sort(source_rows.begin(), source_rows.end());
@@ -1180,14 +1370,15 @@ void QSortFilterProxyModelPrivate::filter_about_to_be_changed(const QModelIndex
   Updates the proxy model (adds/removes rows) based on the
   new filter.
 */
-void QSortFilterProxyModelPrivate::filter_changed(Direction dir, const QModelIndex &source_parent)
+void QSortFilterProxyModelPrivate::filter_changed(Direction dir, const QModelIndex &source_parent,
+                                                  QSortFilterProxyModel::FilterChangeHint hint)
 {
     IndexMap::const_iterator it = source_index_mapping.constFind(source_parent);
     if (it == source_index_mapping.constEnd())
         return;
     Mapping *m = it.value();
-    const QSet<int> rows_removed = (dir & Direction::Rows) ? handle_filter_changed(m->proxy_rows, m->source_rows, source_parent, Qt::Vertical) : QSet<int>();
-    const QSet<int> columns_removed = (dir & Direction::Columns) ? handle_filter_changed(m->proxy_columns, m->source_columns, source_parent, Qt::Horizontal) : QSet<int>();
+    const QSet<int> rows_removed = (dir & Direction::Rows) ? handle_filter_changed(m->proxy_rows, m->source_rows, source_parent, Qt::Vertical, hint) : QSet<int>();
+    const QSet<int> columns_removed = (dir & Direction::Columns) ? handle_filter_changed(m->proxy_columns, m->source_columns, source_parent, Qt::Horizontal, hint) : QSet<int>();
 
     // We need to iterate over a copy of m->mapped_children because otherwise it may be changed by other code, invalidating
     // the iterator it2.
@@ -1201,7 +1392,7 @@ void QSortFilterProxyModelPrivate::filter_changed(Direction dir, const QModelInd
             indexesToRemove.push_back(i);
             remove_from_mapping(source_child_index);
         } else {
-            filter_changed(dir, source_child_index);
+            filter_changed(dir, source_child_index, hint);
         }
     }
     QList<int>::const_iterator removeIt = indexesToRemove.constEnd();
@@ -1221,48 +1412,160 @@ void QSortFilterProxyModelPrivate::filter_changed(Direction dir, const QModelInd
 /*!
   \internal
   returns the removed items indexes
+
+  A narrowing \a hint means that no filtered out item can be accepted now,
+  so only the mapped items are filtered again; a widening one means that
+  no mapped item can be rejected now, so only the unmapped ones are.
 */
 QSet<int> QSortFilterProxyModelPrivate::handle_filter_changed(
     QList<int> &source_to_proxy, QList<int> &proxy_to_source,
-    const QModelIndex &source_parent, Qt::Orientation orient)
+    const QModelIndex &source_parent, Qt::Orientation orient,
+    QSortFilterProxyModel::FilterChangeHint hint)
 {
-    Q_Q(QSortFilterProxyModel);
-    // Figure out which mapped items to remove
+    // Figure out which mapped items no longer satisfy the filter, and must be removed
     QList<int> source_items_remove;
-    for (int i = 0; i < proxy_to_source.count(); ++i) {
-        const int source_item = proxy_to_source.at(i);
-        if ((orient == Qt::Vertical)
-            ? !filterAcceptsRowInternal(source_item, source_parent)
-            : !q->filterAcceptsColumn(source_item, source_parent)) {
-            // This source item does not satisfy the filter, so it must be removed
-            source_items_remove.append(source_item);
-        }
+    if (hint != QSortFilterProxyModel::WideningFilterHint) {
+        source_items_remove = filter_source_items(
+            proxy_to_source.size(), [&proxy_to_source](int i) { return proxy_to_source.at(i); },
+            false, source_parent, orient);
     }
-    // Figure out which non-mapped items to insert
+    // Figure out which non-mapped items now satisfy the filter, and must be added
     QList<int> source_items_insert;
-    int source_count = source_to_proxy.size();
-    for (int source_item = 0; source_item < source_count; ++source_item) {
-        if (source_to_proxy.at(source_item) == -1) {
-            if ((orient == Qt::Vertical)
-                ? filterAcceptsRowInternal(source_item, source_parent)
-                : q->filterAcceptsColumn(source_item, source_parent)) {
-                // This source item satisfies the filter, so it must be added
-                source_items_insert.append(source_item);
-            }
+    if (hint != QSortFilterProxyModel::NarrowingFilterHint) {
+        QList<int> source_items_unmapped;
+        const int source_count = source_to_proxy.size();
+        for (int source_item = 0; source_item < source_count; ++source_item) {
+            if (source_to_proxy.at(source_item) == -1)
+                source_items_unmapped.append(source_item);
         }
+        source_items_insert = filter_source_items(
+            source_items_unmapped.size(),
+            [&source_items_unmapped](int i) { return source_items_unmapped.at(i); },
+            true, source_parent, orient);
     }
     if (!source_items_remove.isEmpty() || !source_items_insert.isEmpty()) {
-        // Do item removal and insertion
-        remove_source_items(source_to_proxy, proxy_to_source,
-                            source_items_remove, source_parent, orient);
         if (orient == Qt::Vertical)
             sort_source_rows(source_items_insert, source_parent);
-        insert_source_items(source_to_proxy, proxy_to_source,
-                            source_items_insert, source_parent, orient);
+        // Every range of items removed or inserted with its own signal updates
+        // the mapping after it; when that adds up to more work than rebuilding
+        // it, replace the items in one go instead. That turns the removals and
+        // insertions into a layout change, which only users who enabled
+        // layoutChangeFilteringEnabled have agreed to.
+        const qsizetype intervals = layout_change_filter
+                ? proxy_intervals_for_source_items(source_to_proxy, source_items_remove).size()
+                        + source_items_insert.size()
+                : 0;
+        if (intervals * source_to_proxy.size() > FilterChangeMaximumIncrementalWork) {
+            replace_filtered_items(source_to_proxy, proxy_to_source, source_items_remove,
+                                   source_items_insert, source_parent, orient);
+        } else {
+            // Do item removal and insertion
+            remove_source_items(source_to_proxy, proxy_to_source,
+                                source_items_remove, source_parent, orient);
+            insert_source_items(source_to_proxy, proxy_to_source,
+                                source_items_insert, source_parent, orient);
+        }
     }
     return qListToSet(source_items_remove);
 }
 
+/*!
+  \internal
+
+  Removes \a source_items_remove from and inserts \a source_items_insert
+  into this proxy model within a single layout change, instead of
+  signalling each range of removed or inserted items separately.
+*/
+void QSortFilterProxyModelPrivate::replace_filtered_items(
+    QList<int> &source_to_proxy, QList<int> &proxy_to_source,
+    const QList<int> &source_items_remove, const QList<int> &source_items_insert,
+    const QModelIndex &source_parent, Qt::Orientation orient)
+{
+    Q_Q(QSortFilterProxyModel);
+    const QModelIndex proxy_parent = q->mapFromSource(source_parent);
+    if (!proxy_parent.isValid() && source_parent.isValid())
+        return; // nothing to do (source_parent is not mapped)
+
+    QList<QPersistentModelIndex> parents;
+    if (proxy_parent.isValid())
+        parents << proxy_parent;
+    emit q->layoutAboutToBeChanged(parents);
+    const QModelIndexPairList source_indexes = store_persistent_indexes();
+
+    for (int source_item : source_items_remove)
+        source_to_proxy[source_item] = -1;
+    proxy_to_source.removeIf([&source_to_proxy](int source_item) {
+        return source_to_proxy.at(source_item) == -1;
+    });
+
+    const auto proxy_intervals = proxy_intervals_for_source_items_to_add(
+        proxy_to_source, source_items_insert, source_parent, orient);
+    QList<int> new_proxy_to_source;
+    new_proxy_to_source.reserve(proxy_to_source.size() + source_items_insert.size());
+    int proxy_item = 0;
+    for (const auto &interval : proxy_intervals) {
+        for (; proxy_item < interval.first; ++proxy_item)
+            new_proxy_to_source.append(proxy_to_source.at(proxy_item));
+        new_proxy_to_source.append(interval.second);
+    }
+    for (; proxy_item < proxy_to_source.size(); ++proxy_item)
+        new_proxy_to_source.append(proxy_to_source.at(proxy_item));
+    proxy_to_source = std::move(new_proxy_to_source);
+    build_source_to_proxy_mapping(proxy_to_source, source_to_proxy);
+
+    // The mappings of the removed items' children go away with them, so
+    // that the persistent indexes below them become invalid.
+    if (Mapping *m = source_index_mapping.value(source_parent)) {
+        const QSet<int> removed = qListToSet(source_items_remove);
+        for (int i = m->mapped_children.size() - 1; i >= 0; --i) {
+            const QModelIndex &source_child_index = m->mapped_children.at(i);
+            if (removed.contains(orient == Qt::Vertical ? source_child_index.row()
+                                                        : source_child_index.column())) {
+                remove_from_mapping(source_child_index);
+                m->mapped_children.remove(i);
+            }
+        }
+    }
+
+    QModelIndexList from, to;
+    from.reserve(source_indexes.size());
+    to.reserve(source_indexes.size());
+    for (const auto &indexPair : source_indexes) {
+        const QPersistentModelIndex &source_index = indexPair.second;
+        from << indexPair.first;
+        if (can_create_mapping(source_index.parent()))
+            to << q->mapFromSource(source_index);
+        else
+            to << QModelIndex();
+    }
+    q->changePersistentIndexList(from, to);
+    emit q->layoutChanged(parents);
+}
+
+/*!
+  \internal
+
+  Returns how changing the fixed string filter to \a pattern, with case
+  sensitivity \a cs, changes the set of accepted rows, if incremental
+  filtering is enabled and this can be told.
+*/
+QSortFilterProxyModel::FilterChangeHint QSortFilterProxyModelPrivate::fixed_string_change_hint(
+    const QString &pattern, Qt::CaseSensitivity cs) const
+{
+    if (!incremental_filter || !filter_is_fixed_string)
+        return QSortFilterProxyModel::NoFilterChangeHint;
+    const Qt::CaseSensitivity old_cs =
+            (filter_data.patternOptions() & QRegularExpression::CaseInsensitiveOption)
+            ? Qt::CaseInsensitive : Qt::CaseSensitive;
+    // Whatever contains the new string also contains the old one
+    if ((cs == old_cs || cs == Qt::CaseSensitive) && pattern.contains(filter_fixed_string, old_cs))
+        return QSortFilterProxyModel::NarrowingFilterHint;
+    // Whatever contains the old string also contains the new one
+    if ((cs == old_cs || old_cs == Qt::CaseSensitive) && filter_fixed_string.contains(pattern, cs))
+        return QSortFilterProxyModel::WideningFilterHint;
+    return QSortFilterProxyModel::NoFilterChangeHint;
+}
+
 bool QSortFilterProxyModelPrivate::needsReorder(const QList<int> &source_rows, const QModelIndex &source_parent) const
 {
     Q_Q(const QSortFilterProxyModel);
@@ -1891,6 +2194,20 @@ void QSortFilterProxyModelPrivate::_q_sourceColumnsMoved(
     {Basic Sort/Filter Model Example}, {Custom Sort/Filter Model Example}, QIdentityProxyModel
 */
 
+/*!
+    \enum QSortFilterProxyModel::FilterChangeHint
+    \since 6.1
+
+    This enum describes how a change of the filter changes the set of
+    accepted rows.
+
+    \value NoFilterChangeHint   No hint is available.
+    \value NarrowingFilterHint  No row that was filtered out is accepted now.
+    \value WideningFilterHint   No row that was accepted is filtered out now.
+
+    \sa invalidateRowsFilter(), incrementalFilteringEnabled
+*/
+
 /*!
     Constructs a sorting filter model with the given \a parent.
 */
@@ -1909,6 +2226,10 @@ QSortFilterProxyModel::QSortFilterProxyModel(QObject *parent)
     d->filter_recursive = false;
     d->accept_children = false;
     d->dynamic_sortfilter = true;
+    d->incremental_filter = false;
+    d->layout_change_filter = false;
+    d->parallel_sortfilter = false;
+    d->filter_is_fixed_string = false;
     d->complete_insert = false;
     connect(this, SIGNAL(modelReset()), this, SLOT(_q_clearMapping()));
 }
@@ -2510,6 +2831,7 @@ void QSortFilterProxyModel::setFilterRegularExpression(const QRegularExpression
     Q_D(QSortFilterProxyModel);
     d->filter_about_to_be_changed();
     d->filter_data = regularExpression;
+    d->filter_is_fixed_string = false;
     d->filter_changed(QSortFilterProxyModelPrivate::Direction::Rows);
 }
 #endif
@@ -2569,8 +2891,9 @@ void QSortFilterProxyModel::setFilterCaseSensitivity(Qt::CaseSensitivity cs)
     if (o == d->filter_data.patternOptions())
         return;
     d->filter_about_to_be_changed();
+    const FilterChangeHint hint = d->fixed_string_change_hint(d->filter_fixed_string, cs);
     d->filter_data.setPatternOptions(o);
-    d->filter_changed(QSortFilterProxyModelPrivate::Direction::Rows);
+    d->filter_changed(QSortFilterProxyModelPrivate::Direction::Rows, QModelIndex(), hint);
     emit filterCaseSensitivityChanged(cs);
 }
 
@@ -2659,6 +2982,7 @@ void QSortFilterProxyModel::setFilterRegularExpression(const QString &pattern)
     QRegularExpression rx(pattern,
                           d->filter_data.patternOptions() & QRegularExpression::CaseInsensitiveOption);
     d->filter_data.setPattern(pattern);
+    d->filter_is_fixed_string = false;
     d->filter_changed(QSortFilterProxyModelPrivate::Direction::Rows);
 }
 #endif
@@ -2675,6 +2999,7 @@ void QSortFilterProxyModel::setFilterWildcard(const QString &pattern)
     d->filter_about_to_be_changed();
     QString p = QRegularExpression::wildcardToRegularExpression(pattern, QRegularExpression::UnanchoredWildcardConversion);
     d->filter_data.setPattern(p);
+    d->filter_is_fixed_string = false;
     d->filter_changed(QSortFilterProxyModelPrivate::Direction::Rows);
 }
 
@@ -2682,14 +3007,22 @@ void QSortFilterProxyModel::setFilterWildcard(const QString &pattern)
     Sets the fixed string used to filter the contents
     of the source model to the given \a pattern.
 
+    If \l incrementalFilteringEnabled is true and \a pattern contains the
+    previous fixed string, only the rows that are currently accepted are
+    filtered again; if the previous fixed string contains \a pattern, only
+    the rows that are currently filtered out are.
+
     \sa setFilterCaseSensitivity(), setFilterRegularExpression(), setFilterWildcard(), filterRegularExpression()
 */
 void QSortFilterProxyModel::setFilterFixedString(const QString &pattern)
 {
     Q_D(QSortFilterProxyModel);
     d->filter_about_to_be_changed();
+    const FilterChangeHint hint = d->fixed_string_change_hint(pattern, filterCaseSensitivity());
     d->filter_data.setPattern(QRegularExpression::escape(pattern));
-    d->filter_changed(QSortFilterProxyModelPrivate::Direction::Rows);
+    d->filter_is_fixed_string = true;
+    d->filter_fixed_string = pattern;
+    d->filter_changed(QSortFilterProxyModelPrivate::Direction::Rows, QModelIndex(), hint);
 }
 
 /*!
@@ -2860,6 +3193,144 @@ void QSortFilterProxyModel::setAutoAcceptChildRows(bool accept)
     emit autoAcceptChildRowsChanged(accept);
 }
 
+/*!
+    \since 6.1
+    \property QSortFilterProxyModel::incrementalFilteringEnabled
+    \brief whether changes of the fixed string filter only filter again the
+    rows whose state they can change.
+
+    When this property is true and the filter is set with
+    setFilterFixedString(), changing it to a string that contains the
+    previous one, like while the user is typing it, only filters the rows
+    that are currently accepted again. Changing it to a string that is
+    contained in the previous one only filters the rows that are currently
+    filtered out again. The same applies to making the filter case sensitive
+    or case insensitive.
+
+    Only enable this if filterAcceptsRow() accepts a row only if its data
+    matches filterRegularExpression(), like the default implementation
+    does. Subclasses with other filters can pass a FilterChangeHint to
+    invalidateRowsFilter() instead.
+
+    The default value is false.
+
+    \sa setFilterFixedString(), invalidateRowsFilter(), layoutChangeFilteringEnabled
+*/
+
+/*!
+    \since 6.1
+    \fn void QSortFilterProxyModel::incrementalFilteringEnabledChanged(bool incrementalFilteringEnabled)
+
+    \brief This signal is emitted when the value of the \a incrementalFilteringEnabled
+    property is changed.
+
+    \sa incrementalFilteringEnabled
+*/
+bool QSortFilterProxyModel::isIncrementalFilteringEnabled() const
+{
+    Q_D(const QSortFilterProxyModel);
+    return d->incremental_filter;
+}
+
+void QSortFilterProxyModel::setIncrementalFilteringEnabled(bool incremental)
+{
+    Q_D(QSortFilterProxyModel);
+    if (d->incremental_filter == incremental)
+        return;
+    d->incremental_filter = incremental;
+    emit incrementalFilteringEnabledChanged(incremental);
+}
+
+/*!
+    \since 6.1
+    \property QSortFilterProxyModel::layoutChangeFilteringEnabled
+    \brief whether filter changes that remove or insert many separate ranges
+    of rows are reported as a layout change.
+
+    When this property is true, a filter change that would remove or insert
+    a large number of separate ranges of rows is reported with
+    layoutAboutToBeChanged() and layoutChanged() instead of
+    rowsAboutToBeRemoved(), rowsRemoved(), rowsAboutToBeInserted() and
+    rowsInserted() for each range. This is much faster for large models, but
+    views and other users of the model then only learn that the rows have
+    changed, not which rows were removed or inserted. Persistent indexes of
+    rows that were filtered out become invalid either way.
+
+    The default value is false.
+
+    \sa incrementalFilteringEnabled
+*/
+
+/*!
+    \since 6.1
+    \fn void QSortFilterProxyModel::layoutChangeFilteringEnabledChanged(bool layoutChangeFilteringEnabled)
+
+    \brief This signal is emitted when the value of the \a layoutChangeFilteringEnabled
+    property is changed.
+
+    \sa layoutChangeFilteringEnabled
+*/
+bool QSortFilterProxyModel::isLayoutChangeFilteringEnabled() const
+{
+    Q_D(const QSortFilterProxyModel);
+    return d->layout_change_filter;
+}
+
+void QSortFilterProxyModel::setLayoutChangeFilteringEnabled(bool layoutChange)
+{
+    Q_D(QSortFilterProxyModel);
+    if (d->layout_change_filter == layoutChange)
+        return;
+    d->layout_change_filter = layoutChange;
+    emit layoutChangeFilteringEnabledChanged(layoutChange);
+}
+
+/*!
+    \since 6.1
+    \property QSortFilterProxyModel::parallelSortFilterEnabled
+    \brief whether large numbers of rows are sorted and filtered on several
+    threads.
+
+    When this property is true, filterAcceptsRow(), filterAcceptsColumn()
+    and lessThan() are called from the threads of
+    QThreadPool::globalInstance() as well as from the proxy model's thread
+    when many rows are filtered or sorted at once, for instance when the
+    filter changes. They must then be safe to call concurrently, and so must
+    the source model's index(), parent(), rowCount() and data() functions
+    that they use. They must not use the proxy model itself.
+
+    Rows that compare equal keep the same order as when sorting on a single
+    thread.
+
+    The default value is false.
+
+    \sa lessThan(), filterAcceptsRow()
+*/
+
+/*!
+    \since 6.1
+    \fn void QSortFilterProxyModel::parallelSortFilterEnabledChanged(bool parallelSortFilterEnabled)
+
+    \brief This signal is emitted when the value of the \a parallelSortFilterEnabled
+    property is changed.
+
+    \sa parallelSortFilterEnabled
+*/
+bool QSortFilterProxyModel::isParallelSortFilterEnabled() const
+{
+    Q_D(const QSortFilterProxyModel);
+    return d->parallel_sortfilter;
+}
+
+void QSortFilterProxyModel::setParallelSortFilterEnabled(bool parallel)
+{
+    Q_D(QSortFilterProxyModel);
+    if (d->parallel_sortfilter == parallel)
+        return;
+    d->parallel_sortfilter = parallel;
+    emit parallelSortFilterEnabledChanged(parallel);
+}
+
 /*!
    \since 4.3
 
@@ -2937,6 +3408,30 @@ void QSortFilterProxyModel::invalidateRowsFilter()
     d->filter_changed(QSortFilterProxyModelPrivate::Direction::Rows);
 }
 
+/*!
+   \since 6.1
+   \overload
+
+   Invalidates the current filtering for the rows, where \a hint tells how
+   the filter parameters have changed.
+
+   When the filter has become narrower, so that filterAcceptsRow() cannot
+   accept any row that it rejected before, pass NarrowingFilterHint: only
+   the rows that are currently accepted are then filtered again. When it has
+   become wider, so that filterAcceptsRow() cannot reject any row that it
+   accepted before, pass WideningFilterHint: only the rows that are
+   currently filtered out are then filtered again. With large source
+   models, this makes changes of the filter, like each key press while the
+   user types a search string, a lot faster.
+
+   \sa incrementalFilteringEnabled
+*/
+void QSortFilterProxyModel::invalidateRowsFilter(FilterChangeHint hint)
+{
+    Q_D(QSortFilterProxyModel);
+    d->filter_changed(QSortFilterProxyModelPrivate::Direction::Rows, QModelIndex(), hint);
+}
+
 /*!
     Returns \c true if the value of the item referred to by the given
     index \a source_left is less than the value of the item referred to by
@@ -2977,6 +3472,20 @@ void QSortFilterProxyModel::invalidateRowsFilter()
 bool QSortFilterProxyModel::lessThan(const QModelIndex &source_left, const QModelIndex &source_right) const
 {
     Q_D(const QSortFilterProxyModel);
+    if (const QSortFilterProxyModelSortKeys *keys = d->sort_keys) {
+        if (keys->values.isEmpty()) {
+            keys->used = true;
+        } else {
+            // the keys only apply to the indexes being sorted
+            const int left = source_left.row() - keys->first_row;
+            const int right = source_right.row() - keys->first_row;
+            if (left >= 0 && left < keys->indexes.size() && keys->indexes.at(left) == source_left
+                && right >= 0 && right < keys->indexes.size() && keys->indexes.at(right) == source_right) {
+                return QAbstractItemModelPrivate::isVariantLessThan(keys->values.at(left), keys->values.at(right),
+                                                                    d->sort_casesensitivity, d->sort_localeaware);
+            }
+        }
+    }
     QVariant l = (source_left.model() ? source_left.model()->data(source_left, d->sort_role) : QVariant());
     QVariant r = (source_right.model() ? source_right.model()->data(source_right, d->sort_role) : QVariant());
     return QAbstractItemModelPrivate::isVariantLessThan(l, r, d->sort_casesensitivity, d->sort_localeaware);
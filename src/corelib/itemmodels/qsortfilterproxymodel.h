@@ -73,8 +73,18 @@ class Q_CORE_EXPORT QSortFilterProxyModel : public QAbstractProxyModel
     Q_PROPERTY(int filterRole READ filterRole WRITE setFilterRole NOTIFY filterRoleChanged)
     Q_PROPERTY(bool recursiveFilteringEnabled READ isRecursiveFilteringEnabled WRITE setRecursiveFilteringEnabled NOTIFY recursiveFilteringEnabledChanged)
     Q_PROPERTY(bool autoAcceptChildRows READ autoAcceptChildRows WRITE setAutoAcceptChildRows NOTIFY autoAcceptChildRowsChanged)
+    Q_PROPERTY(bool incrementalFilteringEnabled READ isIncrementalFilteringEnabled WRITE setIncrementalFilteringEnabled NOTIFY incrementalFilteringEnabledChanged)
+    Q_PROPERTY(bool layoutChangeFilteringEnabled READ isLayoutChangeFilteringEnabled WRITE setLayoutChangeFilteringEnabled NOTIFY layoutChangeFilteringEnabledChanged)
+    Q_PROPERTY(bool parallelSortFilterEnabled READ isParallelSortFilterEnabled WRITE setParallelSortFilterEnabled NOTIFY parallelSortFilterEnabledChanged)
 
 public:
+    enum FilterChangeHint {
+        NoFilterChangeHint,
+        NarrowingFilterHint,
+        WideningFilterHint
+    };
+    Q_ENUM(FilterChangeHint)
+
     explicit QSortFilterProxyModel(QObject *parent = nullptr);
     ~QSortFilterProxyModel();
 
@@ -120,6 +130,15 @@ public:
     bool autoAcceptChildRows() const;
     void setAutoAcceptChildRows(bool accept);
 
+    bool isIncrementalFilteringEnabled() const;
+    void setIncrementalFilteringEnabled(bool incremental);
+
+    bool isLayoutChangeFilteringEnabled() const;
+    void setLayoutChangeFilteringEnabled(bool layoutChange);
+
+    bool isParallelSortFilterEnabled() const;
+    void setParallelSortFilterEnabled(bool parallel);
+
 public Q_SLOTS:
 #if QT_CONFIG(regularexpression)
     void setFilterRegularExpression(const QString &pattern);
@@ -136,6 +155,7 @@ protected:
 
     void invalidateFilter();
     void invalidateRowsFilter();
+    void invalidateRowsFilter(FilterChangeHint hint);
     void invalidateColumnsFilter();
 
 public:
@@ -189,6 +209,9 @@ Q_SIGNALS:
     void filterRoleChanged(int filterRole);
     void recursiveFilteringEnabledChanged(bool recursiveFilteringEnabled);
     void autoAcceptChildRowsChanged(bool autoAcceptChildRows);
+    void incrementalFilteringEnabledChanged(bool incrementalFilteringEnabled);
+    void layoutChangeFilteringEnabledChanged(bool layoutChangeFilteringEnabled);
+    void parallelSortFilterEnabledChanged(bool parallelSortFilterEnabled);
 
 private:
     Q_DECLARE_PRIVATE(QSortFilterProxyModel)
@@ -42,6 +42,7 @@
 */
 
 #include "qstringlistmodel.h"
+#include "qabstractitemmodel_p.h"
 
 #include <QtCore/qlist.h>
 
@@ -49,6 +50,30 @@
 
 QT_BEGIN_NAMESPACE
 
+class QStringListModelPrivate : public QAbstractItemModelPrivate
+{
+    Q_DECLARE_PUBLIC(QStringListModel)
+public:
+    void columnData(int column, int firstRow, int lastRow, int role, QVariant *values,
+                    const QModelIndex &parent) const override;
+};
+
+void QStringListModelPrivate::columnData(int column, int firstRow, int lastRow, int role,
+                                         QVariant *values, const QModelIndex &parent) const
+{
+    Q_Q(const QStringListModel);
+    const bool hasData = column == 0 && !parent.isValid()
+            && (role == Qt::DisplayRole || role == Qt::EditRole);
+    const QStringList &lst = q->lst;
+    for (int row = firstRow; row <= lastRow; ++row) {
+        if (hasData && row >= 0 && row < lst.size())
+            values->setValue(lst.at(row));
+        else
+            *values = QVariant();
+        ++values;
+    }
+}
+
 /*!
     \class QStringListModel
     \inmodule QtCore
@@ -91,7 +116,7 @@ QT_BEGIN_NAMESPACE
 */
 
 QStringListModel::QStringListModel(QObject *parent)
-    : QAbstractListModel(parent)
+    : QAbstractListModel(*new QStringListModelPrivate, parent)
 {
 }
 
@@ -101,7 +126,7 @@ QStringListModel::QStringListModel(QObject *parent)
 */
 
 QStringListModel::QStringListModel(const QStringList &strings, QObject *parent)
-    : QAbstractListModel(parent), lst(strings)
+    : QAbstractListModel(*new QStringListModelPrivate, parent), lst(strings)
 {
 }
 
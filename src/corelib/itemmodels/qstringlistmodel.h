@@ -47,6 +47,8 @@ QT_REQUIRE_CONFIG(stringlistmodel);
 
 QT_BEGIN_NAMESPACE
 
+class QStringListModelPrivate;
+
 class Q_CORE_EXPORT QStringListModel : public QAbstractListModel
 {
     Q_OBJECT
@@ -78,6 +80,7 @@ public:
     Qt::DropActions supportedDropActions() const override;
 
 private:
+    Q_DECLARE_PRIVATE(QStringListModel)
     Q_DISABLE_COPY(QStringListModel)
     QStringList lst;
 };
@@ -69,6 +69,7 @@ QMimeDatabasePrivate *QMimeDatabasePrivate::instance()
 QMimeDatabasePrivate::QMimeDatabasePrivate()
     : m_defaultMimeType(QLatin1String("application/octet-stream"))
 {
+    m_clock.start();
 }
 
 QMimeDatabasePrivate::~QMimeDatabasePrivate()
@@ -84,16 +85,43 @@ int qmime_secondsBetweenChecks = 5;
 
 bool QMimeDatabasePrivate::shouldCheck()
 {
-    if (m_lastCheck.isValid() && m_lastCheck.elapsed() < qmime_secondsBetweenChecks * 1000)
+    const qint64 now = m_clock.elapsed();
+    const qint64 lastCheck = m_lastCheck.loadRelaxed();
+    if (now - lastCheck < qmime_secondsBetweenChecks * 1000)
         return false;
-    m_lastCheck.start();
-    return true;
+    // only one of the threads getting here checks, the others carry on
+    return m_lastCheck.testAndSetRelaxed(lastCheck, now);
 }
 
 #if defined(Q_OS_UNIX) && !defined(Q_OS_NACL) && !defined(Q_OS_INTEGRITY)
 #  define QT_USE_MMAP
 #endif
 
+static std::shared_ptr<QMimeProviderBase> createProvider(QMimeDatabasePrivate *db, const QString &mimeDir)
+{
+    std::shared_ptr<QMimeProviderBase> provider;
+#if defined(QT_USE_MMAP)
+    const QString cacheFile = mimeDir + QStringLiteral("/mime.cache");
+    if (qEnvironmentVariableIsEmpty("QT_NO_MIME_CACHE") && QFileInfo::exists(cacheFile)) {
+        provider = std::make_shared<QMimeBinaryProvider>(db, mimeDir);
+        //qDebug() << "Created binary provider for" << mimeDir;
+        if (!provider->isValid()) {
+            provider.reset();
+        }
+    }
+#endif
+    if (!provider) {
+        provider = std::make_shared<QMimeXMLProvider>(db, mimeDir);
+        //qDebug() << "Created XML provider for" << mimeDir;
+    }
+    return provider;
+}
+
+/*!
+    \internal
+    Publishes a new list of providers if the MIME directories or their
+    contents changed. Must be called with m_providersMutex locked.
+ */
 void QMimeDatabasePrivate::loadProviders()
 {
     // We use QStandardPaths every time to check if new files appeared
@@ -104,76 +132,68 @@ void QMimeDatabasePrivate::loadProviders()
     const bool needInternalDB = QMimeXMLProvider::InternalDatabaseAvailable && fdoIterator == mimeDirs.constEnd();
     //qDebug() << "mime dirs:" << mimeDirs;
 
-    Providers currentProviders;
-    std::swap(m_providers, currentProviders);
+    static const Providers noProviders;
+    const Providers *current = m_providers.loadRelaxed();
+    const Providers &currentProviders = current ? *current : noProviders;
 
-    m_providers.reserve(mimeDirs.size() + (needInternalDB ? 1 : 0));
+    Providers newProviders;
+    newProviders.reserve(mimeDirs.size() + (needInternalDB ? 1 : 0));
 
     for (const QString &mimeDir : mimeDirs) {
-        const QString cacheFile = mimeDir + QStringLiteral("/mime.cache");
-        QFileInfo fileInfo(cacheFile);
-        // Check if we already have a provider for this dir
-        const auto predicate = [mimeDir](const std::unique_ptr<QMimeProviderBase> &prov)
+        // Check if we already have a provider for this dir, that is still up to date
+        const auto predicate = [mimeDir](const std::shared_ptr<QMimeProviderBase> &prov)
         {
             return prov && prov->directory() == mimeDir;
         };
         const auto it = std::find_if(currentProviders.begin(), currentProviders.end(), predicate);
-        if (it == currentProviders.end()) {
-            std::unique_ptr<QMimeProviderBase> provider;
-#if defined(QT_USE_MMAP)
-            if (qEnvironmentVariableIsEmpty("QT_NO_MIME_CACHE") && fileInfo.exists()) {
-                provider.reset(new QMimeBinaryProvider(this, mimeDir));
-                //qDebug() << "Created binary provider for" << mimeDir;
-                if (!provider->isValid()) {
-                    provider.reset();
-                }
-            }
-#endif
-            if (!provider) {
-                provider.reset(new QMimeXMLProvider(this, mimeDir));
-                //qDebug() << "Created XML provider for" << mimeDir;
-            }
-            m_providers.push_back(std::move(provider));
-        } else {
-            auto provider = std::move(*it); // take provider out of the vector
-            provider->ensureLoaded();
-            if (!provider->isValid()) {
-                provider.reset(new QMimeXMLProvider(this, mimeDir));
-                //qDebug() << "Created XML provider to replace binary provider for" << mimeDir;
-            }
-            m_providers.push_back(std::move(provider));
-        }
+        if (it != currentProviders.end() && (*it)->isUpToDate())
+            newProviders.push_back(*it);
+        else
+            newProviders.push_back(createProvider(this, mimeDir));
     }
     // mimeDirs is sorted "most local first, most global last"
     // so the internal XML DB goes at the end
     if (needInternalDB) {
         // Check if we already have a provider for the InternalDatabase
-        const auto isInternal = [](const std::unique_ptr<QMimeProviderBase> &prov)
+        const auto isInternal = [](const std::shared_ptr<QMimeProviderBase> &prov)
         {
             return prov && prov->isInternalDatabase();
         };
         const auto it = std::find_if(currentProviders.begin(), currentProviders.end(), isInternal);
-        if (it == currentProviders.end()) {
-            m_providers.push_back(Providers::value_type(new QMimeXMLProvider(this, QMimeXMLProvider::InternalDatabase)));
-        } else {
-            m_providers.push_back(std::move(*it));
-        }
+        if (it == currentProviders.end())
+            newProviders.push_back(std::make_shared<QMimeXMLProvider>(this, QMimeXMLProvider::InternalDatabase));
+        else
+            newProviders.push_back(*it);
     }
+
+    if (current && newProviders == *current)
+        return; // nothing changed
+    m_providerLists.push_back(std::make_unique<const Providers>(std::move(newProviders)));
+    m_providers.storeRelease(m_providerLists.back().get());
 }
 
+/*!
+    \internal
+    Returns the providers to look MIME types up in. This does not lock
+    anything, unless the providers have to be loaded or checked for changes.
+ */
 const QMimeDatabasePrivate::Providers &QMimeDatabasePrivate::providers()
 {
-#ifndef Q_OS_WASM // stub implementation always returns true
-    Q_ASSERT(!mutex.tryLock()); // caller should have locked mutex
-#endif
-    if (m_providers.empty()) {
-        loadProviders();
-        m_lastCheck.start();
-    } else {
-        if (shouldCheck())
+    const Providers *current = m_providers.loadAcquire();
+    if (Q_UNLIKELY(!current)) {
+        QMutexLocker locker(&m_providersMutex);
+        current = m_providers.loadRelaxed();
+        if (!current) {
+            m_lastCheck.storeRelaxed(m_clock.elapsed());
             loadProviders();
+            current = m_providers.loadRelaxed();
+        }
+    } else if (shouldCheck()) {
+        QMutexLocker locker(&m_providersMutex);
+        loadProviders();
+        current = m_providers.loadRelaxed();
     }
-    return m_providers;
+    return *current;
 }
 
 QString QMimeDatabasePrivate::resolveAlias(const QString &nameOrAlias)
@@ -276,13 +296,11 @@ static QString fallbackParent(const QString &mimeTypeName)
 
 QStringList QMimeDatabasePrivate::mimeParents(const QString &mimeName)
 {
-    QMutexLocker locker(&mutex);
     return parents(mimeName);
 }
 
 QStringList QMimeDatabasePrivate::parents(const QString &mimeName)
 {
-    Q_ASSERT(!mutex.tryLock());
     QStringList result;
     for (const auto &provider : providers())
         provider->addParents(mimeName, result);
@@ -296,7 +314,6 @@ QStringList QMimeDatabasePrivate::parents(const QString &mimeName)
 
 QStringList QMimeDatabasePrivate::listAliases(const QString &mimeName)
 {
-    QMutexLocker locker(&mutex);
     QStringList result;
     for (const auto &provider : providers())
         provider->addAliases(mimeName, result);
@@ -305,7 +322,6 @@ QStringList QMimeDatabasePrivate::listAliases(const QString &mimeName)
 
 bool QMimeDatabasePrivate::mimeInherits(const QString &mime, const QString &parent)
 {
-    QMutexLocker locker(&mutex);
     return inherits(mime, parent);
 }
 
@@ -513,8 +529,6 @@ QMimeDatabase::~QMimeDatabase()
  */
 QMimeType QMimeDatabase::mimeTypeForName(const QString &nameOrAlias) const
 {
-    QMutexLocker locker(&d->mutex);
-
     return d->mimeTypeForName(nameOrAlias);
 }
 
@@ -548,8 +562,6 @@ QMimeType QMimeDatabase::mimeTypeForName(const QString &nameOrAlias) const
 */
 QMimeType QMimeDatabase::mimeTypeForFile(const QFileInfo &fileInfo, MatchMode mode) const
 {
-    QMutexLocker locker(&d->mutex);
-
     if (fileInfo.isDir())
         return d->mimeTypeForName(QLatin1String("inode/directory"));
 
@@ -578,11 +590,9 @@ QMimeType QMimeDatabase::mimeTypeForFile(const QFileInfo &fileInfo, MatchMode mo
         file.open(QIODevice::ReadOnly); // isOpen() will be tested by method below
         return d->mimeTypeForFileNameAndData(fileInfo.absoluteFilePath(), &file, &priority);
     case MatchExtension:
-        locker.unlock();
         return mimeTypeForFile(fileInfo.absoluteFilePath(), mode);
     case MatchContent:
         if (file.open(QIODevice::ReadOnly)) {
-            locker.unlock();
             return mimeTypeForData(&file);
         } else {
             return d->mimeTypeForName(d->defaultMimeType());
@@ -601,7 +611,6 @@ QMimeType QMimeDatabase::mimeTypeForFile(const QFileInfo &fileInfo, MatchMode mo
 QMimeType QMimeDatabase::mimeTypeForFile(const QString &fileName, MatchMode mode) const
 {
     if (mode == MatchExtension) {
-        QMutexLocker locker(&d->mutex);
         const QStringList matches = d->mimeTypeForFileName(fileName);
         const int matchCount = matches.count();
         if (matchCount == 0) {
@@ -613,7 +622,6 @@ QMimeType QMimeDatabase::mimeTypeForFile(const QString &fileName, MatchMode mode
             return d->mimeTypeForName(matches.first());
         }
     } else {
-        // Implemented as a wrapper around mimeTypeForFile(QFileInfo), so no mutex.
         QFileInfo fileInfo(fileName);
         return mimeTypeForFile(fileInfo, mode);
     }
@@ -633,8 +641,6 @@ QMimeType QMimeDatabase::mimeTypeForFile(const QString &fileName, MatchMode mode
 */
 QList<QMimeType> QMimeDatabase::mimeTypesForFileName(const QString &fileName) const
 {
-    QMutexLocker locker(&d->mutex);
-
     const QStringList matches = d->mimeTypeForFileName(fileName);
     QList<QMimeType> mimes;
     mimes.reserve(matches.count());
@@ -650,7 +656,6 @@ QList<QMimeType> QMimeDatabase::mimeTypesForFileName(const QString &fileName) co
 */
 QString QMimeDatabase::suffixForFileName(const QString &fileName) const
 {
-    QMutexLocker locker(&d->mutex);
     const int suffixLength = d->findByFileName(QFileInfo(fileName).fileName()).m_knownSuffixLength;
     return fileName.right(suffixLength);
 }
@@ -664,8 +669,6 @@ QString QMimeDatabase::suffixForFileName(const QString &fileName) const
 */
 QMimeType QMimeDatabase::mimeTypeForData(const QByteArray &data) const
 {
-    QMutexLocker locker(&d->mutex);
-
     int accuracy = 0;
     return d->findByData(data, &accuracy);
 }
@@ -679,8 +682,6 @@ QMimeType QMimeDatabase::mimeTypeForData(const QByteArray &data) const
 */
 QMimeType QMimeDatabase::mimeTypeForData(QIODevice *device) const
 {
-    QMutexLocker locker(&d->mutex);
-
     int accuracy = 0;
     const bool openedByUs = !device->isOpen() && device->open(QIODevice::ReadOnly);
     if (device->isOpen()) {
@@ -742,7 +743,6 @@ QMimeType QMimeDatabase::mimeTypeForUrl(const QUrl &url) const
 */
 QMimeType QMimeDatabase::mimeTypeForFileNameAndData(const QString &fileName, QIODevice *device) const
 {
-    QMutexLocker locker(&d->mutex);
     int accuracy = 0;
     const bool openedByUs = !device->isOpen() && device->open(QIODevice::ReadOnly);
     const QMimeType result = d->mimeTypeForFileNameAndData(fileName, device, &accuracy);
@@ -769,7 +769,6 @@ QMimeType QMimeDatabase::mimeTypeForFileNameAndData(const QString &fileName, QIO
 */
 QMimeType QMimeDatabase::mimeTypeForFileNameAndData(const QString &fileName, const QByteArray &data) const
 {
-    QMutexLocker locker(&d->mutex);
     QBuffer buffer(const_cast<QByteArray *>(&data));
     buffer.open(QIODevice::ReadOnly);
     int accuracy = 0;
@@ -785,8 +784,6 @@ QMimeType QMimeDatabase::mimeTypeForFileNameAndData(const QString &fileName, con
 */
 QList<QMimeType> QMimeDatabase::allMimeTypes() const
 {
-    QMutexLocker locker(&d->mutex);
-
     return d->allMimeTypes();
 }
 
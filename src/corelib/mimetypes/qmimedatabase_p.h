@@ -59,6 +59,7 @@ QT_REQUIRE_CONFIG(mimetype);
 #include "qmimetype_p.h"
 #include "qmimeglobpattern_p.h"
 
+#include <QtCore/qatomic.h>
 #include <QtCore/qelapsedtimer.h>
 #include <QtCore/qlist.h>
 #include <QtCore/qmutex.h>
@@ -96,7 +97,7 @@ public:
     QStringList mimeTypeForFileName(const QString &fileName);
     QMimeGlobMatchResult findByFileName(const QString &fileName);
 
-    // API for QMimeType. Takes care of locking the mutex.
+    // API for QMimeType. Takes care of locking the mutex for updating the QMimeTypePrivate.
     void loadMimeTypePrivate(QMimeTypePrivate &mimePrivate);
     void loadGenericIcon(QMimeTypePrivate &mimePrivate);
     void loadIcon(QMimeTypePrivate &mimePrivate);
@@ -105,13 +106,19 @@ public:
     bool mimeInherits(const QString &mime, const QString &parent);
 
 private:
-    using Providers = std::vector<std::unique_ptr<QMimeProviderBase>>;
+    using Providers = std::vector<std::shared_ptr<QMimeProviderBase>>;
     const Providers &providers();
     bool shouldCheck();
     void loadProviders();
 
-    mutable Providers m_providers;
-    QElapsedTimer m_lastCheck;
+    // Lookups use the current list of providers without locking. A list that
+    // got replaced may still be in use, so all of them are kept until the
+    // database is destroyed; that only happens when the MIME data changed.
+    QAtomicPointer<const Providers> m_providers;
+    std::vector<std::unique_ptr<const Providers>> m_providerLists;
+    QMutex m_providersMutex; // protects m_providerLists and loading
+    QElapsedTimer m_clock;
+    QAtomicInteger<qint64> m_lastCheck;
 
 public:
     const QString m_defaultMimeType;
@@ -97,50 +97,40 @@ bool QMimeMagicRule::operator==(const QMimeMagicRule &other) const
 bool QMimeMagicRule::matchSubstring(const char *dataPtr, int dataSize, int rangeStart, int rangeLength,
                                     int valueLength, const char *valueData, const char *mask)
 {
-    // Size of searched data.
-    // Example: value="ABC", rangeLength=3 -> we need 3+3-1=5 bytes (ABCxx,xABCx,xxABC would match)
-    const int dataNeeded = qMin(rangeLength + valueLength - 1, dataSize - rangeStart);
-
-    if (!mask) {
-        // callgrind says QByteArray::indexOf is much slower, since our strings are typically too
-        // short for be worth Boyer-Moore matching (1 to 71 bytes, 11 bytes on average).
-        bool found = false;
-        for (int i = rangeStart; i < rangeStart + rangeLength; ++i) {
-            if (i + valueLength > dataSize)
-                break;
-
-            if (memcmp(valueData, dataPtr + i, valueLength) == 0) {
-                found = true;
-                break;
-            }
+    // One past the last position the value can start at.
+    // Example: value="ABC", rangeLength=3 -> we need 3+3-1=5 bytes (ABCxx,xABCx,xxABC would match),
+    // but if dataSize is 4, only positions 0 and 1 can match (ABCx and xABC).
+    const int end = qMin(rangeStart + rangeLength, dataSize - valueLength + 1);
+
+    // callgrind says QByteArray::indexOf is much slower, since our strings are typically too
+    // short for be worth Boyer-Moore matching (1 to 71 bytes, 11 bytes on average).
+    // Instead, unless the first byte is masked, let memchr, which is vectorized, skip to the
+    // positions starting with the right byte.
+    const bool findFirst = !mask || uchar(mask[0]) == 0xff;
+    for (int i = rangeStart; i < end; ++i) {
+        if (findFirst) {
+            const void *first = memchr(dataPtr + i, valueData[0], end - i);
+            if (!first)
+                return false;
+            i = static_cast<const char *>(first) - dataPtr;
         }
-        if (!found)
-            return false;
-    } else {
-        bool found = false;
-        const char *readDataBase = dataPtr + rangeStart;
-        // Example (continued from above):
-        // deviceSize is 4, so dataNeeded was max'ed to 4.
-        // maxStartPos = 4 - 3 + 1 = 2, and indeed
-        // we need to check for a match a positions 0 and 1 (ABCx and xABC).
-        const int maxStartPos = dataNeeded - valueLength + 1;
-        for (int i = 0; i < maxStartPos; ++i) {
-            const char *d = readDataBase + i;
+        if (!mask) {
+            if (memcmp(valueData, dataPtr + i, valueLength) == 0)
+                return true;
+        } else {
+            const char *d = dataPtr + i;
             bool valid = true;
             for (int idx = 0; idx < valueLength; ++idx) {
-                if (((*d++) & mask[idx]) != (valueData[idx] & mask[idx])) {
+                if ((d[idx] & mask[idx]) != (valueData[idx] & mask[idx])) {
                     valid = false;
                     break;
                 }
             }
             if (valid)
-                found = true;
+                return true;
         }
-        if (!found)
-            return false;
     }
-    //qDebug() << "Found" << value << "in" << searchedData;
-    return true;
+    return false;
 }
 
 bool QMimeMagicRule::matchString(const QByteArray &data) const
@@ -337,6 +327,49 @@ QByteArray QMimeMagicRule::mask() const
     return result;
 }
 
+template <typename T>
+static inline uchar firstByteInMemory(quint32 number)
+{
+    uchar bytes[sizeof(T)];
+    qToUnaligned(T(number), bytes);
+    return bytes[0];
+}
+
+// Returns the value that the byte at startPos() must have for this rule to
+// match, or -1 if the rule can match at more than one offset or the first
+// byte is masked. Used to index the rules by their first byte.
+int QMimeMagicRule::anchorByte() const
+{
+    if (!m_matchFunction || m_startPos != m_endPos)
+        return -1;
+
+    uchar value;
+    uchar mask;
+    switch (m_type) {
+    case String:
+        if (m_pattern.isEmpty())
+            return -1;
+        value = m_pattern.at(0);
+        mask = m_mask.at(0);
+        break;
+    case Byte:
+        value = firstByteInMemory<quint8>(m_number);
+        mask = firstByteInMemory<quint8>(m_numberMask);
+        break;
+    case Host16:
+    case Big16:
+    case Little16:
+        value = firstByteInMemory<quint16>(m_number);
+        mask = firstByteInMemory<quint16>(m_numberMask);
+        break;
+    default:
+        value = firstByteInMemory<quint32>(m_number);
+        mask = firstByteInMemory<quint32>(m_numberMask);
+        break;
+    }
+    return mask == 0xff ? value : -1;
+}
+
 bool QMimeMagicRule::matches(const QByteArray &data) const
 {
     const bool ok = m_matchFunction && (this->*m_matchFunction)(data);
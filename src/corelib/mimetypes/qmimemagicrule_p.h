@@ -93,6 +93,7 @@ public:
     bool isValid() const { return m_matchFunction != nullptr; }
 
     bool matches(const QByteArray &data) const;
+    int anchorByte() const;
 
     QList<QMimeMagicRule> m_subMatches;
 
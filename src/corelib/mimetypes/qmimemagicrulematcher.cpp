@@ -43,6 +43,8 @@
 
 #include "qmimetype_p.h"
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 /*!
@@ -81,7 +83,7 @@ void QMimeMagicRuleMatcher::addRules(const QList<QMimeMagicRule> &rules)
     m_list.append(rules);
 }
 
-QList<QMimeMagicRule> QMimeMagicRuleMatcher::magicRules() const
+const QList<QMimeMagicRule> &QMimeMagicRuleMatcher::magicRules() const
 {
     return m_list;
 }
@@ -103,4 +105,95 @@ unsigned QMimeMagicRuleMatcher::priority() const
     return m_priority;
 }
 
+/*!
+    \internal
+    \class QMimeMagicRuleIndex
+    \inmodule QtCore
+
+    \brief The QMimeMagicRuleIndex class finds the magic rules that can match some data.
+
+    Most magic rules compare data at one fixed offset, with an unmasked first
+    byte. These rules are bucketed by offset and indexed by the value of that
+    byte, so that looking up the candidates for some data takes one pass over
+    the offsets used by any rule, with a bit test for each, instead of
+    checking every rule. All other rules are always candidates.
+
+    Both providers use it for the top-level rules of their matchers. The
+    matchers are numbered in the order in which they should be tried, so that
+    the first candidate that matches is the best match.
+
+    \sa QMimeMagicRule, QMimeMagicRuleMatcher
+*/
+
+/*!
+    \internal
+    Adds rule \a rule of matcher \a matcher. If \a anchorByte is not -1, the
+    rule can only match when the byte at \a offset is \a anchorByte.
+
+    Call finish() once all rules are added.
+*/
+void QMimeMagicRuleIndex::addRule(int matcher, int rule, int offset, int anchorByte)
+{
+    if (anchorByte < 0 || offset < 0)
+        m_unanchored.push_back({ matcher, rule });
+    else
+        m_entries.push_back({ offset, anchorByte, { matcher, rule } });
+}
+
+/*!
+    \internal
+    Builds the lookup structure from the rules added with addRule().
+*/
+void QMimeMagicRuleIndex::finish()
+{
+    std::sort(m_entries.begin(), m_entries.end(), [](const Entry &lhs, const Entry &rhs) {
+        if (lhs.offset != rhs.offset)
+            return lhs.offset < rhs.offset;
+        if (lhs.byte != rhs.byte)
+            return lhs.byte < rhs.byte;
+        return lhs.rule < rhs.rule;
+    });
+    std::sort(m_unanchored.begin(), m_unanchored.end());
+
+    m_buckets.clear();
+    for (int i = 0; i < int(m_entries.size()); ++i) {
+        const Entry &entry = m_entries[i];
+        if (m_buckets.empty() || m_buckets.back().offset != entry.offset)
+            m_buckets.push_back({ entry.offset, i, i, {} });
+        Bucket &bucket = m_buckets.back();
+        bucket.end = i + 1;
+        bucket.bytes[entry.byte / 32] |= 1u << (entry.byte % 32);
+    }
+    m_entries.shrink_to_fit();
+    m_buckets.shrink_to_fit();
+    m_unanchored.shrink_to_fit();
+}
+
+/*!
+    \internal
+    Returns the rules that can match the \a size bytes at \a data, sorted by
+    matcher and rule.
+*/
+QMimeMagicRuleIndex::Candidates QMimeMagicRuleIndex::candidates(const char *data, qsizetype size) const
+{
+    Candidates result;
+    for (const Bucket &bucket : m_buckets) {
+        if (bucket.offset >= size)
+            break;
+        const uchar byte = data[bucket.offset];
+        if (!(bucket.bytes[byte / 32] & (1u << (byte % 32))))
+            continue;
+        const auto begin = m_entries.begin() + bucket.begin;
+        const auto end = m_entries.begin() + bucket.end;
+        auto it = std::lower_bound(begin, end, int(byte), [](const Entry &entry, int byte) {
+            return entry.byte < byte;
+        });
+        for ( ; it != end && it->byte == byte; ++it)
+            result.append(it->rule);
+    }
+    result.append(m_unanchored.data(), qsizetype(m_unanchored.size()));
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
 QT_END_NAMESPACE
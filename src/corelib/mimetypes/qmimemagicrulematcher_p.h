@@ -58,6 +58,9 @@ QT_REQUIRE_CONFIG(mimetype);
 #include <QtCore/qbytearray.h>
 #include <QtCore/qlist.h>
 #include <QtCore/qstring.h>
+#include <QtCore/qvarlengtharray.h>
+
+#include <vector>
 
 QT_BEGIN_NAMESPACE
 
@@ -77,7 +80,7 @@ public:
 
     void addRule(const QMimeMagicRule &rule);
     void addRules(const QList<QMimeMagicRule> &rules);
-    QList<QMimeMagicRule> magicRules() const;
+    const QList<QMimeMagicRule> &magicRules() const;
 
     bool matches(const QByteArray &data) const;
 
@@ -92,6 +95,45 @@ private:
 };
 Q_DECLARE_SHARED(QMimeMagicRuleMatcher)
 
+class QMimeMagicRuleIndex
+{
+public:
+    // A top-level rule, as the index of its matcher and its index in there
+    struct Rule
+    {
+        int matcher;
+        int rule;
+
+        friend bool operator<(Rule lhs, Rule rhs)
+        { return lhs.matcher < rhs.matcher || (lhs.matcher == rhs.matcher && lhs.rule < rhs.rule); }
+    };
+    typedef QVarLengthArray<Rule, 64> Candidates;
+
+    void addRule(int matcher, int rule, int offset, int anchorByte);
+    void finish();
+
+    Candidates candidates(const char *data, qsizetype size) const;
+
+private:
+    struct Entry
+    {
+        int offset;
+        int byte;
+        Rule rule;
+    };
+    struct Bucket
+    {
+        int offset;
+        int begin;
+        int end;
+        quint32 bytes[256 / 32];
+    };
+
+    std::vector<Entry> m_entries;
+    std::vector<Bucket> m_buckets;
+    std::vector<Rule> m_unanchored;
+};
+
 QT_END_NAMESPACE
 
 #endif // QMIMEMAGICRULEMATCHER_P_H
@@ -54,6 +54,8 @@
 #include <QDateTime>
 #include <QtEndian>
 
+#include <algorithm>
+
 #if QT_CONFIG(mimetype_database)
 #  if defined(Q_CC_MSVC)
 #    pragma section(".qtmimedatabase", read, shared)
@@ -91,7 +93,7 @@ QMimeProviderBase::QMimeProviderBase(QMimeDatabasePrivate *db, const QString &di
 
 
 QMimeBinaryProvider::QMimeBinaryProvider(QMimeDatabasePrivate *db, const QString &directory)
-    : QMimeProviderBase(db, directory), m_mimetypeListLoaded(false)
+    : QMimeProviderBase(db, directory)
 {
     ensureLoaded();
 }
@@ -115,7 +117,6 @@ struct QMimeBinaryProvider::CacheFile
         return reinterpret_cast<const char *>(data + offset);
     }
     bool load();
-    bool reload();
 
     QFile file;
     uchar *data;
@@ -147,16 +148,6 @@ bool QMimeBinaryProvider::CacheFile::load()
     return m_valid;
 }
 
-bool QMimeBinaryProvider::CacheFile::reload()
-{
-    m_valid = false;
-    if (file.isOpen()) {
-        file.close();
-    }
-    data = nullptr;
-    return load();
-}
-
 QMimeBinaryProvider::~QMimeBinaryProvider()
 {
     delete m_cacheFile;
@@ -185,34 +176,28 @@ enum {
     PosGenericIconsListOffset = 36
 };
 
-bool QMimeBinaryProvider::checkCacheChanged()
+bool QMimeBinaryProvider::isUpToDate() const
 {
-    QFileInfo fileInfo(m_cacheFile->file);
-    if (fileInfo.lastModified() > m_cacheFile->m_mtime) {
-        // Deletion can't happen by just running update-mime-database.
-        // But the user could use rm -rf :-)
-        m_cacheFile->reload(); // will mark itself as invalid on failure
-        return true;
-    }
-    return false;
+    // Deletion can't happen by just running update-mime-database.
+    // But the user could use rm -rf :-)
+    if (!m_cacheFile)
+        return false;
+    QFileInfo fileInfo(m_cacheFile->file.fileName());
+    return fileInfo.exists() && fileInfo.lastModified() <= m_cacheFile->m_mtime;
 }
 
 void QMimeBinaryProvider::ensureLoaded()
 {
-    if (!m_cacheFile) {
-        const QString cacheFileName = m_directory + QLatin1String("/mime.cache");
-        m_cacheFile = new CacheFile(cacheFileName);
-        m_mimetypeListLoaded = false;
-    } else {
-        if (checkCacheChanged())
-            m_mimetypeListLoaded = false;
-        else
-            return; // nothing to do
-    }
+    const QString cacheFileName = m_directory + QLatin1String("/mime.cache");
+    m_cacheFile = new CacheFile(cacheFileName);
     if (!m_cacheFile->isValid()) { // verify existence and version
         delete m_cacheFile;
         m_cacheFile = nullptr;
+        return;
     }
+    // load it now rather than on first use, so that lookups don't modify anything
+    loadMimeTypeList();
+    buildMagicIndex();
 }
 
 static QMimeType mimeTypeForNameUnchecked(const QString &name)
@@ -229,8 +214,6 @@ static QMimeType mimeTypeForNameUnchecked(const QString &name)
 
 QMimeType QMimeBinaryProvider::mimeTypeForName(const QString &name)
 {
-    if (!m_mimetypeListLoaded)
-        loadMimeTypeList();
     if (!m_mimetypeNames.contains(name))
         return QMimeType(); // unknown mimetype
     return mimeTypeForNameUnchecked(name);
@@ -353,18 +336,49 @@ bool QMimeBinaryProvider::matchMagicRule(QMimeBinaryProvider::CacheFile *cacheFi
     return false;
 }
 
-void QMimeBinaryProvider::findByMagic(const QByteArray &data, int *accuracyPtr, QMimeType &candidate)
+// Index the top-level matchlets, which are always checked, by the byte
+// they need at their offset, if they can match at only one
+void QMimeBinaryProvider::buildMagicIndex()
 {
     const int magicListOffset = m_cacheFile->getUint32(PosMagicListOffset);
     const int numMatches = m_cacheFile->getUint32(magicListOffset);
-    //const int maxExtent = cacheFile->getUint32(magicListOffset + 4);
     const int firstMatchOffset = m_cacheFile->getUint32(magicListOffset + 8);
 
     for (int i = 0; i < numMatches; ++i) {
         const int off = firstMatchOffset + i * 16;
         const int numMatchlets = m_cacheFile->getUint32(off + 8);
         const int firstMatchletOffset = m_cacheFile->getUint32(off + 12);
-        if (matchMagicRule(m_cacheFile, numMatchlets, firstMatchletOffset, data)) {
+        for (int matchlet = 0; matchlet < numMatchlets; ++matchlet) {
+            const int matchletOffset = firstMatchletOffset + matchlet * 32;
+            const int rangeStart = m_cacheFile->getUint32(matchletOffset);
+            const int rangeLength = m_cacheFile->getUint32(matchletOffset + 4);
+            const int valueLength = m_cacheFile->getUint32(matchletOffset + 12);
+            const int valueOffset = m_cacheFile->getUint32(matchletOffset + 16);
+            const int maskOffset = m_cacheFile->getUint32(matchletOffset + 20);
+            int anchorByte = -1;
+            if (rangeLength == 1 && valueLength > 0
+                && (!maskOffset || uchar(*m_cacheFile->getCharStar(maskOffset)) == 0xff)) {
+                anchorByte = uchar(*m_cacheFile->getCharStar(valueOffset));
+            }
+            m_magicIndex.addRule(i, matchlet, rangeStart, anchorByte);
+        }
+    }
+    m_magicIndex.finish();
+}
+
+void QMimeBinaryProvider::findByMagic(const QByteArray &data, int *accuracyPtr, QMimeType &candidate)
+{
+    const int magicListOffset = m_cacheFile->getUint32(PosMagicListOffset);
+    //const int maxExtent = cacheFile->getUint32(magicListOffset + 4);
+    const int firstMatchOffset = m_cacheFile->getUint32(magicListOffset + 8);
+
+    // The candidates are in the order of the matches, so the first one
+    // that matches is the first match
+    const auto candidates = m_magicIndex.candidates(data.constData(), data.size());
+    for (const QMimeMagicRuleIndex::Rule &rule : candidates) {
+        const int off = firstMatchOffset + rule.matcher * 16;
+        const int firstMatchletOffset = m_cacheFile->getUint32(off + 12);
+        if (matchMagicRule(m_cacheFile, 1, firstMatchletOffset + rule.rule * 32, data)) {
             const int mimeTypeOffset = m_cacheFile->getUint32(off + 4);
             const char *mimeType = m_cacheFile->getCharStar(mimeTypeOffset);
             *accuracyPtr = m_cacheFile->getUint32(off);
@@ -457,26 +471,21 @@ void QMimeBinaryProvider::addAliases(const QString &name, QStringList &result)
 
 void QMimeBinaryProvider::loadMimeTypeList()
 {
-    if (!m_mimetypeListLoaded) {
-        m_mimetypeListLoaded = true;
-        m_mimetypeNames.clear();
-        // Unfortunately mime.cache doesn't have a full list of all mimetypes.
-        // So we have to parse the plain-text files called "types".
-        QFile file(m_directory + QStringLiteral("/types"));
-        if (file.open(QIODevice::ReadOnly)) {
-            while (!file.atEnd()) {
-                QByteArray line = file.readLine();
-                if (line.endsWith('\n'))
-                    line.chop(1);
-                m_mimetypeNames.insert(QString::fromLatin1(line));
-            }
+    // Unfortunately mime.cache doesn't have a full list of all mimetypes.
+    // So we have to parse the plain-text files called "types".
+    QFile file(m_directory + QStringLiteral("/types"));
+    if (file.open(QIODevice::ReadOnly)) {
+        while (!file.atEnd()) {
+            QByteArray line = file.readLine();
+            if (line.endsWith('\n'))
+                line.chop(1);
+            m_mimetypeNames.insert(QString::fromLatin1(line));
         }
     }
 }
 
 void QMimeBinaryProvider::addAllMimeTypes(QList<QMimeType> &result)
 {
-    loadMimeTypeList();
     if (result.isEmpty()) {
         result.reserve(m_mimetypeNames.count());
         for (const QString &name : qAsConst(m_mimetypeNames))
@@ -673,6 +682,7 @@ QMimeXMLProvider::QMimeXMLProvider(QMimeDatabasePrivate *db, InternalDatabaseEnu
 #endif
 
     load(data, size);
+    buildMagicIndex();
 }
 #else // !QT_CONFIG(mimetype_database)
 // never called in release mode, but some debug builds may need
@@ -722,23 +732,22 @@ void QMimeXMLProvider::addFileNameMatches(const QString &fileName, QMimeGlobMatc
 
 void QMimeXMLProvider::findByMagic(const QByteArray &data, int *accuracyPtr, QMimeType &candidate)
 {
-    QString candidateName;
-    bool foundOne = false;
-    for (const QMimeMagicRuleMatcher &matcher : qAsConst(m_magicMatchers)) {
-        if (matcher.matches(data)) {
-            const int priority = matcher.priority();
-            if (priority > *accuracyPtr) {
-                *accuracyPtr = priority;
-                candidateName = matcher.mimetype();
-                foundOne = true;
-            }
+    // The matchers are sorted by priority, so the first candidate that
+    // matches is the best one
+    const auto candidates = m_magicIndex.candidates(data.constData(), data.size());
+    for (const QMimeMagicRuleIndex::Rule &rule : candidates) {
+        const QMimeMagicRuleMatcher &matcher = m_magicMatchers.at(rule.matcher);
+        if (int(matcher.priority()) <= *accuracyPtr)
+            break;
+        if (matcher.magicRules().at(rule.rule).matches(data)) {
+            *accuracyPtr = matcher.priority();
+            candidate = mimeTypeForName(matcher.mimetype());
+            return;
         }
     }
-    if (foundOne)
-        candidate = mimeTypeForName(candidateName);
 }
 
-void QMimeXMLProvider::ensureLoaded()
+QStringList QMimeXMLProvider::packageFiles() const
 {
     QStringList allFiles;
     const QString packageDir = m_directory + QStringLiteral("/packages");
@@ -747,21 +756,38 @@ void QMimeXMLProvider::ensureLoaded()
     allFiles.reserve(files.count());
     for (const QString &xmlFile : files)
         allFiles.append(packageDir + QLatin1Char('/') + xmlFile);
+    return allFiles;
+}
 
-    if (m_allFiles == allFiles)
-        return;
-    m_allFiles = allFiles;
+bool QMimeXMLProvider::isUpToDate() const
+{
+    return isInternalDatabase() || packageFiles() == m_allFiles;
+}
 
-    m_nameMimeTypeMap.clear();
-    m_aliases.clear();
-    m_parents.clear();
-    m_mimeTypeGlobs.clear();
-    m_magicMatchers.clear();
+void QMimeXMLProvider::ensureLoaded()
+{
+    m_allFiles = packageFiles();
 
     //qDebug() << "Loading" << m_allFiles;
 
-    for (const QString &file : qAsConst(allFiles))
+    for (const QString &file : qAsConst(m_allFiles))
         load(file);
+    buildMagicIndex();
+}
+
+void QMimeXMLProvider::buildMagicIndex()
+{
+    // stable, so that the first of several matchers with the same priority wins
+    std::stable_sort(m_magicMatchers.begin(), m_magicMatchers.end(),
+                     [](const QMimeMagicRuleMatcher &lhs, const QMimeMagicRuleMatcher &rhs) {
+                         return lhs.priority() > rhs.priority();
+                     });
+    for (int i = 0; i < m_magicMatchers.size(); ++i) {
+        const QList<QMimeMagicRule> &rules = m_magicMatchers.at(i).magicRules();
+        for (int j = 0; j < rules.size(); ++j)
+            m_magicIndex.addRule(i, j, rules.at(j).startPos(), rules.at(j).anchorByte());
+    }
+    m_magicIndex.finish();
 }
 
 void QMimeXMLProvider::load(const QString &fileName)
@@ -57,13 +57,17 @@
 QT_REQUIRE_CONFIG(mimetype);
 
 #include "qmimeglobpattern_p.h"
+#include "qmimemagicrulematcher_p.h"
 #include <QtCore/qdatetime.h>
 #include <QtCore/qset.h>
 
 QT_BEGIN_NAMESPACE
 
-class QMimeMagicRuleMatcher;
-
+/*
+   Providers are not modified once loaded, so that lookups can use them
+   from several threads at the same time. When the files a provider was
+   loaded from change, it is replaced by a new one instead.
+ */
 class QMimeProviderBase
 {
 public:
@@ -81,7 +85,7 @@ public:
     virtual void addAllMimeTypes(QList<QMimeType> &result) = 0;
     virtual void loadIcon(QMimeTypePrivate &) {}
     virtual void loadGenericIcon(QMimeTypePrivate &) {}
-    virtual void ensureLoaded() {}
+    virtual bool isUpToDate() const { return true; }
 
     QString directory() const { return m_directory; }
 
@@ -110,22 +114,24 @@ public:
     static void loadMimeTypePrivate(QMimeTypePrivate &);
     void loadIcon(QMimeTypePrivate &) override;
     void loadGenericIcon(QMimeTypePrivate &) override;
-    void ensureLoaded() override;
+    bool isUpToDate() const override;
 
 private:
     struct CacheFile;
 
+    void ensureLoaded();
+
     void matchGlobList(QMimeGlobMatchResult &result, CacheFile *cacheFile, int offset, const QString &fileName);
     bool matchSuffixTree(QMimeGlobMatchResult &result, CacheFile *cacheFile, int numEntries, int firstOffset, const QString &fileName, int charPos, bool caseSensitiveCheck);
     bool matchMagicRule(CacheFile *cacheFile, int numMatchlets, int firstOffset, const QByteArray &data);
     QLatin1String iconForMime(CacheFile *cacheFile, int posListOffset, const QByteArray &inputMime);
     void loadMimeTypeList();
-    bool checkCacheChanged();
+    void buildMagicIndex();
 
     CacheFile *m_cacheFile = nullptr;
     QStringList m_cacheFileNames;
     QSet<QString> m_mimetypeNames;
-    bool m_mimetypeListLoaded;
+    QMimeMagicRuleIndex m_magicIndex;
 };
 
 /*
@@ -153,7 +159,7 @@ public:
     void addAliases(const QString &name, QStringList &result) override;
     void findByMagic(const QByteArray &data, int *accuracyPtr, QMimeType &candidate) override;
     void addAllMimeTypes(QList<QMimeType> &result) override;
-    void ensureLoaded() override;
+    bool isUpToDate() const override;
 
     bool load(const QString &fileName, QString *errorMessage);
 
@@ -165,8 +171,11 @@ public:
     void addMagicMatcher(const QMimeMagicRuleMatcher &matcher);
 
 private:
+    QStringList packageFiles() const;
+    void ensureLoaded();
     void load(const QString &fileName);
     void load(const char *data, qsizetype len);
+    void buildMagicIndex();
 
     typedef QHash<QString, QMimeType> NameMimeTypeMap;
     NameMimeTypeMap m_nameMimeTypeMap;
@@ -178,7 +187,8 @@ private:
     ParentsHash m_parents;
     QMimeAllGlobPatterns m_mimeTypeGlobs;
 
-    QList<QMimeMagicRuleMatcher> m_magicMatchers;
+    QList<QMimeMagicRuleMatcher> m_magicMatchers; // sorted by priority, once loaded
+    QMimeMagicRuleIndex m_magicIndex;
     QStringList m_allFiles;
 };
 
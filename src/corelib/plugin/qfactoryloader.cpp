@@ -58,6 +58,9 @@
 #include "qjsonobject.h"
 #include "qjsonarray.h"
 #include "private/qduplicatetracker_p.h"
+#if QT_CONFIG(library)
+#include "private/qpluginmetadatacache_p.h"
+#endif
 
 #include <qtcore_tracepoints_p.h>
 
@@ -170,6 +173,7 @@ void QFactoryLoader::update()
 {
 #ifdef QT_SHARED
     Q_D(QFactoryLoader);
+    Q_TRACE_SCOPE(QFactoryLoader_update, QString::fromLatin1(d->iid));
     QStringList paths = QCoreApplication::libraryPaths();
     for (int i = 0; i < paths.count(); ++i) {
         const QString &pluginDir = paths.at(i);
@@ -283,6 +287,10 @@ void QFactoryLoader::update()
                 library->release();
             }
         }
+
+        // write back what was learned about the plugins in this directory
+        if (QPluginMetaDataCache *cache = QPluginMetaDataCache::instance())
+            cache->sync();
     }
 #else
     Q_D(QFactoryLoader);
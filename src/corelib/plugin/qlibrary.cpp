@@ -63,6 +63,7 @@
 #include <qjsonvalue.h>
 #include "qelfparser_p.h"
 #include "qmachparser_p.h"
+#include "qpluginmetadatacache_p.h"
 
 #include <qtcore_tracepoints_p.h>
 
@@ -763,8 +764,19 @@ void QLibraryPrivate::updatePluginState()
 #endif
 
     if (!pHnd.loadRelaxed()) {
-        // scan for the plugin metadata without loading
-        success = findPatternUnloaded(fileName, this);
+        // scan for the plugin metadata without loading, unless it's known already
+        QPluginMetaDataCache *cache = QPluginMetaDataCache::instance();
+        QPluginMetaDataCache::FileKey key;
+        if (cache && cache->find(fileName, &key, &metaData)) {
+            if (qt_debug_component())
+                qDebug() << "Using cached metadata for" << fileName;
+            success = !metaData.isEmpty();
+        } else {
+            success = findPatternUnloaded(fileName, this);
+            // don't remember files we failed to read as not being plugins
+            if (cache && (success || QFileInfo(fileName).isReadable()))
+                cache->insert(fileName, key, success ? metaData : QJsonObject());
+        }
     } else {
         // library is already loaded (probably via QLibrary)
         // simply get the target function and call it.
@@ -0,0 +1,303 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qpluginmetadatacache_p.h"
+
+#include "qcborarray.h"
+#include "qcbormap.h"
+#include "qcborvalue.h"
+#include "qcryptographichash.h"
+#include "qdir.h"
+#include "qfile.h"
+#include "qfileinfo.h"
+#include "qsavefile.h"
+#include "qstandardpaths.h"
+#include "private/qlibrary_p.h"
+
+#ifdef Q_OS_UNIX
+#  include "private/qcore_unix_p.h"
+#endif
+
+#include <qdebug.h>
+#include <qtcore_tracepoints_p.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+    \class QPluginMetaDataCache
+    \inmodule QtCore
+
+    Finding out whether a file is a plugin and reading its metadata means
+    opening it, walking its ELF or Mach-O headers and decoding the CBOR
+    metadata. An application scanning a few hundred plugins at startup
+    spends most of that time on files that have not changed since the last
+    run, so QPluginMetaDataCache remembers the decoded metadata of every
+    file it was given, along with the file's size, modification time and
+    file id. The metadata of a file is reused for as long as those match.
+
+    Each plugin directory gets its own cache file, named after a hash of its
+    path, in the \c qt6/plugin-metadata subdirectory of
+    QStandardPaths::GenericCacheLocation, or in the directory named by the
+    \c QT_PLUGIN_CACHE_DIR environment variable. Setting
+    \c QT_NO_PLUGIN_CACHE disables the cache. Cache files are only read the
+    first time a directory is looked at, and written back by sync() if
+    something was added since.
+
+    Files that are not plugins are cached as well, with empty metadata.
+*/
+
+// Bump when the cache file contents or the metadata conversion change.
+static const int CacheFormatVersion = 1;
+
+namespace {
+template <typename T>
+auto nanosecondsOf(const T &st, int) -> decltype(st.st_mtim.tv_nsec, qint64())
+{ return qint64(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec; }
+template <typename T>
+auto nanosecondsOf(const T &st, long) -> decltype(st.st_mtimespec.tv_nsec, qint64())
+{ return qint64(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec; }
+template <typename T>
+qint64 nanosecondsOf(const T &st, ...)
+{ return qint64(st.st_mtime) * 1000000000; }
+}
+
+Q_GLOBAL_STATIC(QPluginMetaDataCache, pluginMetaDataCache)
+
+/*!
+    \internal
+    Returns the cache, or \nullptr if it is disabled.
+*/
+QPluginMetaDataCache *QPluginMetaDataCache::instance()
+{
+    if (qEnvironmentVariableIsSet("QT_NO_PLUGIN_CACHE"))
+        return nullptr;
+    return pluginMetaDataCache();
+}
+
+/*!
+    \internal
+    Returns what identifies the current contents of \a fileName, or an
+    invalid key if the file cannot be accessed.
+*/
+QPluginMetaDataCache::FileKey QPluginMetaDataCache::fileKey(const QString &fileName)
+{
+    FileKey key;
+#ifdef Q_OS_UNIX
+    QT_STATBUF st;
+    if (QT_STAT(QFile::encodeName(fileName).constData(), &st) == 0) {
+        key.size = st.st_size;
+        key.modificationTime = nanosecondsOf(st, 0);
+        key.fileId = quint64(st.st_ino);
+    }
+#else
+    const QFileInfo info(fileName);
+    if (info.exists()) {
+        key.size = info.size();
+        key.modificationTime = info.lastModified().toMSecsSinceEpoch();
+    }
+#endif
+    return key;
+}
+
+/*!
+    \internal
+    Returns the path of the file the metadata of the plugins in
+    \a directory is cached in, or an empty string if there is no place to
+    cache it.
+*/
+QString QPluginMetaDataCache::cacheFilePath(const QString &directory)
+{
+    QString cacheDir = qEnvironmentVariable("QT_PLUGIN_CACHE_DIR");
+    if (cacheDir.isEmpty()) {
+        cacheDir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+        if (cacheDir.isEmpty())
+            return QString();
+        cacheDir += QLatin1String("/qt6/plugin-metadata");
+    }
+    const QByteArray hash = QCryptographicHash::hash(directory.toUtf8(), QCryptographicHash::Sha1);
+    return cacheDir + QLatin1Char('/') + QLatin1String(hash.toHex()) + QLatin1String(".cbor");
+}
+
+QPluginMetaDataCache::Directory &QPluginMetaDataCache::directory(const QString &path)
+{
+    auto it = directories.find(path);
+    if (it == directories.end()) {
+        it = directories.insert(path, Directory());
+        load(path, &*it);
+    }
+    return *it;
+}
+
+void QPluginMetaDataCache::load(const QString &path, Directory *dir)
+{
+    QFile file(cacheFilePath(path));
+    if (file.fileName().isEmpty() || !file.open(QIODevice::ReadOnly))
+        return;
+
+    const QCborMap cache = QCborValue::fromCbor(file.readAll()).toMap();
+    if (cache.value(QLatin1String("version")).toInteger() != CacheFormatVersion
+            || cache.value(QLatin1String("qt")).toInteger() != QT_VERSION
+            || cache.value(QLatin1String("directory")).toString() != path) {
+        if (qt_debug_component())
+            qDebug() << "QPluginMetaDataCache: ignoring outdated cache" << file.fileName();
+        return;
+    }
+
+    const QCborMap entries = cache.value(QLatin1String("entries")).toMap();
+    dir->entries.reserve(entries.size());
+    for (auto it : entries) {
+        const QCborArray fields = it.second.toArray();
+        if (fields.size() != 4)
+            continue;
+        Entry entry;
+        entry.key.size = fields.at(0).toInteger(-1);
+        entry.key.modificationTime = fields.at(1).toInteger();
+        entry.key.fileId = quint64(fields.at(2).toInteger());
+        entry.metaData = fields.at(3).toMap().toJsonObject();
+        dir->entries.insert(it.first.toString(), entry);
+    }
+}
+
+void QPluginMetaDataCache::save(const QString &path, Directory *dir)
+{
+    const QString cacheFile = cacheFilePath(path);
+    if (cacheFile.isEmpty())
+        return;
+
+    QCborMap entries;
+    for (auto it = dir->entries.begin(); it != dir->entries.end(); ) {
+        // drop what was not looked at and is gone or has changed
+        if (!it->used && fileKey(path + QLatin1Char('/') + it.key()) != it->key) {
+            it = dir->entries.erase(it);
+            continue;
+        }
+        QCborArray fields;
+        fields.append(it->key.size);
+        fields.append(it->key.modificationTime);
+        fields.append(qint64(it->key.fileId));
+        fields.append(QCborMap::fromJsonObject(it->metaData));
+        entries.insert(it.key(), fields);
+        ++it;
+    }
+
+    QCborMap cache;
+    cache.insert(QLatin1String("version"), CacheFormatVersion);
+    cache.insert(QLatin1String("qt"), QT_VERSION);
+    cache.insert(QLatin1String("directory"), path);
+    cache.insert(QLatin1String("entries"), entries);
+
+    QDir().mkpath(QFileInfo(cacheFile).path());
+    QSaveFile file(cacheFile);
+    if (!file.open(QIODevice::WriteOnly) || file.write(QCborValue(cache).toCbor()) < 0
+            || !file.commit()) {
+        if (qt_debug_component())
+            qDebug() << "QPluginMetaDataCache: could not write" << cacheFile << file.errorString();
+    }
+}
+
+/*!
+    \internal
+    Looks up the metadata of \a fileName, which must be an absolute path.
+    Stores the current key of the file in \a key and returns \c true if the
+    cached metadata matches it, in which case it is stored in \a metaData.
+    The metadata of a file that is not a plugin is empty.
+
+    If this returns \c false, the caller is expected to read the metadata
+    from the file and insert() it with \a key.
+*/
+bool QPluginMetaDataCache::find(const QString &fileName, FileKey *key, QJsonObject *metaData)
+{
+    *key = fileKey(fileName);
+    if (!key->isValid())
+        return false;
+
+    const qsizetype slash = fileName.lastIndexOf(QLatin1Char('/'));
+    QMutexLocker locker(&mutex);
+    Directory &dir = directory(fileName.left(slash));
+    const auto it = dir.entries.find(fileName.mid(slash + 1));
+    const bool found = it != dir.entries.end() && it->key == *key;
+    if (found) {
+        it->used = true;
+        *metaData = it->metaData;
+    }
+    locker.unlock();
+
+    Q_TRACE(QPluginMetaDataCache_find, fileName, found);
+    return found;
+}
+
+/*!
+    \internal
+    Remembers \a metaData as the metadata of \a fileName, as it was when its
+    key was \a key.
+*/
+void QPluginMetaDataCache::insert(const QString &fileName, const FileKey &key,
+                                  const QJsonObject &metaData)
+{
+    if (!key.isValid())
+        return;
+
+    const qsizetype slash = fileName.lastIndexOf(QLatin1Char('/'));
+    const QMutexLocker locker(&mutex);
+    Directory &dir = directory(fileName.left(slash));
+    Entry &entry = dir.entries[fileName.mid(slash + 1)];
+    entry.key = key;
+    entry.metaData = metaData;
+    entry.used = true;
+    dir.dirty = true;
+}
+
+/*!
+    \internal
+    Writes the cache files of the directories that had metadata inserted.
+*/
+void QPluginMetaDataCache::sync()
+{
+    const QMutexLocker locker(&mutex);
+    for (auto it = directories.begin(); it != directories.end(); ++it) {
+        if (it->dirty) {
+            save(it.key(), &*it);
+            it->dirty = false;
+        }
+    }
+}
+
+QT_END_NAMESPACE
@@ -39,6 +39,7 @@
 
 #include "qcborvalue.h"
 #include "qcborvalue_p.h"
+#include "qrecordsequence_p.h"
 #include "qdatastream.h"
 #include "qcborarray.h"
 #include "qcbormap.h"
@@ -53,6 +54,7 @@
 
 #include <qendian.h>
 #include <qlocale.h>
+#include <qvarlengtharray.h>
 #include <private/qbytearray_p.h>
 #include <private/qnumeric_p.h>
 #include <private/qsimd_p.h>
@@ -2513,6 +2515,206 @@ QCborValue QCborValue::fromCbor(const QByteArray &ba, QCborParserError *error)
     overload of this function that accepts a QByteArray, also passing \a error,
     if provided.
 */
+
+// Returns the offset just past the CBOR data item starting at \a pos, without
+// decoding it, or -1 if the item is malformed or truncated. Only the headers
+// are examined: string payloads are skipped over and no validation of their
+// contents is performed.
+static qsizetype skipCborItem(const uchar *data, qsizetype size, qsizetype pos)
+{
+    // number of items left to read in each open container (-1 for
+    // indefinite-length containers, which end with a break byte)
+    QVarLengthArray<qint64, 16> stack;
+    qint64 remaining = 1;
+    while (true) {
+        if (remaining == 0) {
+            if (stack.isEmpty())
+                return pos;
+            remaining = stack.last();
+            stack.removeLast();
+            continue;
+        }
+        if (pos >= size)
+            return -1;
+
+        const uchar initial = data[pos++];
+        if (initial == 0xff) {
+            // "break" closes the innermost indefinite-length container
+            if (remaining != -1 || stack.isEmpty())
+                return -1;
+            remaining = stack.last();
+            stack.removeLast();
+            continue;
+        }
+        if (remaining > 0)
+            --remaining;
+
+        const uint majorType = initial >> 5;
+        const uint info = initial & 0x1f;
+        quint64 arg = info;
+        bool indefinite = false;
+        if (info >= 24 && info <= 27) {
+            const qsizetype n = qsizetype(1) << (info - 24);
+            if (size - pos < n)
+                return -1;
+            arg = 0;
+            for (qsizetype i = 0; i < n; ++i)
+                arg = (arg << 8) | data[pos++];
+        } else if (info == 31) {
+            if (majorType < 2 || majorType > 5)
+                return -1;
+            indefinite = true;
+        } else if (info > 27) {
+            return -1;
+        }
+
+        switch (majorType) {
+        case 0:         // unsigned integer
+        case 1:         // negative integer
+        case 7:         // simple types and floating point
+            break;
+
+        case 2:         // byte string
+        case 3:         // text string
+            if (indefinite) {
+                stack.append(remaining);
+                remaining = -1;
+            } else if (arg > quint64(size - pos)) {
+                return -1;
+            } else {
+                pos += qsizetype(arg);
+            }
+            break;
+
+        case 4:         // array
+        case 5:         // map
+            if (!indefinite && majorType == 5) {
+                if (arg > quint64(std::numeric_limits<qint64>::max()) / 2)
+                    return -1;
+                arg *= 2;
+            }
+            // each item takes at least one byte
+            if (!indefinite && arg > quint64(size - pos))
+                return -1;
+            stack.append(remaining);
+            remaining = indefinite ? -1 : qint64(arg);
+            break;
+
+        case 6:         // tag: one more item follows
+            stack.append(remaining);
+            remaining = 1;
+            break;
+        }
+
+        if (stack.size() > MaximumRecursionDepth)
+            return -1;
+    }
+}
+
+namespace {
+struct CborSequenceResult
+{
+    qsizetype offset;
+    QCborValue value;
+    QCborParserError error;
+};
+}
+
+/*!
+    \since 6.1
+
+    Decodes the CBOR sequence (RFC 8742) found in the byte array \a ba, that
+    is, a concatenation of zero or more independently encoded CBOR data items,
+    and returns the items in the order they appear.
+
+    The boundaries of the items are located first, without decoding them, and
+    the items are then decoded in parallel, using idle threads of
+    QThreadPool::globalInstance() when available. To decode a large file without
+    reading it into memory, pass a QByteArray created with
+    QByteArray::fromRawData() over the memory returned by QFile::map().
+
+    If any item fails to decode, an empty list is returned and the optional \a
+    error variable contains the details of the first error, with its offset
+    relative to the beginning of \a ba.
+
+    \sa fromCbor()
+ */
+QList<QCborValue> QCborValue::fromCborSequence(const QByteArray &ba, QCborParserError *error)
+{
+    QList<QCborValue> result;
+    if (!fromCborSequence(ba, [&result](const QCborValue &v) { result.append(v); }, error))
+        result.clear();
+    return result;
+}
+
+/*!
+    \fn template <typename Callback> bool QCborValue::fromCborSequence(const QByteArray &ba, Callback &&callback, QCborParserError *error)
+    \since 6.1
+    \overload
+
+    Decodes the CBOR sequence found in \a ba and calls \a callback with each
+    decoded item, in the order they appear in \a ba. The items are decoded in
+    parallel, but \a callback is always invoked from the calling thread.
+
+    Returns \c true if all items were decoded successfully. Otherwise, \a
+    callback has been called for all items preceding the first invalid one,
+    this function returns \c false and the optional \a error variable contains
+    further details about the error.
+
+    \note This function only participates in overload resolution if \a
+    callback can be called with a \c{const QCborValue &}.
+ */
+
+/*!
+    \internal
+
+    Implements fromCborSequence() for a callback that is type-erased to
+    \a callback and \a context, to keep std::function out of the header.
+ */
+bool QCborValue::fromCborSequenceImpl(const QByteArray &ba,
+                                      void (*callback)(void *, const QCborValue &), void *context,
+                                      QCborParserError *error)
+{
+    using namespace QRecordSequencePrivate;
+    const uchar *begin = reinterpret_cast<const uchar *>(ba.constData());
+    const qsizetype size = ba.size();
+    qsizetype pos = 0;
+
+    auto findNext = [begin, size, &pos](Span &span) {
+        if (pos >= size)
+            return false;
+        qsizetype end = skipCborItem(begin, size, pos);
+        if (end < 0)
+            end = size;     // let the decoder report the error
+        span = { pos, end - pos };
+        pos = end;
+        return true;
+    };
+    auto parse = [begin](const Span &span, CborSequenceResult &result) {
+        const char *ptr = reinterpret_cast<const char *>(begin) + span.offset;
+        result.offset = span.offset;
+        result.value = fromCbor(QByteArray::fromRawData(ptr, span.size), &result.error);
+        if (result.error.error == QCborError::NoError && result.error.offset != span.size)
+            result.error = { result.error.offset, { QCborError::GarbageAtEnd } };
+    };
+    auto deliver = [callback, context, error](const CborSequenceResult &result) {
+        if (result.error.error != QCborError::NoError) {
+            if (error) {
+                error->error = result.error.error;
+                error->offset = result.offset + result.error.offset;
+            }
+            return false;
+        }
+        callback(context, result.value);
+        return true;
+    };
+
+    if (!parseSequence<CborSequenceResult>(findNext, parse, deliver))
+        return false;
+    if (error)
+        *error = { size, { QCborError::NoError } };
+    return true;
+}
 #endif // QT_CONFIG(cborstreamreader)
 
 #if QT_CONFIG(cborstreamwriter)
@@ -287,6 +287,16 @@ public:
     { return fromCbor(QByteArray(data, int(len)), error); }
     static QCborValue fromCbor(const quint8 *data, qsizetype len, QCborParserError *error = nullptr)
     { return fromCbor(QByteArray(reinterpret_cast<const char *>(data), int(len)), error); }
+    static QList<QCborValue> fromCborSequence(const QByteArray &ba, QCborParserError *error = nullptr);
+    template <typename Callback,
+              std::enable_if_t<std::is_invocable_v<Callback &, const QCborValue &>, bool> = true>
+    static bool fromCborSequence(const QByteArray &ba, Callback &&callback,
+                                 QCborParserError *error = nullptr)
+    {
+        return fromCborSequenceImpl(ba, [](void *c, const QCborValue &value) {
+            (*static_cast<std::remove_reference_t<Callback> *>(c))(value);
+        }, const_cast<void *>(static_cast<const void *>(&callback)), error);
+    }
 #endif // QT_CONFIG(cborstreamreader)
 #if QT_CONFIG(cborstreamwriter)
     QByteArray toCbor(EncodingOptions opt = NoTransformation) const;
@@ -300,6 +310,12 @@ private:
     friend class QCborContainerPrivate;
     friend class QJsonPrivate::Value;
 
+#if QT_CONFIG(cborstreamreader)
+    static bool fromCborSequenceImpl(const QByteArray &ba,
+                                     void (*callback)(void *, const QCborValue &), void *context,
+                                     QCborParserError *error);
+#endif
+
     qint64 n = 0;
     QCborContainerPrivate *container = nullptr;
     Type t = Undefined;
@@ -44,6 +44,7 @@
 #include "qbuffer.h"
 #include "qfloat16.h"
 #include "qstring.h"
+#include "qvarlengtharray.h"
 #include <stdio.h>
 #include <ctype.h>
 #include <stdlib.h>
@@ -1457,6 +1458,88 @@ int QDataStream::skipRawData(int len)
     return skipResult;
 }
 
+namespace QtPrivate {
+
+static void swapRawArray(void *dst, const void *src, qsizetype count, int elementSize)
+{
+    switch (elementSize) {
+    case 2:
+        qbswap<2>(src, count, dst);
+        break;
+    case 4:
+        qbswap<4>(src, count, dst);
+        break;
+    case 8:
+        qbswap<8>(src, count, dst);
+        break;
+    default:
+        Q_ASSERT(elementSize == 1);
+        if (dst != src)
+            memcpy(dst, src, count);
+        break;
+    }
+}
+
+/*!
+    \internal
+
+    Reads \a count elements of \a elementSize bytes each into \a data with
+    as few device reads as possible, byte-swapping them in place if the byte
+    order of \a s differs from the host's. Used by the QList stream operators
+    for arithmetic element types.
+*/
+void readRawArray(QDataStream &s, void *data, qsizetype count, int elementSize)
+{
+    char *ptr = static_cast<char *>(data);
+    qsizetype remaining = count * elementSize;
+    while (remaining > 0 && s.status() == QDataStream::Ok) {
+        const int len = int(qMin<qsizetype>(remaining, std::numeric_limits<int>::max()
+                                                               / elementSize * elementSize));
+        if (s.readRawData(ptr, len) != len)
+            return;
+        ptr += len;
+        remaining -= len;
+    }
+
+    const bool swap = elementSize > 1
+            && QSysInfo::ByteOrder != QSysInfo::Endian(s.byteOrder());
+    if (swap && s.status() == QDataStream::Ok)
+        swapRawArray(data, data, count, elementSize);
+}
+
+/*!
+    \internal
+
+    Writes \a count elements of \a elementSize bytes each from \a data to
+    \a s. If the stream's byte order matches the host's, the data is written
+    in one go; otherwise it is byte-swapped through a bounded temporary buffer.
+*/
+void writeRawArray(QDataStream &s, const void *data, qsizetype count, int elementSize)
+{
+    const char *ptr = static_cast<const char *>(data);
+    const bool swap = elementSize > 1
+            && QSysInfo::ByteOrder != QSysInfo::Endian(s.byteOrder());
+    const qsizetype chunkElements = swap ? qsizetype(65536 / elementSize)
+                                         : std::numeric_limits<int>::max() / elementSize;
+    QVarLengthArray<char, 1024> buffer;
+    while (count > 0 && s.status() == QDataStream::Ok) {
+        const qsizetype n = qMin(count, chunkElements);
+        const int len = int(n * elementSize);
+        const char *chunk = ptr;
+        if (swap) {
+            buffer.resize(len);
+            swapRawArray(buffer.data(), ptr, n, elementSize);
+            chunk = buffer.constData();
+        }
+        if (s.writeRawData(chunk, len) != len)
+            return;
+        ptr += len;
+        count -= n;
+    }
+}
+
+} // namespace QtPrivate
+
 /*!
     \fn template <class T1, class T2> QDataStream &operator<<(QDataStream &out, const std::pair<T1, T2> &pair)
     \since 6.0
@@ -236,6 +236,67 @@ private:
     QDataStream::Status oldStatus;
 };
 
+// Element types whose serialized form is their in-memory representation,
+// byte-swapped if the stream's byte order differs from the host's
+template <typename T>
+using IsRawStreamable = std::disjunction<
+        std::is_same<T, char>, std::is_same<T, qint8>, std::is_same<T, quint8>,
+        std::is_same<T, qint16>, std::is_same<T, quint16>,
+        std::is_same<T, qint32>, std::is_same<T, quint32>,
+        std::is_same<T, qint64>, std::is_same<T, quint64>,
+        std::is_same<T, char16_t>, std::is_same<T, char32_t>,
+        std::is_same<T, float>, std::is_same<T, double>>;
+
+template <typename T>
+bool canStreamRawArray(const QDataStream &s)
+{
+    // floating point values may be converted to the stream's precision
+    if constexpr (std::is_same_v<T, float>)
+        return s.version() < QDataStream::Qt_4_6
+                || s.floatingPointPrecision() == QDataStream::SinglePrecision;
+    else if constexpr (std::is_same_v<T, double>)
+        return s.version() < QDataStream::Qt_4_6
+                || s.floatingPointPrecision() == QDataStream::DoublePrecision;
+    else
+        return IsRawStreamable<T>::value;
+}
+
+Q_CORE_EXPORT void readRawArray(QDataStream &s, void *data, qsizetype count, int elementSize);
+Q_CORE_EXPORT void writeRawArray(QDataStream &s, const void *data, qsizetype count,
+                                 int elementSize);
+
+template <typename Container>
+QDataStream &readRawArrayContainer(QDataStream &s, Container &c)
+{
+    using T = typename Container::value_type;
+    StreamStateSaver stateSaver(&s);
+
+    c.clear();
+    quint32 n;
+    s >> n;
+    // Grow the container in steps, so that corrupt data announcing a huge
+    // size does not make us allocate more than the stream actually holds.
+    constexpr qsizetype ChunkSize = qsizetype(1024 * 1024 / sizeof(T));
+    for (qsizetype done = 0; done < qsizetype(n) && s.status() == QDataStream::Ok; ) {
+        const qsizetype count = qMin(qsizetype(n) - done, ChunkSize);
+        c.resize(done + count);
+        readRawArray(s, c.data() + done, count, int(sizeof(T)));
+        done += count;
+    }
+    if (s.status() != QDataStream::Ok)
+        c.clear();
+
+    return s;
+}
+
+template <typename Container>
+QDataStream &writeRawArrayContainer(QDataStream &s, const Container &c)
+{
+    s << quint32(c.size());
+    writeRawArray(s, c.constData(), c.size(), int(sizeof(typename Container::value_type)));
+    return s;
+}
+
 template <typename Container>
 QDataStream &readArrayBasedContainer(QDataStream &s, Container &c)
 {
@@ -426,12 +487,20 @@ operator>>(QDataStream &s, T &t)
 template<typename T>
 inline QDataStreamIfHasIStreamOperators<T> operator>>(QDataStream &s, QList<T> &v)
 {
+    if constexpr (QtPrivate::IsRawStreamable<T>::value) {
+        if (QtPrivate::canStreamRawArray<T>(s))
+            return QtPrivate::readRawArrayContainer(s, v);
+    }
     return QtPrivate::readArrayBasedContainer(s, v);
 }
 
 template<typename T>
 inline QDataStreamIfHasOStreamOperators<T> operator<<(QDataStream &s, const QList<T> &v)
 {
+    if constexpr (QtPrivate::IsRawStreamable<T>::value) {
+        if (QtPrivate::canStreamRawArray<T>(s))
+            return QtPrivate::writeRawArrayContainer(s, v);
+    }
     return QtPrivate::writeSequentialContainer(s, v);
 }
 
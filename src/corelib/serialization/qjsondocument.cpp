@@ -50,8 +50,11 @@
 #include "qjsonwriter_p.h"
 #include "qjsonparser_p.h"
 #include "qjson_p.h"
+#include "qrecordsequence_p.h"
 #include "qdatastream.h"
 
+#include <limits>
+
 QT_BEGIN_NAMESPACE
 
 /*! \class QJsonDocument
@@ -324,6 +327,131 @@ QJsonDocument QJsonDocument::fromJson(const QByteArray &json, QJsonParseError *e
     return result;
 }
 
+namespace {
+struct JsonLineResult
+{
+    qsizetype offset;
+    QCborValue value;
+    QJsonParseError error;
+};
+}
+
+/*!
+    \since 6.1
+
+    Parses \a json as a sequence of newline-delimited UTF-8 encoded JSON
+    documents (also known as "JSON Lines" or NDJSON) and returns the top-level
+    value of each of them, in order. Each record must be an object or an
+    array that fits on one line; empty lines are ignored.
+
+    Record boundaries are located first and the records are then parsed in
+    parallel, using idle threads of QThreadPool::globalInstance() when
+    available. To parse a large file without reading it into memory, pass
+    a QByteArray created with QByteArray::fromRawData() over the memory
+    returned by QFile::map().
+
+    If any record fails to parse, an empty list is returned and the optional
+    \a error variable contains the details of the first error, with its offset
+    relative to the beginning of \a json.
+
+    \sa fromJson()
+ */
+QList<QJsonValue> QJsonDocument::fromJsonLines(const QByteArray &json, QJsonParseError *error)
+{
+    QList<QJsonValue> result;
+    if (!fromJsonLines(json, [&result](const QJsonValue &v) { result.append(v); }, error))
+        result.clear();
+    return result;
+}
+
+/*!
+    \fn template <typename Callback> bool QJsonDocument::fromJsonLines(const QByteArray &json, Callback &&callback, QJsonParseError *error)
+    \since 6.1
+    \overload
+
+    Parses \a json as a sequence of newline-delimited JSON documents and calls
+    \a callback with the top-level value of each of them, in the order they
+    appear in \a json. The records are parsed in parallel, but \a callback is
+    always invoked from the calling thread.
+
+    Returns \c true if all records were parsed successfully. Otherwise, \a
+    callback has been called for all records preceding the first invalid one,
+    this function returns \c false and the optional \a error variable contains
+    further details about the error.
+
+    A record longer than 2 GiB is reported as a
+    QJsonParseError::DocumentTooLarge error. If an error lies further than
+    2 GiB into \a json, QJsonParseError::offset cannot hold its position and
+    is set to -1.
+
+    \note This function only participates in overload resolution if \a
+    callback can be called with a \c{const QJsonValue &}.
+ */
+
+/*!
+    \internal
+
+    Implements fromJsonLines() for a callback that is type-erased to
+    \a callback and \a context, to keep std::function out of the header.
+ */
+bool QJsonDocument::fromJsonLinesImpl(const QByteArray &json,
+                                      void (*callback)(void *, const QJsonValue &), void *context,
+                                      QJsonParseError *error)
+{
+    using namespace QRecordSequencePrivate;
+    const char *begin = json.constData();
+    const qsizetype size = json.size();
+    qsizetype pos = 0;
+
+    auto findNext = [begin, size, &pos](Span &span) {
+        while (pos < size) {
+            const char *start = begin + pos;
+            const char *eol = static_cast<const char *>(memchr(start, '\n', size - pos));
+            const qsizetype length = eol ? eol - start : size - pos;
+            span = { pos, length };
+            pos += length + 1;
+
+            // skip blank lines
+            for (const char *ptr = start; ptr != start + length; ++ptr) {
+                if (*ptr != ' ' && *ptr != '\t' && *ptr != '\r')
+                    return true;
+            }
+        }
+        return false;
+    };
+    auto parse = [begin](const Span &span, JsonLineResult &result) {
+        result.offset = span.offset;
+        // the parser, like fromJson(), only handles int-sized documents
+        if (span.size > std::numeric_limits<int>::max()) {
+            result.error.error = QJsonParseError::DocumentTooLarge;
+            result.error.offset = 0;
+            return;
+        }
+        QJsonPrivate::Parser parser(begin + span.offset, int(span.size));
+        result.value = parser.parse(&result.error);
+    };
+    auto deliver = [callback, context, error](const JsonLineResult &result) {
+        if (result.error.error != QJsonParseError::NoError) {
+            if (error) {
+                const qsizetype offset = result.offset + result.error.offset;
+                error->error = result.error.error;
+                error->offset = offset <= std::numeric_limits<int>::max() ? int(offset) : -1;
+            }
+            return false;
+        }
+        callback(context, QJsonPrivate::Value::fromTrustedCbor(result.value));
+        return true;
+    };
+
+    if (!parseSequence<JsonLineResult>(findNext, parse, deliver))
+        return false;
+    if (error) {
+        error->error = QJsonParseError::NoError;
+        error->offset = 0;
+    }
+    return true;
+}
+
 /*!
     Returns \c true if the document doesn't contain any data.
  */
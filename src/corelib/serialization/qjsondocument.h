@@ -115,6 +115,16 @@ public:
     };
 
     static QJsonDocument fromJson(const QByteArray &json, QJsonParseError *error = nullptr);
+    static QList<QJsonValue> fromJsonLines(const QByteArray &json, QJsonParseError *error = nullptr);
+    template <typename Callback,
+              std::enable_if_t<std::is_invocable_v<Callback &, const QJsonValue &>, bool> = true>
+    static bool fromJsonLines(const QByteArray &json, Callback &&callback,
+                              QJsonParseError *error = nullptr)
+    {
+        return fromJsonLinesImpl(json, [](void *c, const QJsonValue &value) {
+            (*static_cast<std::remove_reference_t<Callback> *>(c))(value);
+        }, const_cast<void *>(static_cast<const void *>(&callback)), error);
+    }
 
 #if !defined(QT_JSON_READONLY) || defined(Q_CLANG_QDOC)
     QByteArray toJson(JsonFormat format = Indented) const;
@@ -143,6 +153,10 @@ public:
     bool isNull() const;
 
 private:
+    static bool fromJsonLinesImpl(const QByteArray &json,
+                                  void (*callback)(void *, const QJsonValue &), void *context,
+                                  QJsonParseError *error);
+
     friend class QJsonValue;
     friend class QJsonPrivate::Parser;
     friend Q_CORE_EXPORT QDebug operator<<(QDebug, const QJsonDocument &);
@@ -0,0 +1,161 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QRECORDSEQUENCE_P_H
+#define QRECORDSEQUENCE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qlist.h>
+
+#if QT_CONFIG(thread)
+#  include <QtCore/qatomic.h>
+#  include <QtCore/qsemaphore.h>
+#  include <QtCore/qthreadpool.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace QRecordSequencePrivate {
+
+// Location of one record inside the buffer being parsed
+struct Span
+{
+    qsizetype offset;
+    qsizetype size;
+};
+
+enum {
+    // records parsed in parallel before results are handed back in order;
+    // bounds the memory used for parsed-but-undelivered records
+    WindowSize = 8192,
+    // records claimed by a worker at a time
+    BatchSize = 32
+};
+
+/*
+    Calls \a function for every index in [0, count). If threads are available
+    in the global thread pool, the work is spread over them in batches, with
+    the calling thread always taking part. Returns once all calls have
+    finished. We use tryStart() so that we never wait for a busy pool: if no
+    thread is idle, the calling thread simply does all the work itself.
+*/
+template <typename Function>
+void parallelFor(qsizetype count, Function function)
+{
+#if QT_CONFIG(thread)
+    const qsizetype batchCount = (count + BatchSize - 1) / BatchSize;
+    if (batchCount > 1) {
+        QAtomicInteger<qsizetype> nextBatch = 0;
+        auto worker = [&]() {
+            for (qsizetype batch = nextBatch.fetchAndAddRelaxed(1); batch < batchCount;
+                 batch = nextBatch.fetchAndAddRelaxed(1)) {
+                const qsizetype end = qMin(count, (batch + 1) * BatchSize);
+                for (qsizetype i = batch * BatchSize; i < end; ++i)
+                    function(i);
+            }
+        };
+
+        QThreadPool *pool = QThreadPool::globalInstance();
+        const qsizetype maxHelpers = qMin(qsizetype(pool->maxThreadCount()), batchCount - 1);
+        QSemaphore finished;
+        int helpers = 0;
+        while (helpers < maxHelpers
+               && pool->tryStart([&worker, &finished]() { worker(); finished.release(); }))
+            ++helpers;
+
+        worker();
+        finished.acquire(helpers);
+        return;
+    }
+#endif
+    for (qsizetype i = 0; i < count; ++i)
+        function(i);
+}
+
+/*
+    Parses a sequence of independent records. \a findNext is called to locate
+    the next record boundary (it returns false at the end of the data), \a parse
+    converts the record in a Span into a Result (this is what runs in
+    parallel) and \a deliver receives the results in their original order. If
+    \a deliver returns false, parsing stops and this function returns false.
+*/
+template <typename Result, typename FindNext, typename Parse, typename Deliver>
+bool parseSequence(FindNext findNext, Parse parse, Deliver deliver)
+{
+    QList<Span> spans;
+    QList<Result> results;
+    bool more = true;
+    while (more) {
+        spans.clear();
+        Span span;
+        while (spans.size() < WindowSize && (more = findNext(span)))
+            spans.append(span);
+        if (spans.isEmpty())
+            break;
+
+        results.resize(spans.size());
+        const Span *s = spans.constData();
+        Result *r = results.data();
+        parallelFor(spans.size(), [s, r, &parse](qsizetype i) { parse(s[i], r[i]); });
+
+        for (Result &result : results) {
+            if (!deliver(result))
+                return false;
+        }
+    }
+    return true;
+}
+
+} // namespace QRecordSequencePrivate
+
+QT_END_NAMESPACE
+
+#endif // QRECORDSEQUENCE_P_H
@@ -49,6 +49,7 @@
 #include <qstack.h>
 #include <qbuffer.h>
 #include <qscopeguard.h>
+#include <private/qsimd_p.h>
 #ifndef QT_BOOTSTRAPPED
 #include <qcoreapplication.h>
 #else
@@ -64,6 +65,7 @@ public: \
 private:
 #endif
 
+#include <algorithm>
 #include <iterator>
 #include "qxmlstream_p.h"
 #include "qxmlstreamparser_p.h"
@@ -955,6 +957,95 @@ inline uint QXmlStreamReaderPrivate::peekChar()
     return c;
 }
 
+/*!
+  \internal
+
+  Returns the number of UTF-16 code units at the beginning of [\a ptr, \a end)
+  that the fast scanners can copy to the text buffer verbatim: characters that
+  are neither control characters (including tab and line breaks), nor U+FFFE
+  or U+FFFF, nor one of \a c1, \a c2, \a c3 and \a c4.
+ */
+static qsizetype plainCharacterRun(const char16_t *ptr, const char16_t *end,
+                                   char16_t c1, char16_t c2, char16_t c3, char16_t c4)
+{
+    const char16_t *start = ptr;
+#ifdef __SSE2__
+    const __m128i controlLimit = _mm_set1_epi16(0x20);
+    const __m128i nonCharacterLimit = _mm_set1_epi16(short(0xfffd));
+    const __m128i special1 = _mm_set1_epi16(short(c1));
+    const __m128i special2 = _mm_set1_epi16(short(c2));
+    const __m128i special3 = _mm_set1_epi16(short(c3));
+    const __m128i special4 = _mm_set1_epi16(short(c4));
+    for ( ; end - ptr >= 8; ptr += 8) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+
+        // the saturated subtractions are non-zero for c < 0x20 and c > 0xfffd
+        __m128i stop = _mm_or_si128(_mm_subs_epu16(controlLimit, data),
+                                    _mm_subs_epu16(data, nonCharacterLimit));
+        stop = _mm_or_si128(stop, _mm_cmpeq_epi16(data, special1));
+        stop = _mm_or_si128(stop, _mm_cmpeq_epi16(data, special2));
+        stop = _mm_or_si128(stop, _mm_cmpeq_epi16(data, special3));
+        stop = _mm_or_si128(stop, _mm_cmpeq_epi16(data, special4));
+
+        const uint mask = ~uint(_mm_movemask_epi8(_mm_cmpeq_epi16(stop, _mm_setzero_si128())));
+        if (mask & 0xffff)
+            return ptr - start + qCountTrailingZeroBits(mask) / 2;
+    }
+#endif
+    for ( ; ptr != end; ++ptr) {
+        const char16_t c = *ptr;
+        if (c < 0x20 || c > 0xfffd || c == c1 || c == c2 || c == c3 || c == c4)
+            break;
+    }
+    return ptr - start;
+}
+
+/*!
+  \internal
+
+  Returns the number of spaces (U+0020) at the beginning of [\a ptr, \a end).
+ */
+static qsizetype spaceRun(const char16_t *ptr, const char16_t *end)
+{
+    const char16_t *start = ptr;
+#ifdef __SSE2__
+    const __m128i spaces = _mm_set1_epi16(' ');
+    for ( ; end - ptr >= 8; ptr += 8) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        const uint mask = ~uint(_mm_movemask_epi8(_mm_cmpeq_epi16(data, spaces)));
+        if (mask & 0xffff)
+            return ptr - start + qCountTrailingZeroBits(mask) / 2;
+    }
+#endif
+    while (ptr != end && *ptr == u' ')
+        ++ptr;
+    return ptr - start;
+}
+
+/*!
+  \internal
+
+  Appends the run of characters at the current read position that needs no
+  per-character processing to the text buffer in one go, and returns its
+  length. Runs are only taken from the decoded read buffer, never from the
+  put-back stack. \a run is one of the run scanning functions above, called
+  with the characters that the caller needs to look at itself.
+ */
+template <typename RunFunction, typename... Specials>
+inline int QXmlStreamReaderPrivate::fastScanRun(RunFunction run, Specials... specials)
+{
+    if (putStack.size() || readBufferPos >= readBuffer.size())
+        return 0;
+    const char16_t *begin = reinterpret_cast<const char16_t *>(readBuffer.constData()) + readBufferPos;
+    const char16_t *end = reinterpret_cast<const char16_t *>(readBuffer.constData()) + readBuffer.size();
+    const int n = int(run(begin, end, specials...));
+    if (n) {
+        textBuffer.append(reinterpret_cast<const QChar *>(begin), n);
+        readBufferPos += n;
+    }
+    return n;
+}
+
 /*!
   \internal
 
@@ -1149,7 +1240,10 @@ inline int QXmlStreamReaderPrivate::fastScanLiteralContent()
 {
     int n = 0;
     uint c;
-    while ((c = getChar()) != StreamEOF) {
+    while (true) {
+        n += fastScanRun(plainCharacterRun, u'&', u'<', u'"', u'\'');
+        if ((c = getChar()) == StreamEOF)
+            break;
         switch (ushort(c)) {
         case 0xfffe:
         case 0xffff:
@@ -1199,7 +1293,10 @@ inline int QXmlStreamReaderPrivate::fastScanSpace()
 {
     int n = 0;
     uint c;
-    while ((c = getChar()) != StreamEOF) {
+    while (true) {
+        n += fastScanRun(spaceRun);
+        if ((c = getChar()) == StreamEOF)
+            break;
         switch (c) {
         case '\r':
             if ((c = filterCarriageReturn()) == 0)
@@ -1232,7 +1329,16 @@ inline int QXmlStreamReaderPrivate::fastScanContentCharList()
 {
     int n = 0;
     uint c;
-    while ((c = getChar()) != StreamEOF) {
+    while (true) {
+        if (const int run = fastScanRun(plainCharacterRun, u'&', u'<', u']', u']')) {
+            if (isWhitespace) {
+                const QChar *ptr = textBuffer.constData() + textBuffer.size() - run;
+                isWhitespace = std::all_of(ptr, ptr + run, [](QChar ch) { return ch == u' '; });
+            }
+            n += run;
+        }
+        if ((c = getChar()) == StreamEOF)
+            break;
         switch (ushort(c)) {
         case 0xfffe:
         case 0xffff:
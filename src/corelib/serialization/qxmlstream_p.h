@@ -500,6 +500,8 @@ public:
 
     // scan optimization functions. Not strictly necessary but LALR is
     // not very well suited for scanning fast
+    template <typename RunFunction, typename... Specials>
+    inline int fastScanRun(RunFunction run, Specials... specials);
     int fastScanLiteralContent();
     int fastScanSpace();
     int fastScanContentCharList();
@@ -4779,6 +4779,251 @@ QDateTime QDateTime::fromSecsSinceEpoch(qint64 secs, const QTimeZone &timeZone)
 }
 #endif
 
+#if QT_CONFIG(timezone)
+namespace {
+// Looks up the offsets from UTC of a zone at a series of instants. The offset
+// found is reused until the zone's next transition, so that for sorted
+// instants the zone's data is only consulted once per transition.
+class ZoneOffsetCursor
+{
+public:
+    explicit ZoneOffsetCursor(const QTimeZonePrivate *zone) : m_zone(zone) {}
+
+    int offsetFromUtc(qint64 msecs)
+    {
+        if (msecs < m_first || msecs > m_last) {
+            m_offset = m_zone->offsetFromUtc(msecs);
+            m_first = m_last = msecs;
+            if (m_zone->hasTransitions()) {
+                const qint64 next = m_zone->nextTransition(msecs).atMSecsSinceEpoch;
+                m_last = next == QTimeZonePrivate::invalidMSecs()
+                         ? std::numeric_limits<qint64>::max() : next - 1;
+            }
+        }
+        return m_offset;
+    }
+
+private:
+    const QTimeZonePrivate *m_zone;
+    // The offset applies from m_first to m_last, both included:
+    qint64 m_first = 1;
+    qint64 m_last = 0;
+    int m_offset = 0;
+};
+} // unnamed namespace
+
+/*!
+    \since 6.1
+
+    Converts the \a count numbers of milliseconds since the start of 1970, UTC,
+    at \a msecs to dates and times in \a timeZone, which are stored at \a dates
+    and \a times, and their offsets from UTC in seconds, which are stored at
+    \a offsetsFromUtc. Each of \a dates, \a times and \a offsetsFromUtc may be
+    null, if that part of the result is not needed; otherwise, it must have
+    room for \a count values.
+
+    This gives the same results as calling fromMSecsSinceEpoch() with \a
+    timeZone for each value, and then date(), time() and offsetFromUtc(), but
+    without creating the QDateTime objects. Large numbers of values are
+    converted much faster, especially when they are sorted: the offset of the
+    time zone is then only looked up again when a transition of the time zone
+    is passed. To convert to local time, pass QTimeZone::systemTimeZone().
+
+    If \a timeZone is not valid, the dates and times are invalid and the
+    offsets are 0.
+
+    \sa fromMSecsSinceEpoch(), toIsoDateStrings()
+*/
+void QDateTime::toDatesAndTimes(const qint64 *msecs, qsizetype count, const QTimeZone &timeZone,
+                                QDate *dates, QTime *times, int *offsetsFromUtc)
+{
+    if (!timeZone.isValid()) {
+        for (qsizetype i = 0; i < count; ++i) {
+            if (dates)
+                dates[i] = QDate();
+            if (times)
+                times[i] = QTime();
+            if (offsetsFromUtc)
+                offsetsFromUtc[i] = 0;
+        }
+        return;
+    }
+
+    ZoneOffsetCursor zone(timeZone.d.constData());
+    for (qsizetype i = 0; i < count; ++i) {
+        const int offset = zone.offsetFromUtc(msecs[i]);
+        if (offsetsFromUtc)
+            offsetsFromUtc[i] = offset;
+        if (!dates && !times)
+            continue;
+        qint64 localMSecs;
+        if (add_overflow(msecs[i], qint64(offset) * 1000, &localMSecs)) {
+            if (dates)
+                dates[i] = QDate();
+            if (times)
+                times[i] = QTime();
+        } else {
+            msecsToTime(localMSecs, dates ? dates + i : nullptr, times ? times + i : nullptr);
+        }
+    }
+}
+#endif // timezone
+
+#if QT_CONFIG(datestring)
+/*!
+    \variable QDateTime::IsoDateStringSize
+    \since 6.1
+
+    The size of each of the strings written by toIsoDateStrings() and read
+    by fromIsoDateStrings().
+*/
+
+static inline char *writeDigits(char *out, int value, int width)
+{
+    for (int i = width - 1; i >= 0; --i) {
+        out[i] = char('0' + value % 10);
+        value /= 10;
+    }
+    return out + width;
+}
+
+static inline bool readDigits(const char *in, int width, int *value)
+{
+    int result = 0;
+    for (int i = 0; i < width; ++i) {
+        if (in[i] < '0' || in[i] > '9')
+            return false;
+        result = result * 10 + in[i] - '0';
+    }
+    *value = result;
+    return true;
+}
+
+# if QT_CONFIG(timezone)
+/*!
+    \since 6.1
+
+    Writes the \a count numbers of milliseconds since the start of 1970, UTC,
+    at \a msecs as ISO 8601 date and time strings in \a timeZone to \a buffer.
+    Each string takes IsoDateStringSize characters, with no separator or
+    terminating '\\0', so \a buffer must have room for \a count times
+    IsoDateStringSize characters.
+
+    The strings have the form \c{yyyy-MM-ddTHH:mm:ss.zzz+HH:mm}: this is the
+    format of toString() with Qt::ISODateWithMs for a QDateTime in \a
+    timeZone, except that the offset from UTC is also written when it is zero.
+    The offsets of the time zone are looked up as in toDatesAndTimes(), so
+    sorted values are converted fastest.
+
+    Like toString(), this writes the offset from UTC in whole minutes. Some
+    historical offsets, such as local mean times before the introduction of
+    standard time, also have seconds; those are dropped, so reading such a
+    string back with fromIsoDateStrings() gives a time that is off by them.
+
+    Returns \c true if all values could be written. Values whose year in \a
+    timeZone is not between 0 and 9999, which ISO 8601 does not support, are
+    written as spaces; so are all values if \a timeZone is not valid.
+
+    \sa fromIsoDateStrings(), toDatesAndTimes(), toString()
+*/
+bool QDateTime::toIsoDateStrings(const qint64 *msecs, qsizetype count, const QTimeZone &timeZone,
+                                 char *buffer)
+{
+    if (!timeZone.isValid()) {
+        memset(buffer, ' ', count * IsoDateStringSize);
+        return count == 0;
+    }
+
+    bool ok = true;
+    ZoneOffsetCursor zone(timeZone.d.constData());
+    for (qsizetype i = 0; i < count; ++i) {
+        char *out = buffer + i * IsoDateStringSize;
+        const int offset = zone.offsetFromUtc(msecs[i]);
+        qint64 localMSecs;
+        QDate date;
+        QTime time;
+        if (!add_overflow(msecs[i], qint64(offset) * 1000, &localMSecs))
+            msecsToTime(localMSecs, &date, &time);
+        const auto parts = date.isValid() ? QGregorianCalendar::partsFromJulian(date.toJulianDay())
+                                          : QCalendar::YearMonthDay();
+        if (!parts.isValid() || parts.year < 0 || parts.year > 9999) {
+            memset(out, ' ', IsoDateStringSize);
+            ok = false;
+            continue;
+        }
+
+        out = writeDigits(out, parts.year, 4);
+        *out++ = '-';
+        out = writeDigits(out, parts.month, 2);
+        *out++ = '-';
+        out = writeDigits(out, parts.day, 2);
+        *out++ = 'T';
+        out = writeDigits(out, time.hour(), 2);
+        *out++ = ':';
+        out = writeDigits(out, time.minute(), 2);
+        *out++ = ':';
+        out = writeDigits(out, time.second(), 2);
+        *out++ = '.';
+        out = writeDigits(out, time.msec(), 3);
+        *out++ = offset >= 0 ? '+' : '-';
+        out = writeDigits(out, qAbs(offset) / SECS_PER_HOUR, 2);
+        *out++ = ':';
+        writeDigits(out, (qAbs(offset) / SECS_PER_MIN) % 60, 2);
+    }
+    return ok;
+}
+# endif // timezone
+
+/*!
+    \since 6.1
+
+    Reads \a count ISO 8601 date and time strings, as written by
+    toIsoDateStrings(), from \a buffer, and stores the numbers of milliseconds
+    since the start of 1970, UTC, that they represent at \a msecs, which must
+    have room for \a count values.
+
+    Each string takes IsoDateStringSize characters, with no separator, and
+    must have the form \c{yyyy-MM-ddTHH:mm:ss.zzz+HH:mm}; a space is also
+    accepted instead of the \c T. Strings in other forms of ISO 8601 can be
+    read one at a time with fromString().
+
+    Returns the number of strings read, which is less than \a count if an
+    invalid string was found: it is the index of that string.
+
+    \sa toIsoDateStrings(), fromString()
+*/
+qsizetype QDateTime::fromIsoDateStrings(const char *buffer, qsizetype count, qint64 *msecs)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        const char *in = buffer + i * IsoDateStringSize;
+        int year, month, day, hour, minute, second, msec, offsetHours, offsetMinutes;
+        qint64 jd;
+        if (!readDigits(in, 4, &year) || in[4] != '-'
+            || !readDigits(in + 5, 2, &month) || in[7] != '-'
+            || !readDigits(in + 8, 2, &day) || (in[10] != 'T' && in[10] != ' ')
+            || !readDigits(in + 11, 2, &hour) || in[13] != ':'
+            || !readDigits(in + 14, 2, &minute) || in[16] != ':'
+            || !readDigits(in + 17, 2, &second) || in[19] != '.'
+            || !readDigits(in + 20, 3, &msec) || (in[23] != '+' && in[23] != '-')
+            || !readDigits(in + 24, 2, &offsetHours) || in[26] != ':'
+            || !readDigits(in + 27, 2, &offsetMinutes)) {
+            return i;
+        }
+        if (hour > 23 || minute > 59 || second > 59 || offsetHours > 23 || offsetMinutes > 59
+            || !QGregorianCalendar::julianFromParts(year, month, day, &jd)) {
+            return i;
+        }
+
+        const int offset = (in[23] == '-' ? -1 : 1)
+                           * (offsetHours * SECS_PER_HOUR + offsetMinutes * SECS_PER_MIN);
+        msecs[i] = (jd - JULIAN_DAY_FOR_EPOCH) * MSECS_PER_DAY
+                   + ((hour * SECS_PER_HOUR + minute * SECS_PER_MIN + second) - offset) * 1000
+                   + msec;
+    }
+    return count;
+}
+#endif // datestring
+
 #if QT_CONFIG(datestring) // depends on, so implies, textdate
 
 /*!
@@ -366,6 +366,19 @@ public:
 #if QT_CONFIG(timezone)
     static QDateTime fromMSecsSinceEpoch(qint64 msecs, const QTimeZone &timeZone);
     static QDateTime fromSecsSinceEpoch(qint64 secs, const QTimeZone &timeZone);
+
+    static void toDatesAndTimes(const qint64 *msecs, qsizetype count, const QTimeZone &timeZone,
+                                QDate *dates, QTime *times, int *offsetsFromUtc = nullptr);
+#endif
+
+#if QT_CONFIG(datestring)
+    // yyyy-MM-ddTHH:mm:ss.zzz+HH:mm
+    static constexpr qsizetype IsoDateStringSize = 29;
+# if QT_CONFIG(timezone)
+    static bool toIsoDateStrings(const qint64 *msecs, qsizetype count, const QTimeZone &timeZone,
+                                 char *buffer);
+# endif
+    static qsizetype fromIsoDateStrings(const char *buffer, qsizetype count, qint64 *msecs);
 #endif
 
     static qint64 currentMSecsSinceEpoch() noexcept;
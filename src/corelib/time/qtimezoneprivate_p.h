@@ -298,8 +298,13 @@ struct QTzTimeZoneCacheEntry
 {
     QList<QTzTransitionTime> m_tranTimes;
     QList<QTzTransitionRule> m_tranRules;
-    QList<QByteArray> m_abbreviations;
+    QList<QString> m_abbreviations;
     QByteArray m_posixRule;
+    // The transitions of m_posixRule for the years from m_posixFirstYear on,
+    // those of year m_posixFirstYear + i starting at m_posixYearStarts[i]:
+    QList<QTimeZonePrivate::Data> m_posixTransitions;
+    QList<int> m_posixYearStarts;
+    int m_posixFirstYear = 0;
 };
 
 class Q_AUTOTEST_EXPORT QTzTimeZonePrivate final : public QTimeZonePrivate
@@ -353,7 +358,7 @@ private:
     mutable QSharedDataPointer<QTimeZonePrivate> m_icu;
 #endif
     QTzTimeZoneCacheEntry cached_data;
-    QList<QTzTransitionTime> tranCache() const { return cached_data.m_tranTimes; }
+    const QList<QTzTransitionTime> &tranCache() const { return cached_data.m_tranTimes; }
 };
 #endif // Q_OS_UNIX
 
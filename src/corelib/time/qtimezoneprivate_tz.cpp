@@ -537,8 +537,10 @@ PosixZone PosixZone::parse(const char *&pos, const char *end)
     return {std::move(name), offset};
 }
 
+// If yearStarts is not null, the index in the result of the first transition
+// of each year is appended to it, followed by the size of the result.
 static QList<QTimeZonePrivate::Data> calculatePosixTransitions(const QByteArray &posixRule, int startYear, int endYear,
-                                                               qint64 lastTranMSecs)
+                                                               qint64 lastTranMSecs, QList<int> *yearStarts = nullptr)
 {
     QList<QTimeZonePrivate::Data> result;
 
@@ -604,6 +606,8 @@ static QList<QTimeZonePrivate::Data> calculatePosixTransitions(const QByteArray
     Q_ASSERT(startYear <= endYear);
 
     for (int year = startYear; year <= endYear; ++year) {
+        if (yearStarts)
+            yearStarts->append(result.size());
         QTimeZonePrivate::Data dstData;
         QDateTime dst(calculatePosixDate(dstDateRule, year), dstTime, Qt::UTC);
         dstData.atMSecsSinceEpoch = dst.toMSecsSinceEpoch() - (stdZone.offset * 1000);
@@ -634,9 +638,34 @@ static QList<QTimeZonePrivate::Data> calculatePosixTransitions(const QByteArray
             result << stdData << dstData;
         }
     }
+    if (yearStarts)
+        yearStarts->append(result.size());
     return result;
 }
 
+// Dates after the last transition of a zone use its POSIX rule, and computing
+// the transitions it implies is expensive, so do it once, up to this year:
+enum { PosixExpansionLastYear = 2100 };
+
+static void expandPosixRule(QTzTimeZoneCacheEntry &entry)
+{
+    // Only rules with daylight-saving time have transitions to expand
+    if (entry.m_posixRule.count(',') != 2)
+        return;
+    // Lookups use the transitions from the year before the one asked about,
+    // and only ask about years from that of the last transition on
+    const int firstYear = (entry.m_tranTimes.isEmpty()
+                           ? 1970
+                           : QDateTime::fromMSecsSinceEpoch(entry.m_tranTimes.last().atMSecsSinceEpoch,
+                                                            Qt::UTC).date().year()) - 1;
+    if (firstYear > PosixExpansionLastYear)
+        return;
+    entry.m_posixFirstYear = firstYear;
+    entry.m_posixTransitions = calculatePosixTransitions(entry.m_posixRule, firstYear,
+                                                         PosixExpansionLastYear, 0,
+                                                         &entry.m_posixYearStarts);
+}
+
 // Create the system default time zone
 QTzTimeZonePrivate::QTzTimeZonePrivate()
 {
@@ -755,7 +784,7 @@ QTzTimeZoneCacheEntry QTzTimeZoneCache::findEntry(const QByteArray &ianaId)
     QList<int> abbrindList;
     abbrindList.reserve(size);
     for (auto it = abbrevMap.cbegin(), end = abbrevMap.cend(); it != end; ++it) {
-        ret.m_abbreviations.append(it.value());
+        ret.m_abbreviations.append(QString::fromUtf8(it.value()));
         abbrindList.append(it.key());
     }
     for (int i = 0; i < typeList.size(); ++i)
@@ -853,6 +882,7 @@ QTzTimeZoneCacheEntry QTzTimeZoneCache::fetchEntry(const QByteArray &ianaId)
 
     // ... or build a new entry from scratch
     QTzTimeZoneCacheEntry ret = findEntry(ianaId);
+    expandPosixRule(ret);
     m_cache.insert(ianaId, new QTzTimeZoneCacheEntry(ret));
     return ret;
 }
@@ -1018,17 +1048,24 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::dataForTzTransition(QTzTransitionTime
 {
     QTimeZonePrivate::Data data;
     data.atMSecsSinceEpoch = tran.atMSecsSinceEpoch;
-    QTzTransitionRule rule = cached_data.m_tranRules.at(tran.ruleIndex);
+    const QTzTransitionRule &rule = cached_data.m_tranRules.at(tran.ruleIndex);
     data.standardTimeOffset = rule.stdOffset;
     data.daylightTimeOffset = rule.dstOffset;
     data.offsetFromUtc = rule.stdOffset + rule.dstOffset;
-    data.abbreviation = QString::fromUtf8(cached_data.m_abbreviations.at(rule.abbreviationIndex));
+    data.abbreviation = cached_data.m_abbreviations.at(rule.abbreviationIndex);
     return data;
 }
 
 QList<QTimeZonePrivate::Data> QTzTimeZonePrivate::getPosixTransitions(qint64 msNear) const
 {
     const int year = QDateTime::fromMSecsSinceEpoch(msNear, Qt::UTC).date().year();
+    // Use the transitions computed when the zone was loaded, if they cover these years:
+    const int first = year - 1 - cached_data.m_posixFirstYear;
+    const int last = year + 2 - cached_data.m_posixFirstYear;
+    if (first >= 0 && last < cached_data.m_posixYearStarts.size()) {
+        const int begin = cached_data.m_posixYearStarts.at(first);
+        return cached_data.m_posixTransitions.mid(begin, cached_data.m_posixYearStarts.at(last) - begin);
+    }
     // The Data::atMSecsSinceEpoch of the single entry if zone is constant:
     qint64 atTime = tranCache().isEmpty() ? msNear : tranCache().last().atMSecsSinceEpoch;
     return calculatePosixTransitions(cached_data.m_posixRule, year - 1, year + 1, atTime);
@@ -443,6 +443,22 @@ void QStandardItemModelPrivate::init()
     roleNames = QAbstractItemModelPrivate::defaultRoleNames();
 }
 
+/*!
+    \internal
+
+    Reads the data from the items directly, without creating an index for
+    each of them.
+*/
+void QStandardItemModelPrivate::columnData(int column, int firstRow, int lastRow, int role,
+                                           QVariant *values, const QModelIndex &parent) const
+{
+    const QStandardItem *parentItem = itemFromIndex(parent);
+    for (int row = firstRow; row <= lastRow; ++row) {
+        const QStandardItem *item = parentItem ? parentItem->child(row, column) : nullptr;
+        *values++ = item ? item->data(role) : QVariant();
+    }
+}
+
 /*!
     \internal
 */
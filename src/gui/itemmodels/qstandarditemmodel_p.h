@@ -226,6 +226,8 @@ public:
         return parent->child(index.row(), index.column());
     }
 
+    void columnData(int column, int firstRow, int lastRow, int role, QVariant *values,
+                    const QModelIndex &parent) const override;
     void sort(QStandardItem *parent, int column, Qt::SortOrder order);
     void itemChanged(QStandardItem *item, const QList<int> &roles = QList<int>());
     void rowsAboutToBeInserted(QStandardItem *parent, int start, int end);
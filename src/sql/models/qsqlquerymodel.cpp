@@ -100,6 +100,28 @@ int QSqlQueryModelPrivate::columnInQuery(int modelColumn) const
     return modelColumn - colOffsets[modelColumn];
 }
 
+// Reads the rows from the query in order, without creating an index for each
+void QSqlQueryModelPrivate::columnData(int column, int firstRow, int lastRow, int role,
+                                       QVariant *values, const QModelIndex &parent) const
+{
+    const int queryColumn = columnInQuery(column);
+    const bool hasData = queryColumn >= 0 && !parent.isValid()
+            && !(role & ~(Qt::DisplayRole | Qt::EditRole));
+    for (int row = firstRow; row <= lastRow; ++row) {
+        if (hasData && row >= 0 && row <= bottom.row()) {
+            if (query.seek(row)) {
+                *values = query.value(queryColumn);
+            } else {
+                error = query.lastError();
+                *values = QVariant();
+            }
+        } else {
+            *values = QVariant();
+        }
+        ++values;
+    }
+}
+
 /*!
     \class QSqlQueryModel
     \brief The QSqlQueryModel class provides a read-only data model for SQL
@@ -72,6 +72,8 @@ public:
     ~QSqlQueryModelPrivate();
 
     void prefetch(int);
+    void columnData(int column, int firstRow, int lastRow, int role, QVariant *values,
+                    const QModelIndex &parent) const override;
     void initColOffsets(int size);
     int columnInQuery(int modelColumn) const;
 
@@ -110,21 +110,40 @@ bool QDomBuilder::startElement(const QString &nsURI, const QString &qName,
         return false;
 
     n->setLocation(locator->line(), locator->column());
+    shareNames(n);
 
     node->appendChild(n);
     node = n;
 
     // attributes
+    auto domElement = static_cast<QDomElementPrivate *>(node);
     for (const auto &attr : atts) {
-        auto domElement = static_cast<QDomElementPrivate *>(node);
-        if (nsProcessing) {
-            domElement->setAttributeNS(attr.namespaceUri().toString(),
-                                       attr.qualifiedName().toString(),
-                                       attr.value().toString());
-        } else {
-            domElement->setAttribute(attr.qualifiedName().toString(),
-                                     attr.value().toString());
+        const QString qName = sharedString(attr.qualifiedName());
+        QDomAttrPrivate *a = nsProcessing
+                ? new QDomAttrPrivate(doc, domElement, sharedString(attr.namespaceUri()), qName)
+                : new QDomAttrPrivate(doc, domElement, qName);
+        shareNames(a);
+
+        const bool exists = nsProcessing
+                ? domElement->m_attr->containsNS(a->namespaceURI, a->name)
+                : domElement->m_attr->contains(a->name);
+        if (exists) {
+            // let the element deal with redefined attributes
+            delete a;
+            if (nsProcessing) {
+                domElement->setAttributeNS(attr.namespaceUri().toString(), qName,
+                                           attr.value().toString());
+            } else {
+                domElement->setAttribute(qName, attr.value().toString());
+            }
+            continue;
         }
+
+        a->setNodeValue(attr.value().toString());
+        // Referencing is done by the map, so we set the reference counter back
+        // to 0 here. This is ok since we created the QDomAttrPrivate.
+        a->ref.deref();
+        domElement->m_attr->setNamedItem(a);
     }
 
     return true;
@@ -198,6 +217,31 @@ QDomBuilder::ErrorInfo QDomBuilder::error() const
     return ErrorInfo(errorMsg, errorLine, errorColumn);
 }
 
+/*!
+    \internal
+
+    Returns a copy of \a s that shares its data with every other string passed
+    to this function that compares equal to it. A null \a s gives a null string.
+ */
+QString QDomBuilder::sharedString(QStringView s)
+{
+    if (s.isNull())
+        return QString();
+    auto it = stringPool.constFind(s);
+    if (it != stringPool.constEnd())
+        return it.value();
+    const QString str = s.toString();
+    stringPool.insert(QStringView(str), str);
+    return str;
+}
+
+void QDomBuilder::shareNames(QDomNodePrivate *n)
+{
+    n->name = sharedString(n->name);
+    n->prefix = sharedString(n->prefix);
+    n->namespaceURI = sharedString(n->namespaceURI);
+}
+
 bool QDomBuilder::startEntity(const QString &name)
 {
     entityName = name;
@@ -355,10 +399,9 @@ bool QDomParser::parseBody()
     while (!reader->atEnd() && !reader->hasError()) {
         switch (reader->tokenType()) {
         case QXmlStreamReader::StartElement:
-            tagStack.push(reader->qualifiedName().toString());
-            if (!domBuilder.startElement(reader->namespaceUri().toString(),
-                                         reader->qualifiedName().toString(),
-                                         reader->attributes())) {
+            tagStack.push(domBuilder.sharedString(reader->qualifiedName()));
+            if (!domBuilder.startElement(domBuilder.sharedString(reader->namespaceUri()),
+                                         tagStack.top(), reader->attributes())) {
                 domBuilder.fatalError(
                         QDomParser::tr("Error occurred while processing a start element"));
                 return false;
@@ -379,7 +422,7 @@ bool QDomParser::parseBody()
             break;
         case QXmlStreamReader::Characters:
             if (!reader->isWhitespace()) { // Skip the content consisting of only whitespaces
-                if (!reader->text().toString().trimmed().isEmpty()) {
+                if (!reader->text().trimmed().isEmpty()) {
                     if (!domBuilder.characters(reader->text().toString(), reader->isCDATA())) {
                         domBuilder.fatalError(QDomParser::tr(
                                 "Error occurred while processing the element content"));
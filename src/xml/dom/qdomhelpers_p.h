@@ -41,6 +41,8 @@
 
 #include <qcoreapplication.h>
 #include <qglobal.h>
+#include <qhash.h>
+#include <qstring.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -124,6 +126,8 @@ public:
     using ErrorInfo = std::tuple<QString, int, int>;
     ErrorInfo error() const;
 
+    QString sharedString(QStringView s);
+
     QString errorMsg;
     int errorLine;
     int errorColumn;
@@ -134,6 +138,13 @@ private:
     QXmlDocumentLocator *locator;
     QString entityName;
     bool nsProcessing;
+
+    void shareNames(QDomNodePrivate *n);
+
+    // Element and attribute names, prefixes and namespace URIs repeat throughout
+    // a document, so all nodes created by the builder share one copy of each.
+    // The keys view the data of the QString stored as value.
+    QHash<QStringView, QString> stringPool;
 };
 
 /**************************************************************
@@ -29,6 +29,11 @@
 #include <QCoreApplication>
 #include <QLoggingCategory>
 
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #ifdef Q_CC_GNU
 #define NEVER_INLINE __attribute__((__noinline__))
 #else
@@ -60,11 +65,64 @@ void MyClass::myFunction(int a)
     qDebug() << "from_a_function" << a;
 }
 
+#ifdef Q_OS_UNIX
+// Holding the stdio lock of stderr keeps the QT_LOGGING_ASYNC writer thread
+// from writing anything, while this thread can still write to stderr.
+
+static void asyncOrder()
+{
+    flockfile(stderr);
+    qDebug("queued");
+    fputs("direct\n", stderr);
+    funlockfile(stderr);
+}
+
+static void asyncFlood(bool block)
+{
+    std::thread locker;
+    if (block) {
+        // the writer stays blocked for a while after the ring is full
+        std::atomic<bool> locked = {false};
+        locker = std::thread([&locked] {
+            flockfile(stderr);
+            locked = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            funlockfile(stderr);
+        });
+        while (!locked)
+            std::this_thread::yield();
+    } else {
+        flockfile(stderr);
+    }
+
+    for (int i = 0; i < 5000; ++i)
+        qDebug("message %d", i);
+
+    if (block)
+        locker.join();
+    else
+        funlockfile(stderr);
+}
+#endif
+
 int main(int argc, char **argv)
 {
     QCoreApplication app(argc, argv);
     app.setApplicationName("tst_qlogging");
 
+#ifdef Q_OS_UNIX
+    const QByteArray mode = argc > 1 ? QByteArray(argv[1]) : QByteArray();
+    if (mode == "async-order" || mode.startsWith("async-flood")) {
+        qSetMessagePattern("%{message}");
+        if (mode == "async-order")
+            asyncOrder();
+        else
+            asyncFlood(mode == "async-flood-block");
+        qSetMessagePattern(QString());
+        return 0;
+    }
+#endif
+
     qSetMessagePattern("[%{type}] %{message}");
 
     qDebug("qDebug");
@@ -33,6 +33,9 @@
 # include <QtCore/QProcess>
 #endif
 #include <QtTest/QTest>
+#include <QtCore/QBuffer>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/private/qbinarylog_p.h>
 
 class tst_qmessagehandler : public QObject
 {
@@ -57,6 +60,12 @@ private slots:
     void qMessagePattern_data();
     void qMessagePattern();
     void setMessagePattern();
+    void asyncOutput_data();
+    void asyncOutput();
+    void asyncOverflow_data();
+    void asyncOverflow();
+    void binaryLog();
+    void binaryOutput();
 
     void formatLogMessage_data();
     void formatLogMessage();
@@ -667,16 +676,16 @@ void tst_qmessagehandler::qMessagePattern_data()
 
     // %{file} is tricky because of shadow builds
     QTest::newRow("basic") << "%{type} %{appname} %{line} %{function} %{message}" << true << (QList<QByteArray>()
-            << "debug  39 T::T static constructor"
+            << "debug  44 T::T static constructor"
             //  we can't be sure whether the QT_MESSAGE_PATTERN is already destructed
             << "static destructor"
-            << "debug tst_qlogging 60 MyClass::myFunction from_a_function 34"
-            << "debug tst_qlogging 70 main qDebug"
-            << "info tst_qlogging 71 main qInfo"
-            << "warning tst_qlogging 72 main qWarning"
-            << "critical tst_qlogging 73 main qCritical"
-            << "warning tst_qlogging 76 main qDebug with category"
-            << "debug tst_qlogging 80 main qDebug2");
+            << "debug tst_qlogging 65 MyClass::myFunction from_a_function 34"
+            << "debug tst_qlogging 128 main qDebug"
+            << "info tst_qlogging 129 main qInfo"
+            << "warning tst_qlogging 130 main qWarning"
+            << "critical tst_qlogging 131 main qCritical"
+            << "warning tst_qlogging 134 main qDebug with category"
+            << "debug tst_qlogging 138 main qDebug2");
 
 
     QTest::newRow("invalid") << "PREFIX: %{unknown} %{message}" << false << (QList<QByteArray>()
@@ -860,6 +869,276 @@ void tst_qmessagehandler::setMessagePattern()
 #endif // QT_CONFIG(process)
 }
 
+void tst_qmessagehandler::asyncOutput_data()
+{
+    QTest::addColumn<QString>("mode");
+
+    QTest::newRow("block") << "block";
+    QTest::newRow("drop") << "drop";
+}
+
+void tst_qmessagehandler::asyncOutput()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#else
+#ifdef Q_OS_ANDROID
+    QSKIP("This test crashes on Android");
+#endif
+    QFETCH(QString, mode);
+
+    QProcess process;
+#ifndef Q_OS_ANDROID
+    const QString appExe(QLatin1String(HELPER_BINARY));
+#else
+    const QString appExe(QCoreApplication::applicationDirPath() + QLatin1String("/libhelper.so"));
+#endif
+
+    QStringList environment;
+    environment.reserve(m_baseEnvironment.size() + 1);
+    for (const QString &variable : qAsConst(m_baseEnvironment)) {
+        if (!variable.startsWith(QLatin1String("QT_MESSAGE_PATTERN"))
+                && !variable.startsWith(QLatin1String("QT_LOGGING_ASYNC"))) {
+            environment << variable;
+        }
+    }
+    environment << QLatin1String("QT_LOGGING_ASYNC=") + mode;
+    process.setEnvironment(environment);
+
+    process.start(appExe);
+    QVERIFY2(process.waitForStarted(), qPrintable(
+        QString::fromLatin1("Could not start %1: %2").arg(appExe, process.errorString())));
+    process.waitForFinished();
+
+    // everything queued must have been written out at exit, in order
+    QByteArray output = process.readAllStandardError();
+    QByteArray expected = "static constructor\n"
+            "[debug] qDebug\n"
+            "[info] qInfo\n"
+            "[warning] qWarning\n"
+            "[critical] qCritical\n"
+            "[warning] qDebug with category\n";
+#ifdef Q_OS_WIN
+    output.replace("\r\n", "\n");
+#endif
+    QCOMPARE(QString::fromLatin1(output), QString::fromLatin1(expected));
+
+#ifdef Q_OS_UNIX
+    // the helper holds the lock of stderr while it logs, so a message that
+    // went through the writer thread comes after what it wrote directly
+    process.start(appExe, { QLatin1String("async-order") });
+    QVERIFY(process.waitForStarted());
+    process.waitForFinished();
+    output = process.readAllStandardError();
+    output.replace("static constructor\n", "");
+    QCOMPARE(output, QByteArray("direct\nqueued\n"));
+#endif
+#endif // QT_CONFIG(process)
+}
+
+void tst_qmessagehandler::asyncOverflow_data()
+{
+    asyncOutput_data();
+}
+
+void tst_qmessagehandler::asyncOverflow()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#elif !defined(Q_OS_UNIX)
+    QSKIP("This test requires flockfile()");
+#else
+    QFETCH(QString, mode);
+
+    QProcess process;
+    const QString appExe(QLatin1String(HELPER_BINARY));
+
+    QStringList environment;
+    environment.reserve(m_baseEnvironment.size() + 1);
+    for (const QString &variable : qAsConst(m_baseEnvironment)) {
+        if (!variable.startsWith(QLatin1String("QT_MESSAGE_PATTERN"))
+                && !variable.startsWith(QLatin1String("QT_LOGGING_ASYNC"))) {
+            environment << variable;
+        }
+    }
+    environment << QLatin1String("QT_LOGGING_ASYNC=") + mode;
+    process.setEnvironment(environment);
+
+    // the helper logs 5000 messages while the writer thread cannot write,
+    // which fills the ring of the logging thread
+    process.start(appExe, { QLatin1String("async-flood-") + mode });
+    QVERIFY(process.waitForStarted());
+    QVERIFY(process.waitForFinished());
+
+    QList<QByteArray> lines = process.readAllStandardError().split('\n');
+    QCOMPARE(lines.takeFirst(), QByteArray("static constructor"));
+    QCOMPARE(lines.takeLast(), QByteArray());
+
+    const QByteArray droppedPrefix = "QT_LOGGING_ASYNC: ";
+    const QByteArray droppedSuffix = " messages dropped";
+    int written = 0;
+    int dropped = 0;
+    int last = -1;
+    for (const QByteArray &line : qAsConst(lines)) {
+        if (line.startsWith(droppedPrefix) && line.endsWith(droppedSuffix)) {
+            const int count = line.mid(droppedPrefix.size(),
+                                       line.size() - droppedPrefix.size() - droppedSuffix.size()).toInt();
+            QVERIFY2(count > 0, line.constData());
+            dropped += count;
+            continue;
+        }
+        QVERIFY2(line.startsWith("message "), line.constData());
+        const int number = line.mid(8).toInt();
+        if (mode == QLatin1String("block"))
+            QCOMPARE(number, last + 1);
+        else
+            QVERIFY2(number > last, line.constData());
+        last = number;
+        ++written;
+    }
+
+    if (mode == QLatin1String("block")) {
+        QCOMPARE(dropped, 0);
+        QCOMPARE(written, 5000);
+    } else {
+        QVERIFY(dropped > 0);
+        QCOMPARE(written + dropped, 5000);
+    }
+#endif // QT_CONFIG(process)
+}
+
+static void writeDeferred(QBinaryLogWriter *writer, const QMessageLogContext &context,
+                          bool expectDeferred, const char *format, ...)
+{
+    va_list ap;
+    va_start(ap, format);
+    const bool deferred = writer->writeDeferred(QtInfoMsg, context, format, ap);
+    if (!deferred)
+        writer->write(QtInfoMsg, context, QString::vasprintf(format, ap));
+    va_end(ap);
+    QCOMPARE(deferred, expectDeferred);
+}
+
+void tst_qmessagehandler::binaryLog()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QByteArray fileName = QFile::encodeName(dir.filePath(QLatin1String("log.bin")));
+
+    QMessageLogContext context("main.cpp", 42, "void f()", "qt.test");
+    char buffer[32];
+    {
+        QBinaryLogWriter writer;
+        QVERIFY(writer.open(fileName.constData()));
+        writer.write(QtWarningMsg, context, QStringLiteral("preformatted \u00e9"));
+        writeDeferred(&writer, context, true, "plain");
+        writeDeferred(&writer, context, true, "%d|%5u|%-4x|%hhd|%lld|%zu|%c|%%",
+                      -12, 7u, 255u, 300, Q_INT64_C(-1234567890123), size_t(99), 'z');
+        writeDeferred(&writer, context, true, "%.2f|%*d|%.*s|%s|%g", 3.14159, 6, 42, 3,
+                      "abcdef", "\xc3\xa9t\xc3\xa9", 1e10);
+        // the same buffer with different contents must not reuse the format
+        qstrcpy(buffer, "first %d");
+        writeDeferred(&writer, context, true, buffer, 1);
+        qstrcpy(buffer, "second %d");
+        writeDeferred(&writer, context, true, buffer, 2);
+        // QChar conversions are not recorded
+        writeDeferred(&writer, context, false, "%lc", int(u'w'));
+    }
+
+    QFile file(QFile::decodeName(fileName));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QBinaryLogReader reader(&file);
+    QStringList messages;
+    while (reader.readNext()) {
+        QCOMPARE(reader.context().file, "main.cpp");
+        QCOMPARE(reader.context().line, 42);
+        QCOMPARE(reader.context().function, "void f()");
+        QCOMPARE(reader.context().category, "qt.test");
+        QVERIFY(reader.timestamp() > 0);
+        QCOMPARE(reader.type(), messages.isEmpty() ? QtWarningMsg : QtInfoMsg);
+        messages << reader.message();
+    }
+    QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+
+    const QStringList expected = {
+        QStringLiteral("preformatted \u00e9"),
+        QStringLiteral("plain"),
+        QString::asprintf("%d|%5u|%-4x|%hhd|%lld|%zu|%c|%%",
+                          -12, 7u, 255u, 300, Q_INT64_C(-1234567890123), size_t(99), 'z'),
+        QString::asprintf("%.2f|%*d|%.*s|%s|%g", 3.14159, 6, 42, 3, "abcdef",
+                          "\xc3\xa9t\xc3\xa9", 1e10),
+        QStringLiteral("first 1"),
+        QStringLiteral("second 2"),
+        QStringLiteral("w"),
+    };
+    QCOMPARE(messages, expected);
+
+    // truncated files are reported
+    QVERIFY(file.seek(0));
+    QBuffer truncated;
+    truncated.setData(file.readAll().chopped(3));
+    QVERIFY(truncated.open(QIODevice::ReadOnly));
+    QBinaryLogReader truncatedReader(&truncated);
+    int count = 0;
+    while (truncatedReader.readNext())
+        ++count;
+    QCOMPARE(count, expected.size() - 1);
+    QVERIFY(truncatedReader.hasError());
+}
+
+void tst_qmessagehandler::binaryOutput()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#else
+#ifdef Q_OS_ANDROID
+    QSKIP("This test crashes on Android");
+#endif
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath(QLatin1String("log.bin"));
+
+    QProcess process;
+#ifndef Q_OS_ANDROID
+    const QString appExe(QLatin1String(HELPER_BINARY));
+#else
+    const QString appExe(QCoreApplication::applicationDirPath() + QLatin1String("/libhelper.so"));
+#endif
+
+    QStringList environment = m_baseEnvironment;
+    environment << QLatin1String("QT_LOGGING_BINARY=") + fileName;
+    process.setEnvironment(environment);
+
+    process.start(appExe);
+    QVERIFY2(process.waitForStarted(), qPrintable(
+        QString::fromLatin1("Could not start %1: %2").arg(appExe, process.errorString())));
+    process.waitForFinished();
+
+    // nothing goes to stderr
+    QCOMPARE(process.readAllStandardError(), QByteArray());
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QBinaryLogReader reader(&file);
+    QStringList messages;
+    while (reader.readNext())
+        messages << reader.message();
+    QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+
+    const QStringList expected = {
+        QStringLiteral("static constructor"),
+        QStringLiteral("qDebug"),
+        QStringLiteral("qInfo"),
+        QStringLiteral("qWarning"),
+        QStringLiteral("qCritical"),
+        QStringLiteral("qDebug with category"),
+        QStringLiteral("qDebug2"),
+        QStringLiteral("from_a_function 34"),
+    };
+    QCOMPARE(messages.mid(0, expected.size()), expected);
+#endif // QT_CONFIG(process)
+}
+
 Q_DECLARE_METATYPE(QtMsgType)
 
 void tst_qmessagehandler::formatLogMessage_data()
@@ -0,0 +1,235 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QTest>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtCore/private/qasyncfileio_p.h>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+class tst_QAsyncFileIO : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void readFiles_data();
+    void readFiles();
+    void readMissingFile_data() { backends(); }
+    void readMissingFile();
+    void readUnsizedFile_data() { backends(); }
+    void readUnsizedFile();
+    void readDirectory_data() { backends(); }
+    void readDirectory();
+    void positionalReadWrite_data() { backends(); }
+    void positionalReadWrite();
+    void batchedReads_data() { backends(); }
+    void batchedReads();
+
+private:
+    void backends();
+    static QByteArray contents(int size, int seed);
+
+    QTemporaryDir dir;
+};
+
+void tst_QAsyncFileIO::initTestCase()
+{
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+}
+
+void tst_QAsyncFileIO::backends()
+{
+    QTest::addColumn<QAsyncFileIO::Backend>("backend");
+    QTest::newRow("threadpool") << QAsyncFileIO::ThreadPoolBackend;
+    QTest::newRow("io_uring") << QAsyncFileIO::IoUringBackend;
+}
+
+QByteArray tst_QAsyncFileIO::contents(int size, int seed)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i)
+        data[i] = char((i * 31 + seed) & 0xff);
+    return data;
+}
+
+void tst_QAsyncFileIO::readFiles_data()
+{
+    QTest::addColumn<QAsyncFileIO::Backend>("backend");
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("size");
+
+    for (auto backend : { QAsyncFileIO::ThreadPoolBackend, QAsyncFileIO::IoUringBackend }) {
+        const char *name = backend == QAsyncFileIO::IoUringBackend ? "io_uring" : "threadpool";
+        QTest::addRow("%s-single", name) << backend << 1 << 100;
+        QTest::addRow("%s-empty", name) << backend << 3 << 0;
+        // more files than fit in the ring at once
+        QTest::addRow("%s-many", name) << backend << 1000 << 512;
+        QTest::addRow("%s-large", name) << backend << 2 << 8 * 1024 * 1024 + 17;
+    }
+}
+
+void tst_QAsyncFileIO::readFiles()
+{
+    QFETCH(QAsyncFileIO::Backend, backend);
+    QFETCH(int, count);
+    QFETCH(int, size);
+
+    QStringList fileNames;
+    for (int i = 0; i < count; ++i) {
+        const QString fileName = dir.filePath(QString::fromLatin1("read-%1-%2").arg(size).arg(i));
+        QFile file(fileName);
+        QVERIFY2(file.open(QIODevice::WriteOnly), qPrintable(file.errorString()));
+        QCOMPARE(file.write(contents(size, i)), qint64(size));
+        fileNames.append(fileName);
+    }
+
+    QAsyncFileIO io(backend);
+    QList<QFuture<QByteArray>> futures = io.readFiles(fileNames);
+    QCOMPARE(futures.size(), count);
+    for (int i = 0; i < count; ++i) {
+        futures[i].waitForFinished();
+        QCOMPARE(futures.at(i).resultCount(), 1);
+        QCOMPARE(futures.at(i).result(), contents(size, i));
+    }
+
+    QFuture<QByteArray> single = io.readFile(fileNames.constFirst());
+    QCOMPARE(single.result(), contents(size, 0));
+}
+
+void tst_QAsyncFileIO::readMissingFile()
+{
+    QFETCH(QAsyncFileIO::Backend, backend);
+
+    QAsyncFileIO io(backend);
+    QFuture<QByteArray> future = io.readFile(dir.filePath(QLatin1String("does-not-exist")));
+    future.waitForFinished();
+    QVERIFY(future.isFinished());
+    QCOMPARE(future.resultCount(), 0);
+}
+
+void tst_QAsyncFileIO::readUnsizedFile()
+{
+#ifdef Q_OS_LINUX
+    QFETCH(QAsyncFileIO::Backend, backend);
+
+    // procfs reports a size of 0 for files that do have contents
+    QAsyncFileIO io(backend);
+    QFuture<QByteArray> future = io.readFile(QLatin1String("/proc/self/status"));
+    future.waitForFinished();
+    QCOMPARE(future.resultCount(), 1);
+    QVERIFY(future.result().contains("Name:"));
+#else
+    QSKIP("This test needs procfs.");
+#endif
+}
+
+void tst_QAsyncFileIO::readDirectory()
+{
+    QFETCH(QAsyncFileIO::Backend, backend);
+
+    // opens fine, but cannot be read
+    QAsyncFileIO io(backend);
+    QFuture<QByteArray> future = io.readFile(dir.path());
+    future.waitForFinished();
+    QCOMPARE(future.resultCount(), 0);
+}
+
+void tst_QAsyncFileIO::positionalReadWrite()
+{
+#ifdef Q_OS_UNIX
+    QFETCH(QAsyncFileIO::Backend, backend);
+
+    const QByteArray fileName = QFile::encodeName(dir.filePath(QLatin1String("positional")));
+    const int fd = ::open(fileName.constData(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    QVERIFY(fd >= 0);
+
+    QAsyncFileIO io(backend);
+    const QByteArray data = contents(4096, 7);
+    QCOMPARE(io.write(fd, 1000, data.constData(), data.size()).result(), qint64(data.size()));
+
+    QByteArray buffer(100, Qt::Uninitialized);
+    QCOMPARE(io.read(fd, 1000 + 50, buffer.data(), buffer.size()).result(), qint64(100));
+    QCOMPARE(buffer, data.mid(50, 100));
+
+    // short read at the end of the file, and nothing past it
+    QCOMPARE(io.read(fd, 5000, buffer.data(), buffer.size()).result(), qint64(96));
+    QCOMPARE(buffer.left(96), data.right(96));
+    QCOMPARE(io.read(fd, 6000, buffer.data(), buffer.size()).result(), qint64(0));
+
+    // the file position is left alone
+    QCOMPARE(::lseek(fd, 0, SEEK_CUR), off_t(0));
+    ::close(fd);
+
+    QCOMPARE(io.read(-1, 0, buffer.data(), buffer.size()).result(), qint64(-1));
+#else
+    QSKIP("Positional I/O on file descriptors is only available on Unix.");
+#endif
+}
+
+void tst_QAsyncFileIO::batchedReads()
+{
+#ifdef Q_OS_UNIX
+    QFETCH(QAsyncFileIO::Backend, backend);
+
+    const QString fileName = dir.filePath(QLatin1String("batched"));
+    const QByteArray data = contents(1 << 20, 3);
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(data), qint64(data.size()));
+    }
+    const int fd = ::open(QFile::encodeName(fileName).constData(), O_RDONLY);
+    QVERIFY(fd >= 0);
+
+    // read the file in 4 KiB blocks, back to front, straight into one buffer
+    const int blockSize = 4096;
+    QByteArray buffer(data.size(), Qt::Uninitialized);
+    QList<QAsyncFileIO::ReadRequest> requests;
+    for (int offset = data.size() - blockSize; offset >= 0; offset -= blockSize)
+        requests.append({ fd, offset, buffer.data() + offset, blockSize });
+
+    QAsyncFileIO io(backend);
+    const QList<QFuture<qint64>> futures = io.read(requests);
+    QCOMPARE(futures.size(), requests.size());
+    for (const QFuture<qint64> &future : futures)
+        QCOMPARE(future.result(), qint64(blockSize));
+    QCOMPARE(buffer, data);
+    ::close(fd);
+#else
+    QSKIP("Positional I/O on file descriptors is only available on Unix.");
+#endif
+}
+
+QTEST_MAIN(tst_QAsyncFileIO)
+#include "tst_qasyncfileio.moc"
@@ -172,6 +172,67 @@ private slots:
             }
         }
         QCOMPARE(state, result);
+
+        QLoggingRuleMatcher matcher;
+        const QList<QLoggingRule> rules{rule};
+        matcher.setRules(&rules, 1);
+        const QLoggingRuleMatcher::Result matched = matcher.match(categoryL1S);
+        const qint8 decision = msgType == QtDebugMsg ? matched.debug
+                : msgType == QtInfoMsg ? matched.info
+                : msgType == QtWarningMsg ? matched.warning : matched.critical;
+        QCOMPARE(decision != 0, state == Match);
+    }
+
+    void QLoggingRuleMatcher_sameAsRules()
+    {
+        // the matcher must come to the same conclusion as testing every rule
+        QLoggingSettingsParser parser;
+        parser.setImplicitRulesSection(true);
+        parser.setContent("*=true\n"
+                          "qt.*=false\n"
+                          "qt.core.*.debug=true\n"
+                          "*.io=false\n"
+                          "*.io.warning=true\n"
+                          "*core*.critical=false\n"
+                          "qt.core.io=true\n"
+                          "qt.core.io.info=false\n"
+                          "*.a=true\n"
+                          "**=false\n"
+                          "*=true\n"
+                          "qt.network.*=false\n"
+                          "qt.network.ssl=true\n");
+        const QList<QLoggingRule> allRules = parser.rules();
+        QCOMPARE(allRules.size(), 13);
+
+        const char *categories[] = {
+            "qt", "qt.core", "qt.core.io", "qt.core.io.x", "qt.io", "io", "default",
+            "x.a", "x.a.a", "a", "qt.network.ssl", "qt.network.http", "qt.networking",
+            "core", "mycore.io", "",
+        };
+
+        // try every split of the rules into two sets
+        for (qsizetype split = 0; split <= allRules.size(); ++split) {
+            const QList<QLoggingRule> ruleSets[] = { allRules.mid(0, split), allRules.mid(split) };
+            QLoggingRuleMatcher matcher;
+            matcher.setRules(ruleSets, 2);
+
+            for (const char *category : categories) {
+                const QLatin1String name(category);
+                qint8 expected[4] = {};
+                const QtMsgType types[4] = { QtDebugMsg, QtInfoMsg, QtWarningMsg, QtCriticalMsg };
+                for (const QLoggingRule &rule : allRules) {
+                    for (int i = 0; i < 4; ++i) {
+                        if (const int pass = rule.pass(name, types[i]))
+                            expected[i] = qint8(pass);
+                    }
+                }
+                const QLoggingRuleMatcher::Result result = matcher.match(name);
+                QCOMPARE(result.debug, expected[0]);
+                QCOMPARE(result.info, expected[1]);
+                QCOMPARE(result.warning, expected[2]);
+                QCOMPARE(result.critical, expected[3]);
+            }
+        }
     }
 
     void QLoggingSettingsParser_iniStyle()
@@ -309,6 +370,36 @@ private slots:
         QVERIFY(!cat.isWarningEnabled());
     }
 
+    void QLoggingRegistry_incrementalUpdate()
+    {
+        QLoggingCategory berlin("Digia.Berlin");
+        QLoggingCategory oslo("Digia.Oslo");
+        QLoggingRegistry *registry = QLoggingRegistry::instance();
+
+        registry->ruleSets[QLoggingRegistry::ApiRules].clear();
+        registry->ruleSets[QLoggingRegistry::ConfigRules].clear();
+        registry->ruleSets[QLoggingRegistry::EnvironmentRules].clear();
+        registry->updateRules();
+
+        QLoggingCategory::setFilterRules("Digia.Berlin.warning=false");
+        QVERIFY(!berlin.isWarningEnabled());
+        QVERIFY(oslo.isWarningEnabled());
+
+        // only the categories matched by a changed rule are filtered again
+        oslo.setEnabled(QtWarningMsg, false);
+        QLoggingCategory::setFilterRules("Digia.Berlin.debug=false");
+        QVERIFY(berlin.isWarningEnabled());
+        QVERIFY(!berlin.isDebugEnabled());
+        QVERIFY(!oslo.isWarningEnabled());
+
+        QLoggingCategory::setFilterRules("Digia.*.warning=true");
+        QVERIFY(berlin.isDebugEnabled());
+        QVERIFY(oslo.isWarningEnabled());
+
+        QLoggingCategory::setFilterRules(QString());
+        QVERIFY(berlin.isWarningEnabled());
+        QVERIFY(oslo.isWarningEnabled());
+    }
 
     void QLoggingRegistry_checkErrors()
     {
@@ -0,0 +1,280 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QDirIterator>
+#include <QFile>
+#include <QMutex>
+#include <QSet>
+#include <QTemporaryDir>
+#include <QThreadPool>
+#include <QtCore/private/qparalleldirwalker_p.h>
+
+#include <atomic>
+
+class tst_QParallelDirWalker : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void matchesDirIterator_data();
+    void matchesDirIterator();
+    void followSymlinks();
+    void batches();
+    void fetchMetaData();
+    void cancel();
+    void customThreadPool();
+    void nonExistentPath();
+
+private:
+    void createFile(const QString &path, int size = 0);
+    static QStringList dirIteratorPaths(const QString &path, QDir::Filters filters,
+                                        const QStringList &nameFilters,
+                                        QDirIterator::IteratorFlags flags);
+    static QStringList paths(const QFileInfoList &list);
+
+    QTemporaryDir tempDir;
+    QString tree;
+};
+
+void tst_QParallelDirWalker::createFile(const QString &path, int size)
+{
+    QFile file(path);
+    QVERIFY2(file.open(QIODevice::WriteOnly), qPrintable(file.errorString()));
+    QCOMPARE(file.write(QByteArray(size, 'x')), qint64(size));
+}
+
+void tst_QParallelDirWalker::initTestCase()
+{
+    QVERIFY2(tempDir.isValid(), qPrintable(tempDir.errorString()));
+    tree = tempDir.path() + QLatin1String("/tree");
+    QDir dir(tempDir.path());
+
+    const char *directories[] = {
+        "tree/a/b/c", "tree/a/d", "tree/e", "tree/.hidden/f", "tree/empty"
+    };
+    for (const char *name : directories)
+        QVERIFY(dir.mkpath(QLatin1String(name)));
+
+    int size = 0;
+    const char *files[] = {
+        "tree/one.txt", "tree/two.cpp", "tree/.hiddenfile.txt", "tree/a/three.txt",
+        "tree/a/b/four.h", "tree/a/b/c/five.txt", "tree/a/d/six.cpp", "tree/e/seven.txt",
+        "tree/.hidden/eight.txt", "tree/.hidden/f/nine.txt"
+    };
+    for (const char *name : files)
+        createFile(tempDir.path() + QLatin1Char('/') + QLatin1String(name), size += 10);
+
+    // Spread many files over a few directories, so that several threads
+    // have something to do.
+    for (int i = 0; i < 20; ++i) {
+        const QString subdir = tree + QLatin1String("/many/") + QString::number(i);
+        QVERIFY(dir.mkpath(subdir));
+        for (int j = 0; j < 20; ++j)
+            createFile(subdir + QLatin1String("/file") + QString::number(j) + QLatin1String(".dat"));
+    }
+
+#ifdef Q_OS_UNIX
+    QVERIFY(QFile::link(QLatin1String("one.txt"), tree + QLatin1String("/link.txt")));
+    QVERIFY(QFile::link(QLatin1String("a/b"), tree + QLatin1String("/linkdir")));
+    QVERIFY(QFile::link(QLatin1String("nowhere"), tree + QLatin1String("/broken")));
+#endif
+}
+
+QStringList tst_QParallelDirWalker::dirIteratorPaths(const QString &path, QDir::Filters filters,
+                                                     const QStringList &nameFilters,
+                                                     QDirIterator::IteratorFlags flags)
+{
+    if (filters == QDir::NoFilter)
+        filters = QDir::AllEntries;
+    QStringList result;
+    QDirIterator it(path, nameFilters, filters | QDir::NoDotAndDotDot,
+                    flags | QDirIterator::Subdirectories);
+    while (it.hasNext())
+        result.append(it.next());
+    result.sort();
+    return result;
+}
+
+QStringList tst_QParallelDirWalker::paths(const QFileInfoList &list)
+{
+    QStringList result;
+    for (const QFileInfo &fileInfo : list)
+        result.append(fileInfo.filePath());
+    result.sort();
+    return result;
+}
+
+void tst_QParallelDirWalker::matchesDirIterator_data()
+{
+    QTest::addColumn<int>("filters");
+    QTest::addColumn<QStringList>("nameFilters");
+
+    QTest::newRow("NoFilter") << int(QDir::NoFilter) << QStringList();
+    QTest::newRow("Files") << int(QDir::Files) << QStringList();
+    QTest::newRow("Dirs") << int(QDir::Dirs) << QStringList();
+    QTest::newRow("AllEntries|Hidden") << int(QDir::AllEntries | QDir::Hidden) << QStringList();
+    QTest::newRow("AllEntries|Hidden|System")
+            << int(QDir::AllEntries | QDir::Hidden | QDir::System) << QStringList();
+    QTest::newRow("Files|NoSymLinks") << int(QDir::Files | QDir::NoSymLinks) << QStringList();
+    QTest::newRow("*.txt") << int(QDir::Files) << QStringList{ "*.txt" };
+    QTest::newRow("*.TXT") << int(QDir::Files) << QStringList{ "*.TXT" };
+    QTest::newRow("*.TXT|CaseSensitive")
+            << int(QDir::Files | QDir::CaseSensitive) << QStringList{ "*.TXT" };
+    QTest::newRow("*.txt,*.h|AllDirs")
+            << int(QDir::Files | QDir::AllDirs) << QStringList{ "*.txt", "*.h" };
+    QTest::newRow("*.txt|Hidden") << int(QDir::Files | QDir::Hidden) << QStringList{ "*.txt" };
+}
+
+void tst_QParallelDirWalker::matchesDirIterator()
+{
+    QFETCH(int, filters);
+    QFETCH(QStringList, nameFilters);
+
+    QParallelDirWalker walker(tree, QDir::Filters(filters));
+    walker.setNameFilters(nameFilters);
+    const QStringList expected =
+            dirIteratorPaths(tree, QDir::Filters(filters), nameFilters, {});
+    QCOMPARE(paths(walker.entryInfoList()), expected);
+
+    QParallelDirWalker metaDataWalker(tree, QDir::Filters(filters),
+                                      QParallelDirWalker::FetchMetaData);
+    metaDataWalker.setNameFilters(nameFilters);
+    QCOMPARE(paths(metaDataWalker.entryInfoList()), expected);
+}
+
+void tst_QParallelDirWalker::followSymlinks()
+{
+#ifndef Q_OS_UNIX
+    QSKIP("Needs symlinks");
+#else
+    QTemporaryDir loopDir;
+    QVERIFY(loopDir.isValid());
+    const QString root = loopDir.path();
+    QVERIFY(QDir(root).mkpath(QLatin1String("x/y")));
+    createFile(root + QLatin1String("/x/y/file"));
+    // Loops back up to the root.
+    QVERIFY(QFile::link(QLatin1String("../.."), root + QLatin1String("/x/y/up")));
+
+    QParallelDirWalker walker(root, QDir::Files, QParallelDirWalker::FollowSymlinks);
+    const QFileInfoList entries = walker.entryInfoList();
+    QCOMPARE(entries.size(), 1);
+    QCOMPARE(entries.first().fileName(), QLatin1String("file"));
+
+    // Without loops, a directory is listed once for every path leading to
+    // it. QDirIterator instead skips whichever of a/b and linkdir it sees
+    // second.
+    QStringList expected = dirIteratorPaths(tree, QDir::AllEntries, {}, {});
+    for (const char *name : { "/linkdir/four.h", "/linkdir/c", "/linkdir/c/five.txt" })
+        expected.append(tree + QLatin1String(name));
+    expected.sort();
+    QParallelDirWalker treeWalker(tree, QDir::AllEntries, QParallelDirWalker::FollowSymlinks);
+    QCOMPARE(paths(treeWalker.entryInfoList()), expected);
+#endif
+}
+
+void tst_QParallelDirWalker::batches()
+{
+    QTemporaryDir bigDir;
+    QVERIFY(bigDir.isValid());
+    const int count = 2500;
+    for (int i = 0; i < count; ++i)
+        createFile(bigDir.filePath(QString::number(i)));
+
+    QMutex mutex;
+    QList<qsizetype> batchSizes;
+    QSet<QString> names;
+    QParallelDirWalker walker(bigDir.path());
+    walker.walk([&](const QFileInfoList &entries) {
+        QMutexLocker locker(&mutex);
+        batchSizes.append(entries.size());
+        for (const QFileInfo &fileInfo : entries)
+            names.insert(fileInfo.fileName());
+    });
+
+    QCOMPARE(names.size(), count);
+    QVERIFY(batchSizes.size() >= 3);
+    for (qsizetype size : qAsConst(batchSizes))
+        QVERIFY(size > 0 && size <= 1024);
+}
+
+void tst_QParallelDirWalker::fetchMetaData()
+{
+    QParallelDirWalker walker(tree, QDir::Files | QDir::Hidden,
+                              QParallelDirWalker::FetchMetaData);
+    const QFileInfoList entries = walker.entryInfoList();
+    QVERIFY(!entries.isEmpty());
+    for (const QFileInfo &fileInfo : entries) {
+        const QFileInfo fresh(fileInfo.filePath());
+        QCOMPARE(fileInfo.isFile(), fresh.isFile());
+        QCOMPARE(fileInfo.isSymLink(), fresh.isSymLink());
+        QCOMPARE(fileInfo.size(), fresh.size());
+        QCOMPARE(fileInfo.lastModified(), fresh.lastModified());
+        QCOMPARE(fileInfo.permissions(), fresh.permissions());
+    }
+}
+
+void tst_QParallelDirWalker::cancel()
+{
+    std::atomic<int> calls(0);
+    QParallelDirWalker walker(tree + QLatin1String("/many"));
+    walker.walk([&](const QFileInfoList &) {
+        ++calls;
+        walker.cancel();
+    });
+    // Only the batches already on their way get through.
+    QVERIFY(calls.load() >= 1);
+    QVERIFY(calls.load() <= QThreadPool::globalInstance()->maxThreadCount() + 1);
+
+    // The walker can be used again afterwards.
+    QCOMPARE(walker.entryInfoList().size(), 20 * 20 + 20);
+}
+
+void tst_QParallelDirWalker::customThreadPool()
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount(2);
+    QParallelDirWalker walker(tree);
+    walker.setThreadPool(&pool);
+    QCOMPARE(walker.threadPool(), &pool);
+    QCOMPARE(paths(walker.entryInfoList()), dirIteratorPaths(tree, QDir::NoFilter, {}, {}));
+    QVERIFY(pool.waitForDone(5000));
+}
+
+void tst_QParallelDirWalker::nonExistentPath()
+{
+    int calls = 0;
+    QParallelDirWalker walker(tempDir.filePath(QLatin1String("does-not-exist")));
+    walker.walk([&](const QFileInfoList &) { ++calls; });
+    QCOMPARE(calls, 0);
+    QVERIFY(walker.entryInfoList().isEmpty());
+}
+
+QTEST_MAIN(tst_QParallelDirWalker)
+#include "tst_qparalleldirwalker.moc"
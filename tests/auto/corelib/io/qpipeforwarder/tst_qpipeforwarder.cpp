@@ -0,0 +1,392 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QtTest/QtTest>
+
+#include <QtCore/private/qcore_unix_p.h>
+#include <QtCore/private/qpipeforwarder_p.h>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+
+#include <thread>
+
+class tst_QPipeForwarder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void pipeToPipe();
+    void fanOut_data();
+    void fanOut();
+    void fileToSocket();
+    void appendingFileSink();
+    void closedSink();
+    void cancel();
+    void cancelStalledSink();
+    void processToProcess();
+    void unbufferedProcessRead();
+
+private:
+    static QByteArray pattern(qsizetype size);
+
+    QTemporaryDir tempDir;
+    QString cat;
+};
+
+// Reads fd until end of file on a thread of its own, so that forwarding
+// into several pipes cannot stall on one of them.
+class Drain
+{
+public:
+    explicit Drain(int fd)
+        : thread([this, fd] {
+              char buffer[65536];
+              qint64 n;
+              while ((n = qt_safe_read(fd, buffer, sizeof buffer)) > 0)
+                  data.append(buffer, n);
+              qt_safe_close(fd);
+          })
+    {
+    }
+    QByteArray result()
+    {
+        thread.join();
+        return data;
+    }
+
+private:
+    QByteArray data;
+    std::thread thread;
+};
+
+QByteArray tst_QPipeForwarder::pattern(qsizetype size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    for (qsizetype i = 0; i < size; ++i)
+        data[i] = char(i * 7 + i / 4093);
+    return data;
+}
+
+void tst_QPipeForwarder::initTestCase()
+{
+    QVERIFY2(tempDir.isValid(), qPrintable(tempDir.errorString()));
+    cat = QStandardPaths::findExecutable("cat");
+}
+
+void tst_QPipeForwarder::pipeToPipe()
+{
+    const QByteArray data = pattern(3 * 1024 * 1024 + 17);
+    int in[2], out[2];
+    QCOMPARE(qt_safe_pipe(in), 0);
+    QCOMPARE(qt_safe_pipe(out), 0);
+
+    QPipeForwarder forwarder;
+    QSignalSpy finishedSpy(&forwarder, &QPipeForwarder::finished);
+    QVERIFY(forwarder.setSource(in[0], QFileDevice::AutoCloseHandle));
+    QVERIFY(forwarder.addSink(out[1], QFileDevice::AutoCloseHandle));
+    QVERIFY(forwarder.start());
+    QVERIFY(!forwarder.start());
+
+    Drain drain(out[0]);
+    QCOMPARE(qt_safe_write(in[1], data.constData(), data.size()), data.size());
+    qt_safe_close(in[1]);
+
+    QVERIFY(forwarder.waitForFinished());
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(drain.result(), data);
+    QCOMPARE(forwarder.bytesForwarded(), data.size());
+    QVERIFY2(forwarder.errorString().isEmpty(), qPrintable(forwarder.errorString()));
+#ifdef Q_OS_LINUX
+    QVERIFY(forwarder.isZeroCopy());
+#endif
+    QVERIFY(!forwarder.isRunning());
+}
+
+void tst_QPipeForwarder::fanOut_data()
+{
+    QTest::addColumn<int>("sinkCount");
+    QTest::addColumn<bool>("pipeSource");
+
+    for (int sinkCount : { 2, 3, 5 }) {
+        QTest::addRow("pipe-%d", sinkCount) << sinkCount << true;
+        QTest::addRow("file-%d", sinkCount) << sinkCount << false;
+    }
+}
+
+void tst_QPipeForwarder::fanOut()
+{
+    QFETCH(int, sinkCount);
+    QFETCH(bool, pipeSource);
+
+    const QByteArray data = pattern(5 * 1024 * 1024 + 3);
+    int in[2] = { -1, -1 };
+    QFile file(tempDir.filePath("fanOut"));
+    if (pipeSource) {
+        QCOMPARE(qt_safe_pipe(in), 0);
+    } else {
+        QVERIFY(file.open(QIODevice::ReadWrite | QIODevice::Truncate));
+        QCOMPARE(file.write(data), data.size());
+        QVERIFY(file.flush());
+        QVERIFY(file.seek(0));
+    }
+
+    QPipeForwarder forwarder;
+    if (pipeSource)
+        QVERIFY(forwarder.setSource(in[0], QFileDevice::AutoCloseHandle));
+    else
+        QVERIFY(forwarder.setSource(file.handle()));
+
+    std::vector<std::unique_ptr<Drain>> drains;
+    for (int i = 0; i < sinkCount; ++i) {
+        int out[2];
+        QCOMPARE(qt_safe_pipe(out), 0);
+        QVERIFY(forwarder.addSink(out[1], QFileDevice::AutoCloseHandle));
+        drains.emplace_back(new Drain(out[0]));
+    }
+    QVERIFY(forwarder.start());
+
+    if (pipeSource) {
+        // write in odd-sized pieces so that the pipe holds partial pages
+        for (qsizetype pos = 0; pos < data.size(); pos += 1000) {
+            const qsizetype len = qMin<qsizetype>(1000, data.size() - pos);
+            QCOMPARE(qt_safe_write(in[1], data.constData() + pos, len), len);
+        }
+        qt_safe_close(in[1]);
+    }
+
+    QVERIFY(forwarder.waitForFinished());
+    for (auto &drain : drains)
+        QCOMPARE(drain->result(), data);
+    QCOMPARE(forwarder.bytesForwarded(), data.size());
+    QVERIFY2(forwarder.errorString().isEmpty(), qPrintable(forwarder.errorString()));
+#ifdef Q_OS_LINUX
+    QVERIFY(forwarder.isZeroCopy());
+#endif
+}
+
+void tst_QPipeForwarder::fileToSocket()
+{
+    const QByteArray data = pattern(2 * 1024 * 1024 + 5);
+    QFile file(tempDir.filePath("fileToSocket"));
+    QVERIFY(file.open(QIODevice::ReadWrite | QIODevice::Truncate));
+    QCOMPARE(file.write(data), data.size());
+    QVERIFY(file.flush());
+    QVERIFY(file.seek(0));
+
+    int sockets[2];
+    QCOMPARE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets), 0);
+
+    QPipeForwarder forwarder;
+    QVERIFY(forwarder.setSource(file.handle()));
+    QVERIFY(forwarder.addSink(sockets[0], QFileDevice::AutoCloseHandle));
+    Drain drain(sockets[1]);
+    QVERIFY(forwarder.start());
+
+    QVERIFY(forwarder.waitForFinished());
+    QCOMPARE(drain.result(), data);
+    QVERIFY2(forwarder.errorString().isEmpty(), qPrintable(forwarder.errorString()));
+}
+
+void tst_QPipeForwarder::appendingFileSink()
+{
+    // the kernel does not splice into files opened for appending
+    const QByteArray data = pattern(1024 * 1024 + 9);
+    QFile file(tempDir.filePath("appendingFileSink"));
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(file.write("header"), 6);
+    file.close();
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+
+    int in[2];
+    QCOMPARE(qt_safe_pipe(in), 0);
+    QPipeForwarder forwarder;
+    QVERIFY(forwarder.setSource(in[0], QFileDevice::AutoCloseHandle));
+    QVERIFY(forwarder.addSink(file.handle()));
+    QVERIFY(forwarder.start());
+    QCOMPARE(qt_safe_write(in[1], data.constData(), data.size()), data.size());
+    qt_safe_close(in[1]);
+
+    QVERIFY(forwarder.waitForFinished());
+    QVERIFY2(forwarder.errorString().isEmpty(), qPrintable(forwarder.errorString()));
+    QVERIFY(!forwarder.isZeroCopy());
+    file.close();
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), "header" + data);
+}
+
+void tst_QPipeForwarder::closedSink()
+{
+    int in[2], out[2];
+    QCOMPARE(qt_safe_pipe(in), 0);
+    QCOMPARE(qt_safe_pipe(out), 0);
+    qt_safe_close(out[0]);
+
+    QPipeForwarder forwarder;
+    QVERIFY(forwarder.setSource(in[0], QFileDevice::AutoCloseHandle));
+    QVERIFY(forwarder.addSink(out[1], QFileDevice::AutoCloseHandle));
+    QVERIFY(forwarder.start());
+    QCOMPARE(qt_safe_write(in[1], "data", 4), 4);
+
+    QVERIFY(forwarder.waitForFinished());
+    QVERIFY(!forwarder.errorString().isEmpty());
+    qt_safe_close(in[1]);
+}
+
+void tst_QPipeForwarder::cancel()
+{
+    int in[2], out[2];
+    QCOMPARE(qt_safe_pipe(in), 0);
+    QCOMPARE(qt_safe_pipe(out), 0);
+
+    QPipeForwarder forwarder;
+    QSignalSpy finishedSpy(&forwarder, &QPipeForwarder::finished);
+    QVERIFY(forwarder.setSource(in[0], QFileDevice::AutoCloseHandle));
+    QVERIFY(forwarder.addSink(out[1], QFileDevice::AutoCloseHandle));
+    QVERIFY(forwarder.start());
+    QVERIFY(!forwarder.waitForFinished(50));
+    QVERIFY(forwarder.isRunning());
+
+    forwarder.cancel();
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QVERIFY(!forwarder.isRunning());
+    QVERIFY(!forwarder.errorString().isEmpty());
+
+    // the sink was closed, so its reader sees the end of the data
+    char c;
+    QCOMPARE(qt_safe_read(out[0], &c, 1), 0);
+    qt_safe_close(out[0]);
+    qt_safe_close(in[1]);
+}
+
+void tst_QPipeForwarder::cancelStalledSink()
+{
+    if (cat.isEmpty())
+        QSKIP("This test requires cat");
+
+    // More data than the sink pipe holds is already buffered in the
+    // QProcess, so the forwarder has to write it to the sink in one go.
+    const QByteArray data = pattern(512 * 1024);
+    QProcess producer;
+    producer.start(cat, {});
+    QVERIFY(producer.waitForStarted());
+    QCOMPARE(producer.write(data), data.size());
+    while (producer.bytesAvailable() < data.size())
+        QVERIFY(producer.waitForReadyRead());
+
+    int out[2];
+    QCOMPARE(qt_safe_pipe(out), 0);     // blocking, and nobody reads it
+    QPipeForwarder forwarder;
+    QVERIFY(forwarder.setSource(&producer));
+    QVERIFY(forwarder.addSink(out[1]));
+    QVERIFY(forwarder.start());
+    QVERIFY(!forwarder.waitForFinished(100));
+
+    forwarder.cancel();
+    QVERIFY(forwarder.waitForFinished(5000));
+    // the sink is left the way it was passed in
+    QCOMPARE(::fcntl(out[1], F_GETFL) & O_NONBLOCK, 0);
+
+    qt_safe_close(out[0]);
+    qt_safe_close(out[1]);
+    producer.kill();
+    QVERIFY(producer.waitForFinished());
+}
+
+void tst_QPipeForwarder::processToProcess()
+{
+    if (cat.isEmpty())
+        QSKIP("This test requires cat");
+
+    const QByteArray data = pattern(4 * 1024 * 1024 + 1);
+    QFile input(tempDir.filePath("processInput"));
+    QVERIFY(input.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(input.write(data), data.size());
+    input.close();
+
+    QProcess producer;
+    producer.setStandardInputFile(input.fileName());
+    producer.start(cat, {});
+    QVERIFY(producer.waitForStarted());
+
+    QProcess consumer;
+    consumer.setStandardOutputFile(tempDir.filePath("processOutput"));
+    consumer.start(cat, {});
+    QVERIFY(consumer.waitForStarted());
+    // written before the forwarder takes over stdin, so it comes first
+    QCOMPARE(consumer.write("header"), 6);
+
+    QPipeForwarder forwarder;
+    QVERIFY(forwarder.setSource(&producer));
+    QVERIFY(forwarder.addSink(&consumer));
+    QVERIFY(forwarder.start());
+
+    QVERIFY(forwarder.waitForFinished());
+    QVERIFY2(forwarder.errorString().isEmpty(), qPrintable(forwarder.errorString()));
+    QVERIFY(producer.waitForFinished());
+    QVERIFY(consumer.waitForFinished());
+    QCOMPARE(consumer.exitCode(), 0);
+
+    QFile output(tempDir.filePath("processOutput"));
+    QVERIFY(output.open(QIODevice::ReadOnly));
+    QCOMPARE(output.readAll(), "header" + data);
+}
+
+void tst_QPipeForwarder::unbufferedProcessRead()
+{
+    if (cat.isEmpty())
+        QSKIP("This test requires cat");
+
+    const QByteArray data = pattern(3 * 1024 * 1024 + 11);
+    QFile input(tempDir.filePath("unbufferedInput"));
+    QVERIFY(input.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(input.write(data), data.size());
+    input.close();
+
+    QProcess process;
+    process.setStandardInputFile(input.fileName());
+    process.start(cat, {}, QIODevice::ReadOnly | QIODevice::Unbuffered);
+    QVERIFY(process.waitForStarted());
+
+    QByteArray result;
+    QByteArray buffer(256 * 1024, Qt::Uninitialized);
+    forever {
+        const qint64 n = process.read(buffer.data(), buffer.size());
+        if (n > 0)
+            result.append(buffer.constData(), n);
+        else if (n < 0 || !process.waitForReadyRead())
+            break;
+    }
+    QVERIFY(process.state() == QProcess::NotRunning || process.waitForFinished());
+    result += process.readAll();
+    QCOMPARE(result.size(), data.size());
+    QCOMPARE(result, data);
+}
+
+QTEST_MAIN(tst_QPipeForwarder)
+#include "tst_qpipeforwarder.moc"
@@ -42,6 +42,7 @@
 #include <QtCore/QRegularExpression>
 #include <QtCore/QDebug>
 #include <QtCore/QMetaType>
+#include <QtCore/QScopeGuard>
 #include <QtNetwork/QHostInfo>
 
 #include <qplatformdefs.h>
@@ -67,6 +68,8 @@ private slots:
     void constructing();
     void simpleStart();
     void setChildProcessModifier();
+    void startSharingMemory();
+    void programPathLookup();
     void startCommand();
     void startWithOpen();
     void startWithOldOpen();
@@ -309,6 +312,96 @@ void tst_QProcess::setChildProcessModifier()
 #endif
 }
 
+void tst_QProcess::startSharingMemory()
+{
+#ifdef Q_OS_UNIX
+    // Without a child process modifier, the child shares our memory until
+    // it execs. Large argument lists and environments must get across.
+    QStringList arguments = { "-c", "echo $# ${#BIG}", "sh" };
+    for (int i = 0; i < 2000; ++i)
+        arguments << QString(100, QLatin1Char('a' + i % 26));
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert("BIG", QString(100000, QLatin1Char('x')));
+
+    QProcess process;
+    process.setProcessEnvironment(environment);
+    process.start("/bin/sh", arguments);
+    QVERIFY2(process.waitForFinished(5000), qPrintable(process.errorString()));
+    QCOMPARE(process.exitStatus(), QProcess::NormalExit);
+    QCOMPARE(process.exitCode(), 0);
+    QCOMPARE(process.readAll(), QByteArray("2000 100000\n"));
+
+    // Only the starting thread waits for the child to exec; the others
+    // carry on, and may start children of their own.
+    QAtomicInt failures;
+    const auto startSome = [&failures] {
+        for (int i = 0; i < 10; ++i) {
+            QProcess process;
+            process.start("/bin/sh", { "-c", "exit 7" });
+            if (!process.waitForFinished(5000) || process.exitCode() != 7)
+                failures.ref();
+        }
+    };
+    QList<QThread *> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads << QThread::create(startSome);
+        threads.last()->start();
+    }
+    for (QThread *thread : qAsConst(threads)) {
+        QVERIFY(thread->wait(60000));
+        delete thread;
+    }
+    QCOMPARE(failures.loadRelaxed(), 0);
+#else
+    QSKIP("Unix-only test");
+#endif
+}
+
+void tst_QProcess::programPathLookup()
+{
+#ifdef Q_OS_UNIX
+    // Where a program is found in PATH is remembered, but only for as long
+    // as PATH and the current directory stay the same.
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+    for (int i = 1; i <= 2; ++i) {
+        const QString directory = dir.filePath(QString::number(i));
+        QVERIFY(QDir().mkpath(directory));
+        QFile script(directory + QLatin1String("/tst_qprocess_lookup"));
+        QVERIFY(script.open(QIODevice::WriteOnly));
+        script.write("#!/bin/sh\nexit " + QByteArray::number(i) + '\n');
+        script.close();
+        QVERIFY(script.setPermissions(script.permissions() | QFile::ExeOwner));
+    }
+
+    const QByteArray oldPath = qgetenv("PATH");
+    const QString oldCurrentDir = QDir::currentPath();
+    const auto restore = qScopeGuard([&] {
+        qputenv("PATH", oldPath);
+        QDir::setCurrent(oldCurrentDir);
+    });
+    const auto exitCode = [] {
+        QProcess process;
+        process.start("tst_qprocess_lookup", {});
+        return process.waitForFinished(5000) ? process.exitCode() : -1;
+    };
+
+    qputenv("PATH", QFile::encodeName(dir.filePath("1")));
+    QCOMPARE(exitCode(), 1);
+    QCOMPARE(exitCode(), 1);
+    qputenv("PATH", QFile::encodeName(dir.filePath("2")));
+    QCOMPARE(exitCode(), 2);
+
+    qputenv("PATH", ".");
+    QVERIFY(QDir::setCurrent(dir.filePath("1")));
+    QCOMPARE(exitCode(), 1);
+    QVERIFY(QDir::setCurrent(dir.filePath("2")));
+    QCOMPARE(exitCode(), 2);
+#else
+    QSKIP("Unix-only test");
+#endif
+}
+
 void tst_QProcess::startCommand()
 {
     QProcess process;
@@ -0,0 +1,290 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QDir>
+#include <QFile>
+#include <QSet>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtCore/private/qrecursivefilesystemwatcher_p.h>
+
+using Backend = QRecursiveFileSystemWatcher::Backend;
+
+class tst_QRecursiveFileSystemWatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void addPath_data() { backends(); }
+    void addPath();
+    void changes_data() { backends(); }
+    void changes();
+    void newDirectories_data() { backends(); }
+    void newDirectories();
+    void renamedDirectory_data() { backends(); }
+    void renamedDirectory();
+    void coalescing_data() { backends(); }
+    void coalescing();
+    void removePath_data() { backends(); }
+    void removePath();
+    void rootRemoved_data() { backends(); }
+    void rootRemoved();
+
+private:
+    void backends();
+    bool createWatcher();
+    bool waitFor(const QString &path);
+    static void touch(const QString &path, const QByteArray &contents = QByteArray());
+    static int fileSystemMarks();
+
+    QScopedPointer<QTemporaryDir> tempDir;
+    QScopedPointer<QRecursiveFileSystemWatcher> watcher;
+    QSet<QString> reported;
+    int signalCount = 0;
+};
+
+void tst_QRecursiveFileSystemWatcher::backends()
+{
+    QTest::addColumn<Backend>("backend");
+    QTest::newRow("inotify") << QRecursiveFileSystemWatcher::InotifyBackend;
+    QTest::newRow("fanotify") << QRecursiveFileSystemWatcher::FanotifyBackend;
+}
+
+void tst_QRecursiveFileSystemWatcher::touch(const QString &path, const QByteArray &contents)
+{
+    QFile file(path);
+    QVERIFY2(file.open(QIODevice::WriteOnly | QIODevice::Append), qPrintable(file.errorString()));
+    file.write(contents);
+}
+
+// Counts the fanotify marks on whole file systems that this process holds.
+int tst_QRecursiveFileSystemWatcher::fileSystemMarks()
+{
+    int marks = 0;
+    const QDir fdInfo(QLatin1String("/proc/self/fdinfo"));
+    for (const QString &fd : fdInfo.entryList(QDir::Files)) {
+        QFile file(fdInfo.filePath(fd));
+        if (!file.open(QIODevice::ReadOnly))
+            continue;
+        for (const QByteArray &line : file.readAll().split('\n')) {
+            if (line.startsWith("fanotify sdev:"))
+                ++marks;
+        }
+    }
+    return marks;
+}
+
+void tst_QRecursiveFileSystemWatcher::init()
+{
+    tempDir.reset(new QTemporaryDir);
+    QVERIFY2(tempDir->isValid(), qPrintable(tempDir->errorString()));
+    QDir dir(tempDir->path());
+    QVERIFY(dir.mkpath(QLatin1String("a/b/c")));
+    QVERIFY(dir.mkpath(QLatin1String("a/d")));
+    QVERIFY(dir.mkpath(QLatin1String(".hidden/e")));
+    touch(tempDir->filePath(QLatin1String("a/b/file.txt")));
+
+    reported.clear();
+    signalCount = 0;
+}
+
+// Creates the watcher for the current backend, or returns false if
+// the test should be skipped.
+bool tst_QRecursiveFileSystemWatcher::createWatcher()
+{
+    QFETCH(Backend, backend);
+    watcher.reset(new QRecursiveFileSystemWatcher(backend));
+    if (!watcher->isValid())
+        return false;
+    watcher->setDebounceInterval(10);
+    connect(watcher.data(), &QRecursiveFileSystemWatcher::pathsChanged,
+            this, [this](const QStringList &paths) {
+        ++signalCount;
+        for (const QString &path : paths)
+            reported.insert(path);
+    });
+    if (!watcher->addPath(tempDir->path()))
+        return false;
+    return watcher->backend() == backend;
+}
+
+bool tst_QRecursiveFileSystemWatcher::waitFor(const QString &path)
+{
+    return QTest::qWaitFor([&] { return reported.contains(path); }, 5000);
+}
+
+void tst_QRecursiveFileSystemWatcher::addPath()
+{
+    if (!createWatcher())
+        QSKIP("Backend not available");
+
+    QCOMPARE(watcher->paths(), QStringList(tempDir->path()));
+    QCOMPARE(watcher->watchedDirectoryCount(), 7);
+
+    // Adding it again is a no-op
+    QVERIFY(watcher->addPath(tempDir->path() + QLatin1String("/")));
+    QCOMPARE(watcher->paths().size(), 1);
+
+    QVERIFY(!watcher->addPath(tempDir->filePath(QLatin1String("a/b/file.txt"))));
+    QVERIFY(!watcher->addPath(tempDir->filePath(QLatin1String("does-not-exist"))));
+    QCOMPARE(watcher->paths().size(), 1);
+}
+
+void tst_QRecursiveFileSystemWatcher::changes()
+{
+    if (!createWatcher())
+        QSKIP("Backend not available");
+
+    const QString created = tempDir->filePath(QLatin1String("a/b/c/new.txt"));
+    touch(created);
+    QVERIFY(waitFor(created));
+
+    const QString modified = tempDir->filePath(QLatin1String("a/b/file.txt"));
+    touch(modified, "more");
+    QVERIFY(waitFor(modified));
+
+    const QString hidden = tempDir->filePath(QLatin1String(".hidden/e/x"));
+    touch(hidden);
+    QVERIFY(waitFor(hidden));
+
+    reported.clear();
+    QVERIFY(QFile::remove(created));
+    QVERIFY(waitFor(created));
+
+    const QString renamed = tempDir->filePath(QLatin1String("a/d/renamed.txt"));
+    QVERIFY(QFile::rename(modified, renamed));
+    QVERIFY(waitFor(renamed));
+    QVERIFY(waitFor(modified));
+}
+
+void tst_QRecursiveFileSystemWatcher::newDirectories()
+{
+    if (!createWatcher())
+        QSKIP("Backend not available");
+
+    const QString newDir = tempDir->filePath(QLatin1String("a/new"));
+    QVERIFY(QDir().mkdir(newDir));
+    QVERIFY(waitFor(newDir));
+    QCOMPARE(watcher->watchedDirectoryCount(), 8);
+
+    const QString nested = newDir + QLatin1String("/nested");
+    QVERIFY(QDir().mkdir(nested));
+    QVERIFY(waitFor(nested));
+
+    const QString file = nested + QLatin1String("/file");
+    touch(file);
+    QVERIFY(waitFor(file));
+
+    reported.clear();
+    QVERIFY(QDir(newDir).removeRecursively());
+    QVERIFY(waitFor(newDir));
+    QTRY_COMPARE(watcher->watchedDirectoryCount(), 7);
+}
+
+void tst_QRecursiveFileSystemWatcher::renamedDirectory()
+{
+    if (!createWatcher())
+        QSKIP("Backend not available");
+
+    const QString from = tempDir->filePath(QLatin1String("a/b"));
+    const QString to = tempDir->filePath(QLatin1String("a/moved"));
+    QVERIFY(QDir().rename(from, to));
+    QVERIFY(waitFor(from));
+    QVERIFY(waitFor(to));
+
+    // The directories below moved along
+    const QString file = to + QLatin1String("/c/file");
+    touch(file);
+    QVERIFY(waitFor(file));
+    QCOMPARE(watcher->watchedDirectoryCount(), 7);
+}
+
+void tst_QRecursiveFileSystemWatcher::coalescing()
+{
+    if (!createWatcher())
+        QSKIP("Backend not available");
+    watcher->setDebounceInterval(200);
+    QCOMPARE(watcher->debounceInterval(), 200);
+
+    const QString path = tempDir->filePath(QLatin1String("a/b/file.txt"));
+    for (int i = 0; i < 100; ++i)
+        touch(path, "x");
+    QVERIFY(waitFor(path));
+    QCOMPARE(signalCount, 1);
+    QCOMPARE(reported.size(), 1);
+}
+
+void tst_QRecursiveFileSystemWatcher::removePath()
+{
+    if (!createWatcher())
+        QSKIP("Backend not available");
+
+    const QString subtree = tempDir->filePath(QLatin1String("a"));
+    QVERIFY(watcher->addPath(subtree));
+    QCOMPARE(watcher->paths().size(), 2);
+
+    // The tree overlapping with the other one stays watched
+    QVERIFY(watcher->removePath(tempDir->path()));
+    QVERIFY(!watcher->removePath(tempDir->path()));
+    QCOMPARE(watcher->paths(), QStringList(subtree));
+    QCOMPARE(watcher->watchedDirectoryCount(), 4);
+
+    touch(tempDir->filePath(QLatin1String(".hidden/ignored")));
+    const QString file = tempDir->filePath(QLatin1String("a/d/file"));
+    touch(file);
+    QVERIFY(waitFor(file));
+    QCOMPARE(reported.size(), 1);
+
+    QFETCH(Backend, backend);
+    if (backend == QRecursiveFileSystemWatcher::FanotifyBackend)
+        QCOMPARE(fileSystemMarks(), 1);
+    QVERIFY(watcher->removePath(subtree));
+    QCOMPARE(watcher->watchedDirectoryCount(), 0);
+    QCOMPARE(fileSystemMarks(), 0);
+    reported.clear();
+    touch(file, "x");
+    QTest::qWait(100);
+    QVERIFY(reported.isEmpty());
+}
+
+void tst_QRecursiveFileSystemWatcher::rootRemoved()
+{
+    if (!createWatcher())
+        QSKIP("Backend not available");
+
+    const QString root = tempDir->path();
+    QVERIFY(tempDir->remove());
+    QVERIFY(waitFor(root));
+    QTRY_VERIFY(watcher->paths().isEmpty());
+    QCOMPARE(watcher->watchedDirectoryCount(), 0);
+}
+
+QTEST_MAIN(tst_QRecursiveFileSystemWatcher)
+#include "tst_qrecursivefilesystemwatcher.moc"
@@ -139,6 +139,7 @@ private slots:
     void testChildKeysAndGroups();
     void testUpdateRequestEvent();
     void testThreadSafety();
+    void snapshotReading();
     void testEmptyData();
     void testEmptyKey();
     void testResourceFiles();
@@ -2096,6 +2097,45 @@ void tst_QSettings::testThreadSafety()
     QCOMPARE(numThreadSafetyFailures, 0);
 }
 
+void tst_QSettings::snapshotReading()
+{
+    const QString fileName = settingsPath("snapshot.ini");
+    QVERIFY(QDir().mkpath(settingsPath()));
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("[group]\na=1\nb=2\n");
+    }
+
+    QSettings reader(fileName, QSettings::IniFormat);
+    QVERIFY(!reader.isSnapshotReadingEnabled());
+    reader.setSnapshotReadingEnabled(true);
+    QVERIFY(reader.isSnapshotReadingEnabled());
+    QCOMPARE(reader.value("group/a").toInt(), 1);
+    QCOMPARE(reader.value("group/b").toInt(), 2);
+    QCOMPARE(reader.childGroups(), QStringList{"group"});
+
+    // changes made through another object are seen by the next read
+    QSettings writer(fileName, QSettings::IniFormat);
+    writer.setValue("group/c", 3);
+    writer.remove("group/a");
+    QCOMPARE(reader.value("group/c").toInt(), 3);
+    QVERIFY(!reader.contains("group/a"));
+    reader.beginGroup("group");
+    QCOMPARE(reader.childKeys(), QStringList({"b", "c"}));
+    reader.endGroup();
+
+    // and so are changes made through the same object
+    reader.setValue("group/d", 4);
+    QCOMPARE(reader.value("group/d").toInt(), 4);
+    QCOMPARE(writer.value("group/d").toInt(), 4);
+
+    writer.sync();
+    reader.sync();
+    QCOMPARE(reader.status(), QSettings::NoError);
+    QCOMPARE(reader.allKeys(), QStringList({"group/b", "group/c", "group/d"}));
+}
+
 #ifdef QT_BUILD_INTERNAL
 void tst_QSettings::testNormalizedKey_data()
 {
@@ -40,6 +40,7 @@
 #include <QSignalSpy>
 #include <QMimeData>
 
+#include <algorithm>
 #include <array>
 #include <vector>
 #include <deque>
@@ -81,6 +82,8 @@ private slots:
     void reset();
 
     void complexChangesWithPersistent();
+    void persistentIndexesInMovedParent();
+    void persistentIndexesUnderReorderedParent();
 
     void testMoveSameParentUp_data();
     void testMoveSameParentUp();
@@ -107,6 +110,8 @@ private slots:
     void testReset();
 
     void testDataChanged();
+    void postDataChanged();
+    void coalesceDataChanged();
 
     void testChildrenLayoutsChanged();
 
@@ -1008,6 +1013,135 @@ void tst_QAbstractItemModel::complexChangesWithPersistent()
         QVERIFY(e[i] == model.index(2, i-2 , QModelIndex()));
 }
 
+// The parent of the persistent indexes moves without them changing, and
+// rows are then inserted and moved next to them.
+void tst_QAbstractItemModel::persistentIndexesInMovedParent()
+{
+    const QPersistentModelIndex parent = m_model->index(5, 0);
+    const QPersistentModelIndex child = m_model->index(4, 2, parent);
+    const QPersistentModelIndex sibling = m_model->index(8, 0, parent);
+    const QString childData = child.data().toString();
+    const QString siblingData = sibling.data().toString();
+
+    ModelInsertCommand *insertCommand = new ModelInsertCommand(m_model, this);
+    insertCommand->setNumCols(4);
+    insertCommand->setStartRow(0);
+    insertCommand->setEndRow(1);
+    insertCommand->doCommand();
+    QCOMPARE(parent.row(), 7);
+    QCOMPARE(child.parent(), QModelIndex(parent));
+
+    insertCommand = new ModelInsertCommand(m_model, this);
+    insertCommand->setAncestorRowNumbers(QList<int>() << 7);
+    insertCommand->setNumCols(4);
+    insertCommand->setStartRow(0);
+    insertCommand->setEndRow(2);
+    insertCommand->doCommand();
+    QCOMPARE(child.row(), 7);
+    QCOMPARE(child.column(), 2);
+    QCOMPARE(child.data().toString(), childData);
+    QCOMPARE(sibling.row(), 11);
+
+    // inserting after them doesn't move them
+    insertCommand = new ModelInsertCommand(m_model, this);
+    insertCommand->setAncestorRowNumbers(QList<int>() << 7);
+    insertCommand->setNumCols(4);
+    insertCommand->setStartRow(9);
+    insertCommand->setEndRow(9);
+    insertCommand->doCommand();
+    QCOMPARE(child.row(), 7);
+    QCOMPARE(sibling.row(), 12);
+
+    ModelMoveCommand *moveCommand = new ModelMoveCommand(m_model, this);
+    moveCommand->setAncestorRowNumbers(QList<int>() << 7);
+    moveCommand->setNumCols(4);
+    moveCommand->setStartRow(0);
+    moveCommand->setEndRow(2);
+    moveCommand->setDestAncestors(QList<int>() << 7);
+    moveCommand->setDestRow(14);
+    moveCommand->doCommand();
+    QCOMPARE(child.row(), 4);
+    QCOMPARE(child.data().toString(), childData);
+    QCOMPARE(sibling.row(), 9);
+    QCOMPARE(sibling.data().toString(), siblingData);
+
+    // move the parent itself
+    moveCommand = new ModelMoveCommand(m_model, this);
+    moveCommand->setNumCols(4);
+    moveCommand->setStartRow(7);
+    moveCommand->setEndRow(7);
+    moveCommand->setDestRow(0);
+    moveCommand->doCommand();
+    QCOMPARE(parent.row(), 0);
+    QCOMPARE(child.parent(), QModelIndex(parent));
+
+    insertCommand = new ModelInsertCommand(m_model, this);
+    insertCommand->setAncestorRowNumbers(QList<int>() << 0);
+    insertCommand->setNumCols(4);
+    insertCommand->setStartRow(0);
+    insertCommand->setEndRow(0);
+    insertCommand->doCommand();
+    QCOMPARE(child.row(), 5);
+    QCOMPARE(child.data().toString(), childData);
+    QCOMPARE(sibling.row(), 10);
+}
+
+// The parent of the persistent indexes is not persistent itself, so the
+// model doesn't report its new position in the layout change.
+void tst_QAbstractItemModel::persistentIndexesUnderReorderedParent()
+{
+    ModelInsertCommand *insertCommand = new ModelInsertCommand(m_model, this);
+    insertCommand->setAncestorRowNumbers(QList<int>() << 5 << 3);
+    insertCommand->setNumCols(4);
+    insertCommand->setStartRow(0);
+    insertCommand->setEndRow(4);
+    insertCommand->doCommand();
+
+    insertCommand = new ModelInsertCommand(m_model, this);
+    insertCommand->setAncestorRowNumbers(QList<int>() << 2);
+    insertCommand->setNumCols(4);
+    insertCommand->setStartRow(0);
+    insertCommand->setEndRow(3);
+    insertCommand->doCommand();
+
+    const QModelIndex parent = m_model->index(3, 0, m_model->index(5, 0));
+    const QPersistentModelIndex grandchild = m_model->index(2, 1, parent);
+    const QPersistentModelIndex lastGrandchild = m_model->index(4, 0, parent);
+    const QString grandchildData = grandchild.data().toString();
+
+    // the last child of row 5 becomes its first one
+    ModelChangeChildrenLayoutsCommand *changeCommand = new ModelChangeChildrenLayoutsCommand(m_model, this);
+    changeCommand->setAncestorRowNumbers(QList<int>() << 5);
+    changeCommand->setSecondAncestorRowNumbers(QList<int>() << 2);
+    changeCommand->setNumCols(4);
+    changeCommand->doCommand();
+    QCOMPARE(grandchild.parent().row(), 4);
+    QCOMPARE(grandchild.row(), 2);
+
+    insertCommand = new ModelInsertCommand(m_model, this);
+    insertCommand->setAncestorRowNumbers(QList<int>() << 5 << 4);
+    insertCommand->setNumCols(4);
+    insertCommand->setStartRow(0);
+    insertCommand->setEndRow(1);
+    insertCommand->doCommand();
+    QCOMPARE(grandchild.row(), 4);
+    QCOMPARE(grandchild.column(), 1);
+    QCOMPARE(grandchild.data().toString(), grandchildData);
+    QCOMPARE(lastGrandchild.row(), 6);
+
+    ModelMoveCommand *moveCommand = new ModelMoveCommand(m_model, this);
+    moveCommand->setAncestorRowNumbers(QList<int>() << 5 << 4);
+    moveCommand->setNumCols(4);
+    moveCommand->setStartRow(6);
+    moveCommand->setEndRow(6);
+    moveCommand->setDestAncestors(QList<int>() << 5 << 4);
+    moveCommand->setDestRow(0);
+    moveCommand->doCommand();
+    QCOMPARE(lastGrandchild.row(), 0);
+    QCOMPARE(grandchild.row(), 5);
+    QCOMPARE(grandchild.data().toString(), grandchildData);
+}
+
 void tst_QAbstractItemModel::testMoveSameParentDown_data()
 {
     QTest::addColumn<int>("startRow");
@@ -1988,6 +2122,169 @@ void tst_QAbstractItemModel::testDataChanged()
     QVERIFY(thirdRoles.contains(CustomRoleModel::Custom1));
 }
 
+class PostingModel : public QtTestModel
+{
+public:
+    using QtTestModel::QtTestModel;
+    using QAbstractItemModel::postDataChanged;
+    using QAbstractItemModel::beginDataChangedBatch;
+    using QAbstractItemModel::endDataChangedBatch;
+    using QAbstractItemModel::sendPostedDataChanged;
+
+    void post(int firstRow, int firstColumn, int lastRow, int lastColumn,
+              const QList<int> &roles = QList<int>())
+    {
+        postDataChanged(index(firstRow, firstColumn), index(lastRow, lastColumn), roles);
+    }
+
+    void reverseRows()
+    {
+        emit layoutAboutToBeChanged();
+        std::reverse(table.begin(), table.end());
+        emit layoutChanged();
+    }
+};
+
+typedef std::array<int, 4> ChangedRect; // first row, first column, last row, last column
+
+static QList<ChangedRect> changedRects(const QSignalSpy &spy)
+{
+    QList<ChangedRect> rects;
+    for (const QVariantList &args : spy) {
+        const QModelIndex topLeft = args.at(0).toModelIndex();
+        const QModelIndex bottomRight = args.at(1).toModelIndex();
+        rects.append({ topLeft.row(), topLeft.column(), bottomRight.row(), bottomRight.column() });
+    }
+    return rects;
+}
+
+void tst_QAbstractItemModel::postDataChanged()
+{
+    PostingModel model(20, 4);
+    QSignalSpy spy(&model, &QAbstractItemModel::dataChanged);
+    QVERIFY(spy.isValid());
+
+    // without coalescing nor a batch, the change is reported right away
+    model.post(1, 0, 1, 0, { Qt::DisplayRole });
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(changedRects(spy), QList<ChangedRect>({ { 1, 0, 1, 0 } }));
+    spy.clear();
+
+    model.beginDataChangedBatch();
+    model.post(3, 0, 3, 0, { Qt::DisplayRole });
+    model.post(4, 1, 4, 1, { Qt::ToolTipRole });    // adjacent
+    model.post(5, 0, 6, 0, { Qt::DisplayRole });    // adjacent
+    model.post(10, 2, 10, 2, { Qt::DisplayRole });  // separate run
+    model.beginDataChangedBatch();
+    model.post(2, 0, 2, 3, { Qt::DisplayRole });    // adjacent, nested batch
+    model.endDataChangedBatch();
+    QCOMPARE(spy.count(), 0);
+    model.endDataChangedBatch();
+
+    QCOMPARE(changedRects(spy), QList<ChangedRect>({ { 2, 0, 6, 3 }, { 10, 2, 10, 2 } }));
+    QList<int> roles = spy.at(0).at(2).value<QList<int>>();
+    std::sort(roles.begin(), roles.end());
+    QCOMPARE(roles, QList<int>({ Qt::DisplayRole, Qt::ToolTipRole }));
+    QCOMPARE(spy.at(1).at(2).value<QList<int>>(), QList<int>({ Qt::DisplayRole }));
+    spy.clear();
+
+    // a change to all roles makes the merged change one to all roles
+    model.beginDataChangedBatch();
+    model.post(0, 0, 0, 0, { Qt::DisplayRole });
+    model.post(0, 1, 2, 1);
+    model.post(12, 0, 12, 0, { Qt::DisplayRole });
+    model.sendPostedDataChanged();
+    QCOMPARE(changedRects(spy), QList<ChangedRect>({ { 0, 0, 2, 1 }, { 12, 0, 12, 0 } }));
+    QVERIFY(spy.at(0).at(2).value<QList<int>>().isEmpty());
+    spy.clear();
+
+    // pending changes are reported before rows are inserted...
+    QSignalSpy aboutToInsert(&model, &QAbstractItemModel::rowsAboutToBeInserted);
+    model.post(8, 0, 8, 0);
+    QCOMPARE(spy.count(), 0);
+    model.insertRows(0, 2);
+    QCOMPARE(aboutToInsert.count(), 1);
+    QCOMPARE(changedRects(spy), QList<ChangedRect>({ { 8, 0, 8, 0 } }));
+    spy.clear();
+
+    // ...and before the layout changes
+    int changedBeforeLayout = -1;
+    const auto connection = connect(&model, &QAbstractItemModel::layoutAboutToBeChanged,
+                                    &model, [&] { changedBeforeLayout = spy.count(); });
+    model.post(5, 1, 5, 1);
+    model.reverseRows();
+    disconnect(connection);
+    QCOMPARE(changedBeforeLayout, 1);
+    QCOMPARE(changedRects(spy), QList<ChangedRect>({ { 5, 1, 5, 1 } }));
+    spy.clear();
+
+    // ...and forgotten when the model is reset
+    model.post(8, 0, 8, 0);
+    model.reset();
+    model.endDataChangedBatch();
+    QCOMPARE(spy.count(), 0);
+
+    // receivers connected before the batch started get them first too
+    changedBeforeLayout = -1;
+    const auto earlier = connect(&model, &QAbstractItemModel::layoutAboutToBeChanged,
+                                 &model, [&] { changedBeforeLayout = spy.count(); });
+    model.beginDataChangedBatch();
+    model.post(3, 0, 3, 0);
+    model.reverseRows();
+    model.endDataChangedBatch();
+    disconnect(earlier);
+    QCOMPARE(changedBeforeLayout, 1);
+    QCOMPARE(changedRects(spy), QList<ChangedRect>({ { 3, 0, 3, 0 } }));
+}
+
+void tst_QAbstractItemModel::coalesceDataChanged()
+{
+    PostingModel model(20, 2);
+    QSignalSpy spy(&model, &QAbstractItemModel::dataChanged);
+    QVERIFY(spy.isValid());
+
+    QVERIFY(!model.isDataChangedCoalescingEnabled());
+    model.setDataChangedCoalescingEnabled(true);
+    QVERIFY(model.isDataChangedCoalescingEnabled());
+
+    for (int row = 0; row < 10; ++row)
+        model.post(row, 0, row, 0, { Qt::DisplayRole });
+    model.post(15, 1, 15, 1, { Qt::DisplayRole });
+    QCOMPARE(spy.count(), 0);
+    QTRY_COMPARE(spy.count(), 2);
+    QCOMPARE(changedRects(spy), QList<ChangedRect>({ { 0, 0, 9, 0 }, { 15, 1, 15, 1 } }));
+    spy.clear();
+
+    // pending changes are reported before rows are removed
+    model.post(3, 0, 3, 1);
+    model.removeRows(0, 1);
+    QCOMPARE(changedRects(spy), QList<ChangedRect>({ { 3, 0, 3, 1 } }));
+    spy.clear();
+    QCoreApplication::processEvents();
+    QCOMPARE(spy.count(), 0);
+
+    // and before the layout changes
+    model.post(2, 0, 2, 0);
+    model.reverseRows();
+    QCOMPARE(changedRects(spy), QList<ChangedRect>({ { 2, 0, 2, 0 } }));
+    spy.clear();
+    QCoreApplication::processEvents();
+    QCOMPARE(spy.count(), 0);
+
+    // disabling coalescing sends the pending changes
+    model.post(4, 0, 4, 0);
+    model.setDataChangedCoalescingEnabled(false);
+    QCOMPARE(changedRects(spy), QList<ChangedRect>({ { 4, 0, 4, 0 } }));
+    spy.clear();
+    model.post(5, 0, 5, 0);
+    QCOMPARE(spy.count(), 1);
+    spy.clear();
+
+    // without coalescing, the layout change has nothing to send
+    model.reverseRows();
+    QCOMPARE(spy.count(), 0);
+}
+
 Q_DECLARE_METATYPE(QList<QPersistentModelIndex>)
 
 class SignalArgumentChecker : public QObject
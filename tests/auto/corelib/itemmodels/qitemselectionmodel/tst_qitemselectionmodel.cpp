@@ -83,6 +83,7 @@ private slots:
     void layoutChangedWithAllSelected2();
     void layoutChangedTreeSelection();
     void deselectRemovedMiddleRange();
+    void fragmentedSelection();
     void setModel();
 
     void testDifferentModels();
@@ -2420,6 +2421,70 @@ void tst_QItemSelectionModel::deselectRemovedMiddleRange()
     QCOMPARE(spy.size(), 1);
 }
 
+void tst_QItemSelectionModel::fragmentedSelection()
+{
+    // enough ranges for the selection model to index them
+    QStandardItemModel model(100, 3);
+    QItemSelectionModel selModel(&model);
+    QSignalSpy spy(&selModel, &QItemSelectionModel::selectionChanged);
+    QVERIFY(spy.isValid());
+
+    for (int row = 0; row < 100; row += 2) {
+        selModel.select(model.index(row, 0), QItemSelectionModel::Select | QItemSelectionModel::Rows);
+        QCOMPARE(spy.count(), 1);
+        const QItemSelection selected = spy.takeFirst().at(0).value<QItemSelection>();
+        QCOMPARE(selected, QItemSelection(model.index(row, 0), model.index(row, 2)));
+    }
+    QCOMPARE(selModel.selection().count(), 50);
+    for (int row = 0; row < 100; ++row) {
+        for (int column = 0; column < 3; ++column)
+            QCOMPARE(selModel.isSelected(model.index(row, column)), row % 2 == 0);
+    }
+
+    // selecting selected items changes nothing
+    selModel.select(model.index(4, 1), QItemSelectionModel::Select);
+    QCOMPARE(spy.count(), 0);
+
+    selModel.select(model.index(4, 1), QItemSelectionModel::Toggle);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.takeFirst().at(1).value<QItemSelection>(),
+             QItemSelection(model.index(4, 1), model.index(4, 1)));
+    QVERIFY(!selModel.isSelected(model.index(4, 1)));
+    QVERIFY(selModel.isSelected(model.index(4, 0)));
+    QVERIFY(selModel.isSelected(model.index(4, 2)));
+
+    // extending the current selection over unselected rows, which
+    // replaces the toggle
+    selModel.select(model.index(5, 0), QItemSelectionModel::SelectCurrent);
+    selModel.select(QItemSelection(model.index(5, 0), model.index(5, 2)), QItemSelectionModel::SelectCurrent);
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(spy.at(1).at(0).value<QItemSelection>(),
+             QItemSelection(model.index(5, 1), model.index(5, 2)));
+    QVERIFY(spy.at(1).at(1).value<QItemSelection>().isEmpty());
+    spy.clear();
+    QVERIFY(selModel.isSelected(model.index(4, 1)));
+    QVERIFY(selModel.isSelected(model.index(5, 1)));
+    QVERIFY(!selModel.isSelected(model.index(7, 1)));
+
+    // the selection follows the rows
+    QVERIFY(model.removeRows(10, 11));
+    QVERIFY(model.insertRows(0, 1));
+    QVERIFY(!selModel.isSelected(model.index(0, 0)));
+    QVERIFY(selModel.isSelected(model.index(1, 0)));
+    QVERIFY(selModel.isSelected(model.index(6, 1)));
+    QVERIFY(!selModel.isSelected(model.index(8, 1)));
+    QVERIFY(!selModel.isSelected(model.index(10, 0)));
+    QVERIFY(!selModel.isSelected(model.index(11, 0)));
+    QVERIFY(selModel.isSelected(model.index(12, 0)));
+    QVERIFY(!selModel.isSelected(model.index(13, 0)));
+    spy.clear();
+
+    selModel.select(model.index(12, 0), QItemSelectionModel::Deselect | QItemSelectionModel::Rows);
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(!selModel.isSelected(model.index(12, 2)));
+    QVERIFY(selModel.isSelected(model.index(14, 2)));
+}
+
 void tst_QItemSelectionModel::setModel()
 {
     QItemSelectionModel sel;
@@ -40,6 +40,8 @@
 #include <QStack>
 #include <QSignalSpy>
 #include <QAbstractItemModelTester>
+#include <QScopeGuard>
+#include <QThreadPool>
 
 Q_LOGGING_CATEGORY(lcItemModels, "qt.corelib.tests.itemmodels")
 
@@ -5291,4 +5293,335 @@ void tst_QSortFilterProxyModel::invalidateColumnsOrRowsFilter()
     QCOMPARE(proxy.rowFiltered, 20);
 }
 
+static QStringList proxyContents(const QAbstractItemModel &model)
+{
+    QStringList contents;
+    for (int row = 0; row < model.rowCount(); ++row)
+        contents << model.index(row, 0).data().toString();
+    return contents;
+}
+
+static QList<int> proxySourceRows(const QSortFilterProxyModel &proxy)
+{
+    QList<int> rows;
+    for (int row = 0; row < proxy.rowCount(); ++row)
+        rows << proxy.mapToSource(proxy.index(row, 0)).row();
+    return rows;
+}
+
+void tst_QSortFilterProxyModel::incrementalFiltering()
+{
+    class CountingProxy : public QSortFilterProxyModel
+    {
+    public:
+        bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const override
+        {
+            ++filtered;
+            return QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent);
+        }
+
+        mutable int filtered = 0;
+    };
+
+    QStringList strings;
+    for (int i = 0; i < 1000; ++i)
+        strings << QString::number(i * 7919 % 1000).prepend(i % 2 ? QLatin1String("Odd ") : QLatin1String("even "));
+    QStringListModel model(strings);
+
+    QSortFilterProxyModel reference;
+    reference.setSourceModel(&model);
+    reference.sort(0);
+    CountingProxy proxy;
+    QVERIFY(!proxy.isIncrementalFilteringEnabled());
+    QSignalSpy incrementalSpy(&proxy, &QSortFilterProxyModel::incrementalFilteringEnabledChanged);
+    proxy.setIncrementalFilteringEnabled(true);
+    QVERIFY(proxy.isIncrementalFilteringEnabled());
+    QCOMPARE(incrementalSpy.count(), 1);
+    proxy.setSourceModel(&model);
+    proxy.sort(0);
+    QAbstractItemModelTester tester(&proxy);
+
+    // Which rows each step filters again: all of them, or only those that
+    // were accepted or rejected before
+    enum Filtered { All, Accepted, Rejected };
+    const struct {
+        const char *filter;
+        Qt::CaseSensitivity cs;
+        Filtered filtered;
+    } steps[] = {
+        { "1", Qt::CaseSensitive, All }, // was not a fixed string before
+        { "12", Qt::CaseSensitive, Accepted },
+        { "123", Qt::CaseSensitive, Accepted },
+        { "12", Qt::CaseSensitive, Rejected },
+        { "2", Qt::CaseSensitive, Rejected },
+        { "3", Qt::CaseSensitive, All },
+        { "odd 3", Qt::CaseSensitive, Accepted },
+        { "odd 3", Qt::CaseInsensitive, Rejected },
+        { "odd 34", Qt::CaseInsensitive, Accepted },
+        { "odd 34", Qt::CaseSensitive, Accepted },
+        { "", Qt::CaseSensitive, Rejected },
+    };
+    for (const auto &step : steps) {
+        const QString filter = QLatin1String(step.filter);
+        const int accepted = proxy.rowCount();
+        proxy.filtered = 0;
+        if (step.cs != proxy.filterCaseSensitivity()) {
+            proxy.setFilterCaseSensitivity(step.cs);
+            reference.setFilterCaseSensitivity(step.cs);
+        }
+        if (QRegularExpression::escape(filter) != reference.filterRegularExpression().pattern()) {
+            proxy.setFilterFixedString(filter);
+            reference.setFilterFixedString(filter);
+        }
+        const int expected = step.filtered == All ? model.rowCount()
+                           : step.filtered == Accepted ? accepted
+                           : model.rowCount() - accepted;
+        QCOMPARE(proxy.filtered, expected);
+        QCOMPARE(proxyContents(proxy), proxyContents(reference));
+    }
+
+    // A custom filter tells how it changed
+    class ThresholdProxy : public CountingProxy
+    {
+    public:
+        bool filterAcceptsRow(int source_row, const QModelIndex &) const override
+        {
+            ++filtered;
+            return source_row >= threshold;
+        }
+        void setThreshold(int value)
+        {
+            const FilterChangeHint hint = value > threshold ? NarrowingFilterHint : WideningFilterHint;
+            threshold = value;
+            invalidateRowsFilter(hint);
+        }
+
+        int threshold = 0;
+    };
+    ThresholdProxy thresholdProxy;
+    thresholdProxy.setSourceModel(&model);
+    QCOMPARE(thresholdProxy.rowCount(), 1000);
+    thresholdProxy.filtered = 0;
+    thresholdProxy.setThreshold(600);
+    QCOMPARE(thresholdProxy.filtered, 1000);
+    QCOMPARE(thresholdProxy.rowCount(), 400);
+    thresholdProxy.filtered = 0;
+    thresholdProxy.setThreshold(900);
+    QCOMPARE(thresholdProxy.filtered, 400);
+    QCOMPARE(thresholdProxy.rowCount(), 100);
+    thresholdProxy.filtered = 0;
+    thresholdProxy.setThreshold(500);
+    QCOMPARE(thresholdProxy.filtered, 900);
+    QCOMPARE(thresholdProxy.rowCount(), 500);
+    QCOMPARE(thresholdProxy.mapToSource(thresholdProxy.index(0, 0)).row(), 500);
+}
+
+void tst_QSortFilterProxyModel::parallelSortFilter()
+{
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int maxThreadCount = pool->maxThreadCount();
+    pool->setMaxThreadCount(qMax(4, maxThreadCount));
+    const auto restoreMaxThreadCount = qScopeGuard([&] { pool->setMaxThreadCount(maxThreadCount); });
+
+    // Lots of equal strings, to check that the sorting remains stable
+    QStringList strings;
+    for (int i = 0; i < 50000; ++i)
+        strings << QString::number(i * 7919 % 1000);
+    QStringListModel model(strings);
+
+    QSortFilterProxyModel serial;
+    serial.setSourceModel(&model);
+    QSortFilterProxyModel parallel;
+    QVERIFY(!parallel.isParallelSortFilterEnabled());
+    QSignalSpy parallelSpy(&parallel, &QSortFilterProxyModel::parallelSortFilterEnabledChanged);
+    parallel.setParallelSortFilterEnabled(true);
+    QVERIFY(parallel.isParallelSortFilterEnabled());
+    QCOMPARE(parallelSpy.count(), 1);
+    parallel.setSourceModel(&model);
+    QCOMPARE(proxySourceRows(parallel), proxySourceRows(serial));
+
+    serial.sort(0);
+    parallel.sort(0);
+    QCOMPARE(proxySourceRows(parallel), proxySourceRows(serial));
+
+    serial.setFilterFixedString(QLatin1String("1"));
+    parallel.setFilterFixedString(QLatin1String("1"));
+    QCOMPARE(proxySourceRows(parallel), proxySourceRows(serial));
+
+    serial.sort(0, Qt::DescendingOrder);
+    parallel.sort(0, Qt::DescendingOrder);
+    QCOMPARE(proxySourceRows(parallel), proxySourceRows(serial));
+
+    serial.setFilterFixedString(QString());
+    parallel.setFilterFixedString(QString());
+    QCOMPARE(proxySourceRows(parallel), proxySourceRows(serial));
+    QCOMPARE(parallel.rowCount(), model.rowCount());
+
+    serial.sort(-1);
+    parallel.sort(-1);
+    QCOMPARE(proxySourceRows(parallel), proxySourceRows(serial));
+}
+
+void tst_QSortFilterProxyModel::filterChangeAsLayoutChange()
+{
+    // Removing or inserting every other row of a large model one range at a
+    // time would take very long; with layoutChangeFilteringEnabled it is done
+    // in a single layout change instead.
+    QStringList strings;
+    for (int i = 0; i < 20000; ++i)
+        strings << QString::fromLatin1(i % 2 ? "odd %1" : "even %1").arg(i);
+    QStringListModel model(strings);
+
+    // Without it, every range is still removed and inserted on its own
+    {
+        QStringListModel smallModel(strings.mid(0, 4000));
+        QSortFilterProxyModel proxy;
+        // Incremental filtering alone does not allow a layout change
+        proxy.setIncrementalFilteringEnabled(true);
+        proxy.setSourceModel(&smallModel);
+        QSignalSpy removedSpy(&proxy, &QAbstractItemModel::rowsRemoved);
+        QSignalSpy insertedSpy(&proxy, &QAbstractItemModel::rowsInserted);
+        QSignalSpy layoutChangedSpy(&proxy, &QAbstractItemModel::layoutChanged);
+        proxy.setFilterFixedString(QLatin1String("odd"));
+        QCOMPARE(proxy.rowCount(), 2000);
+        QCOMPARE(removedSpy.count(), 2000);
+        proxy.setFilterFixedString(QString());
+        QCOMPARE(proxy.rowCount(), 4000);
+        QCOMPARE(insertedSpy.count(), 2000);
+        QCOMPARE(layoutChangedSpy.count(), 0);
+    }
+
+    QSortFilterProxyModel proxy;
+    QVERIFY(!proxy.isLayoutChangeFilteringEnabled());
+    QSignalSpy layoutChangeFilteringSpy(&proxy, &QSortFilterProxyModel::layoutChangeFilteringEnabledChanged);
+    proxy.setLayoutChangeFilteringEnabled(true);
+    QVERIFY(proxy.isLayoutChangeFilteringEnabled());
+    QCOMPARE(layoutChangeFilteringSpy.count(), 1);
+    proxy.setSourceModel(&model);
+    QAbstractItemModelTester tester(&proxy);
+
+    QSignalSpy aboutToRemoveSpy(&proxy, &QAbstractItemModel::rowsAboutToBeRemoved);
+    QSignalSpy aboutToInsertSpy(&proxy, &QAbstractItemModel::rowsAboutToBeInserted);
+    QSignalSpy layoutAboutToBeChangedSpy(&proxy, &QAbstractItemModel::layoutAboutToBeChanged);
+    QSignalSpy layoutChangedSpy(&proxy, &QAbstractItemModel::layoutChanged);
+
+    const QPersistentModelIndex even(proxy.index(10, 0));
+    const QPersistentModelIndex odd(proxy.index(11, 0));
+    QCOMPARE(odd.data().toString(), QLatin1String("odd 11"));
+
+    proxy.setFilterFixedString(QLatin1String("odd"));
+    QCOMPARE(proxy.rowCount(), 10000);
+    QCOMPARE(aboutToRemoveSpy.count(), 0);
+    QCOMPARE(layoutAboutToBeChangedSpy.count(), 1);
+    QCOMPARE(layoutChangedSpy.count(), 1);
+    QVERIFY(!even.isValid());
+    QCOMPARE(odd.row(), 5);
+    QCOMPARE(odd.data().toString(), QLatin1String("odd 11"));
+
+    proxy.setFilterFixedString(QString());
+    QCOMPARE(proxy.rowCount(), 20000);
+    QCOMPARE(aboutToInsertSpy.count(), 0);
+    QCOMPARE(layoutChangedSpy.count(), 2);
+    QCOMPARE(odd.row(), 11);
+    QCOMPARE(proxyContents(proxy), strings);
+
+    // A few ranges are still removed one at a time
+    proxy.setFilterRegularExpression(QLatin1String("^(?!(even|odd) 1[0-9]$)"));
+    QCOMPARE(proxy.rowCount(), 19990);
+    QCOMPARE(aboutToRemoveSpy.count(), 1);
+    QCOMPARE(layoutChangedSpy.count(), 2);
+    QVERIFY(!odd.isValid());
+}
+
+void tst_QSortFilterProxyModel::dataChangedOtherRoles()
+{
+    // Changes that do not touch the filter and sort roles still filter and
+    // sort the rows again, but don't move them
+    QStringListModel model({ "b", "a 3", "c", "a 1" });
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    QAbstractItemModelTester tester(&proxy);
+    proxy.setFilterFixedString(QLatin1String("a"));
+    proxy.sort(0);
+    QCOMPARE(proxyContents(proxy), QStringList({ "a 1", "a 3" }));
+
+    QSignalSpy dataChangedSpy(&proxy, &QAbstractItemModel::dataChanged);
+    QSignalSpy insertedSpy(&proxy, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removedSpy(&proxy, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy layoutChangedSpy(&proxy, &QAbstractItemModel::layoutChanged);
+
+    emit model.dataChanged(model.index(0), model.index(3), { Qt::ToolTipRole });
+    QCOMPARE(dataChangedSpy.count(), 1);
+    QCOMPARE(dataChangedSpy.at(0).at(2).value<QList<int>>(), QList<int>({ Qt::ToolTipRole }));
+    QCOMPARE(insertedSpy.count(), 0);
+    QCOMPARE(removedSpy.count(), 0);
+    QCOMPARE(layoutChangedSpy.count(), 0);
+
+    QVERIFY(model.setData(model.index(0), QLatin1String("a 2")));
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(proxyContents(proxy), QStringList({ "a 1", "a 2", "a 3" }));
+
+    QVERIFY(model.setData(model.index(3), QLatin1String("a 4")));
+    QCOMPARE(layoutChangedSpy.count(), 1);
+    QCOMPARE(proxyContents(proxy), QStringList({ "a 2", "a 3", "a 4" }));
+
+    QVERIFY(model.setData(model.index(1), QLatin1String("d")));
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(proxyContents(proxy), QStringList({ "a 2", "a 4" }));
+}
+
+// Filters on another role than filterRole(), without the Q_OBJECT macro
+class UserRoleFilterProxyModel : public QSortFilterProxyModel
+{
+public:
+    bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const override
+    {
+        return sourceModel()->index(source_row, 0, source_parent).data(Qt::UserRole).toBool();
+    }
+};
+
+void tst_QSortFilterProxyModel::dataChangedCustomFilterRole()
+{
+    QStandardItemModel model;
+    for (int row = 0; row < 4; ++row) {
+        QStandardItem *item = new QStandardItem(QString::number(row));
+        item->setData(row % 2 == 0, Qt::UserRole);
+        model.appendRow(item);
+    }
+    UserRoleFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    QAbstractItemModelTester tester(&proxy);
+    QCOMPARE(proxyContents(proxy), QStringList({ "0", "2" }));
+
+    // the change lists only the role the filter reads
+    QVERIFY(model.setData(model.index(1, 0), true, Qt::UserRole));
+    QCOMPARE(proxyContents(proxy), QStringList({ "0", "1", "2" }));
+    QVERIFY(model.setData(model.index(0, 0), false, Qt::UserRole));
+    QCOMPARE(proxyContents(proxy), QStringList({ "1", "2" }));
+}
+
+// Reimplements data() without the Q_OBJECT macro
+class ComplementStringListModel : public QStringListModel
+{
+public:
+    using QStringListModel::QStringListModel;
+
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        const QVariant value = QStringListModel::data(index, role);
+        return role == Qt::DisplayRole ? QVariant(QString::number(10 - value.toInt())) : value;
+    }
+};
+
+void tst_QSortFilterProxyModel::sortSubclassReimplementingData()
+{
+    ComplementStringListModel model({ "3", "1", "4", "5", "2" });
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    proxy.sort(0);
+    QCOMPARE(proxyContents(proxy), QStringList({ "5", "6", "7", "8", "9" }));
+    proxy.sort(0, Qt::DescendingOrder);
+    QCOMPARE(proxyContents(proxy), QStringList({ "9", "8", "7", "6", "5" }));
+}
+
 #include "tst_qsortfilterproxymodel.moc"
@@ -165,6 +165,13 @@ private slots:
     void checkFilteredIndexes();
     void invalidateColumnsOrRowsFilter();
 
+    void incrementalFiltering();
+    void parallelSortFilter();
+    void filterChangeAsLayoutChange();
+    void dataChangedOtherRoles();
+    void dataChangedCustomFilterRole();
+    void sortSubclassReimplementingData();
+
 protected:
     void buildHierarchy(const QStringList &data, QAbstractItemModel *model);
     void checkHierarchy(const QStringList &data, const QAbstractItemModel *model);
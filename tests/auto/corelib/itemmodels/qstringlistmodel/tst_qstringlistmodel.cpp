@@ -93,6 +93,7 @@ private slots:
 
     void itemData();
     void setItemData();
+    void columnData();
 };
 
 void tst_QStringListModel::moveRowsInvalid_data()
@@ -422,6 +423,55 @@ void tst_QStringListModel::setItemData()
     QCOMPARE(dataChangedArguments.at(2).value<QList<int> >(), changeRoles);
 }
 
+// Reimplements data() without the Q_OBJECT macro
+class UpperCaseStringListModel : public QStringListModel
+{
+public:
+    using QStringListModel::QStringListModel;
+
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        return QStringListModel::data(index, role).toString().toUpper();
+    }
+};
+
+void tst_QStringListModel::columnData()
+{
+    const QStringList strings{ QStringLiteral("One"), QStringLiteral("Two"),
+                               QStringLiteral("Three") };
+    QStringListModel testModel(strings);
+    QVERIFY(!testModel.isDirectColumnDataEnabled());
+    testModel.setDirectColumnDataEnabled(true);
+    QVariant values[5];
+    // rows outside the model have no data
+    testModel.columnData(0, -1, 3, Qt::DisplayRole, values);
+    QVERIFY(!values[0].isValid());
+    for (int i = 0; i < strings.size(); ++i)
+        QCOMPARE(values[i + 1], QVariant(strings.at(i)));
+    QVERIFY(!values[4].isValid());
+
+    testModel.columnData(0, 1, 2, Qt::EditRole, values);
+    QCOMPARE(values[0], QVariant(strings.at(1)));
+    QCOMPARE(values[1], QVariant(strings.at(2)));
+
+    // previous data is cleared for items without data
+    testModel.columnData(0, 0, 2, Qt::UserRole, values);
+    QVERIFY(!values[0].isValid() && !values[1].isValid() && !values[2].isValid());
+    testModel.columnData(1, 0, 2, Qt::DisplayRole, values);
+    QVERIFY(!values[0].isValid() && !values[1].isValid() && !values[2].isValid());
+
+    // subclasses may reimplement data(), which is called by default
+    UpperCaseStringListModel upperCaseModel(strings);
+    upperCaseModel.columnData(0, 0, 2, Qt::DisplayRole, values);
+    for (int i = 0; i < strings.size(); ++i)
+        QCOMPARE(values[i], QVariant(strings.at(i).toUpper()));
+    // direct access reads the strings themselves
+    upperCaseModel.setDirectColumnDataEnabled(true);
+    upperCaseModel.columnData(0, 0, 2, Qt::DisplayRole, values);
+    for (int i = 0; i < strings.size(); ++i)
+        QCOMPARE(values[i], QVariant(strings.at(i)));
+}
+
 void tst_QStringListModel::setData_emits_on_change_only()
 {
     QStringListModel model(QStringList{QStringLiteral("one"), QStringLiteral("two")});
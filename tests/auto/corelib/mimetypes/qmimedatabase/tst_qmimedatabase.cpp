@@ -943,6 +943,52 @@ QT_BEGIN_NAMESPACE
 extern Q_CORE_EXPORT int qmime_secondsBetweenChecks; // see qmimeprovider.cpp
 QT_END_NAMESPACE
 
+void tst_QMimeDatabase::fromThreadsWhileReloading()
+{
+    qmime_secondsBetweenChecks = 0;
+    struct RestoreChecks
+    {
+        ~RestoreChecks() { qmime_secondsBetweenChecks = 5; }
+    } restoreChecks;
+
+    // Every lookup checks the MIME directories, and the local one keeps
+    // appearing and disappearing, so the lookups race with new provider
+    // lists being published.
+    QAtomicInt stop = 0;
+    const auto lookUp = [&stop]() {
+        QMimeDatabase db;
+        int failures = 0;
+        while (!stop.loadAcquire()) {
+            if (!db.mimeTypeForName(QStringLiteral("text/plain")).isValid())
+                ++failures;
+            if (db.mimeTypeForFile(QStringLiteral("foo.txt"), QMimeDatabase::MatchExtension).name()
+                != QLatin1String("text/plain"))
+                ++failures;
+            if (db.mimeTypeForData(QByteArray("%PDF-")).name() != QLatin1String("application/pdf"))
+                ++failures;
+        }
+        return failures;
+    };
+
+    QThreadPool tp;
+    tp.setMaxThreadCount(4);
+    QList<QFuture<int>> futures;
+    for (int i = 0; i < tp.maxThreadCount(); ++i)
+        futures.append(QtConcurrent::run(&tp, lookUp));
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int round = 0; round < 200 && timer.elapsed() < 5000; ++round) {
+        QVERIFY(QDir().mkpath(m_localMimeDir));
+        QTest::qSleep(1);
+        QVERIFY(QDir(m_localMimeDir).removeRecursively());
+        QTest::qSleep(1);
+    }
+    stop.storeRelease(1);
+    for (const QFuture<int> &future : qAsConst(futures))
+        QCOMPARE(future.result(), 0);
+}
+
 void tst_QMimeDatabase::installNewGlobalMimeType()
 {
 #if !defined(USE_XDG_DATA_DIRS)
@@ -68,6 +68,7 @@ private slots:
     void knownSuffix();
     void symlinkToFifo();
     void fromThreads();
+    void fromThreadsWhileReloading();
 
     // shared-mime-info test suite
 
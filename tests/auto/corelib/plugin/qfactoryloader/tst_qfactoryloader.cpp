@@ -30,7 +30,11 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qplugin.h>
+#include <QtCore/qtemporarydir.h>
 #include <private/qfactoryloader_p.h>
+#if QT_CONFIG(library) && defined(QT_BUILD_INTERNAL)
+#include <private/qpluginmetadatacache_p.h>
+#endif
 #include "plugin1/plugininterface1.h"
 #include "plugin2/plugininterface2.h"
 
@@ -46,12 +50,17 @@ class tst_QFactoryLoader : public QObject
 #ifdef Q_OS_ANDROID
     QSharedPointer<QTemporaryDir> directory;
 #endif
+    QTemporaryDir cacheDirectory;
 
 public slots:
     void initTestCase();
 
 private slots:
     void usingTwoFactoriesFromSameDir();
+    void metaDataCache();
+#if QT_CONFIG(library) && defined(QT_BUILD_INTERNAL)
+    void metaDataCacheInvalidation();
+#endif
 };
 
 static const char binFolderC[] = "bin";
@@ -69,6 +78,8 @@ void tst_QFactoryLoader::initTestCase()
 #if QT_CONFIG(library)
     QCoreApplication::setLibraryPaths(QStringList(QFileInfo(binFolder).absolutePath()));
 #endif
+    QVERIFY(cacheDirectory.isValid());
+    qputenv("QT_PLUGIN_CACHE_DIR", QFile::encodeName(cacheDirectory.path()));
 }
 
 void tst_QFactoryLoader::usingTwoFactoriesFromSameDir()
@@ -92,5 +103,73 @@ void tst_QFactoryLoader::usingTwoFactoriesFromSameDir()
     QCOMPARE(plugin2->pluginName(), QLatin1String("Plugin2 ok"));
 }
 
+void tst_QFactoryLoader::metaDataCache()
+{
+#if !QT_CONFIG(library)
+    QSKIP("Static plugins are not scanned for");
+#else
+    const QString suffix = QLatin1Char('/') + QLatin1String(binFolderC);
+    QList<QJsonObject> metaData;
+    {
+        QFactoryLoader loader(PluginInterface1_iid, suffix);
+        metaData = loader.metaData();
+        QCOMPARE(metaData.size(), 1);
+    }
+    const QStringList cacheFiles = QDir(cacheDirectory.path()).entryList(QDir::Files);
+    QCOMPARE(cacheFiles.size(), 1);
+
+    // a new loader finds the same plugin, now from the cache
+    QFactoryLoader loader(PluginInterface1_iid, suffix);
+    QCOMPARE(loader.metaData(), metaData);
+    PluginInterface1 *plugin1 = qobject_cast<PluginInterface1 *>(loader.instance(0));
+    QVERIFY(plugin1);
+    QCOMPARE(plugin1->pluginName(), QLatin1String("Plugin1 ok"));
+
+    // disabling the cache gives the same result
+    qputenv("QT_NO_PLUGIN_CACHE", "1");
+    QFactoryLoader uncachedLoader(PluginInterface1_iid, suffix);
+    qunsetenv("QT_NO_PLUGIN_CACHE");
+    QCOMPARE(uncachedLoader.metaData(), metaData);
+#endif
+}
+
+#if QT_CONFIG(library) && defined(QT_BUILD_INTERNAL)
+void tst_QFactoryLoader::metaDataCacheInvalidation()
+{
+    QTemporaryDir pluginDir;
+    QVERIFY(pluginDir.isValid());
+    const QString fileName = pluginDir.filePath(QLatin1String("libfake.so"));
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(file.write("not a plugin") > 0);
+    file.close();
+
+    const QJsonObject fakeMetaData{ { QLatin1String("IID"), QLatin1String("fake") } };
+    QPluginMetaDataCache::FileKey key;
+    QJsonObject metaData;
+    {
+        QPluginMetaDataCache cache;
+        QVERIFY(!cache.find(fileName, &key, &metaData));
+        QVERIFY(key.isValid());
+        cache.insert(fileName, key, fakeMetaData);
+        QVERIFY(cache.find(fileName, &key, &metaData));
+        QCOMPARE(metaData, fakeMetaData);
+        cache.sync();
+    }
+
+    // read back from the cache file
+    QPluginMetaDataCache cache;
+    metaData = QJsonObject();
+    QVERIFY(cache.find(fileName, &key, &metaData));
+    QCOMPARE(metaData, fakeMetaData);
+
+    // a modified file is not found any more
+    QVERIFY(file.open(QIODevice::Append));
+    QVERIFY(file.write(" either") > 0);
+    file.close();
+    QVERIFY(!cache.find(fileName, &key, &metaData));
+}
+#endif
+
 QTEST_MAIN(tst_QFactoryLoader)
 #include "tst_qfactoryloader.moc"
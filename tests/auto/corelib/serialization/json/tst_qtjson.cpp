@@ -106,6 +106,8 @@ private Q_SLOTS:
     void toJsonLargeNumericValues();
     void fromJson();
     void fromJsonErrors();
+    void fromJsonLines();
+    void fromJsonLinesErrors();
     void parseNumbers();
     void parseStrings();
     void parseDuplicateKeys();
@@ -1958,6 +1960,67 @@ void tst_QtJson::fromJson()
     }
 }
 
+void tst_QtJson::fromJsonLines()
+{
+    QByteArray json = "{\"a\": 1}\n[1, 2]\r\n\n   \n{}\n";
+    QList<QJsonValue> values = QJsonDocument::fromJsonLines(json);
+    QCOMPARE(values.size(), 3);
+    QCOMPARE(values.at(0), QJsonValue(QJsonObject{{"a", 1}}));
+    QCOMPARE(values.at(1), QJsonValue(QJsonArray{1, 2}));
+    QCOMPARE(values.at(2), QJsonValue(QJsonObject()));
+
+    QVERIFY(QJsonDocument::fromJsonLines(QByteArray()).isEmpty());
+
+    // large enough to be split across several threads and windows
+    json.clear();
+    const int count = 20000;
+    for (int i = 0; i < count; ++i)
+        json += "{\"index\": " + QByteArray::number(i) + "}\n";
+
+    QJsonParseError error;
+    values = QJsonDocument::fromJsonLines(json, &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QCOMPARE(values.size(), count);
+    for (int i = 0; i < count; ++i)
+        QCOMPARE(values.at(i)[QLatin1String("index")].toInt(), i);
+
+    int next = 0;
+    QVERIFY(QJsonDocument::fromJsonLines(json, [&next](const QJsonValue &v) {
+        QCOMPARE(v[QLatin1String("index")].toInt(), next);
+        ++next;
+    }));
+    QCOMPARE(next, count);
+
+    // any callable works, including const function objects
+    struct Counter {
+        int *count;
+        void operator()(const QJsonValue &) const { ++*count; }
+    };
+    next = 0;
+    const Counter counter = { &next };
+    QVERIFY(QJsonDocument::fromJsonLines(json, counter));
+    QCOMPARE(next, count);
+}
+
+void tst_QtJson::fromJsonLinesErrors()
+{
+    QByteArray json = "{\"a\": 1}\n[1 2]\n{}\n";
+    QJsonParseError error;
+    QVERIFY(QJsonDocument::fromJsonLines(json, &error).isEmpty());
+    QCOMPARE(error.error, QJsonParseError::MissingValueSeparator);
+    QCOMPARE(error.offset, 13);
+
+    int delivered = 0;
+    QVERIFY(!QJsonDocument::fromJsonLines(json, [&delivered](const QJsonValue &) {
+        ++delivered;
+    }, &error));
+    QCOMPARE(delivered, 1);
+
+    // a record may not span several lines
+    QVERIFY(QJsonDocument::fromJsonLines("{\n}\n", &error).isEmpty());
+    QCOMPARE(error.error, QJsonParseError::UnterminatedObject);
+}
+
 void tst_QtJson::fromJsonErrors()
 {
     {
@@ -110,6 +110,10 @@ private slots:
     void fromCborStreamReaderByteArray();
     void fromCborStreamReaderIODevice_data() { fromCbor_data(); }
     void fromCborStreamReaderIODevice();
+    void fromCborSequence_data() { fromCbor_data(); }
+    void fromCborSequence();
+    void fromCborSequenceLarge();
+    void fromCborSequenceErrors();
     void validation_data();
     void validation();
     void extendedTypeValidation_data();
@@ -2038,6 +2042,66 @@ void tst_QCborValue::validation_data()
     }
 }
 
+void tst_QCborValue::fromCborSequence()
+{
+    auto doCheck = [](const QCborValue &v, const QByteArray &result) {
+        // the same item three times in a row
+        const QByteArray data = result + result + result;
+        QCborParserError error;
+        QList<QCborValue> decoded = QCborValue::fromCborSequence(data, &error);
+        QVERIFY2(error.error == QCborError(), qPrintable(error.errorString()));
+        QCOMPARE(error.offset, data.size());
+        QCOMPARE(decoded.size(), 3);
+        for (const QCborValue &d : qAsConst(decoded))
+            QVERIFY(d == v);
+    };
+
+    fromCbor_common(doCheck);
+}
+
+void tst_QCborValue::fromCborSequenceLarge()
+{
+    const int count = 20000;
+    QByteArray data;
+    for (int i = 0; i < count; ++i)
+        data += QCborValue(QCborArray{i, QString::number(i)}).toCbor();
+
+    int next = 0;
+    QCborParserError error;
+    QVERIFY(QCborValue::fromCborSequence(data, [&next](const QCborValue &v) {
+        QCOMPARE(v[0].toInteger(), next);
+        QCOMPARE(v[1].toString(), QString::number(next));
+        ++next;
+    }, &error));
+    QCOMPARE(error.error, QCborError());
+    QCOMPARE(next, count);
+
+    QVERIFY(QCborValue::fromCborSequence(QByteArray(), &error).isEmpty());
+    QCOMPARE(error.error, QCborError());
+}
+
+void tst_QCborValue::fromCborSequenceErrors()
+{
+    // 1, [2, 3], then a truncated array
+    QByteArray data("\x01\x82\x02\x03\x82\x04", 6);
+    QCborParserError error;
+    QVERIFY(QCborValue::fromCborSequence(data, &error).isEmpty());
+    QCOMPARE(error.error, QCborError::EndOfFile);
+    QCOMPARE(error.offset, data.size());
+
+    int delivered = 0;
+    QVERIFY(!QCborValue::fromCborSequence(data, [&delivered](const QCborValue &) {
+        ++delivered;
+    }));
+    QCOMPARE(delivered, 2);
+
+    // a break byte outside an indefinite-length container
+    data = QByteArray("\x01\xff\x02", 3);
+    QVERIFY(QCborValue::fromCborSequence(data, &error).isEmpty());
+    QCOMPARE(error.error, QCborError::UnexpectedBreak);
+    QCOMPARE(error.offset, 1);
+}
+
 void tst_QCborValue::validation()
 {
     QFETCH(QByteArray, data);
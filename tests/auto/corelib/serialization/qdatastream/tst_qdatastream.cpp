@@ -210,6 +210,10 @@ private slots:
 
     void floatingPointPrecision();
 
+    void arithmeticLists_data();
+    void arithmeticLists();
+    void arithmeticListsTruncated();
+
     void compatibility_Qt5();
     void compatibility_Qt3();
     void compatibility_Qt2();
@@ -3703,6 +3707,129 @@ void tst_QDataStream::floatingPointPrecision()
 
 }
 
+void tst_QDataStream::arithmeticLists_data()
+{
+    QTest::addColumn<QDataStream::ByteOrder>("byteOrder");
+    QTest::addColumn<QDataStream::FloatingPointPrecision>("precision");
+
+    QTest::newRow("big-endian/double") << QDataStream::BigEndian << QDataStream::DoublePrecision;
+    QTest::newRow("big-endian/single") << QDataStream::BigEndian << QDataStream::SinglePrecision;
+    QTest::newRow("little-endian/double") << QDataStream::LittleEndian << QDataStream::DoublePrecision;
+    QTest::newRow("little-endian/single") << QDataStream::LittleEndian << QDataStream::SinglePrecision;
+}
+
+template <typename T>
+static QByteArray streamElementWise(const QList<T> &list, QDataStream::ByteOrder byteOrder,
+                                    QDataStream::FloatingPointPrecision precision)
+{
+    QByteArray ba;
+    QDataStream stream(&ba, QIODevice::WriteOnly);
+    stream.setByteOrder(byteOrder);
+    stream.setFloatingPointPrecision(precision);
+    stream << quint32(list.size());
+    for (const T &t : list)
+        stream << t;
+    return ba;
+}
+
+template <typename T>
+static void checkArithmeticList(const QList<T> &list, QDataStream::ByteOrder byteOrder,
+                                QDataStream::FloatingPointPrecision precision)
+{
+    QByteArray ba;
+    {
+        QDataStream stream(&ba, QIODevice::WriteOnly);
+        stream.setByteOrder(byteOrder);
+        stream.setFloatingPointPrecision(precision);
+        stream << list;
+        QCOMPARE(stream.status(), QDataStream::Ok);
+    }
+    QCOMPARE(ba, streamElementWise(list, byteOrder, precision));
+
+    QDataStream stream(ba);
+    stream.setByteOrder(byteOrder);
+    stream.setFloatingPointPrecision(precision);
+    QList<T> result;
+    stream >> result;
+    QCOMPARE(stream.status(), QDataStream::Ok);
+    QVERIFY(stream.atEnd());
+    if constexpr (std::is_same_v<T, double>) {
+        if (precision == QDataStream::SinglePrecision) {
+            QCOMPARE(result.size(), list.size());
+            for (qsizetype i = 0; i < list.size(); ++i)
+                QCOMPARE(result.at(i), double(float(list.at(i))));
+            return;
+        }
+    }
+    QCOMPARE(result, list);
+}
+
+void tst_QDataStream::arithmeticLists()
+{
+    QFETCH(QDataStream::ByteOrder, byteOrder);
+    QFETCH(QDataStream::FloatingPointPrecision, precision);
+
+    QList<qint8> i8;
+    QList<qint16> i16;
+    QList<quint32> u32;
+    QList<qint64> i64;
+    QList<char16_t> c16;
+    QList<float> f;
+    QList<double> d;
+    // larger than the chunk size used for swapping on write
+    for (int i = 0; i < 70000; ++i) {
+        i8 << qint8(i * 7);
+        i16 << qint16(i * 31 - 1000);
+        u32 << quint32(i) * 0x01020304u;
+        i64 << qint64(i) * Q_INT64_C(0x0102030405) - 1;
+        c16 << char16_t(i);
+        f << float(i) / 3;
+        d << double(i) / 7;
+    }
+
+    checkArithmeticList(i8, byteOrder, precision);
+    checkArithmeticList(i16, byteOrder, precision);
+    checkArithmeticList(u32, byteOrder, precision);
+    checkArithmeticList(i64, byteOrder, precision);
+    checkArithmeticList(c16, byteOrder, precision);
+    checkArithmeticList(f, byteOrder, precision);
+    checkArithmeticList(d, byteOrder, precision);
+    checkArithmeticList(QList<double>(), byteOrder, precision);
+}
+
+void tst_QDataStream::arithmeticListsTruncated()
+{
+    QByteArray ba;
+    {
+        QDataStream stream(&ba, QIODevice::WriteOnly);
+        stream << QList<qint32>{1, 2, 3, 4};
+    }
+
+    // drop the last element
+    ba.chop(sizeof(qint32));
+    {
+        QDataStream stream(ba);
+        QList<qint32> list{42};
+        stream >> list;
+        QCOMPARE(stream.status(), QDataStream::ReadPastEnd);
+        QVERIFY(list.isEmpty());
+    }
+
+    // a size far beyond the available data must not be trusted
+    ba.clear();
+    {
+        QDataStream stream(&ba, QIODevice::WriteOnly);
+        stream << quint32(0x7fffffff) << qint32(1);
+    }
+    {
+        QDataStream stream(ba);
+        QList<qint32> list;
+        stream >> list;
+        QCOMPARE(stream.status(), QDataStream::ReadPastEnd);
+        QVERIFY(list.isEmpty());
+    }
+}
+
 void tst_QDataStream::transaction_data()
 {
     QTest::addColumn<qint8>("i8Data");
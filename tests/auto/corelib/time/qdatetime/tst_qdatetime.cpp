@@ -70,6 +70,10 @@ private Q_SLOTS:
     void fromSecsSinceEpoch();
     void fromMSecsSinceEpoch_data();
     void fromMSecsSinceEpoch();
+#if QT_CONFIG(timezone)
+    void bulkConversion_data();
+    void bulkConversion();
+#endif
 #if QT_CONFIG(datestring)
     void toString_isoDate_data();
     void toString_isoDate();
@@ -802,6 +806,93 @@ void tst_QDateTime::fromSecsSinceEpoch()
 #endif // timezone
 }
 
+#if QT_CONFIG(timezone)
+void tst_QDateTime::bulkConversion_data()
+{
+    QTest::addColumn<QTimeZone>("zone");
+    QTest::addColumn<bool>("sorted");
+
+    for (const QByteArray &name : { QByteArray("Europe/Oslo"), QByteArray("America/Vancouver"),
+                                    QByteArray("Australia/Eucla"), QByteArray("UTC-03:30") }) {
+        const QTimeZone zone(name);
+        if (!zone.isValid())
+            continue;
+        QTest::addRow("%s, sorted", name.constData()) << zone << true;
+        QTest::addRow("%s, unsorted", name.constData()) << zone << false;
+    }
+    QTest::newRow("invalid") << QTimeZone() << true;
+}
+
+void tst_QDateTime::bulkConversion()
+{
+    QFETCH(QTimeZone, zone);
+    QFETCH(bool, sorted);
+
+    // Every seven hours for three years, around two transitions a year, and
+    // some instants far from them, including ones out of the ISO 8601 range
+    QList<qint64> msecs;
+    const qint64 start = QDateTime(QDate(2019, 1, 1), QTime(0, 0), Qt::UTC).toMSecsSinceEpoch();
+    for (qint64 ms = start; ms < start + 3 * 366 * 24 * 3600 * qint64(1000); ms += 7 * 3600 * 1000)
+        msecs << ms;
+    msecs << -2000000000000 << 0 << 4102444800123 << 300000000000000;
+    if (!sorted)
+        std::reverse(msecs.begin(), msecs.end());
+
+    const qsizetype count = msecs.size();
+    QList<QDate> dates(count);
+    QList<QTime> times(count);
+    QList<int> offsets(count);
+    QDateTime::toDatesAndTimes(msecs.constData(), count, zone, dates.data(), times.data(),
+                               offsets.data());
+    for (qsizetype i = 0; i < count; ++i) {
+        const QDateTime dt = QDateTime::fromMSecsSinceEpoch(msecs.at(i), zone);
+        QCOMPARE(dates.at(i), dt.date());
+        QCOMPARE(times.at(i), dt.time());
+        QCOMPARE(offsets.at(i), zone.isValid() ? dt.offsetFromUtc() : 0);
+    }
+
+#if QT_CONFIG(datestring)
+    QByteArray buffer(count * QDateTime::IsoDateStringSize, Qt::Uninitialized);
+    QCOMPARE(QDateTime::toIsoDateStrings(msecs.constData(), count, zone, buffer.data()), false);
+    QList<qint64> parsed(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        const QByteArray string = buffer.mid(i * QDateTime::IsoDateStringSize,
+                                             QDateTime::IsoDateStringSize);
+        const QDateTime dt = QDateTime::fromMSecsSinceEpoch(msecs.at(i), zone);
+        const QString expected = dt.toString(Qt::ISODateWithMs);
+        if (expected.isEmpty()) {
+            QCOMPARE(string, QByteArray(QDateTime::IsoDateStringSize, ' '));
+            QCOMPARE(QDateTime::fromIsoDateStrings(string.constData(), 1, parsed.data()), 0);
+            continue;
+        }
+        QCOMPARE(string, expected.toLatin1());
+        QCOMPARE(QDateTime::fromIsoDateStrings(string.constData(), 1, parsed.data() + i), 1);
+        QCOMPARE(parsed.at(i), msecs.at(i));
+    }
+
+    // Reading stops at the first invalid string
+    const QByteArray valid = QByteArrayLiteral("2021-03-28T01:59:59.999+01:00"
+                                               "1969-12-31 23:30:00.000-00:30"
+                                               "2021-02-29T00:00:00.000+00:00");
+    QCOMPARE(QDateTime::fromIsoDateStrings(valid.constData(), 3, parsed.data()), 2);
+    QCOMPARE(parsed.at(0), QDateTime(QDate(2021, 3, 28), QTime(0, 59, 59, 999), Qt::UTC)
+                               .toMSecsSinceEpoch());
+    QCOMPARE(parsed.at(1), 0);
+
+    // Like toString(), offsets are written in whole minutes
+    const QTimeZone withSeconds(3723);
+    const qint64 epoch = 0;
+    QByteArray string(QDateTime::IsoDateStringSize, Qt::Uninitialized);
+    QVERIFY(QDateTime::toIsoDateStrings(&epoch, 1, withSeconds, string.data()));
+    QCOMPARE(string, QByteArray("1970-01-01T01:02:03.000+01:02"));
+    QCOMPARE(string, QDateTime::fromMSecsSinceEpoch(epoch, withSeconds)
+                             .toString(Qt::ISODateWithMs).toLatin1());
+    QCOMPARE(QDateTime::fromIsoDateStrings(string.constData(), 1, parsed.data()), 1);
+    QCOMPARE(parsed.at(0), 3000);
+#endif
+}
+#endif // timezone
+
 #if QT_CONFIG(datestring) // depends on, so implies, textdate
 void tst_QDateTime::toString_isoDate_data()
 {
@@ -137,6 +137,7 @@ private slots:
 
     void taskQTBUG_45114_setItemData();
     void setItemPersistentIndex();
+    void columnData();
 
 private:
     QStandardItemModel *m_model = nullptr;
@@ -1738,5 +1739,93 @@ void tst_QStandardItemModel::setItemPersistentIndex()
     QVERIFY(!persistentIndex.isValid());
 }
 
+// Reimplements data() without the Q_OBJECT macro, so columnData() must not
+// read the items directly unless asked to
+class UpperCaseModel : public QStandardItemModel
+{
+public:
+    using QStandardItemModel::QStandardItemModel;
+
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        const QVariant value = QStandardItemModel::data(index, role);
+        return role == Qt::DisplayRole ? QVariant(value.toString().toUpper()) : value;
+    }
+};
+
+static void compareColumnData(const QStandardItemModel &model, int column, int role,
+                              const QModelIndex &parent = QModelIndex())
+{
+    const int rows = model.rowCount(parent);
+    // past the last row too, where the items do not exist
+    QList<QVariant> values(rows + 2, QVariant(42));
+    model.columnData(column, 0, rows + 1, role, values.data(), parent);
+    for (int row = 0; row < rows; ++row)
+        QCOMPARE(values.at(row), model.data(model.index(row, column, parent), role));
+    QCOMPARE(values.at(rows), QVariant());
+    QCOMPARE(values.at(rows + 1), QVariant());
+}
+
+void tst_QStandardItemModel::columnData()
+{
+    auto fill = [](QStandardItemModel &model) {
+        model.setRowCount(4);
+        model.setColumnCount(3);
+        for (int row = 0; row < 4; ++row) {
+            for (int column = 0; column < 3; ++column) {
+                if (row == 1 && column == 1)
+                    continue; // no item
+                QStandardItem *item = new QStandardItem(QString::fromLatin1("item %1 %2").arg(row).arg(column));
+                item->setData(row * 10 + column, Qt::UserRole);
+                model.setItem(row, column, item);
+            }
+        }
+        QStandardItem *parent = model.item(2, 0);
+        parent->setColumnCount(2);
+        parent->setChild(0, 1, new QStandardItem(QLatin1String("child 0 1")));
+        parent->setChild(2, 0, new QStandardItem(QLatin1String("child 2 0")));
+        parent->child(2, 0)->setData(20, Qt::UserRole);
+    };
+
+    QStandardItemModel model;
+    fill(model);
+    QStandardItemModel directModel;
+    fill(directModel);
+    directModel.setDirectColumnDataEnabled(true);
+    UpperCaseModel upperCaseModel;
+    fill(upperCaseModel);
+
+    for (const QStandardItemModel *m : { &model, &directModel,
+                                         static_cast<QStandardItemModel *>(&upperCaseModel) }) {
+        const QModelIndex parent = m->index(2, 0);
+        QCOMPARE(m->rowCount(parent), 3);
+        for (int role : { int(Qt::DisplayRole), int(Qt::UserRole), int(Qt::ToolTipRole) }) {
+            for (int column = 0; column < 3; ++column) {
+                compareColumnData(*m, column, role);
+                if (QTest::currentTestFailed())
+                    return;
+            }
+            for (int column = 0; column < 2; ++column) {
+                compareColumnData(*m, column, role, parent);
+                if (QTest::currentTestFailed())
+                    return;
+            }
+        }
+    }
+
+    QVariant value;
+    upperCaseModel.columnData(0, 3, 3, Qt::DisplayRole, &value);
+    QCOMPARE(value, QVariant(QLatin1String("ITEM 3 0")));
+    directModel.columnData(0, 3, 3, Qt::DisplayRole, &value);
+    QCOMPARE(value, QVariant(QLatin1String("item 3 0")));
+    // the item that was never set
+    directModel.columnData(1, 1, 1, Qt::DisplayRole, &value);
+    QCOMPARE(value, QVariant());
+    // direct access bypasses the reimplemented data()
+    upperCaseModel.setDirectColumnDataEnabled(true);
+    upperCaseModel.columnData(0, 3, 3, Qt::DisplayRole, &value);
+    QCOMPARE(value, QVariant(QLatin1String("item 3 0")));
+}
+
 QTEST_MAIN(tst_QStandardItemModel)
 #include "tst_qstandarditemmodel.moc"
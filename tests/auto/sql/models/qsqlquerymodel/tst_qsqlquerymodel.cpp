@@ -71,6 +71,8 @@ private slots:
     void setHeaderData();
     void fetchMore_data() { generic_data(); }
     void fetchMore();
+    void columnData_data() { generic_data("QSQLITE"); }
+    void columnData();
 
     //problem specific tests
     void withSortFilterProxyModel_data() { generic_data(); }
@@ -491,6 +493,44 @@ void tst_QSqlQueryModel::fetchMore()
     }
 }
 
+void tst_QSqlQueryModel::columnData()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlQueryModel model;
+    model.setDirectColumnDataEnabled(true);
+    model.setQuery(QSqlQuery("select id, name from " + qTableName("many", __FILE__, db) + " order by id", db));
+    // QSQLITE doesn't report the size of the query, so only some rows are fetched
+    const int rows = model.rowCount();
+    QVERIFY(rows > 0);
+    QVERIFY(model.canFetchMore());
+    QVERIFY(model.insertColumn(1));
+    QCOMPARE(model.columnCount(), 3);
+
+    for (int role : { int(Qt::DisplayRole), int(Qt::EditRole), int(Qt::ToolTipRole) }) {
+        for (int column = 0; column < 4; ++column) {
+            QList<QVariant> values(rows + 10, QVariant(42));
+            model.columnData(column, 0, rows + 9, role, values.data());
+            for (int row = 0; row < rows; ++row)
+                QCOMPARE(values.at(row), model.data(model.index(row, column), role));
+            // the rows past the ones fetched so far don't exist yet
+            for (int row = rows; row < rows + 10; ++row)
+                QCOMPARE(values.at(row), QVariant());
+        }
+    }
+    QCOMPARE(model.rowCount(), rows);
+
+    QVariant value;
+    model.columnData(0, 5, 5, Qt::DisplayRole, &value);
+    QCOMPARE(value.toInt(), 5);
+    model.columnData(2, 5, 5, Qt::DisplayRole, &value);
+    QCOMPARE(value.toString(), QString("harry"));
+    model.columnData(1, 5, 5, Qt::DisplayRole, &value);
+    QCOMPARE(value, QVariant());
+}
+
 // For task 149491: When used with QSortFilterProxyModel, a view and a
 // database that doesn't support the QuerySize feature, blank rows was
 // appended if the query returned more than 256 rows and setQuery()
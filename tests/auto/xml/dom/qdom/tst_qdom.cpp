@@ -111,6 +111,7 @@ private slots:
     void checkIntOverflow() const;
     void setContentWhitespace() const;
     void setContentWhitespace_data() const;
+    void setContentSharesNames() const;
 
     void taskQTBUG4595_dontAssertWhenDocumentSpecifiesUnknownEncoding() const;
     void cloneDTD_QTBUG8398() const;
@@ -1830,6 +1831,32 @@ void tst_QDom::setContentQXmlReaderOverload() const
     QCOMPARE(doc.documentElement().nodeName(), QString::fromLatin1("e"));
 }
 
+void tst_QDom::setContentSharesNames() const
+{
+    QDomDocument doc;
+    QVERIFY(doc.setContent(QByteArray("<root xmlns:p=\"urn:p\">"
+                                      "<p:item a=\"1\"/><p:item a=\"2\"/></root>"), true));
+    const QDomElement first = doc.documentElement().firstChildElement();
+    const QDomElement second = first.nextSiblingElement();
+    QCOMPARE(first.localName(), QString::fromLatin1("item"));
+    QCOMPARE(first.prefix(), QString::fromLatin1("p"));
+    QCOMPARE(first.namespaceURI(), QString::fromLatin1("urn:p"));
+    QCOMPARE(second.attribute("a"), QString::fromLatin1("2"));
+
+    // nodes created by the parser share the storage of equal names
+    QCOMPARE(first.localName().constData(), second.localName().constData());
+    QCOMPARE(first.prefix().constData(), second.prefix().constData());
+    QCOMPARE(first.namespaceURI().constData(), second.namespaceURI().constData());
+    QCOMPARE(first.attributes().item(0).nodeName().constData(),
+             second.attributes().item(0).nodeName().constData());
+
+    // without namespace processing
+    QVERIFY(doc.setContent(QByteArray("<root><item a=\"1\"/><item a=\"2\"/></root>")));
+    QCOMPARE(doc.documentElement().firstChildElement().tagName().constData(),
+             doc.documentElement().lastChildElement().tagName().constData());
+    QVERIFY(doc.documentElement().firstChildElement().prefix().isNull());
+}
+
 void tst_QDom::cleanupTestCase() const
 {
     QFile::remove("germanUmlautToFile.xml");
@@ -1,9 +1,12 @@
 TEMPLATE = subdirs
 SUBDIRS = \
+        global \
         io \
+        itemmodels \
         json \
         mimetypes \
         kernel \
+        serialization \
         text \
         thread \
         time \
@@ -0,0 +1,79 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QDebug>
+#include <qtest.h>
+
+#include <thread>
+#include <vector>
+
+// Measures the throughput of the default message handler with many threads
+// logging at once. Run with QT_LOGGING_ASYNC=block (or drop) in the
+// environment to compare against synchronous output, and redirect stderr
+// to get numbers that are not dominated by the terminal.
+class tst_QLogging : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void debugThroughput_data();
+    void debugThroughput();
+};
+
+void tst_QLogging::debugThroughput_data()
+{
+    QTest::addColumn<int>("threadCount");
+
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("8 threads") << 8;
+    QTest::newRow("32 threads") << 32;
+}
+
+void tst_QLogging::debugThroughput()
+{
+    QFETCH(int, threadCount);
+    const int messagesPerThread = 32000 / threadCount;
+
+    QBENCHMARK {
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount);
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back([t, messagesPerThread] {
+                for (int i = 0; i < messagesPerThread; ++i)
+                    qDebug("thread %d: message %d of %d", t, i, messagesPerThread);
+            });
+        }
+        for (std::thread &thread : threads)
+            thread.join();
+    }
+}
+
+QTEST_MAIN(tst_QLogging)
+
+#include "main.moc"
@@ -5,7 +5,9 @@ SUBDIRS = \
         qfile \
         qfileinfo \
         qiodevice \
+        qloggingcategory \
         qtemporaryfile \
         qtextstream
 
 qtConfig(process): SUBDIRS += qprocess
+linux:qtConfig(filesystemwatcher):qtConfig(inotify): SUBDIRS += qfilesystemwatcher
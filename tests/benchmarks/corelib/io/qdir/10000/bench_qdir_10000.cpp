@@ -155,6 +155,23 @@ private slots:
         }
     }
 
+    void sorted_bySize() {
+        QDir testdir(QDir::tempPath() + QLatin1String("/test_speed"));
+        QBENCHMARK {
+            QFileInfoList fileInfoList = testdir.entryInfoList(QDir::Files, QDir::Size);
+            QCOMPARE(fileInfoList.size(), 10000);
+        }
+    }
+
+    void sorted_byTimeDirsFirst() {
+        QDir testdir(QDir::tempPath() + QLatin1String("/test_speed"));
+        QBENCHMARK {
+            QFileInfoList fileInfoList = testdir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot,
+                                                               QDir::Time | QDir::DirsFirst);
+            QCOMPARE(fileInfoList.size(), 10000);
+        }
+    }
+
     void sizeSpeedWithoutFilterLowLevel() {
         QDir testdir(QDir::tempPath() + QLatin1String("/test_speed"));
 #ifdef Q_OS_WIN
@@ -44,6 +44,11 @@
 
 #include "qfilesystemiterator.h"
 
+#if QT_CONFIG(thread)
+#include <QtCore/private/qparalleldirwalker_p.h>
+#include <atomic>
+#endif
+
 #if QT_CONFIG(cxx17_filesystem)
 #include <filesystem>
 #endif
@@ -60,6 +65,8 @@ private slots:
     void diriterator_data() { data(); }
     void fsiterator();
     void fsiterator_data() { data(); }
+    void parallelDirWalker();
+    void parallelDirWalker_data() { data(); }
     void stdRecursiveDirectoryIterator();
     void stdRecursiveDirectoryIterator_data() { data(); }
 };
@@ -237,6 +244,25 @@ void tst_qdiriterator::fsiterator()
     qDebug() << count;
 }
 
+void tst_qdiriterator::parallelDirWalker()
+{
+#if QT_CONFIG(thread)
+    QFETCH(QByteArray, dirpath);
+
+    int count = 0;
+
+    QBENCHMARK {
+        std::atomic<int> c(0);
+        QParallelDirWalker walker(dirpath, QDir::Files);
+        walker.walk([&c](const QFileInfoList &entries) { c += entries.size(); });
+        count = c;
+    }
+    qDebug() << count;
+#else
+    QSKIP("Not supported.");
+#endif
+}
+
 void tst_qdiriterator::stdRecursiveDirectoryIterator()
 {
 #if QT_CONFIG(cxx17_filesystem)
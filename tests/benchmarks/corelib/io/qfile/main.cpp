@@ -32,6 +32,9 @@
 #include <QDirIterator>
 
 #include <private/qfsfileengine_p.h>
+#if QT_CONFIG(future)
+#include <private/qasyncfileio_p.h>
+#endif
 
 #include <qtest.h>
 
@@ -107,6 +110,9 @@ private slots:
     void readBigFile_posix();
     void readBigFile_Win32();
 
+    void loadManySmallFiles_data();
+    void loadManySmallFiles();
+
 private:
     void readBigFile_data(BenchmarkType type, QIODevice::OpenModeFlag t, QIODevice::OpenModeFlag b);
     void readBigFile();
@@ -115,7 +121,7 @@ private:
     void createFile();
     void fillFile(int factor=FACTOR);
     void removeFile();
-    void createSmallFiles();
+    void createSmallFiles(int count = 1000);
     void removeSmallFiles();
     QString filename;
     QString tmpDirName;
@@ -562,14 +568,14 @@ void tst_qfile::readSmallFiles_data(BenchmarkType type, QIODevice::OpenModeFlag
 
 }
 
-void tst_qfile::createSmallFiles()
+void tst_qfile::createSmallFiles(int count)
 {
     QDir dir = QDir::temp();
     dir.mkdir("tst");
     dir.cd("tst");
     tmpDirName = dir.absolutePath();
 
-    for (int i = 0; i < 1000; ++i) {
+    for (int i = 0; i < count; ++i) {
         QFile f(tmpDirName + QLatin1Char('/') + QString::number(i));
         f.open(QIODevice::WriteOnly);
         f.seek(511);
@@ -702,6 +708,60 @@ void tst_qfile::readSmallFiles()
     delete[] buffer;
 }
 
+void tst_qfile::loadManySmallFiles_data()
+{
+    QTest::addColumn<QString>("method");
+
+    QTest::newRow("QFile") << QStringLiteral("QFile");
+#if QT_CONFIG(future)
+    QTest::newRow("QAsyncFileIO-threadpool") << QStringLiteral("threadpool");
+    QTest::newRow("QAsyncFileIO-io_uring") << QStringLiteral("io_uring");
+#endif
+}
+
+// Loads 10000 files of 512 bytes each, the way an application reads its
+// icons or translation fragments at startup.
+void tst_qfile::loadManySmallFiles()
+{
+    QFETCH(QString, method);
+
+    createSmallFiles(10000);
+    QStringList fileNames;
+    for (const QString &file : QDir(tmpDirName).entryList(QDir::Files))
+        fileNames.append(tmpDirName + QLatin1Char('/') + file);
+
+    if (method == QLatin1String("QFile")) {
+        QBENCHMARK {
+            qint64 total = 0;
+            for (const QString &fileName : qAsConst(fileNames)) {
+                QFile file(fileName);
+                file.open(QIODevice::ReadOnly);
+                total += file.readAll().size();
+            }
+            QCOMPARE(total, qint64(fileNames.size()) * 512);
+        }
+    }
+#if QT_CONFIG(future)
+    else {
+        QAsyncFileIO io(method == QLatin1String("io_uring") ? QAsyncFileIO::IoUringBackend
+                                                            : QAsyncFileIO::ThreadPoolBackend);
+        if (method == QLatin1String("io_uring") && io.backend() != QAsyncFileIO::IoUringBackend) {
+            removeSmallFiles();
+            QSKIP("io_uring is not available.");
+        }
+        QBENCHMARK {
+            qint64 total = 0;
+            const QList<QFuture<QByteArray>> futures = io.readFiles(fileNames);
+            for (const QFuture<QByteArray> &future : futures)
+                total += future.result().size();
+            QCOMPARE(total, qint64(fileNames.size()) * 512);
+        }
+    }
+#endif
+
+    removeSmallFiles();
+}
+
 QTEST_MAIN(tst_qfile)
 
 #include "main.moc"
@@ -0,0 +1,151 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QDirIterator>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QSet>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QTimer>
+#include <QtCore/private/qrecursivefilesystemwatcher_p.h>
+
+class tst_bench_QFileSystemWatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void addEveryDirectory();
+    void addRecursive_data() { backends(); }
+    void addRecursive();
+    void eventThroughput_data() { backends(); }
+    void eventThroughput();
+
+private:
+    void backends();
+    static bool requireBackend(const QRecursiveFileSystemWatcher &watcher,
+                               QRecursiveFileSystemWatcher::Backend backend);
+
+    QTemporaryDir tempDir;
+    QStringList directories;
+};
+
+// 20 * 20 * 10 leaf directories, 4620 in all
+void tst_bench_QFileSystemWatcher::initTestCase()
+{
+    QVERIFY(tempDir.isValid());
+    QDir root(tempDir.path());
+    for (int i = 0; i < 20; ++i) {
+        for (int j = 0; j < 20; ++j) {
+            for (int k = 0; k < 10; ++k)
+                QVERIFY(root.mkpath(QString::asprintf("%d/%d/%d", i, j, k)));
+        }
+    }
+    QDirIterator it(tempDir.path(), QDir::Dirs | QDir::NoDotAndDotDot,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext())
+        directories.append(it.next());
+    directories.append(tempDir.path());
+}
+
+void tst_bench_QFileSystemWatcher::backends()
+{
+    QTest::addColumn<QRecursiveFileSystemWatcher::Backend>("backend");
+    QTest::newRow("inotify") << QRecursiveFileSystemWatcher::InotifyBackend;
+    QTest::newRow("fanotify") << QRecursiveFileSystemWatcher::FanotifyBackend;
+}
+
+bool tst_bench_QFileSystemWatcher::requireBackend(const QRecursiveFileSystemWatcher &watcher,
+                                                  QRecursiveFileSystemWatcher::Backend backend)
+{
+    return watcher.isValid() && watcher.backend() == backend;
+}
+
+void tst_bench_QFileSystemWatcher::addEveryDirectory()
+{
+    QBENCHMARK {
+        QFileSystemWatcher watcher;
+        QVERIFY(watcher.addPaths(directories).isEmpty());
+    }
+}
+
+void tst_bench_QFileSystemWatcher::addRecursive()
+{
+    QFETCH(QRecursiveFileSystemWatcher::Backend, backend);
+
+    QBENCHMARK {
+        QRecursiveFileSystemWatcher watcher(backend);
+        QVERIFY(watcher.addPath(tempDir.path()));
+        if (!requireBackend(watcher, backend))
+            QSKIP("Backend not available");
+        QCOMPARE(watcher.watchedDirectoryCount(), directories.size());
+    }
+}
+
+// Creates a file in every leaf directory and waits until all of them have
+// been reported.
+void tst_bench_QFileSystemWatcher::eventThroughput()
+{
+    QFETCH(QRecursiveFileSystemWatcher::Backend, backend);
+
+    QRecursiveFileSystemWatcher watcher(backend);
+    QVERIFY(watcher.addPath(tempDir.path()));
+    if (!requireBackend(watcher, backend))
+        QSKIP("Backend not available");
+    watcher.setDebounceInterval(10);
+
+    QSet<QString> pending;
+    QEventLoop loop;
+    connect(&watcher, &QRecursiveFileSystemWatcher::pathsChanged,
+            &loop, [&](const QStringList &paths) {
+        for (const QString &path : paths)
+            pending.remove(path);
+        if (pending.isEmpty())
+            loop.quit();
+    });
+
+    int round = 0;
+    QBENCHMARK {
+        const QString name = QLatin1String("/file") + QString::number(round++);
+        for (const QString &directory : qAsConst(directories)) {
+            if (directory.count(QLatin1Char('/')) == tempDir.path().count(QLatin1Char('/')) + 3)
+                pending.insert(directory + name);
+        }
+        for (const QString &path : qAsConst(pending)) {
+            QFile file(path);
+            QVERIFY(file.open(QIODevice::WriteOnly));
+        }
+        QTimer::singleShot(10000, &loop, [&] { loop.exit(1); });
+        QCOMPARE(loop.exec(), 0);
+    }
+}
+
+QTEST_MAIN(tst_bench_QFileSystemWatcher)
+#include "main.moc"
@@ -41,6 +41,11 @@ private slots:
     void read_old_data() { read_data(); }
     void peekAndRead();
     void peekAndRead_data() { read_data(); }
+    void sequentialScan_data();
+    void sequentialScan();
+    void readLines();
+    void readAllSequential_data();
+    void readAllSequential();
     //void read_new();
     //void read_new_data() { read_data(); }
 private:
@@ -119,6 +124,113 @@ void tst_qiodevice::peekAndRead()
     }
 }
 
+void tst_qiodevice::sequentialScan_data()
+{
+    QTest::addColumn<int>("blockSize");
+    QTest::newRow("64") << 64;
+    QTest::newRow("1k") << 1024;
+    QTest::newRow("4k") << 4 * 1024;
+    QTest::newRow("64k") << 64 * 1024;
+}
+
+// Reads a 64 MB file front to back in small blocks, the access pattern
+// that the growing read buffer and the readahead hint are for.
+void tst_qiodevice::sequentialScan()
+{
+    QFETCH(int, blockSize);
+
+    const qint64 size = 64 * 1024 * 1024;
+    const QString name = QLatin1String("tmpscan");
+    {
+        QFile file(name);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QVERIFY(file.resize(size));
+    }
+
+    QByteArray block(blockSize, Qt::Uninitialized);
+    QBENCHMARK {
+        QFile file(name);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        qint64 total = 0;
+        qint64 n;
+        while ((n = file.read(block.data(), blockSize)) > 0)
+            total += n;
+        QCOMPARE(total, size);
+    }
+
+    QFile::remove(name);
+}
+
+void tst_qiodevice::readLines()
+{
+    const QString name = QLatin1String("tmplines");
+    {
+        QFile file(name);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        const QByteArray line(79, 'x');
+        for (int i = 0; i < 500000; ++i)
+            file.write(line + '\n');
+    }
+
+    QBENCHMARK {
+        QFile file(name);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        char buffer[128];
+        int lines = 0;
+        while (file.readLine(buffer, sizeof(buffer)) > 0)
+            ++lines;
+        QCOMPARE(lines, 500000);
+    }
+
+    QFile::remove(name);
+}
+
+// A sequential device that produces size bytes as fast as they are read.
+class GeneratorDevice : public QIODevice
+{
+public:
+    explicit GeneratorDevice(qint64 size) : remaining(size) {}
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override { return remaining + QIODevice::bytesAvailable(); }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        const qint64 n = qMin(maxSize, remaining);
+        if (n == 0)
+            return -1;
+        memset(data, 'x', size_t(n));
+        remaining -= n;
+        return n;
+    }
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    qint64 remaining;
+};
+
+void tst_qiodevice::readAllSequential_data()
+{
+    QTest::addColumn<qint64>("size");
+    QTest::newRow("16k") << qint64(16 * 1024);
+    QTest::newRow("1M") << qint64(1024 * 1024);
+    QTest::newRow("64M") << qint64(64 * 1024 * 1024);
+}
+
+void tst_qiodevice::readAllSequential()
+{
+    QFETCH(qint64, size);
+
+    QBENCHMARK {
+        GeneratorDevice device(size);
+        device.open(QIODevice::ReadOnly);
+        // have something in the read buffer, as after readyRead()
+        device.peek(1);
+        QCOMPARE(device.readAll().size(), size);
+    }
+}
+
 QTEST_MAIN(tst_qiodevice)
 
 #include "main.moc"
@@ -0,0 +1,135 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QLoggingCategory>
+#include <qtest.h>
+
+#include <memory>
+#include <vector>
+
+class tst_QLoggingCategory : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void setFilterRules_data();
+    void setFilterRules();
+    void createCategories();
+
+private:
+    std::vector<QByteArray> names;
+    std::vector<std::unique_ptr<QLoggingCategory>> categories;
+};
+
+static const int CategoryCount = 10000;
+
+void tst_QLoggingCategory::initTestCase()
+{
+    // module.component.subcomponent names, as an application with many
+    // categories has them
+    names.reserve(CategoryCount);
+    for (int i = 0; i < CategoryCount; ++i) {
+        names.push_back("app.module" + QByteArray::number(i % 50)
+                        + ".component" + QByteArray::number(i % 200)
+                        + ".item" + QByteArray::number(i));
+    }
+    for (const QByteArray &name : names)
+        categories.push_back(std::make_unique<QLoggingCategory>(name.constData()));
+}
+
+void tst_QLoggingCategory::cleanupTestCase()
+{
+    QLoggingCategory::setFilterRules(QString());
+    categories.clear();
+}
+
+void tst_QLoggingCategory::setFilterRules_data()
+{
+    QTest::addColumn<int>("ruleCount");
+
+    QTest::newRow("1 rule") << 1;
+    QTest::newRow("10 rules") << 10;
+    QTest::newRow("100 rules") << 100;
+}
+
+void tst_QLoggingCategory::setFilterRules()
+{
+    QFETCH(int, ruleCount);
+
+    QString rules[2];
+    for (int variant = 0; variant < 2; ++variant) {
+        for (int i = 0; i < ruleCount; ++i) {
+            switch (i % 4) {
+            case 0:
+                rules[variant] += QStringLiteral("app.module%1.*=%2\n")
+                        .arg(i % 50).arg(variant ? "true" : "false");
+                break;
+            case 1:
+                rules[variant] += QStringLiteral("*.item%1.debug=%2\n")
+                        .arg(i).arg(variant ? "false" : "true");
+                break;
+            case 2:
+                rules[variant] += QStringLiteral("app.module%1.component%2.item%3=false\n")
+                        .arg(i % 50).arg(i % 200).arg(i);
+                break;
+            case 3:
+                rules[variant] += QStringLiteral("*component%1*.warning=%2\n")
+                        .arg(i % 200).arg(variant ? "true" : "false");
+                break;
+            }
+        }
+    }
+
+    // every reload re-evaluates all categories
+    int variant = 0;
+    QBENCHMARK {
+        QLoggingCategory::setFilterRules(rules[variant]);
+        variant ^= 1;
+    }
+}
+
+void tst_QLoggingCategory::createCategories()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("app.module1.*=false\n"
+                                                    "*.item42.debug=true\n"
+                                                    "*component7*.warning=false\n"));
+    QBENCHMARK {
+        std::vector<std::unique_ptr<QLoggingCategory>> created;
+        created.reserve(names.size());
+        for (const QByteArray &name : names)
+            created.push_back(std::make_unique<QLoggingCategory>(name.constData()));
+    }
+}
+
+QTEST_MAIN(tst_QLoggingCategory)
+
+#include "main.moc"
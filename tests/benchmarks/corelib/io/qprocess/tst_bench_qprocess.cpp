@@ -30,16 +30,50 @@
 #include <QSignalSpy>
 #include <QtCore/QProcess>
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTemporaryDir>
+
+#include <vector>
+#ifdef Q_OS_UNIX
+#include <QtCore/private/qpipeforwarder_p.h>
+#endif
 
 class tst_QProcess : public QObject
 {
     Q_OBJECT
 
 private slots:
+    void initTestCase();
 
     void echoTest_performance();
+    void readOutput_data();
+    void readOutput();
+    void forwardOutput_data();
+    void forwardOutput();
+    void startLatency_data();
+    void startLatency();
+
+private:
+    QTemporaryDir tempDir;
+    QString dataFile;
+    QString cat;
 };
 
+static const qint64 dataSize = 256 * 1024 * 1024;
+
+void tst_QProcess::initTestCase()
+{
+    QVERIFY(tempDir.isValid());
+    cat = QStandardPaths::findExecutable("cat");
+
+    QFile file(tempDir.filePath("data"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    const QByteArray block(1024 * 1024, 'q');
+    for (qint64 i = 0; i < dataSize; i += block.size())
+        QCOMPARE(file.write(block), qint64(block.size()));
+    dataFile = file.fileName();
+}
+
 void tst_QProcess::echoTest_performance()
 {
     QProcess process;
@@ -85,5 +119,142 @@ void tst_QProcess::echoTest_performance()
     QVERIFY(process.waitForFinished());
 }
 
+void tst_QProcess::readOutput_data()
+{
+    QTest::addColumn<bool>("unbuffered");
+    QTest::newRow("buffered") << false;
+    QTest::newRow("unbuffered") << true;
+}
+
+// Reads a lot of output in large blocks, which unbuffered mode reads
+// straight into the caller's buffer.
+void tst_QProcess::readOutput()
+{
+    QFETCH(bool, unbuffered);
+    if (cat.isEmpty())
+        QSKIP("This benchmark requires cat");
+
+    QByteArray buffer(1024 * 1024, Qt::Uninitialized);
+    QBENCHMARK {
+        QProcess process;
+        process.setStandardInputFile(dataFile);
+        process.start(cat, {}, unbuffered ? QIODevice::ReadOnly | QIODevice::Unbuffered
+                                          : QIODevice::ReadOnly);
+        QVERIFY(process.waitForStarted());
+
+        qint64 total = 0;
+        forever {
+            const qint64 n = process.read(buffer.data(), buffer.size());
+            if (n > 0)
+                total += n;
+            else if (n < 0 || !process.waitForReadyRead(-1))
+                break;
+        }
+        QVERIFY(process.state() == QProcess::NotRunning || process.waitForFinished());
+        QCOMPARE(total, dataSize);
+    }
+}
+
+void tst_QProcess::forwardOutput_data()
+{
+    QTest::addColumn<int>("method");
+    QTest::newRow("read-write") << 0;
+#ifdef Q_OS_UNIX
+    QTest::newRow("QPipeForwarder") << 1;
+#endif
+    QTest::newRow("setStandardOutputProcess") << 2;
+}
+
+// Moves the output of one process to another, through the parent with
+// readAll() and write(), with QPipeForwarder, or by connecting the two
+// processes' pipes directly.
+void tst_QProcess::forwardOutput()
+{
+    QFETCH(int, method);
+    if (cat.isEmpty())
+        QSKIP("This benchmark requires cat");
+
+    QBENCHMARK {
+        QProcess producer;
+        QProcess consumer;
+        producer.setStandardInputFile(dataFile);
+        consumer.setStandardOutputFile(QProcess::nullDevice());
+        if (method == 2)
+            producer.setStandardOutputProcess(&consumer);
+        producer.start(cat, {});
+        consumer.start(cat, {});
+        QVERIFY(producer.waitForStarted());
+        QVERIFY(consumer.waitForStarted());
+
+        if (method == 0) {
+            forever {
+                if (producer.bytesAvailable() == 0 && !producer.waitForReadyRead(-1))
+                    break;
+                consumer.write(producer.readAll());
+                while (consumer.bytesToWrite() > 4 * 1024 * 1024)
+                    QVERIFY(consumer.waitForBytesWritten(-1));
+            }
+            while (consumer.bytesToWrite() > 0)
+                QVERIFY(consumer.waitForBytesWritten(-1));
+            consumer.closeWriteChannel();
+        } else if (method == 1) {
+#ifdef Q_OS_UNIX
+            QPipeForwarder forwarder;
+            QVERIFY(forwarder.setSource(&producer));
+            QVERIFY(forwarder.addSink(&consumer));
+            QVERIFY(forwarder.start());
+            QVERIFY(forwarder.waitForFinished(-1));
+            QCOMPARE(forwarder.bytesForwarded(), dataSize);
+#endif
+        }
+
+        QVERIFY(producer.state() == QProcess::NotRunning || producer.waitForFinished());
+        QVERIFY(consumer.waitForFinished());
+    }
+}
+
+void tst_QProcess::startLatency_data()
+{
+    QTest::addColumn<bool>("searchPath");
+    QTest::addColumn<int>("environmentSize");
+    QTest::addColumn<int>("heapMegabytes");
+
+    QTest::newRow("absolute path") << false << 0 << 0;
+    QTest::newRow("PATH lookup") << true << 0 << 0;
+    QTest::newRow("custom environment") << false << 200 << 0;
+    QTest::newRow("large parent") << false << 0 << 512;
+}
+
+// Starts a short-lived program over and over. The cost of starting it
+// from an application using a lot of memory is mostly that of fork().
+void tst_QProcess::startLatency()
+{
+    QFETCH(bool, searchPath);
+    QFETCH(int, environmentSize);
+    QFETCH(int, heapMegabytes);
+
+    const QString program = QStandardPaths::findExecutable("true");
+    if (program.isEmpty())
+        QSKIP("This benchmark requires true");
+
+    // touch every page, so that it has to be mapped in the child as well
+    const std::vector<char> heap(size_t(heapMegabytes) << 20, 1);
+
+    QProcess process;
+    if (environmentSize) {
+        QProcessEnvironment environment;
+        for (int i = 0; i < environmentSize; ++i)
+            environment.insert(QString::fromLatin1("QT_BENCH_VARIABLE_%1").arg(i), QString(64, u'x'));
+        process.setProcessEnvironment(environment);
+    }
+
+    QBENCHMARK {
+        process.start(searchPath ? QStringLiteral("true") : program, {});
+        QVERIFY(process.waitForFinished());
+        QCOMPARE(process.exitCode(), 0);
+    }
+    QVERIFY(heap.empty() || heap.back() == 1);
+}
+
 QTEST_MAIN(tst_QProcess)
 #include "tst_bench_qprocess.moc"
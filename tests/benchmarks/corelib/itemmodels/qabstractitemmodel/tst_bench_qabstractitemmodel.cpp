@@ -0,0 +1,146 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QAbstractItemModel>
+
+// Either a flat list, or a list of top-level rows with children each
+class Model : public QAbstractItemModel
+{
+public:
+    Model(int topLevelRows, int childRows)
+        : topLevelRows(topLevelRows), childRows(childRows ? topLevelRows : 0, childRows) {}
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override
+    {
+        if (row < 0 || column != 0 || row >= rowCount(parent))
+            return QModelIndex();
+        return createIndex(row, column, quintptr(parent.isValid() ? parent.row() + 1 : 0));
+    }
+
+    QModelIndex parent(const QModelIndex &child) const override
+    {
+        if (!child.isValid() || child.internalId() == 0)
+            return QModelIndex();
+        return createIndex(int(child.internalId() - 1), 0, quintptr(0));
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        if (!parent.isValid())
+            return topLevelRows;
+        return parent.internalId() == 0 ? childRows.value(parent.row()) : 0;
+    }
+
+    int columnCount(const QModelIndex & = QModelIndex()) const override { return 1; }
+
+    QVariant data(const QModelIndex &, int) const override { return QVariant(); }
+
+    void insert(const QModelIndex &parent, int row, int count)
+    {
+        beginInsertRows(parent, row, row + count - 1);
+        if (parent.isValid())
+            childRows[parent.row()] += count;
+        else
+            topLevelRows += count;
+        endInsertRows();
+    }
+
+    void remove(const QModelIndex &parent, int row, int count)
+    {
+        beginRemoveRows(parent, row, row + count - 1);
+        if (parent.isValid())
+            childRows[parent.row()] -= count;
+        else
+            topLevelRows -= count;
+        endRemoveRows();
+    }
+
+private:
+    int topLevelRows;
+    QList<int> childRows;
+};
+
+class tst_QAbstractItemModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insertRows_data();
+    void insertRows();
+};
+
+void tst_QAbstractItemModel::insertRows_data()
+{
+    QTest::addColumn<int>("parents");
+    QTest::addColumn<int>("position"); // in percent of the rows of the parent
+
+    QTest::newRow("flat, start") << 0 << 0;
+    QTest::newRow("flat, middle") << 0 << 50;
+    QTest::newRow("flat, end") << 0 << 100;
+    QTest::newRow("tree, start") << 100 << 0;
+    QTest::newRow("tree, end") << 100 << 100;
+}
+
+// Inserts and removes rows one at a time in a model with 100k persistent
+// indexes, like a view with a large selection does.
+void tst_QAbstractItemModel::insertRows()
+{
+    QFETCH(int, parents);
+    QFETCH(int, position);
+    const int persistentCount = 100000;
+
+    Model model(parents ? parents : persistentCount, parents ? persistentCount / parents : 0);
+    QList<QPersistentModelIndex> persistent;
+    persistent.reserve(persistentCount);
+    if (parents) {
+        for (int p = 0; p < parents; ++p) {
+            const QModelIndex parent = model.index(p, 0);
+            for (int row = 0; row < model.rowCount(parent); ++row)
+                persistent.append(model.index(row, 0, parent));
+        }
+    } else {
+        for (int row = 0; row < persistentCount; ++row)
+            persistent.append(model.index(row, 0));
+    }
+    QCOMPARE(persistent.size(), persistentCount);
+
+    const QModelIndex parent = parents ? model.index(parents / 2, 0) : QModelIndex();
+    const int row = model.rowCount(parent) * position / 100;
+    const QPersistentModelIndex last = persistent.constLast();
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i)
+            model.insert(parent, row, 1);
+        for (int i = 0; i < 100; ++i)
+            model.remove(parent, row, 1);
+    }
+    QCOMPARE(last, model.index(model.rowCount(last.parent()) - 1, 0, last.parent()));
+}
+
+QTEST_MAIN(tst_QAbstractItemModel)
+#include "tst_bench_qabstractitemmodel.moc"
@@ -0,0 +1,152 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QItemSelectionModel>
+
+class TableModel : public QAbstractTableModel
+{
+public:
+    explicit TableModel(int rows) : rows(rows) {}
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : rows;
+    }
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : 4;
+    }
+
+    QVariant data(const QModelIndex &, int) const override
+    {
+        return QVariant();
+    }
+
+private:
+    const int rows;
+};
+
+class tst_QItemSelectionModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void selectRows_data();
+    void selectRows();
+    void isSelected_data();
+    void isSelected();
+    void toggleRows_data();
+    void toggleRows();
+
+private:
+    void addRowCounts();
+};
+
+void tst_QItemSelectionModel::addRowCounts()
+{
+    QTest::addColumn<int>("rows");
+
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+}
+
+void tst_QItemSelectionModel::selectRows_data()
+{
+    addRowCounts();
+}
+
+// Selects every other row, one at a time, like clicking them with Ctrl held
+void tst_QItemSelectionModel::selectRows()
+{
+    QFETCH(int, rows);
+
+    TableModel model(rows);
+    QBENCHMARK {
+        QItemSelectionModel selectionModel(&model);
+        for (int row = 0; row < rows; row += 2)
+            selectionModel.select(model.index(row, 0), QItemSelectionModel::Select | QItemSelectionModel::Rows);
+        QCOMPARE(selectionModel.selection().count(), rows / 2);
+    }
+}
+
+void tst_QItemSelectionModel::isSelected_data()
+{
+    addRowCounts();
+}
+
+// Looks up every item of a fragmented selection, like painting a view does
+void tst_QItemSelectionModel::isSelected()
+{
+    QFETCH(int, rows);
+
+    TableModel model(rows);
+    QItemSelectionModel selectionModel(&model);
+    QItemSelection selection;
+    for (int row = 0; row < rows; row += 2)
+        selection.select(model.index(row, 0), model.index(row, 3));
+    selectionModel.select(selection, QItemSelectionModel::Select);
+
+    QBENCHMARK {
+        int selected = 0;
+        for (int row = 0; row < rows; ++row) {
+            for (int column = 0; column < 4; ++column)
+                selected += selectionModel.isSelected(model.index(row, column));
+        }
+        QCOMPARE(selected, rows * 2);
+    }
+}
+
+void tst_QItemSelectionModel::toggleRows_data()
+{
+    addRowCounts();
+}
+
+// Toggles single items inside and outside of the selected rows
+void tst_QItemSelectionModel::toggleRows()
+{
+    QFETCH(int, rows);
+
+    TableModel model(rows);
+    QItemSelection selection;
+    for (int row = 0; row < rows; row += 2)
+        selection.select(model.index(row, 0), model.index(row, 3));
+
+    QBENCHMARK {
+        QItemSelectionModel selectionModel(&model);
+        selectionModel.select(selection, QItemSelectionModel::Select);
+        for (int row = 0; row < rows; row += 5)
+            selectionModel.select(model.index(row, 1), QItemSelectionModel::Toggle);
+        QVERIFY(!selectionModel.isSelected(model.index(0, 1)));
+        QVERIFY(selectionModel.isSelected(model.index(5, 1)));
+    }
+}
+
+QTEST_MAIN(tst_QItemSelectionModel)
+#include "tst_bench_qitemselectionmodel.moc"
@@ -0,0 +1,220 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QSortFilterProxyModel>
+#include <QStringListModel>
+#include <QThreadPool>
+
+// A large flat model whose rows are not in sorted order
+class LargeModel : public QAbstractListModel
+{
+public:
+    explicit LargeModel(int rows) : rows(rows) {}
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : rows;
+    }
+
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        if (role != Qt::DisplayRole)
+            return QVariant();
+        return QString::number(qint64(index.row()) * 7919 % rows);
+    }
+
+private:
+    const int rows;
+};
+
+// A flat model whose values are updated one row at a time
+class UpdatingModel : public QAbstractListModel
+{
+public:
+    explicit UpdatingModel(int rows) : values(rows, 0) {}
+
+    using QAbstractItemModel::beginDataChangedBatch;
+    using QAbstractItemModel::endDataChangedBatch;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : int(values.size());
+    }
+
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        const int value = values.at(index.row());
+        if (role == Qt::DisplayRole)
+            return QString::number(value % 1000).rightJustified(3, u'0');
+        if (role == Qt::ToolTipRole)
+            return value;
+        return QVariant();
+    }
+
+    void update(int row, int value, int role)
+    {
+        values[row] = value;
+        const QModelIndex changed = index(row);
+        postDataChanged(changed, changed, { role });
+    }
+
+private:
+    QList<int> values;
+};
+
+class tst_QSortFilterProxyModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void typeFilter_data();
+    void typeFilter();
+    void sort_data();
+    void sort();
+    void updateRows_data();
+    void updateRows();
+};
+
+static const int sourceRows = 1000000;
+
+void tst_QSortFilterProxyModel::typeFilter_data()
+{
+    QTest::addColumn<bool>("incremental");
+    QTest::addColumn<bool>("parallel");
+
+    // Without incremental and layout change filtering, each of the many
+    // ranges of rows that every key press filters out is removed separately,
+    // which takes minutes
+    QTest::newRow("incremental") << true << false;
+    QTest::newRow("incremental, parallel") << true << true;
+}
+
+// Types a search string and deletes it again, filtering the proxy model
+// after each key press.
+void tst_QSortFilterProxyModel::typeFilter()
+{
+    QFETCH(bool, incremental);
+    QFETCH(bool, parallel);
+
+    LargeModel model(sourceRows);
+    QSortFilterProxyModel proxy;
+    proxy.setIncrementalFilteringEnabled(incremental);
+    proxy.setLayoutChangeFilteringEnabled(incremental);
+    proxy.setParallelSortFilterEnabled(parallel);
+    proxy.setSourceModel(&model);
+    QCOMPARE(proxy.rowCount(), sourceRows);
+
+    const QString search = QStringLiteral("1234");
+    QBENCHMARK {
+        for (int i = 1; i <= search.size(); ++i)
+            proxy.setFilterFixedString(search.left(i));
+        QCOMPARE(proxy.rowCount(), 300);
+        for (int i = search.size() - 1; i >= 0; --i)
+            proxy.setFilterFixedString(search.left(i));
+        QCOMPARE(proxy.rowCount(), sourceRows);
+    }
+}
+
+void tst_QSortFilterProxyModel::sort_data()
+{
+    QTest::addColumn<bool>("parallel");
+    QTest::addColumn<bool>("stringList");
+
+    QTest::newRow("serial") << false << false;
+    QTest::newRow("parallel") << true << false;
+    QTest::newRow("QStringListModel") << false << true;
+}
+
+void tst_QSortFilterProxyModel::sort()
+{
+    QFETCH(bool, parallel);
+    QFETCH(bool, stringList);
+
+    LargeModel model(sourceRows);
+    // the same data, which QStringListModel hands out without calling data()
+    QStringListModel stringListModel;
+    if (stringList) {
+        QStringList strings;
+        strings.reserve(sourceRows);
+        for (int row = 0; row < sourceRows; ++row)
+            strings.append(model.index(row).data().toString());
+        stringListModel.setStringList(strings);
+        stringListModel.setDirectColumnDataEnabled(true);
+    }
+    QSortFilterProxyModel proxy;
+    proxy.setParallelSortFilterEnabled(parallel);
+    proxy.setSourceModel(stringList ? static_cast<QAbstractItemModel *>(&stringListModel) : &model);
+    QCOMPARE(proxy.rowCount(), sourceRows);
+
+    QBENCHMARK {
+        proxy.sort(0);
+        proxy.sort(-1);
+    }
+}
+
+void tst_QSortFilterProxyModel::updateRows_data()
+{
+    QTest::addColumn<bool>("batched");
+    QTest::addColumn<int>("role");
+
+    QTest::newRow("one by one") << false << int(Qt::DisplayRole);
+    QTest::newRow("batched") << true << int(Qt::DisplayRole);
+    QTest::newRow("one by one, other role") << false << int(Qt::ToolTipRole);
+    QTest::newRow("batched, other role") << true << int(Qt::ToolTipRole);
+}
+
+// Updates every row of a sorted and filtered model, the way a model
+// refreshing its data from somewhere else does.
+void tst_QSortFilterProxyModel::updateRows()
+{
+    QFETCH(bool, batched);
+    QFETCH(int, role);
+
+    const int rows = 10000;
+    UpdatingModel model(rows);
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    proxy.setFilterRegularExpression(QStringLiteral("[^9]$"));
+    proxy.sort(0);
+
+    int generation = 0;
+    QBENCHMARK {
+        ++generation;
+        if (batched)
+            model.beginDataChangedBatch();
+        for (int row = 0; row < rows; ++row)
+            model.update(row, row * 7919 + generation, role);
+        if (batched)
+            model.endDataChangedBatch();
+    }
+}
+
+QTEST_MAIN(tst_QSortFilterProxyModel)
+
+#include "tst_bench_qsortfilterproxymodel.moc"
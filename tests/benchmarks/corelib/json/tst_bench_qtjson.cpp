@@ -45,6 +45,8 @@ private Q_SLOTS:
     void parseNumbers();
     void parseJson();
     void parseJsonToVariant();
+    void parseJsonLines_data();
+    void parseJsonLines();
 
     void jsonObjectInsert();
     void variantMapInsert();
@@ -117,6 +119,40 @@ void BenchmarkQtJson::parseJsonToVariant()
     }
 }
 
+void BenchmarkQtJson::parseJsonLines_data()
+{
+    QTest::addColumn<bool>("parallel");
+    QTest::newRow("serial") << false;
+    QTest::newRow("parallel") << true;
+}
+
+void BenchmarkQtJson::parseJsonLines()
+{
+    QFETCH(bool, parallel);
+
+    QByteArray testJson;
+    for (int i = 0; i < 100000; ++i) {
+        testJson += "{\"id\": " + QByteArray::number(i)
+                + ", \"name\": \"record\", \"values\": [1.5, 2.5, 3.5], \"valid\": true}\n";
+    }
+
+    if (parallel) {
+        QBENCHMARK {
+            QList<QJsonValue> values = QJsonDocument::fromJsonLines(testJson);
+            QCOMPARE(values.size(), 100000);
+        }
+    } else {
+        QBENCHMARK {
+            QList<QJsonValue> values;
+            for (const QByteArray &line : testJson.split('\n')) {
+                if (!line.isEmpty())
+                    values.append(QJsonDocument::fromJson(line).object());
+            }
+            QCOMPARE(values.size(), 100000);
+        }
+    }
+}
+
 void BenchmarkQtJson::jsonObjectInsert()
 {
     QJsonObject object;
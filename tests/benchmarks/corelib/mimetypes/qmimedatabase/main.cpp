@@ -28,6 +28,8 @@
 
 #include <QTest>
 #include <QMimeDatabase>
+#include <QTemporaryDir>
+#include <QThreadPool>
 
 class tst_QMimeDatabase: public QObject
 {
@@ -35,10 +37,44 @@ class tst_QMimeDatabase: public QObject
     Q_OBJECT
 
 private slots:
+    void initTestCase();
     void inheritsPerformance();
     void benchMimeTypeForName();
+    void mimeTypeForFileThreaded_data();
+    void mimeTypeForFileThreaded();
+    void mimeTypeForData_data();
+    void mimeTypeForData();
+
+private:
+    QTemporaryDir tempDir;
+    QStringList files;
 };
 
+void tst_QMimeDatabase::initTestCase()
+{
+    QVERIFY(tempDir.isValid());
+    // a mix of files found by name, by contents, and by both
+    const struct {
+        const char *name;
+        QByteArray contents;
+    } samples[] = {
+        { "notes.txt", "Some plain text\n" },
+        { "image.png", QByteArray("\x89PNG\r\n\x1a\n\0\0\0\rIHDR", 16) },
+        { "source.c", "int main() { return 0; }\n" },
+        { "page.html", "<!DOCTYPE html><html></html>\n" },
+        { "archive.gz", QByteArray("\x1f\x8b\x08\0\0\0\0\0", 8) },
+        { "noextension", QByteArray("\x7f" "ELF\x02\x01\x01\0", 8) },
+        { "document.pdf", "%PDF-1.4\n" },
+        { "README", "Read me first\n" },
+    };
+    for (const auto &sample : samples) {
+        QFile file(tempDir.filePath(QLatin1String(sample.name)));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(sample.contents), qint64(sample.contents.size()));
+        files.append(file.fileName());
+    }
+}
+
 void tst_QMimeDatabase::inheritsPerformance()
 {
     // Check performance of inherits().
@@ -82,5 +118,71 @@ void tst_QMimeDatabase::benchMimeTypeForName()
     }
 }
 
+void tst_QMimeDatabase::mimeTypeForFileThreaded_data()
+{
+    QTest::addColumn<int>("threadCount");
+
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("32 threads") << 32;
+}
+
+// The same number of lookups in total, spread over a number of threads,
+// like file indexing workers do.
+void tst_QMimeDatabase::mimeTypeForFileThreaded()
+{
+    QFETCH(int, threadCount);
+    const int lookups = 8192;
+
+    QMimeDatabase db;
+    QVERIFY(db.mimeTypeForFile(files.first()).isValid()); // load the database
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount);
+    QBENCHMARK {
+        QAtomicInt invalid;
+        for (int t = 0; t < threadCount; ++t) {
+            pool.start([&, t] {
+                QMimeDatabase db;
+                for (int i = t; i < lookups; i += threadCount) {
+                    if (!db.mimeTypeForFile(files.at(i % files.size())).isValid())
+                        invalid.ref();
+                }
+            });
+        }
+        pool.waitForDone();
+        QCOMPARE(invalid.loadRelaxed(), 0);
+    }
+}
+
+void tst_QMimeDatabase::mimeTypeForData_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("png") << QByteArray("\x89PNG\r\n\x1a\n\0\0\0\rIHDR", 16)
+                         << QStringLiteral("image/png");
+    QTest::newRow("pdf") << QByteArray("%PDF-1.4\n") << QStringLiteral("application/pdf");
+    QTest::newRow("html") << QByteArray("<!DOCTYPE html><html></html>\n")
+                          << QStringLiteral("text/html");
+    // no rule matches, so every rule has to be tried
+    QTest::newRow("text") << QByteArray(4096, 'x') << QStringLiteral("text/plain");
+    QTest::newRow("binary") << QByteArray(4096, '\x02')
+                            << QStringLiteral("application/octet-stream");
+}
+
+// Content sniffing only, without a file name
+void tst_QMimeDatabase::mimeTypeForData()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QString, expected);
+
+    QMimeDatabase db;
+    QCOMPARE(db.mimeTypeForData(data).name(), expected);
+    QBENCHMARK {
+        db.mimeTypeForData(data);
+    }
+}
+
 QTEST_MAIN(tst_QMimeDatabase)
 #include "main.moc"
@@ -0,0 +1,9 @@
+TEMPLATE = lib
+CONFIG += plugin
+QT = core
+
+TARGET = benchplugin
+DESTDIR = ../bin
+HEADERS = benchplugin.h
+SOURCES = benchplugin.cpp
+OTHER_FILES = benchplugin.json
@@ -0,0 +1,3 @@
+TEMPLATE = subdirs
+SUBDIRS = plugin test
+test.depends = plugin
@@ -0,0 +1,105 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qtemporarydir.h>
+#include <private/qfactoryloader_p.h>
+
+#include "plugin/benchplugin.h"
+
+class tst_QFactoryLoader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void update_data();
+    void update();
+
+private:
+    QTemporaryDir tempDir;
+};
+
+static const int pluginCount = 300;
+static const char pluginSuffix[] = "/benchplugins";
+
+// Fills a plugin directory with copies of the benchmark plugin, like an
+// installation with many plugins of the same type.
+void tst_QFactoryLoader::initTestCase()
+{
+    QVERIFY(tempDir.isValid());
+    const QDir binDir(QCoreApplication::applicationDirPath() + QLatin1String("/bin"));
+    const QStringList plugins = binDir.entryList(QDir::Files);
+    QVERIFY2(!plugins.isEmpty(), "Unable to locate the benchmark plugin");
+    const QString plugin = binDir.filePath(plugins.first());
+
+    const QString pluginDir = tempDir.path() + QLatin1String(pluginSuffix);
+    QVERIFY(QDir().mkpath(pluginDir));
+    const QString suffix = QFileInfo(plugin).suffix();
+    for (int i = 0; i < pluginCount; ++i) {
+        const QString copy = QString::fromLatin1("%1/libbench%2.%3").arg(pluginDir).arg(i).arg(suffix);
+        QVERIFY(QFile::copy(plugin, copy));
+    }
+    QCoreApplication::setLibraryPaths(QStringList(tempDir.path()));
+}
+
+void tst_QFactoryLoader::update_data()
+{
+    QTest::addColumn<bool>("cached");
+
+    QTest::newRow("no cache") << false;
+    QTest::newRow("cache") << true;
+}
+
+// Measures finding the plugins of one type. With tracing enabled, the
+// same scan is reported by the QFactoryLoader_update_entry and
+// QFactoryLoader_update_exit tracepoints.
+void tst_QFactoryLoader::update()
+{
+    QFETCH(bool, cached);
+
+    if (cached) {
+        qunsetenv("QT_NO_PLUGIN_CACHE");
+        qputenv("QT_PLUGIN_CACHE_DIR", QFile::encodeName(tempDir.filePath("cache")));
+        // populate the cache
+        QFactoryLoader loader(BenchInterface_iid, QLatin1String(pluginSuffix));
+        QCOMPARE(loader.metaData().size(), pluginCount);
+    } else {
+        qputenv("QT_NO_PLUGIN_CACHE", "1");
+    }
+
+    QBENCHMARK {
+        QFactoryLoader loader(BenchInterface_iid, QLatin1String(pluginSuffix));
+        QCOMPARE(loader.metaData().size(), pluginCount);
+    }
+}
+
+QTEST_MAIN(tst_QFactoryLoader)
+#include "tst_bench_qfactoryloader.moc"
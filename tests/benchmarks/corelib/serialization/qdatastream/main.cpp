@@ -0,0 +1,133 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QBuffer>
+#include <QDataStream>
+#include <qtest.h>
+
+class tst_QDataStream : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void writeDoubleList_data();
+    void writeDoubleList();
+    void readDoubleList_data();
+    void readDoubleList();
+    void readIntList_data();
+    void readIntList();
+};
+
+static void addByteOrders()
+{
+    QTest::addColumn<QDataStream::ByteOrder>("byteOrder");
+    QTest::newRow("big-endian") << QDataStream::BigEndian;
+    QTest::newRow("little-endian") << QDataStream::LittleEndian;
+}
+
+template <typename T>
+static QList<T> makeList()
+{
+    QList<T> list;
+    list.reserve(1000000);
+    for (int i = 0; i < 1000000; ++i)
+        list << T(i) / 3;
+    return list;
+}
+
+template <typename T>
+static QByteArray serialize(const QList<T> &list, QDataStream::ByteOrder byteOrder)
+{
+    QByteArray ba;
+    QDataStream stream(&ba, QIODevice::WriteOnly);
+    stream.setByteOrder(byteOrder);
+    stream << list;
+    return ba;
+}
+
+void tst_QDataStream::writeDoubleList_data()
+{
+    addByteOrders();
+}
+
+void tst_QDataStream::writeDoubleList()
+{
+    QFETCH(QDataStream::ByteOrder, byteOrder);
+    const QList<double> list = makeList<double>();
+    QByteArray ba;
+    ba.reserve(list.size() * sizeof(double) + sizeof(quint32));
+
+    QBENCHMARK {
+        QBuffer buffer(&ba);
+        buffer.open(QIODevice::WriteOnly);
+        QDataStream stream(&buffer);
+        stream.setByteOrder(byteOrder);
+        stream << list;
+    }
+}
+
+void tst_QDataStream::readDoubleList_data()
+{
+    addByteOrders();
+}
+
+void tst_QDataStream::readDoubleList()
+{
+    QFETCH(QDataStream::ByteOrder, byteOrder);
+    const QByteArray ba = serialize(makeList<double>(), byteOrder);
+
+    QBENCHMARK {
+        QDataStream stream(ba);
+        stream.setByteOrder(byteOrder);
+        QList<double> list;
+        stream >> list;
+    }
+}
+
+void tst_QDataStream::readIntList_data()
+{
+    addByteOrders();
+}
+
+void tst_QDataStream::readIntList()
+{
+    QFETCH(QDataStream::ByteOrder, byteOrder);
+    const QByteArray ba = serialize(makeList<qint32>(), byteOrder);
+
+    QBENCHMARK {
+        QDataStream stream(ba);
+        stream.setByteOrder(byteOrder);
+        QList<qint32> list;
+        stream >> list;
+    }
+}
+
+QTEST_MAIN(tst_QDataStream)
+
+#include "main.moc"
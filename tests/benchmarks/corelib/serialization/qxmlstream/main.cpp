@@ -0,0 +1,134 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QBuffer>
+#include <QXmlStreamReader>
+#include <qtest.h>
+
+class tst_QXmlStreamReader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void readText_data();
+    void readText();
+    void readAttributes_data();
+    void readAttributes();
+
+private:
+    QByteArray textDocument;
+    QByteArray attributeDocument;
+};
+
+void tst_QXmlStreamReader::initTestCase()
+{
+    // character data dominated, with indentation between the elements
+    textDocument = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<feed>\n";
+    for (int i = 0; i < 20000; ++i) {
+        textDocument += "    <entry id=\"" + QByteArray::number(i) + "\">\n"
+                        "        <title>Entry number " + QByteArray::number(i) + "</title>\n"
+                        "        <summary>Lorem ipsum dolor sit amet, consectetur adipiscing "
+                        "elit, sed do eiusmod tempor incididunt ut labore et dolore magna "
+                        "aliqua &amp; more.</summary>\n"
+                        "    </entry>\n";
+    }
+    textDocument += "</feed>\n";
+
+    // attribute value dominated
+    attributeDocument = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<rows>\n";
+    for (int i = 0; i < 20000; ++i) {
+        attributeDocument += "<row id=\"" + QByteArray::number(i) + "\" name=\"row number "
+                + QByteArray::number(i) + "\" description='a somewhat longer attribute value'"
+                  " path=\"/usr/share/some/where/file.xml\"/>\n";
+    }
+    attributeDocument += "</rows>\n";
+}
+
+void tst_QXmlStreamReader::readText_data()
+{
+    QTest::addColumn<bool>("fromDevice");
+    QTest::newRow("QByteArray") << false;
+    QTest::newRow("QIODevice") << true;
+}
+
+void tst_QXmlStreamReader::readText()
+{
+    QFETCH(bool, fromDevice);
+
+    QBENCHMARK {
+        QBuffer buffer(&textDocument);
+        buffer.open(QIODevice::ReadOnly);
+        QXmlStreamReader reader;
+        if (fromDevice)
+            reader.setDevice(&buffer);
+        else
+            reader.addData(textDocument);
+
+        qsizetype characters = 0;
+        while (!reader.atEnd()) {
+            if (reader.readNext() == QXmlStreamReader::Characters)
+                characters += reader.text().size();
+        }
+        QVERIFY(!reader.hasError());
+        QVERIFY(characters > 0);
+    }
+}
+
+void tst_QXmlStreamReader::readAttributes_data()
+{
+    readText_data();
+}
+
+void tst_QXmlStreamReader::readAttributes()
+{
+    QFETCH(bool, fromDevice);
+
+    QBENCHMARK {
+        QBuffer buffer(&attributeDocument);
+        buffer.open(QIODevice::ReadOnly);
+        QXmlStreamReader reader;
+        if (fromDevice)
+            reader.setDevice(&buffer);
+        else
+            reader.addData(attributeDocument);
+
+        qsizetype attributes = 0;
+        while (!reader.atEnd()) {
+            if (reader.readNext() == QXmlStreamReader::StartElement)
+                attributes += reader.attributes().size();
+        }
+        QVERIFY(!reader.hasError());
+        QCOMPARE(attributes, 4 * 20000);
+    }
+}
+
+QTEST_MAIN(tst_QXmlStreamReader)
+
+#include "main.moc"
@@ -100,6 +100,8 @@ private Q_SLOTS:
     void fromMSecsSinceEpoch();
     void fromMSecsSinceEpochUtc();
     void fromMSecsSinceEpochTz();
+    void bulkConversion_data();
+    void bulkConversion();
 };
 
 QList<QDateTime> tst_QDateTime::daily(qint64 start, qint64 end)
@@ -569,6 +571,53 @@ void tst_QDateTime::fromMSecsSinceEpochTz()
     }
 }
 
+void tst_QDateTime::bulkConversion_data()
+{
+    QTest::addColumn<bool>("bulk");
+    QTest::newRow("per value") << false;
+    QTest::newRow("bulk") << true;
+}
+
+// Hourly values over ten years, converted to date, time and offset and
+// then to ISO strings and back, one at a time or with the bulk API.
+void tst_QDateTime::bulkConversion()
+{
+    QFETCH(bool, bulk);
+    const QTimeZone cet("Europe/Oslo");
+    const qint64 start = (JULIAN_DAY_2010 - JULIAN_DAY_1970) * MSECS_PER_DAY;
+    const qint64 end = (JULIAN_DAY_2020 - JULIAN_DAY_1970) * MSECS_PER_DAY;
+    QList<qint64> msecs;
+    for (qint64 ms = start; ms < end; ms += 3600 * 1000)
+        msecs.append(ms);
+    const qsizetype count = msecs.size();
+
+    QList<QDate> dates(count);
+    QList<QTime> times(count);
+    QList<int> offsets(count);
+    QByteArray buffer(count * QDateTime::IsoDateStringSize, Qt::Uninitialized);
+    QList<qint64> parsed(count);
+    if (bulk) {
+        QBENCHMARK {
+            QDateTime::toDatesAndTimes(msecs.constData(), count, cet,
+                                       dates.data(), times.data(), offsets.data());
+            QDateTime::toIsoDateStrings(msecs.constData(), count, cet, buffer.data());
+            QDateTime::fromIsoDateStrings(buffer.constData(), count, parsed.data());
+        }
+    } else {
+        QBENCHMARK {
+            for (qsizetype i = 0; i < count; ++i) {
+                const QDateTime dt = QDateTime::fromMSecsSinceEpoch(msecs.at(i), cet);
+                dates[i] = dt.date();
+                times[i] = dt.time();
+                offsets[i] = dt.offsetFromUtc();
+                const QString iso = dt.toString(Qt::ISODateWithMs);
+                parsed[i] = QDateTime::fromString(iso, Qt::ISODateWithMs).toMSecsSinceEpoch();
+            }
+        }
+    }
+    QCOMPARE(parsed, msecs);
+}
+
 QTEST_MAIN(tst_QDateTime)
 
 #include "main.moc"
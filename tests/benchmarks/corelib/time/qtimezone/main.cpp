@@ -49,6 +49,10 @@ private Q_SLOTS:
     void transitionsForward();
     void transitionsReverse_data() { transitionList_data(); }
     void transitionsReverse();
+    void offsetFromUtc_data();
+    void offsetFromUtc();
+    void localTimeInZone_data() { offsetFromUtc_data(); }
+    void localTimeInZone();
 };
 
 static QList<QByteArray> enoughZones()
@@ -161,6 +165,56 @@ void tst_QTimeZone::transitionsReverse()
     }
 }
 
+void tst_QTimeZone::offsetFromUtc_data()
+{
+    QTest::addColumn<QByteArray>("name");
+    QTest::addColumn<int>("firstYear");
+    QTest::addColumn<int>("lastYear");
+
+    // Covered by the zone's transitions, and by its POSIX rule, for zoneinfo
+    // files listing transitions until 2037
+    const QList<QByteArray> names = { QByteArray("Europe/Berlin"), QByteArray("America/Sao_Paulo"),
+                                      QByteArray("Australia/Sydney") };
+    for (const auto &name : names) {
+        if (!QTimeZone(name).isValid())
+            continue;
+        QTest::addRow("%s, 1900-2030", name.constData()) << name << 1900 << 2030;
+        QTest::addRow("%s, 2040-2100", name.constData()) << name << 2040 << 2100;
+    }
+}
+
+void tst_QTimeZone::offsetFromUtc()
+{
+    QFETCH(QByteArray, name);
+    QFETCH(int, firstYear);
+    QFETCH(int, lastYear);
+    const QTimeZone zone(name);
+    QList<QDateTime> instants;
+    for (int year = firstYear; year <= lastYear; ++year) {
+        for (int month = 1; month <= 12; ++month)
+            instants << QDateTime(QDate(year, month, 13), QTime(12, 0), Qt::UTC);
+    }
+    QBENCHMARK {
+        for (const QDateTime &instant : qAsConst(instants))
+            zone.offsetFromUtc(instant);
+    }
+}
+
+// Resolving a local time needs the zone's data around it
+void tst_QTimeZone::localTimeInZone()
+{
+    QFETCH(QByteArray, name);
+    QFETCH(int, firstYear);
+    QFETCH(int, lastYear);
+    const QTimeZone zone(name);
+    QBENCHMARK {
+        for (int year = firstYear; year <= lastYear; ++year) {
+            for (int month = 1; month <= 12; ++month)
+                QDateTime(QDate(year, month, 13), QTime(12, 0), zone).toMSecsSinceEpoch();
+        }
+    }
+}
+
 QTEST_MAIN(tst_QTimeZone)
 
 #include "main.moc"
@@ -0,0 +1,124 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QDomDocument>
+#include <qtest.h>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#  include <malloc.h>
+#  define HAVE_MALLINFO2
+#endif
+
+class tst_QDomDocument : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void setContent_data();
+    void setContent();
+    void traverse();
+    void memoryUsage_data();
+    void memoryUsage();
+
+private:
+    QByteArray document;
+};
+
+void tst_QDomDocument::initTestCase()
+{
+    document = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+               "<catalog xmlns=\"urn:example:catalog\" xmlns:x=\"urn:example:extra\">\n";
+    for (int i = 0; i < 20000; ++i) {
+        document += "  <item id=\"" + QByteArray::number(i) + "\" x:state=\"active\" kind=\"book\">\n"
+                    "    <title>Title " + QByteArray::number(i) + "</title>\n"
+                    "    <x:price currency=\"EUR\">" + QByteArray::number(i % 100) + ".50</x:price>\n"
+                    "  </item>\n";
+    }
+    document += "</catalog>\n";
+}
+
+void tst_QDomDocument::setContent_data()
+{
+    QTest::addColumn<bool>("namespaceProcessing");
+    QTest::newRow("plain") << false;
+    QTest::newRow("namespaces") << true;
+}
+
+void tst_QDomDocument::setContent()
+{
+    QFETCH(bool, namespaceProcessing);
+
+    QBENCHMARK {
+        QDomDocument doc;
+        QVERIFY(doc.setContent(document, namespaceProcessing));
+    }
+}
+
+void tst_QDomDocument::traverse()
+{
+    QDomDocument doc;
+    QVERIFY(doc.setContent(document, true));
+
+    QBENCHMARK {
+        int count = 0;
+        for (QDomElement item = doc.documentElement().firstChildElement(); !item.isNull();
+             item = item.nextSiblingElement()) {
+            if (item.attribute(QStringLiteral("kind")) == QLatin1String("book"))
+                ++count;
+        }
+        QCOMPARE(count, 20000);
+    }
+}
+
+void tst_QDomDocument::memoryUsage_data()
+{
+    setContent_data();
+}
+
+void tst_QDomDocument::memoryUsage()
+{
+#ifdef HAVE_MALLINFO2
+    QFETCH(bool, namespaceProcessing);
+
+    // Heap bytes held by a parsed document, measured while it is still alive.
+    const size_t before = mallinfo2().uordblks;
+    QDomDocument doc;
+    QVERIFY(doc.setContent(document, namespaceProcessing));
+    const size_t after = mallinfo2().uordblks;
+
+    QTest::setBenchmarkResult(qreal(after > before ? after - before : 0), QTest::BytesAllocated);
+#else
+    QSKIP("This test requires mallinfo2() from glibc 2.33 or later");
+#endif
+}
+
+QTEST_MAIN(tst_QDomDocument)
+
+#include "main.moc"
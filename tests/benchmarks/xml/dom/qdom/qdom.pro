@@ -0,0 +1,5 @@
+CONFIG += benchmark
+QT = xml testlib
+
+TARGET = tst_bench_qdom
+SOURCES += main.cpp
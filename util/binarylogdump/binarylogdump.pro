@@ -0,0 +1,5 @@
+TEMPLATE = app
+TARGET = binarylogdump
+SOURCES += main.cpp
+QT = core-private
+CONFIG += console
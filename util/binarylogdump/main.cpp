@@ -0,0 +1,80 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the utils of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/private/qbinarylog_p.h>
+
+#include <stdio.h>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral(
+            "Prints the messages of a log written with QT_LOGGING_BINARY set."));
+    parser.addHelpOption();
+    const QCommandLineOption timestampsOption(QStringLiteral("timestamps"), QStringLiteral(
+            "Prefix every message with the time and thread it was logged in."));
+    parser.addOption(timestampsOption);
+    parser.addPositionalArgument(QStringLiteral("file"), QStringLiteral("The binary log."));
+    parser.process(app);
+
+    const QStringList files = parser.positionalArguments();
+    if (files.size() != 1)
+        parser.showHelp(1);
+
+    QFile file(files.first());
+    if (!file.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "Cannot open %s: %s\n", qPrintable(file.fileName()),
+                qPrintable(file.errorString()));
+        return 1;
+    }
+
+    const bool timestamps = parser.isSet(timestampsOption);
+    QBinaryLogReader reader(&file);
+    while (reader.readNext()) {
+        const QString text = qFormatLogMessage(reader.type(), reader.context(), reader.message());
+        if (text.isNull())
+            continue;
+        if (timestamps) {
+            const QDateTime time = QDateTime::fromMSecsSinceEpoch(reader.timestamp() / 1000000);
+            printf("%s [%llx] ", qPrintable(time.toString(Qt::ISODateWithMs)),
+                   reader.threadId());
+        }
+        printf("%s\n", text.toLocal8Bit().constData());
+    }
+
+    if (reader.hasError()) {
+        fprintf(stderr, "%s: %s\n", qPrintable(file.fileName()), qPrintable(reader.errorString()));
+        return 1;
+    }
+    return 0;
+}